@@ -50,6 +50,28 @@ struct DEVICE_FD_ID
     int id;
 };
 
+// Copy of a CPU texture in a renderer device other than the allocator
+struct TEXTURE_COPY
+{
+    SRMDevice *device;
+    SRMBuffer *buffer { nullptr };
+
+    // Damage not yet copied to buffer
+    LRegion stale;
+};
+
+/* With multiple renderer GPUs, CPU textures keep a shadow of their pixels so that each device is only
+ * updated with the damaged rects, and only once the texture is used on one of its outputs */
+struct TEXTURE_SHADOW
+{
+    std::vector<UInt8> pixels;
+    UInt32 stride;
+    UInt32 format;
+    UInt32 bytesPerPixel;
+    LSize size;
+    std::vector<TEXTURE_COPY> copies;
+};
+
 struct Backend
 {
     SRMCore *core;
@@ -58,6 +80,8 @@ struct Backend
     std::vector<LDMAFormat>dmaFormats;
     std::list<DEVICE_FD_ID> devices;
     UInt32 rendererGPUs {0};
+    std::unordered_map<LTexture*, TEXTURE_SHADOW> textureShadows;
+    std::unordered_map<SRMDevice*, UInt64> copiedBytes;
 };
 
 struct Output
@@ -325,7 +349,7 @@ bool LGraphicBackend::backendInitialize()
 
     if (!bknd->core)
     {
-        LLog::fatal("[%s] Failed to create SRM core.", BKND_NAME);
+        LLOG_FATAL("[%s] Failed to create SRM core.", BKND_NAME);
         goto fail;
     }
 
@@ -333,7 +357,7 @@ bool LGraphicBackend::backendInitialize()
 
     if (version->major == 0 && version->minor == 5 && version->patch == 1)
     {
-        LLog::fatal("[%s] You are currently using SRM v0.5.1, which has serious bugs causing issues with the refresh rate and hardware cursor plane updates. Consider upgrading to v0.5.2 or a later version.", BKND_NAME);
+        LLOG_FATAL("[%s] You are currently using SRM v0.5.1, which has serious bugs causing issues with the refresh rate and hardware cursor plane updates. Consider upgrading to v0.5.2 or a later version.", BKND_NAME);
         srmCoreDestroy(bknd->core);
         goto fail;
     }
@@ -455,6 +479,73 @@ EGLContext LGraphicBackend::backendGetAllocatorEGLContext()
 
 /* TEXTURES */
 
+static void destroyTextureShadow(Backend *bknd, LTexture *texture)
+{
+    auto it = bknd->textureShadows.find(texture);
+
+    if (it == bknd->textureShadows.end())
+        return;
+
+    for (TEXTURE_COPY &copy : it->second.copies)
+        if (copy.buffer)
+            srmBufferDestroy(copy.buffer);
+
+    bknd->textureShadows.erase(it);
+}
+
+// Returns the copy of the texture in the device (updating its stale rects) or NULL if the texture has no shadow
+static SRMBuffer *textureShadowGetBuffer(Backend *bknd, LTexture *texture, SRMDevice *device)
+{
+    auto it = bknd->textureShadows.find(texture);
+
+    if (it == bknd->textureShadows.end())
+        return NULL;
+
+    TEXTURE_SHADOW &shadow { it->second };
+    TEXTURE_COPY *copy { nullptr };
+
+    for (TEXTURE_COPY &c : shadow.copies)
+    {
+        if (c.device == device)
+        {
+            copy = &c;
+            break;
+        }
+    }
+
+    if (!copy)
+    {
+        SRMBuffer *buffer { srmBufferCreateFromCPU(bknd->core, device, shadow.size.w(), shadow.size.h(), shadow.stride, shadow.pixels.data(), shadow.format) };
+
+        if (!buffer)
+            return NULL;
+
+        shadow.copies.emplace_back();
+        shadow.copies.back().device = device;
+        shadow.copies.back().buffer = buffer;
+        bknd->copiedBytes[device] += shadow.pixels.size();
+        return buffer;
+    }
+
+    if (copy->stale.empty())
+        return copy->buffer;
+
+    Int32 n;
+    LBox *boxes { copy->stale.boxes(&n) };
+
+    for (Int32 i = 0; i < n; i++)
+    {
+        const UInt32 w = boxes[i].x2 - boxes[i].x1;
+        const UInt32 h = boxes[i].y2 - boxes[i].y1;
+        srmBufferWrite(copy->buffer, shadow.stride, boxes[i].x1, boxes[i].y1, w, h,
+                       &shadow.pixels[boxes[i].y1 * shadow.stride + boxes[i].x1 * shadow.bytesPerPixel]);
+        bknd->copiedBytes[device] += w * h * shadow.bytesPerPixel;
+    }
+
+    copy->stale.clear();
+    return copy->buffer;
+}
+
 bool LGraphicBackend::textureCreateFromCPUBuffer(LTexture *texture, const LSize &size, UInt32 stride, UInt32 format, const void *pixels)
 {
     Backend *bknd = (Backend*)LCompositor::compositor()->imp()->graphicBackendData;
@@ -463,6 +554,22 @@ bool LGraphicBackend::textureCreateFromCPUBuffer(LTexture *texture, const LSize
     if (bkndBuffer)
     {
         texture->imp()->graphicBackendData = bkndBuffer;
+        destroyTextureShadow(bknd, texture);
+
+        if (bknd->rendererGPUs > 1)
+        {
+            TEXTURE_SHADOW &shadow { bknd->textureShadows[texture] };
+            shadow.stride = stride;
+            shadow.format = format;
+            shadow.bytesPerPixel = LTexture::formatBytesPerPixel(format);
+            shadow.size = size;
+
+            if (pixels)
+                shadow.pixels.assign((const UInt8*)pixels, (const UInt8*)pixels + stride * size.h());
+            else
+                shadow.pixels.resize(stride * size.h());
+        }
+
         return true;
     }
 
@@ -505,23 +612,53 @@ bool LGraphicBackend::textureCreateFromDMA(LTexture *texture, const LDMAPlanes *
 
 bool LGraphicBackend::textureUpdateRect(LTexture *texture, UInt32 stride, const LRect &dst, const void *pixels)
 {
+    Backend *bknd = (Backend*)LCompositor::compositor()->imp()->graphicBackendData;
     SRMBuffer *bkndBuffer = (SRMBuffer*)texture->imp()->graphicBackendData;
-    return srmBufferWrite(bkndBuffer, stride, dst.x(), dst.y(), dst.w(), dst.h(), pixels);
+
+    if (!srmBufferWrite(bkndBuffer, stride, dst.x(), dst.y(), dst.w(), dst.h(), pixels))
+        return false;
+
+    auto it = bknd->textureShadows.find(texture);
+
+    if (it == bknd->textureShadows.end())
+        return true;
+
+    // Update the shadow and mark the rect as stale in the other devices
+    TEXTURE_SHADOW &shadow { it->second };
+    const UInt32 rowSize { dst.w() * shadow.bytesPerPixel };
+
+    for (Int32 y = 0; y < dst.h(); y++)
+        memcpy(&shadow.pixels[(dst.y() + y) * shadow.stride + dst.x() * shadow.bytesPerPixel],
+               (const UInt8*)pixels + y * stride,
+               rowSize);
+
+    for (TEXTURE_COPY &copy : shadow.copies)
+        copy.stale.addRect(dst);
+
+    return true;
 }
 
 UInt32 LGraphicBackend::textureGetID(LOutput *output, LTexture *texture)
 {
     SRMDevice *bkndRendererDevice;
 
+    Backend *bknd = (Backend*)LCompositor::compositor()->imp()->graphicBackendData;
+
     if (output)
     {
         Output *bkndOutput = (Output*)output->imp()->graphicBackendData;
         bkndRendererDevice = srmDeviceGetRendererDevice(srmConnectorGetDevice(bkndOutput->conn));
     }
     else
-    {
-        Backend *bknd = (Backend*)LCompositor::compositor()->imp()->graphicBackendData;
         bkndRendererDevice = srmCoreGetAllocatorDevice(bknd->core);
+
+    // CPU texture used on another GPU, copy only what changed since it was last used there
+    if (bknd->rendererGPUs > 1 && bkndRendererDevice != srmCoreGetAllocatorDevice(bknd->core))
+    {
+        SRMBuffer *copy { textureShadowGetBuffer(bknd, texture, bkndRendererDevice) };
+
+        if (copy)
+            return srmBufferGetTextureID(bkndRendererDevice, copy);
     }
 
     return srmBufferGetTextureID(bkndRendererDevice, (SRMBuffer*)texture->imp()->graphicBackendData);
@@ -535,7 +672,9 @@ GLenum LGraphicBackend::textureGetTarget(LTexture *texture)
 
 void LGraphicBackend::textureDestroy(LTexture *texture)
 {
+    Backend *bknd = (Backend*)LCompositor::compositor()->imp()->graphicBackendData;
     SRMBuffer *buffer = (SRMBuffer*)texture->imp()->graphicBackendData;
+    destroyTextureShadow(bknd, texture);
 
     if (buffer)
         srmBufferDestroy(buffer);
@@ -714,7 +853,7 @@ bool LGraphicBackend::outputSetGamma(LOutput *output, const LGammaTable &table)
 #if SRM_VERSION_MINOR >= 5
     if (table.size() != srmConnectorGetGammaSize(bkndOutput->conn))
     {
-        LLog::error("[%s] Failed to set gamma to output %s. Invalid size %d != real gamma size %d.",
+        LLOG_ERROR("[%s] Failed to set gamma to output %s. Invalid size %d != real gamma size %d.",
                     BKND_NAME,
                     output->name(),
                     table.size(),
@@ -797,6 +936,14 @@ clockid_t LGraphicBackend::outputGetClock(LOutput *output)
 #endif
 }
 
+UInt64 LGraphicBackend::outputGetCopiedBytes(LOutput *output)
+{
+    Backend *bknd = (Backend*)LCompositor::compositor()->imp()->graphicBackendData;
+    Output *bkndOutput = (Output*)output->imp()->graphicBackendData;
+    auto it = bknd->copiedBytes.find(srmDeviceGetRendererDevice(srmConnectorGetDevice(bkndOutput->conn)));
+    return it == bknd->copiedBytes.end() ? 0 : it->second;
+}
+
 /* OUTPUT CURSOR */
 
 bool LGraphicBackend::outputHasHardwareCursorSupport(LOutput *output)
@@ -925,6 +1072,7 @@ extern "C" LGraphicBackendInterface *getAPI()
 
     /* OUTPUT TIME */
     API.outputGetClock                  = &LGraphicBackend::outputGetClock;
+    API.outputGetCopiedBytes            = &LGraphicBackend::outputGetCopiedBytes;
 
     /* OUTPUT CURSOR */
     API.outputHasHardwareCursorSupport  = &LGraphicBackend::outputHasHardwareCursorSupport;
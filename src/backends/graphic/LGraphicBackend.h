@@ -62,6 +62,7 @@ public:
 
     /* OUTPUT TIME */
     static clockid_t                        outputGetClock(LOutput *output);
+    static UInt64                           outputGetCopiedBytes(LOutput *output);
 
     /* OUTPUT CURSOR */
     static bool                             outputHasHardwareCursorSupport(LOutput *output);
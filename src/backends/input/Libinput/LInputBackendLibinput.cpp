@@ -2,15 +2,66 @@
 #include <private/LSeatPrivate.h>
 #include <private/LKeyboardPrivate.h>
 #include <private/LPointerPrivate.h>
+#include <private/LCursorPrivate.h>
+#include <private/LTracePrivate.h>
 #include <LInputBackend.h>
 #include <LLog.h>
 #include <unordered_map>
 #include <cstring>
 #include <libinput.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <sys/eventfd.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Must be a power of 2
+#define INPUT_QUEUE_SIZE 1024
 
 using namespace Louvre;
 
+struct QUEUED_EVENT
+{
+    libinput_event *event;
+    UInt64 timeUs;
+};
+
+// Lock-free single producer (input thread) single consumer (main thread) ring buffer
+struct EVENT_QUEUE
+{
+    QUEUED_EVENT events[INPUT_QUEUE_SIZE];
+    alignas(64) std::atomic<UInt32> head { 0 };
+    alignas(64) std::atomic<UInt32> tail { 0 };
+
+    bool push(const QUEUED_EVENT &event)
+    {
+        const UInt32 t { tail.load(std::memory_order_relaxed) };
+
+        if (t - head.load(std::memory_order_acquire) == INPUT_QUEUE_SIZE)
+            return false;
+
+        events[t & (INPUT_QUEUE_SIZE - 1)] = event;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(QUEUED_EVENT &event)
+    {
+        const UInt32 h { head.load(std::memory_order_relaxed) };
+
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+
+        event = events[h & (INPUT_QUEUE_SIZE - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
 struct DEVICE_FD_ID
 {
     int fd;
@@ -24,6 +75,19 @@ struct BACKEND_DATA
     libinput_interface libinputInterface;
     LSeat *seat;
     std::list<DEVICE_FD_ID> devices;
+
+    // Input thread (LOUVRE_INPUT_THREAD=1)
+    bool threaded = false;
+    std::thread thread;
+    std::atomic<bool> threadRunning { false };
+
+    /* Guards the libinput context, which is not thread-safe. Recursive since it is also held while
+     * LSeat::nativeInputEvent() is invoked, which may call suspend() or resume() */
+    std::recursive_mutex libinputMutex;
+    EVENT_QUEUE queue;
+    std::vector<libinput_event*> processedEvents;
+    Int32 wakeFd = -1;
+    Int32 stopFd = -1;
 };
 
 // Libseat devices
@@ -100,6 +164,130 @@ static void closeRestricted(int fd, void *data)
     close(fd);
 }
 
+static UInt64 nowUs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UInt64)ts.tv_sec * 1000000 + (UInt64)ts.tv_nsec / 1000;
+}
+
+// Kernel timestamp (CLOCK_MONOTONIC) or 0 if the event has none
+static UInt64 eventTimeUs(libinput_event *event)
+{
+    switch (libinput_event_get_type(event))
+    {
+    case LIBINPUT_EVENT_POINTER_MOTION:
+    case LIBINPUT_EVENT_POINTER_BUTTON:
+    case LIBINPUT_EVENT_POINTER_SCROLL_WHEEL:
+    case LIBINPUT_EVENT_POINTER_SCROLL_FINGER:
+    case LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS:
+        return libinput_event_pointer_get_time_usec(libinput_event_get_pointer_event(event));
+    case LIBINPUT_EVENT_KEYBOARD_KEY:
+        return libinput_event_keyboard_get_time_usec(libinput_event_get_keyboard_event(event));
+    default:
+        return 0;
+    }
+}
+
+static void handleEvent(LSeat *seat, BACKEND_DATA *data, UInt64 timeUs)
+{
+    LTRACE_SCOPE("inputEvent");
+    eventType = libinput_event_get_type(ev);
+
+    if (eventType == LIBINPUT_EVENT_POINTER_MOTION)
+    {
+        pointerEvent = libinput_event_get_pointer_event(ev);
+
+        x = libinput_event_pointer_get_dx(pointerEvent);
+        y = libinput_event_pointer_get_dy(pointerEvent);
+
+        // In threaded mode the motion was already applied to the hardware cursor planes by the input thread
+        seat->pointer()->imp()->backendMoveEvent(x, y, timeUs, data->threaded);
+    }
+    else if (eventType == LIBINPUT_EVENT_POINTER_BUTTON)
+    {
+        seat->pointer()->imp()->flushMotion();
+        pointerEvent = libinput_event_get_pointer_event(ev);
+        pointerButton = libinput_event_pointer_get_button(pointerEvent);
+        pointerButtonState = libinput_event_pointer_get_button_state(pointerEvent);
+
+        // Remember: Move this in 2.0.0
+        if (pointerButton == LPointer::Pressed)
+            seat->pointer()->imp()->pressedButtons.push_back((LPointer::Button)pointerButton);
+        else
+            LVectorRemoveOneUnordered(seat->pointer()->imp()->pressedButtons, (LPointer::Button)pointerButton);
+
+        seat->pointer()->pointerButtonEvent(
+            (LPointer::Button)pointerButton,
+            (LPointer::ButtonState)pointerButtonState);
+    }
+    else if (eventType == LIBINPUT_EVENT_KEYBOARD_KEY)
+    {
+        keyEvent = libinput_event_get_keyboard_event(ev);
+        keyState = libinput_event_keyboard_get_key_state(keyEvent);
+        keyCode = libinput_event_keyboard_get_key(keyEvent);
+        seat->keyboard()->imp()->backendKeyEvent(keyCode, (LKeyboard::KeyState)keyState);
+
+        data->libinputMutex.lock();
+        libinput_device_led_update(
+            libinput_event_get_device(ev),
+            seat->keyboard()->isModActive(XKB_MOD_NAME_CAPS, XKB_STATE_MODS_LOCKED) ? LIBINPUT_LED_CAPS_LOCK : (libinput_led)0);
+        data->libinputMutex.unlock();
+    }
+    else if (eventType == LIBINPUT_EVENT_POINTER_SCROLL_FINGER)
+    {
+        seat->pointer()->imp()->flushMotion();
+        pointerEvent = libinput_event_get_pointer_event(ev);
+
+        if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL))
+            axisX = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+
+        if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL))
+            axisY = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+
+        seat->pointer()->pointerAxisEvent(axisX, axisY, axisX, axisY, LPointer::AxisSource::Finger);
+    }
+    else if (eventType == LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS)
+    {
+        seat->pointer()->imp()->flushMotion();
+        pointerEvent = libinput_event_get_pointer_event(ev);
+
+        if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL))
+            axisX = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+
+        if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL))
+            axisY = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+
+        seat->pointer()->pointerAxisEvent(axisX, axisY, axisX, axisY, LPointer::AxisSource::Continuous);
+    }
+    else if (eventType == LIBINPUT_EVENT_POINTER_SCROLL_WHEEL)
+    {
+        seat->pointer()->imp()->flushMotion();
+        pointerEvent = libinput_event_get_pointer_event(ev);
+
+        if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL))
+        {
+            discreteX = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+            d120X = libinput_event_pointer_get_scroll_value_v120(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+        }
+
+        if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL))
+        {
+            discreteY = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+            d120Y = libinput_event_pointer_get_scroll_value_v120(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+        }
+
+        seat->pointer()->pointerAxisEvent(discreteX, discreteY, d120X, d120Y, LPointer::AxisSource::Wheel);
+    }
+
+    seat->imp()->recordInputLatency(timeUs, nowUs());
+
+    // The input thread may be dispatching libinput, so calls made with the native event are serialized with it
+    data->libinputMutex.lock();
+    seat->nativeInputEvent(ev);
+    data->libinputMutex.unlock();
+}
+
 static Int32 processInput(int, unsigned int, void *userData)
 {
     LSeat *seat = (LSeat*)userData;
@@ -109,98 +297,128 @@ static Int32 processInput(int, unsigned int, void *userData)
 
     if (ret != 0)
     {
-        LLog::error("[Libinput Backend] Failed to dispatch libinput %s.", strerror(-ret));
+        LLOG_ERROR("[Libinput Backend] Failed to dispatch libinput %s.", strerror(-ret));
         return 0;
     }
 
     while ((ev = libinput_get_event(data->li)) != NULL)
     {
-        eventType = libinput_event_get_type(ev);
+        handleEvent(seat, data, eventTimeUs(ev));
+        libinput_event_destroy(ev);
+    }
 
-        if (eventType == LIBINPUT_EVENT_POINTER_MOTION)
-        {
-            pointerEvent = libinput_event_get_pointer_event(ev);
+    return 0;
+}
 
-            x = libinput_event_pointer_get_dx(pointerEvent);
-            y = libinput_event_pointer_get_dy(pointerEvent);
+// Main thread, consumes the events queued by the input thread in a single batch
+static void processQueue(LSeat *seat, BACKEND_DATA *data)
+{
+    QUEUED_EVENT queued;
 
-            seat->pointer()->pointerMoveEvent(x, y, false);
-        }
-        else if (eventType == LIBINPUT_EVENT_POINTER_BUTTON)
-        {
-            pointerEvent = libinput_event_get_pointer_event(ev);
-            pointerButton = libinput_event_pointer_get_button(pointerEvent);
-            pointerButtonState = libinput_event_pointer_get_button_state(pointerEvent);
-
-            // Remember: Move this in 2.0.0
-            if (pointerButton == LPointer::Pressed)
-                seat->pointer()->imp()->pressedButtons.push_back((LPointer::Button)pointerButton);
-            else
-                LVectorRemoveOneUnordered(seat->pointer()->imp()->pressedButtons, (LPointer::Button)pointerButton);
-
-            seat->pointer()->pointerButtonEvent(
-                (LPointer::Button)pointerButton,
-                (LPointer::ButtonState)pointerButtonState);
-        }
-        else if (eventType == LIBINPUT_EVENT_KEYBOARD_KEY)
-        {
-            keyEvent = libinput_event_get_keyboard_event(ev);
-            keyState = libinput_event_keyboard_get_key_state(keyEvent);
-            keyCode = libinput_event_keyboard_get_key(keyEvent);
-            seat->keyboard()->imp()->backendKeyEvent(keyCode, (LKeyboard::KeyState)keyState);
-
-            libinput_device_led_update(
-                libinput_event_get_device(ev),
-                seat->keyboard()->isModActive(XKB_MOD_NAME_CAPS, XKB_STATE_MODS_LOCKED) ? LIBINPUT_LED_CAPS_LOCK : (libinput_led)0);
-        }
-        else if (eventType == LIBINPUT_EVENT_POINTER_SCROLL_FINGER)
-        {
-            pointerEvent = libinput_event_get_pointer_event(ev);
+    while (data->queue.pop(queued))
+    {
+        ev = queued.event;
+        handleEvent(seat, data, queued.timeUs);
+        data->processedEvents.push_back(ev);
+    }
 
-            if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL))
-                axisX = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+    if (data->processedEvents.empty())
+        return;
 
-            if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL))
-                axisY = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+    data->libinputMutex.lock();
 
-            seat->pointer()->pointerAxisEvent(axisX, axisY, axisX, axisY, LPointer::AxisSource::Finger);
-        }
-        else if (eventType == LIBINPUT_EVENT_POINTER_SCROLL_CONTINUOUS)
-        {
-            pointerEvent = libinput_event_get_pointer_event(ev);
+    for (libinput_event *event : data->processedEvents)
+        libinput_event_destroy(event);
 
-            if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL))
-                axisX = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+    data->libinputMutex.unlock();
+    data->processedEvents.clear();
+}
 
-            if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL))
-                axisY = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+static Int32 processQueueEvent(int fd, unsigned int, void *userData)
+{
+    LSeat *seat = (LSeat*)userData;
+    BACKEND_DATA *data = (BACKEND_DATA*)seat->imp()->inputBackendData;
+    UInt64 value;
+    ssize_t n = read(fd, &value, sizeof(value));
+    L_UNUSED(n);
+    processQueue(seat, data);
+    return 0;
+}
 
-            seat->pointer()->pointerAxisEvent(axisX, axisY, axisX, axisY, LPointer::AxisSource::Continuous);
+// Input thread, drains libinput as soon as events arrive so that they are not delayed by the compositor lock
+static void inputThreadLoop(BACKEND_DATA *data)
+{
+    LTRACE_THREAD_NAME("Input");
+    pollfd fds[2];
+    fds[0].fd = libinput_get_fd(data->li);
+    fds[0].events = POLLIN;
+    fds[1].fd = data->stopFd;
+    fds[1].events = POLLIN;
+    libinput_event *event;
+    libinput_event_pointer *pointerEvent;
+    LCursor *cursor { LCompositor::compositor()->cursor() };
+    const UInt64 wake { 1 };
+    ssize_t n;
+
+    while (data->threadRunning.load())
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
         }
-        else if (eventType == LIBINPUT_EVENT_POINTER_SCROLL_WHEEL)
+
+        if (fds[1].revents & POLLIN)
+            break;
+
+        bool queued { false };
+        data->libinputMutex.lock();
+        libinput_dispatch(data->li);
+
+        while ((event = libinput_get_event(data->li)) != NULL)
         {
-            pointerEvent = libinput_event_get_pointer_event(ev);
+            const QUEUED_EVENT entry { event, eventTimeUs(event) };
+            pointerEvent = nullptr;
 
-            if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL))
+            // Move the hardware cursor planes right away, the main thread reconciles the cursor position later
+            if (cursor && libinput_event_get_type(event) == LIBINPUT_EVENT_POINTER_MOTION)
             {
-                discreteX = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
-                d120X = libinput_event_pointer_get_scroll_value_v120(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL);
+                pointerEvent = libinput_event_get_pointer_event(event);
+                cursor->imp()->fastPathMove(libinput_event_pointer_get_dx(pointerEvent),
+                                            libinput_event_pointer_get_dy(pointerEvent));
             }
 
-            if (libinput_event_pointer_has_axis(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL))
+            // Queue full, wake the main thread and wait for space
+            while (!data->queue.push(entry))
             {
-                discreteY = libinput_event_pointer_get_scroll_value(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
-                d120Y = libinput_event_pointer_get_scroll_value_v120(pointerEvent, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL);
+                if (!data->threadRunning.load())
+                {
+                    if (pointerEvent)
+                        cursor->imp()->fastPathConsume(libinput_event_pointer_get_dx(pointerEvent),
+                                                       libinput_event_pointer_get_dy(pointerEvent));
+
+                    libinput_event_destroy(event);
+                    break;
+                }
+
+                data->libinputMutex.unlock();
+                n = write(data->wakeFd, &wake, sizeof(wake));
+                usleep(500);
+                data->libinputMutex.lock();
             }
 
-            seat->pointer()->pointerAxisEvent(discreteX, discreteY, d120X, d120Y, LPointer::AxisSource::Wheel);
+            queued = true;
         }
 
-        seat->nativeInputEvent(ev);
-        libinput_event_destroy(ev);
+        data->libinputMutex.unlock();
+
+        if (queued)
+            n = write(data->wakeFd, &wake, sizeof(wake));
     }
 
-    return 0;
+    L_UNUSED(n);
 }
 
 UInt32 LInputBackend::id()
@@ -234,6 +452,26 @@ bool LInputBackend::initialize()
     else
         libinput_udev_assign_seat(data->li, "seat0");
 
+    data->threaded = getenvString("LOUVRE_INPUT_THREAD") == "1";
+
+    if (data->threaded)
+    {
+        data->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        data->stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (data->wakeFd >= 0 && data->stopFd >= 0)
+        {
+            eventSource = LCompositor::addFdListener(data->wakeFd, (LSeat*)seat, &processQueueEvent);
+            data->threadRunning.store(true);
+            data->thread = std::thread(&inputThreadLoop, data);
+            LLOG_DEBUG("[Libinput Backend] Reading input events from a dedicated thread.");
+            return true;
+        }
+
+        LLOG_ERROR("[Libinput Backend] Failed to create eventfd, reading input events from the main thread instead.");
+        data->threaded = false;
+    }
+
     fd = libinput_get_fd(data->li);
 
     eventSource = LCompositor::addFdListener(fd, (LSeat*)seat, &processInput);
@@ -260,13 +498,21 @@ void LInputBackend::suspend()
 {
     LSeat *seat = LCompositor::compositor()->seat();
     BACKEND_DATA *data = (BACKEND_DATA*)seat->imp()->inputBackendData;
+    data->libinputMutex.lock();
     libinput_suspend(data->li);
+    data->libinputMutex.unlock();
 }
 
 void LInputBackend::forceUpdate()
 {
     LSeat *seat = LCompositor::compositor()->seat();
-    processInput(0, 0, (LSeat*)seat);
+    BACKEND_DATA *data = (BACKEND_DATA*)seat->imp()->inputBackendData;
+
+    // The input thread keeps dispatching libinput
+    if (data->threaded)
+        processQueue(seat, data);
+    else
+        processInput(0, 0, (LSeat*)seat);
 }
 
 void LInputBackend::resume()
@@ -274,9 +520,13 @@ void LInputBackend::resume()
     LSeat *seat = LCompositor::compositor()->seat();
     BACKEND_DATA *data = (BACKEND_DATA*)seat->imp()->inputBackendData;
 
-    if (libinput_resume(data->li) == -1)
+    data->libinputMutex.lock();
+    const Int32 ret { libinput_resume(data->li) };
+    data->libinputMutex.unlock();
+
+    if (ret == -1)
     {
-        LLog::error("[Libinput Backend] Failed to resume libinput.");
+        LLOG_ERROR("[Libinput Backend] Failed to resume libinput.");
         return;
     }
 }
@@ -295,6 +545,27 @@ void LInputBackend::uninitialize()
         eventSource = nullptr;
     }
 
+    if (data->thread.joinable())
+    {
+        const UInt64 stop { 1 };
+        data->threadRunning.store(false);
+        ssize_t n = write(data->stopFd, &stop, sizeof(stop));
+        L_UNUSED(n);
+        data->thread.join();
+
+        // Discard events never consumed
+        QUEUED_EVENT queued;
+
+        while (data->queue.pop(queued))
+            libinput_event_destroy(queued.event);
+    }
+
+    if (data->wakeFd >= 0)
+        close(data->wakeFd);
+
+    if (data->stopFd >= 0)
+        close(data->stopFd);
+
     if (data->li)
         libinput_unref(data->li);
 
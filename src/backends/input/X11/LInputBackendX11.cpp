@@ -184,7 +184,7 @@ bool LInputBackend::initialize(const LSeat *seat)
 
     if(!data->display)
     {
-        LLog::error("%sFailed to get X display.", BACKEND_NAME);
+        LLOG_ERROR("%sFailed to get X display.", BACKEND_NAME);
         goto fail;
     }
 
@@ -194,11 +194,11 @@ bool LInputBackend::initialize(const LSeat *seat)
 
     data->source = LWayland::addFdListener(fd, (LSeat*)seat, &processInput);
 
-    LLog::debug("X11 Input Backend initialzed.");
+    LLOG_DEBUG("X11 Input Backend initialzed.");
     return true;
 
     failDep:
-    LLog::error("%sNeeds X11 graphic backend.", BACKEND_NAME);
+    LLOG_ERROR("%sNeeds X11 graphic backend.", BACKEND_NAME);
 
     fail:
     delete data;
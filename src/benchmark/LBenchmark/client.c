@@ -0,0 +1,412 @@
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if HAVE_GBM == 1
+#include <gbm.h>
+#endif
+
+#include "client.h"
+#include "shm.h"
+
+struct Client client;
+
+#if HAVE_GBM == 1
+static int drmFd = -1;
+static struct gbm_device *gbmDevice = NULL;
+#endif
+
+static void noop() {}
+
+static void wl_output_handle_scale(void *data, struct wl_output *output, int32_t scale)
+{
+    (void)data;
+    (void)output;
+    client.outputScale = scale;
+}
+
+static void wl_output_handle_mode(void *data,
+                                  struct wl_output *output,
+                                  unsigned int flags,
+                                  int w,
+                                  int h,
+                                  int refresh)
+{
+    (void)data;
+    (void)output;
+    (void)refresh;
+
+    if (!(flags & WL_OUTPUT_MODE_CURRENT))
+        return;
+
+    client.outputW = w;
+    client.outputH = h;
+}
+
+static const struct wl_output_listener wl_output_listener =
+{
+    .geometry = &noop,
+    .mode = &wl_output_handle_mode,
+    .done = &noop,
+    .scale = &wl_output_handle_scale,
+    .name = &noop,
+    .description = &noop
+};
+
+static void xdg_wm_base_handle_ping(void *data, struct xdg_wm_base *wm, uint32_t serial)
+{
+    (void)data;
+    xdg_wm_base_pong(wm, serial);
+}
+
+static const struct xdg_wm_base_listener xdg_wm_base_listener =
+{
+    .ping = &xdg_wm_base_handle_ping
+};
+
+static void handle_global(void *data, struct wl_registry *registry, uint32_t name, const char *interface, uint32_t version)
+{
+    (void)data;
+
+    if (strcmp(interface, wl_shm_interface.name) == 0)
+        client.shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    else if (strcmp(interface, wl_output_interface.name) == 0 && !client.output)
+    {
+        client.output = wl_registry_bind(registry, name, &wl_output_interface, version < 3 ? version : 3);
+        wl_output_add_listener(client.output, &wl_output_listener, NULL);
+    }
+    else if (strcmp(interface, wl_compositor_interface.name) == 0)
+        client.compositor = wl_registry_bind(registry, name, &wl_compositor_interface, version < 4 ? version : 4);
+    else if (strcmp(interface, wl_subcompositor_interface.name) == 0)
+        client.subcompositor = wl_registry_bind(registry, name, &wl_subcompositor_interface, 1);
+    else if (strcmp(interface, xdg_wm_base_interface.name) == 0)
+    {
+        client.xdg_wm_base = wl_registry_bind(registry, name, &xdg_wm_base_interface, 1);
+        xdg_wm_base_add_listener(client.xdg_wm_base, &xdg_wm_base_listener, NULL);
+    }
+    else if (strcmp(interface, wp_viewporter_interface.name) == 0)
+        client.viewporter = wl_registry_bind(registry, name, &wp_viewporter_interface, 1);
+    else if (strcmp(interface, wp_fractional_scale_manager_v1_interface.name) == 0)
+        client.fractional_scale_manager = wl_registry_bind(registry, name, &wp_fractional_scale_manager_v1_interface, 1);
+    else if (strcmp(interface, zwp_linux_dmabuf_v1_interface.name) == 0 && version >= 2)
+        client.linux_dmabuf = wl_registry_bind(registry, name, &zwp_linux_dmabuf_v1_interface, version < 3 ? version : 3);
+}
+
+static void handle_global_remove(void *data, struct wl_registry *registry, uint32_t name)
+{
+    (void)data;
+    (void)registry;
+    (void)name;
+}
+
+static const struct wl_registry_listener registry_listener =
+{
+    .global = handle_global,
+    .global_remove = handle_global_remove,
+};
+
+bool clientConnect(void)
+{
+    memset(&client, 0, sizeof(client));
+    client.outputScale = 1;
+    client.display = wl_display_connect(NULL);
+
+    if (!client.display)
+    {
+        fprintf(stderr, "LBenchmark: Failed to connect to the Wayland display.\n");
+        return false;
+    }
+
+    client.registry = wl_display_get_registry(client.display);
+    wl_registry_add_listener(client.registry, &registry_listener, NULL);
+    wl_display_roundtrip(client.display);
+    wl_display_roundtrip(client.display);
+
+    if (!client.shm || !client.compositor || !client.subcompositor || !client.xdg_wm_base || !client.output)
+    {
+        fprintf(stderr, "LBenchmark: The compositor does not support the required globals.\n");
+        return false;
+    }
+
+    return true;
+}
+
+void clientDisconnect(void)
+{
+#if HAVE_GBM == 1
+    if (gbmDevice)
+    {
+        gbm_device_destroy(gbmDevice);
+        gbmDevice = NULL;
+    }
+
+    if (drmFd >= 0)
+    {
+        close(drmFd);
+        drmFd = -1;
+    }
+#endif
+
+    if (client.display)
+        wl_display_disconnect(client.display);
+
+    client.display = NULL;
+}
+
+bool bufferCreateSHM(struct Buffer *buffer, int width, int height)
+{
+    memset(buffer, 0, sizeof(*buffer));
+    buffer->width = width;
+    buffer->height = height;
+    buffer->stride = width * 4;
+    buffer->size = (size_t)buffer->stride * height;
+
+    int fd = create_shm_file(buffer->size);
+
+    if (fd < 0)
+        return false;
+
+    buffer->data = mmap(NULL, buffer->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (buffer->data == MAP_FAILED)
+    {
+        buffer->data = NULL;
+        close(fd);
+        return false;
+    }
+
+    struct wl_shm_pool *pool = wl_shm_create_pool(client.shm, fd, buffer->size);
+    buffer->buffer = wl_shm_pool_create_buffer(pool, 0, width, height, buffer->stride, WL_SHM_FORMAT_ARGB8888);
+    wl_shm_pool_destroy(pool);
+    close(fd);
+    return true;
+}
+
+bool bufferCreateDMA(struct Buffer *buffer, int width, int height)
+{
+    memset(buffer, 0, sizeof(*buffer));
+
+#if HAVE_GBM == 1
+    if (!client.linux_dmabuf)
+        return false;
+
+    if (!gbmDevice)
+    {
+        drmFd = open("/dev/dri/renderD128", O_RDWR | O_CLOEXEC);
+
+        if (drmFd < 0)
+            return false;
+
+        gbmDevice = gbm_create_device(drmFd);
+
+        if (!gbmDevice)
+            return false;
+    }
+
+    // Linear so that it can be filled from the CPU
+    struct gbm_bo *bo = gbm_bo_create(gbmDevice, width, height, GBM_FORMAT_ARGB8888, GBM_BO_USE_LINEAR | GBM_BO_USE_RENDERING);
+
+    if (!bo)
+        return false;
+
+    const int fd = gbm_bo_get_fd(bo);
+
+    if (fd < 0)
+    {
+        gbm_bo_destroy(bo);
+        return false;
+    }
+
+    buffer->bo = bo;
+    buffer->width = width;
+    buffer->height = height;
+    buffer->stride = gbm_bo_get_stride(bo);
+
+    // DRM_FORMAT_MOD_LINEAR
+    const uint64_t modifier = 0;
+    struct zwp_linux_buffer_params_v1 *params = zwp_linux_dmabuf_v1_create_params(client.linux_dmabuf);
+    zwp_linux_buffer_params_v1_add(params, fd, 0, 0, buffer->stride, modifier >> 32, modifier & 0xffffffff);
+    buffer->buffer = zwp_linux_buffer_params_v1_create_immed(params, width, height, GBM_FORMAT_ARGB8888, 0);
+    zwp_linux_buffer_params_v1_destroy(params);
+    close(fd);
+
+    // Fails asynchronously with a protocol error if the compositor rejects it
+    return wl_display_roundtrip(client.display) >= 0;
+#else
+    (void)width;
+    (void)height;
+    return false;
+#endif
+}
+
+void bufferFill(struct Buffer *buffer, int x, int y, int width, int height, uint32_t argb)
+{
+    unsigned char *data = buffer->data;
+    int stride = buffer->stride;
+
+#if HAVE_GBM == 1
+    void *mapData = NULL;
+    uint32_t mapStride;
+
+    if (buffer->bo)
+    {
+        data = gbm_bo_map(buffer->bo, x, y, width, height, GBM_BO_TRANSFER_WRITE, &mapStride, &mapData);
+
+        if (!data)
+            return;
+
+        stride = mapStride;
+        x = y = 0;
+    }
+#endif
+
+    for (int row = y; row < y + height; row++)
+    {
+        uint32_t *pixel = (uint32_t*)(data + row * stride) + x;
+
+        for (int col = 0; col < width; col++)
+            pixel[col] = argb;
+    }
+
+#if HAVE_GBM == 1
+    if (buffer->bo)
+        gbm_bo_unmap(buffer->bo, mapData);
+#endif
+}
+
+void bufferDestroy(struct Buffer *buffer)
+{
+    if (buffer->buffer)
+        wl_buffer_destroy(buffer->buffer);
+
+    if (buffer->data)
+        munmap(buffer->data, buffer->size);
+
+#if HAVE_GBM == 1
+    if (buffer->bo)
+        gbm_bo_destroy(buffer->bo);
+#endif
+
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+static void xdg_surface_handle_configure(void *data, struct xdg_surface *xdg_surface, uint32_t serial)
+{
+    (void)data;
+    xdg_surface_ack_configure(xdg_surface, serial);
+}
+
+static const struct xdg_surface_listener xdg_surface_listener =
+{
+    .configure = xdg_surface_handle_configure,
+};
+
+static void xdg_toplevel_handle_configure(void *data, struct xdg_toplevel *xdg_toplevel, int32_t w, int32_t h, struct wl_array *states)
+{
+    (void)xdg_toplevel;
+    (void)states;
+    struct Window *window = data;
+
+    if (w == 0 || window->buffer.buffer)
+        return;
+
+    window->width = w;
+    window->height = h;
+}
+
+static const struct xdg_toplevel_listener xdg_toplevel_listener =
+{
+    .configure = &xdg_toplevel_handle_configure,
+    .close = &noop,
+};
+
+bool windowCreate(struct Window *window, int width, int height)
+{
+    memset(window, 0, sizeof(*window));
+    window->width = width;
+    window->height = height;
+    window->surface = wl_compositor_create_surface(client.compositor);
+    window->xdg_surface = xdg_wm_base_get_xdg_surface(client.xdg_wm_base, window->surface);
+    window->xdg_toplevel = xdg_surface_get_toplevel(window->xdg_surface);
+    xdg_surface_add_listener(window->xdg_surface, &xdg_surface_listener, window);
+    xdg_toplevel_add_listener(window->xdg_toplevel, &xdg_toplevel_listener, window);
+    xdg_toplevel_set_title(window->xdg_toplevel, "LBenchmark");
+    wl_display_roundtrip(client.display);
+    wl_surface_set_buffer_scale(window->surface, client.outputScale);
+
+    if (width == 0 || height == 0)
+        xdg_toplevel_set_maximized(window->xdg_toplevel);
+
+    wl_surface_attach(window->surface, NULL, 0, 0);
+    wl_surface_commit(window->surface);
+    wl_display_roundtrip(client.display);
+
+    if (window->width == 0 || window->height == 0)
+    {
+        window->width = client.outputW/client.outputScale;
+        window->height = client.outputH/client.outputScale - 32;
+    }
+
+    if (!bufferCreateSHM(&window->buffer, window->width * client.outputScale, window->height * client.outputScale))
+        return false;
+
+    bufferFill(&window->buffer, 0, 0, window->buffer.width, window->buffer.height, 0xFFFFFFFF);
+    window->region = wl_compositor_create_region(client.compositor);
+    wl_region_add(window->region, 0, 0, window->width, window->height);
+    wl_surface_set_opaque_region(window->surface, window->region);
+    wl_surface_attach(window->surface, window->buffer.buffer, 0, 0);
+    wl_surface_damage(window->surface, 0, 0, window->width, window->height);
+    wl_surface_commit(window->surface);
+    wl_display_roundtrip(client.display);
+    return true;
+}
+
+void windowDestroy(struct Window *window)
+{
+    if (window->xdg_toplevel)
+        xdg_toplevel_destroy(window->xdg_toplevel);
+
+    if (window->xdg_surface)
+        xdg_surface_destroy(window->xdg_surface);
+
+    if (window->surface)
+        wl_surface_destroy(window->surface);
+
+    if (window->region)
+        wl_region_destroy(window->region);
+
+    bufferDestroy(&window->buffer);
+    memset(window, 0, sizeof(*window));
+}
+
+void windowCommitFrame(struct Window *window, double ms)
+{
+    // The buffer may not use an integer scale (wp_viewport)
+    const int rows = (10 * window->buffer.height + window->height - 1) / window->height;
+    bufferFill(&window->buffer, 0, 0, window->buffer.width, rows, timeColor(ms, 255));
+    wl_surface_attach(window->surface, window->buffer.buffer, 0, 0);
+    wl_surface_damage(window->surface, 0, 0, window->width, 10);
+    wl_surface_commit(window->surface);
+}
+
+struct wl_surface *subsurfaceCreate(struct wl_surface *parent, struct wl_subsurface **subsurface)
+{
+    struct wl_surface *surface = wl_compositor_create_surface(client.compositor);
+    wl_surface_set_buffer_scale(surface, client.outputScale);
+    *subsurface = wl_subcompositor_get_subsurface(client.subcompositor, surface, parent);
+    wl_subsurface_set_desync(*subsurface);
+    return surface;
+}
+
+uint32_t timeColor(double ms, unsigned char alpha)
+{
+    const float a = alpha / 255.f;
+    const unsigned char r = (sinf((float)ms * 0.0015f) + 1.f) * 127.f * a;
+    const unsigned char g = (cosf((float)ms * 0.0010f) + 1.f) * 127.f * a;
+    const unsigned char b = (cosf((float)ms * 0.0005f) + 1.f) * 127.f * a;
+    return ((uint32_t)alpha << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
@@ -0,0 +1,79 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wayland-client.h>
+
+#include "xdg-shell-client-protocol.h"
+#include "viewporter-client-protocol.h"
+#include "fractional-scale-v1-client-protocol.h"
+#include "linux-dmabuf-unstable-v1-client-protocol.h"
+
+/* Globals bound by clientConnect(), optional ones are NULL if the compositor does not support them */
+struct Client
+{
+    struct wl_display *display;
+    struct wl_registry *registry;
+    struct wl_shm *shm;
+    struct wl_output *output;
+    struct wl_compositor *compositor;
+    struct wl_subcompositor *subcompositor;
+    struct xdg_wm_base *xdg_wm_base;
+    struct wp_viewporter *viewporter;
+    struct wp_fractional_scale_manager_v1 *fractional_scale_manager;
+    struct zwp_linux_dmabuf_v1 *linux_dmabuf;
+    int outputScale;
+    int outputW, outputH;
+};
+
+extern struct Client client;
+
+/* Returns false if a required global is missing */
+bool clientConnect(void);
+void clientDisconnect(void);
+
+/* ARGB8888 buffer, backed by a wl_shm pool or a linear GBM buffer object */
+struct Buffer
+{
+    struct wl_buffer *buffer;
+    unsigned char *data;
+    int width, height, stride;
+    size_t size;
+    void *bo;
+};
+
+bool bufferCreateSHM(struct Buffer *buffer, int width, int height);
+
+/* Returns false if linux-dmabuf or GBM are not available */
+bool bufferCreateDMA(struct Buffer *buffer, int width, int height);
+
+/* Fills a rect with a premultiplied ARGB color */
+void bufferFill(struct Buffer *buffer, int x, int y, int width, int height, uint32_t argb);
+void bufferDestroy(struct Buffer *buffer);
+
+/* Toplevel with a white opaque SHM buffer, maximized if width or height are 0 */
+struct Window
+{
+    struct wl_surface *surface;
+    struct xdg_surface *xdg_surface;
+    struct xdg_toplevel *xdg_toplevel;
+    struct wl_region *region;
+    struct Buffer buffer;
+    int width, height;
+};
+
+bool windowCreate(struct Window *window, int width, int height);
+void windowDestroy(struct Window *window);
+
+/* Repaints and damages a 10px band at the top of the window with a time dependent color and commits it */
+void windowCommitFrame(struct Window *window, double ms);
+
+/* Desync subsurface of parent */
+struct wl_surface *subsurfaceCreate(struct wl_surface *parent, struct wl_subsurface **subsurface);
+
+/* Returns a color that changes smoothly over time */
+uint32_t timeColor(double ms, unsigned char alpha);
+
+#endif
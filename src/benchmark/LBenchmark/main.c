@@ -1,447 +1,543 @@
-#include <bits/time.h>
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/mman.h>
-#include <sys/time.h>
+#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 #include <wayland-client.h>
-#include <wayland-client-protocol.h>
 
-#include "shm.h"
-#include "xdg-shell-client-protocol.h"
+#include "client.h"
+#include "scenarios.h"
 
-struct wl_callback_listener wl_callback_listener;
-static void wl_callback_handle_done(void *data, struct wl_callback *callback, uint32_t ms);
-
-static int N;
-static FILE *fp;
-static struct wl_display *display;
-static int outputScale = 1;
-static int childSize = 512;
+// Runs fail if no frame callback is received within this time
+#define FRAME_TIMEOUT_MS 5000
 
-static struct wl_shm *shm = NULL;
-static struct wl_output *output = NULL;
-static struct wl_subcompositor *subcompositor = NULL;
-static struct wl_compositor *compositor = NULL;
-static struct xdg_wm_base *xdg_wm_base = NULL;
+enum RunStatus
+{
+    RUN_OK,
+    RUN_SKIPPED,
+    RUN_FAILED
+};
 
-struct wl_region *childRegion;
+static const char *statusNames[] = { "ok", "skipped", "failed" };
 
-struct ParentSurface
-{
-    struct wl_region *region;
-    unsigned char *shm_data;
-    struct wl_buffer *buffer;
-    struct wl_surface *surface;
-    struct xdg_surface *xdg_surface;
-    struct xdg_toplevel *xdg_toplevel;
-    int width, height;
-}parent;
-
-static unsigned char *shm_opaque;
-struct wl_buffer *buffer_opaque;
-
-static unsigned char *shm_translucent;
-static struct wl_buffer *buffer_translucent;
-
-struct ChildSurface
+// Written by the child process of each run into a pipe
+struct RunResult
 {
-    struct wl_surface *surface;
-    struct wl_subsurface *subsurface;
-    float phaseX;
-    float phaseY;
-    float speed;
+    int status;
+    char reason[128];
+    int width, height, scale;
+    long frames;
+    double durationMs;
+    double fps;
+    double mean, p50, p90, p99, max;
 };
 
-static struct ChildSurface *children;
+struct Options
+{
+    int durationMs;
+    int warmupMs;
+    int runs;
+    int count;
+    unsigned int seed;
+    const char *output;
+    const char *label;
+};
 
-static struct wl_callback *callback = NULL;
+/******************** RUN (CHILD PROCESS) ********************/
 
-struct timespec start, end;
+static const struct Scenario *scenario;
+static struct wl_surface *root;
+static int warmupMs, durationMs;
+static double startMs, lastMs, measureStartMs;
+static bool firstFrame, done;
+static double *frameTimes;
+static long frameTimesCount, frameTimesCapacity;
 
-static void noop(){}
+static double nowMs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
 
-static long long int wait_ms = 0;
-static long long int ms = 0;
-static long long int total = 0;
-static int firstCallback = 0;
-static char fname[128];
+static void wl_callback_handle_done(void *data, struct wl_callback *callback, uint32_t ms);
 
-static int outputW, outputH;
+static const struct wl_callback_listener wl_callback_listener =
+{
+    .done = &wl_callback_handle_done
+};
 
-static void save()
+static void requestFrame(double elapsed)
 {
-    fprintf(fp, "RESULTS\n");
-    fprintf(fp, "Output Scale: %d\n", outputScale);
-    fprintf(fp, "Maximized Surface Size: %d x %d\n", parent.width, parent.height);
-    fprintf(fp, "Total Frames: %lld\n", total);
-    fprintf(fp, "Milisegundos: %lld\n", ms);
-    fprintf(fp, "FPS: %f\n", (1000.f*(float)total)/(float)ms);
-    fclose(fp);
-    exit(0);
+    struct wl_callback *callback = wl_surface_frame(root);
+    wl_callback_add_listener(callback, &wl_callback_listener, NULL);
+    scenario->frame(elapsed);
 }
 
-static void wl_callback_handle_done(void *data, struct wl_callback *callback, uint32_t m)
+static void wl_callback_handle_done(void *data, struct wl_callback *callback, uint32_t ms)
 {
-    if(firstCallback == 0)
+    (void)data;
+    (void)ms;
+    wl_callback_destroy(callback);
+
+    const double now = nowMs();
+
+    if (firstFrame)
     {
-        firstCallback = 1;
-        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+        firstFrame = false;
+        startMs = now;
     }
-    else
+    else if (now - startMs >= warmupMs)
     {
-        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
-
-        ms = ((end.tv_sec - start.tv_sec) * 1000000000 + (end.tv_nsec - start.tv_nsec)) / 1000000;
-
-        if(ms >= wait_ms)
-            save();
+        // Only intervals fully inside the measured period are recorded
+        if (lastMs - startMs >= warmupMs)
+        {
+            if (frameTimesCount == frameTimesCapacity)
+            {
+                frameTimesCapacity = frameTimesCapacity ? frameTimesCapacity * 2 : 4096;
+                frameTimes = realloc(frameTimes, frameTimesCapacity * sizeof(double));
+            }
 
-        float t = ms/50.f;
+            frameTimes[frameTimesCount++] = now - lastMs;
+        }
+        else
+            measureStartMs = now;
 
-        for(int i = 0; i < N; i++)
+        if (now - measureStartMs >= durationMs)
         {
-            int x = (parent.width-childSize)* (sin(children[i].phaseX+t*children[i].speed)+1)/2;
-            int y = (parent.height-childSize)* (sin(children[i].phaseY+t*children[i].speed)+1)/2;
-            wl_subsurface_set_position(children[i].subsurface, x, y);
-
-            if(i % 2 == 0)
-                wl_surface_set_opaque_region(children[i].surface,childRegion);
-            else
-                wl_surface_set_opaque_region(children[i].surface, NULL);
+            lastMs = now;
+            done = true;
+            return;
         }
     }
 
-    unsigned char r = (sinf( (float)ms * 0.0015f ) + 1.f) * 128;
-    unsigned char g = (cosf( (float)ms * 0.0010f ) + 1.f) * 128;
-    unsigned char b = (cosf( (float)ms * 0.0005f ) + 1.f) * 128;
-    unsigned char a = 255;
-
-    for(int i = 0; i < parent.width * outputScale * 4 * 10 * outputScale; i+=4)
-    {
-        parent.shm_data[i] = r;
-        parent.shm_data[i+1] = g;
-        parent.shm_data[i+2] = b;
-        parent.shm_data[i+3] = a;
-    }
-
-    callback = wl_surface_frame(parent.surface);
-    wl_callback_add_listener(callback, &wl_callback_listener, parent.surface);
-    wl_surface_attach(parent.surface, parent.buffer, 0, 0);
-    wl_surface_damage(parent.surface,0,0,parent.width,10);
-    wl_surface_set_opaque_region(parent.surface,parent.region);
-    wl_surface_commit(parent.surface);
-    total++;
+    lastMs = now;
+    requestFrame(now - startMs);
 }
 
-struct wl_callback_listener wl_callback_listener =
+static int compareDoubles(const void *a, const void *b)
 {
-    .done = &wl_callback_handle_done
-};
-
-static void xdg_surface_handle_configure(void *data, struct xdg_surface *xdg_surface, uint32_t serial)
-{
-    (void)data;
-	xdg_surface_ack_configure(xdg_surface, serial);
+    const double da = *(const double*)a;
+    const double db = *(const double*)b;
+    return (da > db) - (da < db);
 }
 
-static const struct xdg_surface_listener xdg_surface_listener =
+// Nearest-rank percentile of a sorted array
+static double percentile(const double *sorted, long n, double p)
 {
-	.configure = xdg_surface_handle_configure,
-};
-
-static void xdg_toplevel_handle_configure(void *data, struct xdg_toplevel *xdg_toplevel, int32_t w, int32_t h, struct wl_array *states)
-{
-    (void)data;
-    (void)xdg_toplevel;
-    (void)states;
+    long rank = (long)(p / 100.0 * n + 0.999999);
 
-    if(w == 0)
-        return;
+    if (rank < 1)
+        rank = 1;
 
-    parent.width = w;
-    parent.height = h;
+    return sorted[rank - 1];
 }
 
-static const struct xdg_toplevel_listener xdg_toplevel_listener =
+static void computeStats(struct RunResult *result)
 {
-    .configure = &xdg_toplevel_handle_configure,
-    .close = &noop,
-};
+    result->frames = frameTimesCount;
+    result->durationMs = lastMs - measureStartMs;
 
-static void wl_output_handle_scale(void *data, struct wl_output *output, int32_t scale)
-{
-    (void)data;
-    (void)output;
-    outputScale = scale;
-}
+    if (frameTimesCount == 0)
+        return;
 
-static void wl_output_handle_mode(void *data,
-                                  struct wl_output *output,
-                                  unsigned int flags,
-                                  int w,
-                                  int h,
-                                  int refresh)
-{
-    (void)data;
-    (void)output;
-    (void)flags;
-    (void)refresh;
-    outputW = w;
-    outputH = h;
-}
+    double sum = 0.0;
 
-static const struct wl_output_listener wl_output_listener =
-{
-    .scale = &wl_output_handle_scale,
-    .description = &noop,
-    .done = &noop,
-    .geometry = &noop,
-    .mode = &wl_output_handle_mode
-};
+    for (long i = 0; i < frameTimesCount; i++)
+        sum += frameTimes[i];
 
-static void xdg_wm_base_handle_ping(void *data, struct xdg_wm_base *wm, uint32_t serial)
-{
-    (void)data;
-    xdg_wm_base_pong(wm,serial);
+    qsort(frameTimes, frameTimesCount, sizeof(double), compareDoubles);
+    result->fps = 1000.0 * frameTimesCount / result->durationMs;
+    result->mean = sum / frameTimesCount;
+    result->p50 = percentile(frameTimes, frameTimesCount, 50.0);
+    result->p90 = percentile(frameTimes, frameTimesCount, 90.0);
+    result->p99 = percentile(frameTimes, frameTimesCount, 99.0);
+    result->max = frameTimes[frameTimesCount - 1];
 }
 
-static const struct xdg_wm_base_listener xdg_wm_base_listener =
+static void fail(struct RunResult *result, int status, const char *reason)
 {
-    .ping = &xdg_wm_base_handle_ping
-};
+    result->status = status;
+    snprintf(result->reason, sizeof(result->reason), "%s", reason);
+}
 
-static void handle_global(void *data, struct wl_registry *registry, uint32_t name, const char *interface, uint32_t version)
+static void runChild(const struct Scenario *s, int count, unsigned int seed, const struct Options *options, struct RunResult *result)
 {
-    (void)data; (void)version;
-
-    if (strcmp(interface, wl_shm_interface.name) == 0)
-    {
-		shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
-    }
-    else if (strcmp(interface, wl_output_interface.name) == 0)
+    scenario = s;
+    warmupMs = options->warmupMs;
+    durationMs = options->durationMs;
+    firstFrame = true;
+    done = false;
+    srand(seed);
+
+    if (!clientConnect())
     {
-        output = wl_registry_bind(registry, name, &wl_output_interface, 3);
-        wl_output_add_listener(output, &wl_output_listener, NULL);
+        fail(result, RUN_FAILED, "failed to connect to the compositor");
+        return;
     }
-    else if (strcmp(interface, wl_compositor_interface.name) == 0)
+
+    const char *reason = s->start(count, &root);
+
+    if (reason)
     {
-        compositor = wl_registry_bind(registry, name, &wl_compositor_interface, 3);
+        fail(result, RUN_SKIPPED, reason);
+        return;
     }
-    else if (strcmp(interface, wl_subcompositor_interface.name) == 0)
+
+    result->width = client.outputW;
+    result->height = client.outputH;
+    result->scale = client.outputScale;
+    lastMs = nowMs();
+    requestFrame(0.0);
+
+    struct pollfd pfd;
+    pfd.fd = wl_display_get_fd(client.display);
+    pfd.events = POLLIN;
+
+    while (!done)
     {
-        subcompositor = wl_registry_bind(registry, name, &wl_subcompositor_interface, 1);
+        while (wl_display_prepare_read(client.display) != 0)
+            wl_display_dispatch_pending(client.display);
+
+        wl_display_flush(client.display);
+
+        if (poll(&pfd, 1, 1000) > 0)
+            wl_display_read_events(client.display);
+        else
+            wl_display_cancel_read(client.display);
+
+        if (wl_display_dispatch_pending(client.display) < 0)
+        {
+            fail(result, RUN_FAILED, "connection error (protocol error or compositor crashed)");
+            return;
+        }
+
+        if (!done && nowMs() - lastMs > FRAME_TIMEOUT_MS)
+        {
+            fail(result, RUN_FAILED, "timed out waiting for frame callbacks");
+            return;
+        }
     }
-    else if (strcmp(interface, xdg_wm_base_interface.name) == 0)
-    {
-		xdg_wm_base = wl_registry_bind(registry, name, &xdg_wm_base_interface, 1);
-        xdg_wm_base_add_listener(xdg_wm_base, &xdg_wm_base_listener, NULL);
-	}
-}
 
-static void handle_global_remove(void *data, struct wl_registry *registry, uint32_t name)
-{
-    (void)data;
-    (void)registry;
-    (void)name;
+    computeStats(result);
+    clientDisconnect();
 }
 
-static const struct wl_registry_listener registry_listener =
-{
-	.global = handle_global,
-	.global_remove = handle_global_remove,
-};
+/******************** RUNNER ********************/
 
-static struct wl_buffer *create_buffer(int w, int h)
+// Each run is executed in a child process so that scenarios start from a clean connection
+static void runScenario(const struct Scenario *s, int count, unsigned int seed, const struct Options *options, struct RunResult *result)
 {
-    int stride = w * 4;
-    int size = stride * h;
+    memset(result, 0, sizeof(*result));
+    int fds[2];
 
-	int fd = create_shm_file(size);
+    if (pipe(fds) != 0)
+    {
+        fail(result, RUN_FAILED, "pipe() failed");
+        return;
+    }
 
-    if (fd < 0)
-		return NULL;
+    fflush(stdout);
+    fflush(stderr);
+    const pid_t pid = fork();
 
-    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        fail(result, RUN_FAILED, "fork() failed");
+        return;
+    }
 
-    if (data == MAP_FAILED)
+    if (pid == 0)
     {
-		close(fd);
-		return NULL;
-	}
+        close(fds[0]);
+        struct RunResult childResult;
+        memset(&childResult, 0, sizeof(childResult));
+        runChild(s, count, seed, options, &childResult);
+        ssize_t n = write(fds[1], &childResult, sizeof(childResult));
+        (void)n;
+        _exit(0);
+    }
 
-	struct wl_shm_pool *pool = wl_shm_create_pool(shm, fd, size);
-    struct wl_buffer *buffer = wl_shm_pool_create_buffer(pool, 0, w, h, stride, WL_SHM_FORMAT_ARGB8888);
-    wl_buffer_set_user_data(buffer, data);
-	wl_shm_pool_destroy(pool);
+    close(fds[1]);
+    size_t received = 0;
 
-	return buffer;
-}
+    while (received < sizeof(*result))
+    {
+        const ssize_t n = read(fds[0], (char*)result + received, sizeof(*result) - received);
 
-static void initParent()
-{
-    parent.surface = wl_compositor_create_surface(compositor);
-    parent.xdg_surface = xdg_wm_base_get_xdg_surface(xdg_wm_base, parent.surface);
-    parent.xdg_toplevel = xdg_surface_get_toplevel(parent.xdg_surface);
+        if (n < 0 && errno == EINTR)
+            continue;
 
-    xdg_surface_add_listener(parent.xdg_surface, &xdg_surface_listener, NULL);
-    xdg_toplevel_add_listener(parent.xdg_toplevel, &xdg_toplevel_listener, NULL);
+        if (n <= 0)
+            break;
 
-    wl_display_roundtrip(display);
-    wl_surface_set_buffer_scale(parent.surface, outputScale);
-    xdg_toplevel_set_maximized(parent.xdg_toplevel);
-    wl_surface_attach(parent.surface, NULL, 0,0);
-    wl_surface_commit(parent.surface);
+        received += n;
+    }
 
-    wl_display_roundtrip(display);
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
 
-    if (parent.width == 0)
+    if (received != sizeof(*result))
     {
-        parent.width = outputW/outputScale;
-        parent.height = outputH/outputScale - 32;
+        memset(result, 0, sizeof(*result));
+        fail(result, RUN_FAILED, "the benchmark process crashed");
     }
+}
 
-    parent.buffer = create_buffer(parent.width*outputScale, parent.height*outputScale);
-    parent.shm_data = wl_buffer_get_user_data(parent.buffer);
+static void printJSONString(FILE *fp, const char *string)
+{
+    fputc('"', fp);
 
-    for(int i = 0; i < parent.width*parent.height*outputScale*outputScale*4; i+=4)
+    for (const char *c = string; *c; c++)
     {
-        parent.shm_data[i] = 255;
-        parent.shm_data[i+1] = 255;
-        parent.shm_data[i+2] = 255;
-        parent.shm_data[i+3] = 255;
+        if (*c == '"' || *c == '\\')
+            fprintf(fp, "\\%c", *c);
+        else if ((unsigned char)*c < 0x20)
+            fprintf(fp, "\\u%04x", *c);
+        else
+            fputc(*c, fp);
     }
 
-    parent.region = wl_compositor_create_region(compositor);
-    wl_region_add(parent.region,0,0,parent.width,parent.height);
-    wl_surface_set_opaque_region(parent.surface,parent.region);
+    fputc('"', fp);
+}
 
-    wl_surface_attach(parent.surface, parent.buffer, 0, 0);
-    wl_surface_commit(parent.surface);
-    wl_display_roundtrip(display);
+static void printRunJSON(FILE *fp, const struct RunResult *r, unsigned int seed)
+{
+    fprintf(fp, "{\"status\": \"%s\", ", statusNames[r->status]);
+
+    if (r->status != RUN_OK)
+    {
+        fprintf(fp, "\"reason\": ");
+        printJSONString(fp, r->reason);
+        fprintf(fp, ", \"seed\": %u}", seed);
+        return;
+    }
+
+    fprintf(fp,
+            "\"seed\": %u, \"output\": {\"width\": %d, \"height\": %d, \"scale\": %d}, "
+            "\"frames\": %ld, \"duration_ms\": %.3f, \"fps\": %.3f, "
+            "\"frame_time_ms\": {\"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}}",
+            seed, r->width, r->height, r->scale,
+            r->frames, r->durationMs, r->fps,
+            r->mean, r->p50, r->p90, r->p99, r->max);
+}
+
+static void printRunSummary(const struct Scenario *s, int run, const struct RunResult *r)
+{
+    if (r->status != RUN_OK)
+        fprintf(stderr, "%-20s run %d: %s (%s)\n", s->name, run, statusNames[r->status], r->reason);
+    else
+        fprintf(stderr, "%-20s run %d: %8.2f FPS | frame time ms: mean %.2f p50 %.2f p90 %.2f p99 %.2f max %.2f\n",
+                s->name, run, r->fps, r->mean, r->p50, r->p90, r->p99, r->max);
 }
 
-void initChildren()
+static int runSuite(const struct Scenario **selected, int selectedCount, const struct Options *options)
 {
-    children = malloc(sizeof(struct ChildSurface)*N);
-    childRegion = wl_compositor_create_region(compositor);
-    wl_region_add(childRegion,0,0,childSize,childSize);
-    wl_display_roundtrip(display);
+    FILE *fp = stdout;
 
-    for(int i = 0; i < N; i++)
+    if (options->output)
     {
-        children[i].phaseX = 6.28f*(float)(rand() % 10000)/10000.f;
-        children[i].phaseY = 6.28f*(float)(rand() % 10000)/10000.f;
-        children[i].speed = 0.01 + 0.1*(float)(rand() % 10000)/10000.f;
-        children[i].surface = wl_compositor_create_surface(compositor);
-        wl_surface_set_buffer_scale(children[i].surface, outputScale);
-        wl_display_roundtrip(display);
-        children[i].subsurface = wl_subcompositor_get_subsurface(subcompositor, children[i].surface, parent.surface);
-        wl_subsurface_set_desync(children[i].subsurface);
-        wl_surface_commit(children[i].surface);
-        wl_display_roundtrip(display);
-        wl_subsurface_set_position(children[i].subsurface, 100, 100);
-        wl_surface_commit(parent.surface);
-        wl_display_roundtrip(display);
-        wl_surface_commit(children[i].surface);
-
-        if(i % 2 == 0)
+        fp = fopen(options->output, "w");
+
+        if (!fp)
         {
-            wl_surface_attach(children[i].surface, buffer_opaque, 0, 0);
-            wl_surface_set_opaque_region(children[i].surface,childRegion);
+            fprintf(stderr, "LBenchmark: Failed to open %s.\n", options->output);
+            return EXIT_FAILURE;
         }
-        else
-        {
-            wl_surface_attach(children[i].surface, buffer_translucent, 0, 0);
-            wl_surface_set_opaque_region(children[i].surface, NULL);
+    }
+
+    fprintf(fp, "{\n  \"benchmark\": \"LBenchmark\",\n  \"compositor\": ");
+    printJSONString(fp, options->label);
+    fprintf(fp, ",\n  \"warmup_ms\": %d,\n  \"duration_ms\": %d,\n  \"scenarios\": [", options->warmupMs, options->durationMs);
+
+    int failures = 0;
+
+    for (int i = 0; i < selectedCount; i++)
+    {
+        const struct Scenario *s = selected[i];
+        const int count = options->count > 0 ? options->count : s->defaultCount;
+
+        fprintf(fp, "%s\n    {\"name\": \"%s\", \"count\": %d, \"runs\": [", i == 0 ? "" : ",", s->name, count);
 
+        for (int run = 0; run < options->runs; run++)
+        {
+            struct RunResult result;
+            const unsigned int seed = options->seed + run;
+            runScenario(s, count, seed, options, &result);
+            printRunSummary(s, run, &result);
+            failures += result.status == RUN_FAILED;
+            fprintf(fp, "%s\n      ", run == 0 ? "" : ",");
+            printRunJSON(fp, &result, seed);
+            fflush(fp);
         }
 
-        wl_surface_commit(children[i].surface);
-        wl_surface_commit(parent.surface);
-        wl_display_roundtrip(display);
+        fprintf(fp, "\n    ]}");
     }
+
+    fprintf(fp, "\n  ]\n}\n");
+
+    if (fp != stdout)
+        fclose(fp);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
-int main(int argc, char *argv[])
+/******************** LEGACY MODE ********************/
+
+static bool isNumber(const char *string)
 {
-    N = atoi(argv[1]);
-    wait_ms = atoi(argv[2]);
-    sprintf(fname, "%s_N_%d_MS_%d.txt", argv[3], N, atoi(argv[2]));
-    srand(atoi(argv[4]));
-
-    fp = fopen(fname, "w");
-    display = wl_display_connect(NULL);
-	struct wl_registry *registry = wl_display_get_registry(display);
-	wl_registry_add_listener(registry, &registry_listener, NULL);
-	wl_display_roundtrip(display);
-    wl_display_roundtrip(display);
-
-    if (shm == NULL || compositor == NULL || xdg_wm_base == NULL || subcompositor == NULL)
-		return EXIT_FAILURE;
-
-    initParent();
-
-    buffer_opaque = create_buffer(childSize*outputScale, childSize*outputScale);
-    shm_opaque = wl_buffer_get_user_data(buffer_opaque);
-    for(int i = 0; i < childSize*outputScale*childSize*outputScale*4; i+=4)
-    {
-        shm_opaque[i] = 0;
-        shm_opaque[i+1] = 0;
-        shm_opaque[i+2] = 255;
-        shm_opaque[i+3] = 255;
-    }
+    if (!*string)
+        return false;
+
+    for (const char *c = string; *c; c++)
+        if (!isdigit((unsigned char)*c))
+            return false;
 
-    wl_display_roundtrip(display);
+    return true;
+}
+
+/* LBenchmark <N surfaces> <milliseconds> <file prefix> <seed>
+ * Runs the subsurfaces scenario without warm-up and writes the text report used by the bench-*.sh scripts and the notebook */
+static int runLegacy(char *argv[])
+{
+    struct Options options = { .durationMs = atoi(argv[2]), .warmupMs = 0, .runs = 1 };
+    const int count = atoi(argv[1]);
+    char fname[256];
+    snprintf(fname, sizeof(fname), "%s_N_%d_MS_%d.txt", argv[3], count, options.durationMs);
 
-    buffer_translucent = create_buffer(childSize*outputScale, childSize*outputScale);
-    shm_translucent = wl_buffer_get_user_data(buffer_translucent);
-    for(int i = 0; i < childSize*outputScale*childSize*outputScale*4; i+=4)
+    struct RunResult result;
+    runScenario(findScenario("subsurfaces"), count, atoi(argv[4]), &options, &result);
+
+    if (result.status != RUN_OK)
     {
-        shm_translucent[i] = 255;
-        shm_translucent[i+1] = 0;
-        shm_translucent[i+2] = 0;
-        shm_translucent[i+3] = 100;
+        fprintf(stderr, "LBenchmark: %s.\n", result.reason);
+        return EXIT_FAILURE;
     }
 
-    wl_display_roundtrip(display);
+    FILE *fp = fopen(fname, "w");
 
-    initChildren();
+    if (!fp)
+        return EXIT_FAILURE;
 
-    wl_display_roundtrip(display);
+    fprintf(fp, "RESULTS\n");
+    fprintf(fp, "Output Scale: %d\n", result.scale);
+    fprintf(fp, "Maximized Surface Size: %d x %d\n", result.width / result.scale, result.height / result.scale - 32);
+    fprintf(fp, "Total Frames: %ld\n", result.frames);
+    fprintf(fp, "Milisegundos: %lld\n", (long long int)result.durationMs);
+    fprintf(fp, "FPS: %f\n", result.fps);
+    fclose(fp);
+    return EXIT_SUCCESS;
+}
 
-    callback = wl_surface_frame(parent.surface);
-    wl_callback_add_listener(callback, &wl_callback_listener, parent.surface);
-    wl_surface_damage(parent.surface, 0,0,parent.width,parent.height);
-    wl_surface_commit(parent.surface);
+/******************** MAIN ********************/
 
-    for(int i = 0; i < N; i++)
-    {
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] [scenario...]\n\n"
+            "Runs the given scenarios (all by default) against the running compositor and writes the results as JSON.\n\n"
+            "Options:\n"
+            "  -l          List the available scenarios\n"
+            "  -d <ms>     Measured duration of each run (default 10000)\n"
+            "  -w <ms>     Warm-up time before each run is measured (default 2000)\n"
+            "  -r <runs>   Runs per scenario, each one with seed + run index (default 1)\n"
+            "  -n <count>  Number of elements of each scenario (default depends on the scenario)\n"
+            "  -s <seed>   Random seed (default 1)\n"
+            "  -c <label>  Compositor label stored in the JSON output\n"
+            "  -o <file>   JSON output file (default stdout)\n\n"
+            "Legacy usage: %s <N surfaces> <milliseconds> <file prefix> <seed>\n",
+            name, name);
+}
 
-        wl_subsurface_set_position(children[i].subsurface, 0, 0);
+int main(int argc, char *argv[])
+{
+    if (argc == 5 && isNumber(argv[1]) && isNumber(argv[2]) && isNumber(argv[4]))
+        return runLegacy(argv);
 
-        if(i % 2 == 0)
-        {
-            wl_surface_attach(children[i].surface, buffer_opaque, 0, 0);
-            wl_surface_damage(children[i].surface, 0, 0, childSize, childSize);
-        }
-        else
+    struct Options options =
+    {
+        .durationMs = 10000,
+        .warmupMs = 2000,
+        .runs = 1,
+        .count = 0,
+        .seed = 1,
+        .output = NULL,
+        .label = "unknown"
+    };
+
+    int opt;
+
+    while ((opt = getopt(argc, argv, "hld:w:r:n:s:c:o:")) != -1)
+    {
+        switch (opt)
         {
-            wl_surface_attach(children[i].surface, buffer_translucent, 0, 0);
-            wl_surface_damage(children[i].surface, 0, 0, childSize, childSize);
+        case 'l':
+            for (int i = 0; i < scenariosCount; i++)
+                printf("%-20s %s (default N = %d)\n", scenarios[i].name, scenarios[i].description, scenarios[i].defaultCount);
+            return EXIT_SUCCESS;
+        case 'd':
+            options.durationMs = atoi(optarg);
+            break;
+        case 'w':
+            options.warmupMs = atoi(optarg);
+            break;
+        case 'r':
+            options.runs = atoi(optarg);
+            break;
+        case 'n':
+            options.count = atoi(optarg);
+            break;
+        case 's':
+            options.seed = strtoul(optarg, NULL, 10);
+            break;
+        case 'c':
+            options.label = optarg;
+            break;
+        case 'o':
+            options.output = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
         }
+    }
 
-        wl_surface_commit(children[i].surface);
+    if (options.durationMs <= 0 || options.warmupMs < 0 || options.runs <= 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
     }
 
+    const struct Scenario *selected[64];
+    int selectedCount = 0;
 
-    while (wl_display_dispatch(display) != -1)
+    if (optind == argc)
     {
-		// This space intentionally left blank
-	}
+        for (int i = 0; i < scenariosCount; i++)
+            selected[selectedCount++] = &scenarios[i];
+    }
+    else
+    {
+        for (int i = optind; i < argc && selectedCount < 64; i++)
+        {
+            selected[selectedCount] = findScenario(argv[i]);
+
+            if (!selected[selectedCount])
+            {
+                fprintf(stderr, "LBenchmark: Unknown scenario %s, use -l to list them.\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+
+            selectedCount++;
+        }
+    }
 
-	return EXIT_SUCCESS;
+    return runSuite(selected, selectedCount, &options);
 }
@@ -0,0 +1,688 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "client.h"
+#include "scenarios.h"
+#include "shm.h"
+
+/* Each run is executed in its own process, so surfaces are never destroyed */
+
+static struct Window window;
+
+/******************** MOVING SUBSURFACES ********************/
+
+struct Mover
+{
+    struct wl_surface *surface;
+    struct wl_subsurface *subsurface;
+    struct wp_viewport *viewport;
+    struct Buffer buffer;
+    float phaseX;
+    float phaseY;
+    float speed;
+    int opaque;
+};
+
+static struct Mover *movers;
+static int moversCount;
+static int moverSize;
+static struct Buffer opaqueBuffer;
+static struct Buffer translucentBuffer;
+static struct wl_region *moverRegion;
+
+static void moverInit(struct Mover *mover)
+{
+    memset(mover, 0, sizeof(*mover));
+    mover->phaseX = 6.28f*(float)(rand() % 10000)/10000.f;
+    mover->phaseY = 6.28f*(float)(rand() % 10000)/10000.f;
+    mover->speed = 0.01 + 0.1*(float)(rand() % 10000)/10000.f;
+    mover->surface = subsurfaceCreate(window.surface, &mover->subsurface);
+}
+
+static void moverCommit(struct Mover *mover, struct Buffer *buffer)
+{
+    wl_surface_attach(mover->surface, buffer->buffer, 0, 0);
+    wl_surface_damage(mover->surface, 0, 0, moverSize, moverSize);
+    wl_surface_set_opaque_region(mover->surface, mover->opaque ? moverRegion : NULL);
+    wl_surface_commit(mover->surface);
+}
+
+static void moversInit(int count, int size)
+{
+    moversCount = count;
+    moverSize = size;
+    movers = calloc(count, sizeof(struct Mover));
+    moverRegion = wl_compositor_create_region(client.compositor);
+    wl_region_add(moverRegion, 0, 0, size, size);
+
+    for (int i = 0; i < count; i++)
+    {
+        moverInit(&movers[i]);
+        movers[i].opaque = i % 2 == 0;
+    }
+}
+
+// Subsurface positions are applied on the next commit of the window
+static void moversMove(double ms)
+{
+    const float t = ms/50.f;
+
+    for (int i = 0; i < moversCount; i++)
+    {
+        const int x = (window.width - moverSize) * (sin(movers[i].phaseX + t*movers[i].speed) + 1)/2;
+        const int y = (window.height - moverSize) * (sin(movers[i].phaseY + t*movers[i].speed) + 1)/2;
+        wl_subsurface_set_position(movers[i].subsurface, x, y);
+    }
+}
+
+static const char *startSharedMovers(int count, int size, struct wl_surface **root)
+{
+    if (!windowCreate(&window, 0, 0))
+        return "failed to create the window";
+
+    const int sizeB = size * client.outputScale;
+
+    if (!bufferCreateSHM(&opaqueBuffer, sizeB, sizeB) || !bufferCreateSHM(&translucentBuffer, sizeB, sizeB))
+        return "failed to create SHM buffers";
+
+    bufferFill(&opaqueBuffer, 0, 0, sizeB, sizeB, 0xFF0000FF);
+    bufferFill(&translucentBuffer, 0, 0, sizeB, sizeB, 0x64640000);
+    moversInit(count, size);
+
+    for (int i = 0; i < count; i++)
+        moverCommit(&movers[i], movers[i].opaque ? &opaqueBuffer : &translucentBuffer);
+
+    wl_display_roundtrip(client.display);
+    *root = window.surface;
+    return NULL;
+}
+
+static const char *subsurfacesStart(int count, struct wl_surface **root)
+{
+    return startSharedMovers(count, 512, root);
+}
+
+static void subsurfacesFrame(double ms)
+{
+    moversMove(ms);
+
+    // The opaque regions are re-sent every frame, as the original LBenchmark did
+    for (int i = 0; i < moversCount; i++)
+    {
+        wl_surface_set_opaque_region(movers[i].surface, movers[i].opaque ? moverRegion : NULL);
+        wl_surface_commit(movers[i].surface);
+    }
+
+    windowCommitFrame(&window, ms);
+}
+
+static const char *smallSubsurfacesStart(int count, struct wl_surface **root)
+{
+    return startSharedMovers(count, 32, root);
+}
+
+static void smallSubsurfacesFrame(double ms)
+{
+    moversMove(ms);
+    windowCommitFrame(&window, ms);
+}
+
+/******************** STACKED WINDOWS ********************/
+
+static int layersOpaque;
+
+static const char *startLayers(int count, int opaque, struct wl_surface **root)
+{
+    if (!windowCreate(&window, 0, 0))
+        return "failed to create the window";
+
+    layersOpaque = opaque;
+    moversCount = count;
+    moverSize = (window.width < window.height ? window.width : window.height) * 3 / 4;
+    movers = calloc(count, sizeof(struct Mover));
+    moverRegion = wl_compositor_create_region(client.compositor);
+    wl_region_add(moverRegion, 0, 0, moverSize, moverSize);
+
+    const int sizeB = moverSize * client.outputScale;
+    const int step = count > 1 ? (window.height - moverSize) / (count - 1) : 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        moverInit(&movers[i]);
+        movers[i].opaque = opaque;
+
+        if (!bufferCreateSHM(&movers[i].buffer, sizeB, sizeB))
+            return "failed to create SHM buffers";
+
+        bufferFill(&movers[i].buffer, 0, 0, sizeB, sizeB, opaque ? 0xFF202020 + i * 0x00101010 : 0x80400000 + i * 0x00000810);
+        wl_subsurface_set_position(movers[i].subsurface, i * step, i * step);
+        moverCommit(&movers[i], &movers[i].buffer);
+    }
+
+    wl_surface_commit(window.surface);
+    wl_display_roundtrip(client.display);
+    *root = window.surface;
+    return NULL;
+}
+
+static const char *opaqueWindowsStart(int count, struct wl_surface **root)
+{
+    return startLayers(count, 1, root);
+}
+
+static const char *translucentWindowsStart(int count, struct wl_surface **root)
+{
+    return startLayers(count, 0, root);
+}
+
+// Only the top window is fully repainted, the rest are static and hidden (opaque) or blended (translucent)
+static void windowsFrame(double ms)
+{
+    struct Mover *top = &movers[moversCount - 1];
+    bufferFill(&top->buffer, 0, 0, top->buffer.width, top->buffer.height, timeColor(ms, layersOpaque ? 255 : 128));
+    moverCommit(top, &top->buffer);
+    windowCommitFrame(&window, ms);
+}
+
+/******************** POPUPS ********************/
+
+#define POPUP_SIZE 256
+#define POPUP_SQUARE 32
+
+struct Popup
+{
+    struct wl_surface *surface;
+    struct xdg_surface *xdg_surface;
+    struct xdg_popup *xdg_popup;
+    struct Buffer buffer;
+};
+
+static struct Popup *popups;
+static int popupsCount;
+
+static void noop() {}
+
+static void popup_xdg_surface_handle_configure(void *data, struct xdg_surface *xdg_surface, uint32_t serial)
+{
+    (void)data;
+    xdg_surface_ack_configure(xdg_surface, serial);
+}
+
+static const struct xdg_surface_listener popup_xdg_surface_listener =
+{
+    .configure = popup_xdg_surface_handle_configure,
+};
+
+static const struct xdg_popup_listener xdg_popup_listener =
+{
+    .configure = &noop,
+    .popup_done = &noop,
+    .repositioned = &noop
+};
+
+static const char *popupsStart(int count, struct wl_surface **root)
+{
+    if (!windowCreate(&window, 0, 0))
+        return "failed to create the window";
+
+    popupsCount = count;
+    popups = calloc(count, sizeof(struct Popup));
+    struct xdg_surface *parent = window.xdg_surface;
+    const int sizeB = POPUP_SIZE * client.outputScale;
+
+    // Each popup is nested in the previous one, shifted to the bottom-right
+    for (int i = 0; i < count; i++)
+    {
+        struct Popup *popup = &popups[i];
+        struct xdg_positioner *positioner = xdg_wm_base_create_positioner(client.xdg_wm_base);
+        xdg_positioner_set_size(positioner, POPUP_SIZE, POPUP_SIZE);
+        xdg_positioner_set_anchor_rect(positioner, i == 0 ? 64 : POPUP_SIZE/4, i == 0 ? 64 : POPUP_SIZE/4, 1, 1);
+        xdg_positioner_set_anchor(positioner, XDG_POSITIONER_ANCHOR_TOP_LEFT);
+        xdg_positioner_set_gravity(positioner, XDG_POSITIONER_GRAVITY_BOTTOM_RIGHT);
+        xdg_positioner_set_constraint_adjustment(positioner,
+            XDG_POSITIONER_CONSTRAINT_ADJUSTMENT_SLIDE_X | XDG_POSITIONER_CONSTRAINT_ADJUSTMENT_SLIDE_Y);
+
+        popup->surface = wl_compositor_create_surface(client.compositor);
+        wl_surface_set_buffer_scale(popup->surface, client.outputScale);
+        popup->xdg_surface = xdg_wm_base_get_xdg_surface(client.xdg_wm_base, popup->surface);
+        xdg_surface_add_listener(popup->xdg_surface, &popup_xdg_surface_listener, NULL);
+        popup->xdg_popup = xdg_surface_get_popup(popup->xdg_surface, parent, positioner);
+        xdg_popup_add_listener(popup->xdg_popup, &xdg_popup_listener, NULL);
+        xdg_positioner_destroy(positioner);
+        wl_surface_commit(popup->surface);
+        wl_display_roundtrip(client.display);
+
+        if (!bufferCreateSHM(&popup->buffer, sizeB, sizeB))
+            return "failed to create SHM buffers";
+
+        bufferFill(&popup->buffer, 0, 0, sizeB, sizeB, 0xFFE0E0E0 - i * 0x00101010);
+        wl_surface_attach(popup->surface, popup->buffer.buffer, 0, 0);
+        wl_surface_damage(popup->surface, 0, 0, POPUP_SIZE, POPUP_SIZE);
+        wl_surface_commit(popup->surface);
+        parent = popup->xdg_surface;
+    }
+
+    wl_display_roundtrip(client.display);
+    *root = window.surface;
+    return NULL;
+}
+
+// Each popup repaints a small square moving along its diagonal
+static void popupsFrame(double ms)
+{
+    const int range = POPUP_SIZE - POPUP_SQUARE;
+
+    for (int i = 0; i < popupsCount; i++)
+    {
+        struct Popup *popup = &popups[i];
+        const int pos = ((int)(ms/10.0) + i * 20) % range;
+        bufferFill(&popup->buffer, 0, 0, popup->buffer.width, popup->buffer.height, 0xFFE0E0E0 - i * 0x00101010);
+        bufferFill(&popup->buffer,
+                   pos * client.outputScale,
+                   pos * client.outputScale,
+                   POPUP_SQUARE * client.outputScale,
+                   POPUP_SQUARE * client.outputScale,
+                   timeColor(ms + i * 100, 255));
+        wl_surface_attach(popup->surface, popup->buffer.buffer, 0, 0);
+        wl_surface_damage(popup->surface, pos > 0 ? pos - 1 : 0, pos > 0 ? pos - 1 : 0, POPUP_SQUARE + 1, POPUP_SQUARE + 1);
+        wl_surface_commit(popup->surface);
+    }
+
+    windowCommitFrame(&window, ms);
+}
+
+/******************** FRACTIONAL SCALE ********************/
+
+// In 120ths, as sent by wp_fractional_scale_v1
+static uint32_t preferredScale = 120;
+
+static void fractional_scale_handle_preferred_scale(void *data, struct wp_fractional_scale_v1 *fractional_scale, uint32_t scale)
+{
+    (void)data;
+    (void)fractional_scale;
+    preferredScale = scale;
+}
+
+static const struct wp_fractional_scale_v1_listener fractional_scale_listener =
+{
+    .preferred_scale = fractional_scale_handle_preferred_scale
+};
+
+static inline int toFractional(int size)
+{
+    return (size * preferredScale + 60) / 120;
+}
+
+static const char *fractionalScaleStart(int count, struct wl_surface **root)
+{
+    if (!client.viewporter || !client.fractional_scale_manager)
+        return "wp_viewporter or wp_fractional_scale_v1 not supported";
+
+    if (!windowCreate(&window, 0, 0))
+        return "failed to create the window";
+
+    struct wp_fractional_scale_v1 *fractionalScale = wp_fractional_scale_manager_v1_get_fractional_scale(client.fractional_scale_manager, window.surface);
+    wp_fractional_scale_v1_add_listener(fractionalScale, &fractional_scale_listener, NULL);
+    wl_display_roundtrip(client.display);
+
+    // Buffers are rendered at the preferred scale and mapped back to the logical size with viewports
+    struct wp_viewport *windowViewport = wp_viewporter_get_viewport(client.viewporter, window.surface);
+    wp_viewport_set_destination(windowViewport, window.width, window.height);
+    bufferDestroy(&window.buffer);
+
+    if (!bufferCreateSHM(&window.buffer, toFractional(window.width), toFractional(window.height)))
+        return "failed to create SHM buffers";
+
+    bufferFill(&window.buffer, 0, 0, window.buffer.width, window.buffer.height, 0xFFFFFFFF);
+    wl_surface_set_buffer_scale(window.surface, 1);
+    wl_surface_attach(window.surface, window.buffer.buffer, 0, 0);
+    wl_surface_damage(window.surface, 0, 0, window.width, window.height);
+    wl_surface_commit(window.surface);
+
+    const int sizeB = toFractional(256);
+
+    if (!bufferCreateSHM(&opaqueBuffer, sizeB, sizeB) || !bufferCreateSHM(&translucentBuffer, sizeB, sizeB))
+        return "failed to create SHM buffers";
+
+    bufferFill(&opaqueBuffer, 0, 0, sizeB, sizeB, 0xFF0000FF);
+    bufferFill(&translucentBuffer, 0, 0, sizeB, sizeB, 0x64640000);
+    moversInit(count, 256);
+
+    for (int i = 0; i < count; i++)
+    {
+        movers[i].viewport = wp_viewporter_get_viewport(client.viewporter, movers[i].surface);
+        wp_viewport_set_destination(movers[i].viewport, 256, 256);
+        wl_surface_set_buffer_scale(movers[i].surface, 1);
+        moverCommit(&movers[i], movers[i].opaque ? &opaqueBuffer : &translucentBuffer);
+    }
+
+    wl_display_roundtrip(client.display);
+    *root = window.surface;
+    return NULL;
+}
+
+static void fractionalScaleFrame(double ms)
+{
+    moversMove(ms);
+    windowCommitFrame(&window, ms);
+}
+
+/******************** VIEWPORTS ********************/
+
+static const char *viewportsStart(int count, struct wl_surface **root)
+{
+    if (!client.viewporter)
+        return "wp_viewporter not supported";
+
+    if (!windowCreate(&window, 0, 0))
+        return "failed to create the window";
+
+    // Small buffers upscaled to 256x256 with a cropped source rect
+    if (!bufferCreateSHM(&opaqueBuffer, 64, 64))
+        return "failed to create SHM buffers";
+
+    for (int y = 0; y < 64; y += 8)
+        for (int x = 0; x < 64; x += 8)
+            bufferFill(&opaqueBuffer, x, y, 8, 8, ((x + y) / 8) % 2 ? 0xFF3050A0 : 0xFFE0A030);
+
+    moversInit(count, 256);
+
+    for (int i = 0; i < count; i++)
+    {
+        movers[i].opaque = 1;
+        movers[i].viewport = wp_viewporter_get_viewport(client.viewporter, movers[i].surface);
+        wp_viewport_set_destination(movers[i].viewport, 256, 256);
+        wl_surface_set_buffer_scale(movers[i].surface, 1);
+        moverCommit(&movers[i], &opaqueBuffer);
+    }
+
+    wl_display_roundtrip(client.display);
+    *root = window.surface;
+    return NULL;
+}
+
+// The source rect of every viewport changes each frame without new buffer content
+static void viewportsFrame(double ms)
+{
+    moversMove(ms);
+
+    for (int i = 0; i < moversCount; i++)
+    {
+        const double offset = (sin(ms * 0.002 + movers[i].phaseX) + 1.0) * 8.0;
+        wp_viewport_set_source(movers[i].viewport,
+                               wl_fixed_from_double(offset),
+                               wl_fixed_from_double(offset),
+                               wl_fixed_from_double(48.0),
+                               wl_fixed_from_double(48.0));
+        wl_surface_commit(movers[i].surface);
+    }
+
+    windowCommitFrame(&window, ms);
+}
+
+/******************** TERMINALS ********************/
+
+#define CELL_W 8
+#define CELL_H 16
+
+struct Terminal
+{
+    int col, row, cols, rows;
+};
+
+static struct Terminal *terminals;
+
+static const char *terminalStart(int count, struct wl_surface **root)
+{
+    if (!windowCreate(&window, 0, 0))
+        return "failed to create the window";
+
+    int gridCols = 1;
+
+    while (gridCols * gridCols < count)
+        gridCols++;
+
+    const int gridRows = (count + gridCols - 1) / gridCols;
+    const int w = window.width / gridCols;
+    const int h = window.height / gridRows;
+
+    moversCount = count;
+    movers = calloc(count, sizeof(struct Mover));
+    terminals = calloc(count, sizeof(struct Terminal));
+
+    for (int i = 0; i < count; i++)
+    {
+        moverInit(&movers[i]);
+        terminals[i].cols = w / CELL_W;
+        terminals[i].rows = h / CELL_H;
+
+        if (!bufferCreateSHM(&movers[i].buffer, w * client.outputScale, h * client.outputScale))
+            return "failed to create SHM buffers";
+
+        bufferFill(&movers[i].buffer, 0, 0, movers[i].buffer.width, movers[i].buffer.height, 0xFF101010);
+        struct wl_region *region = wl_compositor_create_region(client.compositor);
+        wl_region_add(region, 0, 0, w, h);
+        wl_surface_set_opaque_region(movers[i].surface, region);
+        wl_region_destroy(region);
+        wl_subsurface_set_position(movers[i].subsurface, (i % gridCols) * w, (i / gridCols) * h);
+        wl_surface_attach(movers[i].surface, movers[i].buffer.buffer, 0, 0);
+        wl_surface_damage(movers[i].surface, 0, 0, w, h);
+        wl_surface_commit(movers[i].surface);
+    }
+
+    wl_surface_commit(window.surface);
+    wl_display_roundtrip(client.display);
+    *root = window.surface;
+    return NULL;
+}
+
+// Each terminal prints a glyph per frame and only damages its cell, the screen is cleared once full
+static void terminalFrame(double ms)
+{
+    const int s = client.outputScale;
+
+    for (int i = 0; i < moversCount; i++)
+    {
+        struct Terminal *t = &terminals[i];
+        struct Buffer *buffer = &movers[i].buffer;
+
+        if (t->row >= t->rows)
+        {
+            t->row = 0;
+            bufferFill(buffer, 0, 0, buffer->width, buffer->height, 0xFF101010);
+            wl_surface_damage(movers[i].surface, 0, 0, buffer->width / s, buffer->height / s);
+        }
+
+        bufferFill(buffer, (t->col * CELL_W + 1) * s, (t->row * CELL_H + 2) * s, (CELL_W - 2) * s, (CELL_H - 4) * s, timeColor(ms + i * 300, 255));
+        wl_surface_attach(movers[i].surface, buffer->buffer, 0, 0);
+        wl_surface_damage(movers[i].surface, t->col * CELL_W, t->row * CELL_H, CELL_W, CELL_H);
+        wl_surface_commit(movers[i].surface);
+
+        if (++t->col >= t->cols)
+        {
+            t->col = 0;
+            t->row++;
+        }
+    }
+
+    windowCommitFrame(&window, ms);
+}
+
+/******************** DMA-BUF ********************/
+
+static const char *dmabufStart(int count, struct wl_surface **root)
+{
+    if (!client.linux_dmabuf)
+        return "zwp_linux_dmabuf_v1 not supported";
+
+    if (!windowCreate(&window, 0, 0))
+        return "failed to create the window";
+
+    moversInit(count, 256);
+    const int sizeB = 256 * client.outputScale;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!bufferCreateDMA(&movers[i].buffer, sizeB, sizeB))
+            return "failed to allocate DMA buffers (GBM not available)";
+
+        bufferFill(&movers[i].buffer, 0, 0, sizeB, sizeB, movers[i].opaque ? 0xFF0000FF : 0x64640000);
+        moverCommit(&movers[i], &movers[i].buffer);
+    }
+
+    wl_display_roundtrip(client.display);
+    *root = window.surface;
+    return NULL;
+}
+
+// All buffers move and the top one is also repainted by the client each frame
+static void dmabufFrame(double ms)
+{
+    struct Mover *top = &movers[moversCount - 1];
+    moversMove(ms);
+    bufferFill(&top->buffer, 0, 0, top->buffer.width, top->buffer.height, timeColor(ms, top->opaque ? 255 : 100));
+    moverCommit(top, &top->buffer);
+    windowCommitFrame(&window, ms);
+}
+
+/******************** RESIZE ********************/
+
+#define RESIZE_MAX_W 1000
+#define RESIZE_MAX_H 700
+
+static struct wl_shm_pool *resizePool;
+static struct wl_buffer *resizeBuffer;
+static unsigned char *resizeData;
+
+static const char *resizeStart(int count, struct wl_surface **root)
+{
+    (void)count;
+
+    if (!windowCreate(&window, 400, 300))
+        return "failed to create the window";
+
+    // A single pool, each frame a buffer with the new size is created from it
+    const int s = client.outputScale;
+    const size_t size = (size_t)RESIZE_MAX_W * RESIZE_MAX_H * s * s * 4;
+    const int fd = create_shm_file(size);
+
+    if (fd < 0)
+        return "failed to create SHM buffers";
+
+    resizeData = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (resizeData == MAP_FAILED)
+    {
+        close(fd);
+        return "failed to create SHM buffers";
+    }
+
+    memset(resizeData, 0xFF, size);
+    resizePool = wl_shm_create_pool(client.shm, fd, size);
+    close(fd);
+    *root = window.surface;
+    return NULL;
+}
+
+static void resizeFrame(double ms)
+{
+    const int s = client.outputScale;
+    const int stride = RESIZE_MAX_W * s * 4;
+    const int w = 300 + (RESIZE_MAX_W - 300) * (sin(ms * 0.003) + 1.0) / 2.0;
+    const int h = 200 + (RESIZE_MAX_H - 200) * (cos(ms * 0.002) + 1.0) / 2.0;
+    struct wl_buffer *prev = resizeBuffer;
+
+    // Time dependent border so that every frame has new content
+    const uint32_t color = timeColor(ms, 255);
+
+    for (int y = 0; y < h * s; y++)
+    {
+        uint32_t *row = (uint32_t*)(resizeData + y * stride);
+
+        for (int x = 0; x < w * s; x++)
+            row[x] = (x < 10 * s || y < 10 * s || x >= (w - 10) * s || y >= (h - 10) * s) ? color : 0xFFFFFFFF;
+    }
+
+    resizeBuffer = wl_shm_pool_create_buffer(resizePool, 0, w * s, h * s, stride, WL_SHM_FORMAT_ARGB8888);
+    struct wl_region *region = wl_compositor_create_region(client.compositor);
+    wl_region_add(region, 0, 0, w, h);
+    wl_surface_set_opaque_region(window.surface, region);
+    wl_region_destroy(region);
+    xdg_surface_set_window_geometry(window.xdg_surface, 0, 0, w, h);
+    wl_surface_attach(window.surface, resizeBuffer, 0, 0);
+    wl_surface_damage(window.surface, 0, 0, w, h);
+    wl_surface_commit(window.surface);
+
+    if (prev)
+        wl_buffer_destroy(prev);
+}
+
+/******************** TABLE ********************/
+
+const struct Scenario scenarios[] =
+{
+    {
+        "subsurfaces",
+        "Maximized SHM window with N moving 512px subsurfaces, half opaque and half translucent (original LBenchmark)",
+        16, subsurfacesStart, subsurfacesFrame
+    },
+    {
+        "small-subsurfaces",
+        "Maximized SHM window with N moving 32px subsurfaces, half opaque and half translucent",
+        500, smallSubsurfacesStart, smallSubsurfacesFrame
+    },
+    {
+        "opaque-windows",
+        "N stacked opaque window-sized surfaces, only the top one is repainted each frame",
+        8, opaqueWindowsStart, windowsFrame
+    },
+    {
+        "translucent-windows",
+        "N stacked translucent window-sized surfaces, only the top one is repainted each frame",
+        8, translucentWindowsStart, windowsFrame
+    },
+    {
+        "popups",
+        "N nested xdg_popups, each one repaints a small square every frame",
+        8, popupsStart, popupsFrame
+    },
+    {
+        "fractional-scale",
+        "Like subsurfaces with 256px surfaces, buffers rendered at the wp_fractional_scale_v1 preferred scale",
+        16, fractionalScaleStart, fractionalScaleFrame
+    },
+    {
+        "viewports",
+        "N moving subsurfaces with 64px buffers upscaled by wp_viewport, the source rect changes every frame",
+        32, viewportsStart, viewportsFrame
+    },
+    {
+        "terminal",
+        "N tiled terminal-like surfaces, each one damages a single 8x16 glyph cell per frame",
+        4, terminalStart, terminalFrame
+    },
+    {
+        "dmabuf",
+        "N moving 256px subsurfaces with linear GBM DMA buffers, the top one is repainted every frame",
+        16, dmabufStart, dmabufFrame
+    },
+    {
+        "resize",
+        "Floating window that changes its size every frame",
+        1, resizeStart, resizeFrame
+    }
+};
+
+const int scenariosCount = sizeof(scenarios)/sizeof(scenarios[0]);
+
+const struct Scenario *findScenario(const char *name)
+{
+    for (int i = 0; i < scenariosCount; i++)
+        if (strcmp(scenarios[i].name, name) == 0)
+            return &scenarios[i];
+
+    return NULL;
+}
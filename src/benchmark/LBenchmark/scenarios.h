@@ -0,0 +1,27 @@
+#ifndef SCENARIOS_H
+#define SCENARIOS_H
+
+#include <wayland-client.h>
+
+struct Scenario
+{
+    const char *name;
+    const char *description;
+
+    // Number of elements (surfaces, popups, etc) used when not specified with -n
+    int defaultCount;
+
+    /* Creates the surfaces and returns NULL, or a reason if the scenario is not supported.
+     * root is the surface whose frame callbacks are used to measure frame times. */
+    const char *(*start)(int count, struct wl_surface **root);
+
+    // Called on each frame callback of root with the time since the first frame, must commit root
+    void (*frame)(double ms);
+};
+
+extern const struct Scenario scenarios[];
+extern const int scenariosCount;
+
+const struct Scenario *findScenario(const char *name);
+
+#endif
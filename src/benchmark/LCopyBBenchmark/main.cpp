@@ -0,0 +1,131 @@
+#include <LCompositor.h>
+#include <LTexture.h>
+#include <LLog.h>
+#include <GLES2/gl2.h>
+#include <drm_fourcc.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <time.h>
+
+/* Measures LTexture::copyB() downscaling 8K to 1080p and 4K to 256px with each scaling filter.
+ * The copies are made from the main thread painter of a compositor that is started but whose
+ * outputs are never initialized, so it can be run from a TTY or nested in another compositor. */
+
+using namespace Louvre;
+
+static Int32 samples { 20 };
+
+static double ms(const timespec &a, const timespec &b)
+{
+    return (b.tv_sec - a.tv_sec) * 1000.0 + (b.tv_nsec - a.tv_nsec) / 1000000.0;
+}
+
+// Noise, so that aliasing and filtering costs are not hidden by uniform content
+static LTexture *createSource(const LSize &size)
+{
+    std::mt19937 rng(1);
+    std::vector<UInt32> pixels(size.w() * size.h());
+
+    for (UInt32 &pixel : pixels)
+        pixel = rng() | 0xFF000000;
+
+    LTexture *texture { new LTexture() };
+
+    if (!texture->setDataB(size, size.w() * 4, DRM_FORMAT_ARGB8888, pixels.data()))
+    {
+        delete texture;
+        return nullptr;
+    }
+
+    return texture;
+}
+
+static void bench(const LTexture *src, const LSize &dst, LTexture::ScalingFilter filter, const char *filterName)
+{
+    std::vector<double> times;
+    timespec t0, t1;
+
+    // Warm-up (shader compilation, mipmap storage allocation)
+    delete src->copyB(dst, LRect(), filter);
+    glFinish();
+
+    for (Int32 i = 0; i < samples; i++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        LTexture *copy { src->copyB(dst, LRect(), filter) };
+        glFinish();
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        if (!copy)
+        {
+            printf("%dx%d -> %dx%d %-8s failed\n", src->sizeB().w(), src->sizeB().h(), dst.w(), dst.h(), filterName);
+            return;
+        }
+
+        delete copy;
+        times.push_back(ms(t0, t1));
+    }
+
+    std::sort(times.begin(), times.end());
+    printf("%dx%d -> %dx%d %-8s median: %.3f ms  min: %.3f ms  max: %.3f ms\n",
+           src->sizeB().w(), src->sizeB().h(), dst.w(), dst.h(), filterName,
+           times[times.size() / 2], times.front(), times.back());
+}
+
+class Compositor final : public LCompositor
+{
+public:
+    void initialized() override
+    {
+        struct Case
+        {
+            LSize src, dst;
+        };
+
+        static const Case cases[]
+        {
+            { LSize(7680, 4320), LSize(1920, 1080) },
+            { LSize(3840, 2160), LSize(256, 144) }
+        };
+
+        for (const Case &c : cases)
+        {
+            LTexture *src { createSource(c.src) };
+
+            if (!src)
+            {
+                LLog::error("[LCopyBBenchmark] Failed to create %dx%d texture.", c.src.w(), c.src.h());
+                continue;
+            }
+
+            bench(src, c.dst, LTexture::Linear, "Linear");
+            bench(src, c.dst, LTexture::Box, "Box");
+            bench(src, c.dst, LTexture::Mipmap, "Mipmap");
+            delete src;
+        }
+
+        finish();
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        samples = std::max(1, atoi(argv[1]));
+
+    Compositor compositor;
+
+    if (!compositor.start())
+    {
+        LLog::fatal("[LCopyBBenchmark] Failed to start compositor.");
+        return 1;
+    }
+
+    while (compositor.state() != LCompositor::Uninitialized)
+        compositor.processLoop(-1);
+
+    return 0;
+}
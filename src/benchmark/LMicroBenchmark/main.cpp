@@ -0,0 +1,617 @@
+#include <private/LSceneViewPrivate.h>
+#include <private/LPainterPrivate.h>
+#include <private/LViewPrivate.h>
+#include <LCompositor.h>
+#include <LScene.h>
+#include <LSceneView.h>
+#include <LLayerView.h>
+#include <LSolidColorView.h>
+#include <LTexture.h>
+#include <LRegion.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <drm_fourcc.h>
+#include <wayland-server.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+
+/* Micro-benchmarks of the primitives the compositor depends on: LRegion operations, LScene hit
+ * testing, the LSceneView damage pass over synthetic view trees, LPainter region draw submission and
+ * LTexture format queries. Workloads are generated from a fixed seed, so runs are comparable across
+ * builds. Results (median ns per operation) can be saved and compared against a previous run. */
+
+using namespace Louvre;
+
+struct Options
+{
+    UInt32 seed { 1 };
+    Int32 repeats { 7 };
+    Float64 minMs { 50.0 };
+    Float64 threshold { 10.0 };
+    const char *output { nullptr };
+    const char *baseline { nullptr };
+    std::vector<std::string> filters;
+};
+
+struct Result
+{
+    std::string name;
+    Float64 nsPerOp;
+};
+
+static Options options;
+static std::vector<Result> results;
+static volatile UInt64 sink;
+
+static Float64 ns(const timespec &a, const timespec &b)
+{
+    return (b.tv_sec - a.tv_sec) * 1000000000.0 + (b.tv_nsec - a.tv_nsec);
+}
+
+static bool selected(const std::string &name)
+{
+    if (options.filters.empty())
+        return true;
+
+    for (const std::string &filter : options.filters)
+        if (name.compare(0, filter.size(), filter) == 0)
+            return true;
+
+    return false;
+}
+
+/* Calls op() (which performs one operation) in batches until a batch takes at least minMs,
+ * then reports the median time per operation of N repeats */
+template<class Op>
+static void bench(const std::string &name, Op op)
+{
+    if (!selected(name))
+        return;
+
+    timespec t0, t1;
+    UInt64 batch { 1 };
+
+    // Calibrate the batch size
+    while (true)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (UInt64 i = 0; i < batch; i++)
+            op();
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+
+        if (ns(t0, t1) >= options.minMs * 1000000.0 || batch >= (1ULL << 32))
+            break;
+
+        batch *= 2;
+    }
+
+    std::vector<Float64> samples(options.repeats);
+
+    for (Float64 &sample : samples)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (UInt64 i = 0; i < batch; i++)
+            op();
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        sample = ns(t0, t1) / batch;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const Float64 median { samples[samples.size() / 2] };
+    results.push_back({name, median});
+    printf("%-40s %14.1f ns/op\n", name.c_str(), median);
+    fflush(stdout);
+}
+
+/******************** LREGION ********************/
+
+static LRegion randomRegion(std::mt19937 &rng, Int32 rects, Int32 maxSize)
+{
+    LRegion region;
+
+    for (Int32 i = 0; i < rects; i++)
+        region.addRect(rng() % 1920, rng() % 1080, 1 + rng() % maxSize, 1 + rng() % maxSize);
+
+    return region;
+}
+
+static void benchRegion()
+{
+    for (Int32 rects : {16, 256})
+    {
+        std::mt19937 rng(options.seed);
+        const LRegion a { randomRegion(rng, rects, 256) };
+        const LRegion b { randomRegion(rng, rects, 256) };
+        const std::string suffix { "/" + std::to_string(rects) };
+
+        bench("region.copy" + suffix, [&]
+        {
+            LRegion r { a };
+            sink = sink + r.extents().x2;
+        });
+
+        bench("region.addRegion" + suffix, [&]
+        {
+            LRegion r { a };
+            r.addRegion(b);
+            sink = sink + r.extents().x2;
+        });
+
+        bench("region.subtractRegion" + suffix, [&]
+        {
+            LRegion r { a };
+            r.subtractRegion(b);
+            sink = sink + r.extents().x2;
+        });
+
+        bench("region.intersectRegion" + suffix, [&]
+        {
+            LRegion r { a };
+            r.intersectRegion(b);
+            sink = sink + r.extents().x2;
+        });
+
+        UInt32 transform { 0 };
+
+        bench("region.transform" + suffix, [&]
+        {
+            LRegion r { a };
+            r.transform(LSize(1920, 1080), (LFramebuffer::Transform)(transform++ & 7));
+            sink = sink + r.extents().x2;
+        });
+
+        bench("region.multiply" + suffix, [&]
+        {
+            LRegion r { a };
+            r.multiply(1.5f);
+            sink = sink + r.extents().x2;
+        });
+
+        LRegion src { a };
+
+        bench("region.multiplyStatic" + suffix, [&]
+        {
+            LRegion dst;
+            LRegion::multiply(&dst, &src, 2.f);
+            sink = sink + dst.extents().x2;
+        });
+    }
+}
+
+/******************** SCENE ********************/
+
+// Offscreen target for the scene views and the painter, no buffer is allocated
+class BenchFramebuffer final : public LFramebuffer
+{
+public:
+    BenchFramebuffer(const LSize &size, GLuint id = 0) : m_sizeB(size), m_rect(0, 0, size.w(), size.h()), m_id(id)
+    {
+        m_type = Render;
+    }
+
+    Float32 scale() const override { return 1.f; }
+    const LSize &sizeB() const override { return m_sizeB; }
+    const LRect &rect() const override { return m_rect; }
+    GLuint id() const override { return m_id; }
+    Int32 buffersCount() const override { return 1; }
+    Int32 currentBufferIndex() const override { return 0; }
+    const LTexture *texture(Int32) const override { return nullptr; }
+    void setFramebufferDamage(const LRegion *) override {}
+    Transform transform() const override { return Normal; }
+
+private:
+    LSize m_sizeB;
+    LRect m_rect;
+    GLuint m_id;
+};
+
+// Window-like groups of solid color views inside layer views
+struct SyntheticTree
+{
+    LScene scene;
+    std::vector<std::unique_ptr<LLayerView>> groups;
+    std::vector<std::unique_ptr<LSolidColorView>> views;
+
+    SyntheticTree(std::mt19937 &rng, Int32 groupsCount, Int32 viewsPerGroup)
+    {
+        for (Int32 g = 0; g < groupsCount; g++)
+        {
+            LLayerView *group { new LLayerView(scene.mainView()) };
+            group->setPos(rng() % 1600, rng() % 800);
+            group->setSize(320, 280);
+            groups.emplace_back(group);
+
+            for (Int32 v = 0; v < viewsPerGroup; v++)
+            {
+                // One translucent view out of four
+                LSolidColorView *view { new LSolidColorView(0.5f, 0.5f, 0.5f, v % 4 == 0 ? 0.5f : 1.f, group) };
+                view->setPos(rng() % 256, rng() % 216);
+                view->setSize(16 + rng() % 48, 16 + rng() % 48);
+                view->enableInput(true);
+                views.emplace_back(view);
+            }
+        }
+    }
+};
+
+static void benchSceneHitTest()
+{
+    for (Int32 groups : {10, 100})
+    {
+        std::mt19937 rng(options.seed);
+        SyntheticTree tree(rng, groups, 10);
+        std::vector<LPoint> points(4096);
+
+        for (LPoint &point : points)
+            point = LPoint(Int32(rng() % 1920), Int32(rng() % 1080));
+
+        UInt32 i { 0 };
+
+        bench("scene.viewAt/" + std::to_string(groups * 10), [&]
+        {
+            sink = sink + (uintptr_t)tree.scene.viewAt(points[i++ & 4095]);
+        });
+    }
+}
+
+// Damage pass of LSceneView::render() without painting
+static void damagePass(LSceneView *sceneView)
+{
+    LSceneView::LSceneViewPrivate *imp { sceneView->imp() };
+    LSceneView::LSceneViewPrivate::ThreadData *oD { imp->currentThreadData };
+    imp->clearTmpVariables(oD);
+    imp->updateFlatViews(sceneView);
+
+    for (UInt32 i = imp->flat.views.size(); i-- > 0;)
+        imp->calcNewDamage(i);
+
+    sink = sink + oD->newDamage.extents().x2;
+}
+
+static void benchSceneDamage()
+{
+    BenchFramebuffer fb(LSize(1920, 1080));
+
+    for (Int32 groups : {10, 100})
+    {
+        std::mt19937 rng(options.seed);
+        SyntheticTree tree(rng, groups, 10);
+        LSceneView *sceneView { tree.scene.mainView() };
+        sceneView->imp()->fb = &fb;
+        sceneView->imp()->currentThreadData = &sceneView->imp()->threadData(0);
+        sceneView->imp()->currentThreadSlot = 0;
+        const std::string suffix { "/" + std::to_string(groups * 10) };
+
+        // Nothing changes after the first frame
+        bench("scene.damage.static" + suffix, [&]
+        {
+            damagePass(sceneView);
+        });
+
+        // One group moves every frame (its children are offset by it), like a dragged window
+        UInt32 frame { 0 };
+
+        bench("scene.damage.moving" + suffix, [&]
+        {
+            LLayerView *group { tree.groups[frame % tree.groups.size()].get() };
+            group->setPos(group->pos().x() + ((frame++ & 1) ? 1 : -1), group->pos().y());
+            damagePass(sceneView);
+        });
+
+        // Restacking invalidates the flattened tree
+        bench("scene.damage.restack" + suffix, [&]
+        {
+            tree.groups[frame++ % tree.groups.size()]->insertAfter(nullptr);
+            damagePass(sceneView);
+        });
+
+        sceneView->imp()->removeThreadData(0);
+        sceneView->imp()->fb = nullptr;
+    }
+}
+
+/******************** PAINTER ********************/
+
+static bool initEGL(EGLDisplay *display, EGLContext *context)
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay { (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT") };
+    *display = EGL_NO_DISPLAY;
+
+    if (getPlatformDisplay)
+        *display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+    if (*display == EGL_NO_DISPLAY)
+        *display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (*display == EGL_NO_DISPLAY || !eglInitialize(*display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_ES_API))
+        return false;
+
+    static const EGLint configAttribs[] { EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT, EGL_SURFACE_TYPE, 0, EGL_NONE };
+    static const EGLint contextAttribs[] { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+    EGLConfig config;
+    EGLint n { 0 };
+
+    if (!eglChooseConfig(*display, configAttribs, &config, 1, &n) || n == 0)
+        return false;
+
+    *context = eglCreateContext(*display, config, EGL_NO_CONTEXT, contextAttribs);
+
+    return *context != EGL_NO_CONTEXT && eglMakeCurrent(*display, EGL_NO_SURFACE, EGL_NO_SURFACE, *context);
+}
+
+static GLuint createProgram()
+{
+    static const GLchar *vShaderStr { "attribute vec4 vertexPosition; void main() { gl_Position = vertexPosition; }" };
+    static const GLchar *fShaderStr { "precision mediump float; void main() { gl_FragColor = vec4(1.0); }" };
+    GLuint vShader { glCreateShader(GL_VERTEX_SHADER) };
+    GLuint fShader { glCreateShader(GL_FRAGMENT_SHADER) };
+    glShaderSource(vShader, 1, &vShaderStr, nullptr);
+    glShaderSource(fShader, 1, &fShaderStr, nullptr);
+    glCompileShader(vShader);
+    glCompileShader(fShader);
+    GLuint program { glCreateProgram() };
+    glAttachShader(program, vShader);
+    glAttachShader(program, fShader);
+    glLinkProgram(program);
+    glDeleteShader(vShader);
+    glDeleteShader(fShader);
+    return program;
+}
+
+/* Submits regions box by box like LPainter::drawRegion(), using the painter viewport calculation.
+ * The painter is not created since it is owned by the compositor output threads, instead its
+ * private state is bound to a minimal program on a surfaceless context. */
+static void benchPainter()
+{
+    if (!selected("painter."))
+        return;
+
+    EGLDisplay display;
+    EGLContext context;
+
+    if (!initEGL(&display, &context))
+    {
+        printf("%-40s %s\n", "painter.*", "skipped (no surfaceless EGL context)");
+        return;
+    }
+
+    GLuint texture, framebuffer;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1920, 1080, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    glEnable(GL_SCISSOR_TEST);
+
+    const GLuint program { createProgram() };
+    glUseProgram(program);
+    static const GLfloat square[] { -1.f, 1.f, 1.f, 1.f, 1.f, -1.f, -1.f, -1.f };
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, square);
+
+    BenchFramebuffer fb(LSize(1920, 1080), framebuffer);
+    std::unique_ptr<LPainter::LPainterPrivate> painter { std::make_unique<LPainter::LPainterPrivate>() };
+    LPainter::LPainterPrivate::Uniforms uniforms;
+
+    // Invalid locations, glUniform*() calls are ignored
+    memset(&uniforms, 0xFF, sizeof(uniforms));
+    painter->fb = &fb;
+    painter->fbId = framebuffer;
+    painter->currentState = &painter->state;
+    painter->currentUniforms = &uniforms;
+
+    for (Int32 rects : {1, 16, 256})
+    {
+        std::mt19937 rng(options.seed);
+        const LRegion region { randomRegion(rng, rects, 128) };
+        Int32 boxes;
+        region.boxes(&boxes);
+        UInt32 frame { 0 };
+
+        bench("painter.drawRegion/" + std::to_string(boxes) + "boxes", [&]
+        {
+            Int32 n;
+            LBox *box { region.boxes(&n) };
+
+            for (Int32 i = 0; i < n; i++)
+            {
+                painter->setViewport(box->x1, box->y1, box->x2 - box->x1, box->y2 - box->y1);
+                glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+                box++;
+            }
+
+            // Keep the command queue bounded
+            if ((++frame & 63) == 0)
+                glFinish();
+        });
+    }
+
+    glFinish();
+    glDeleteProgram(program);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+}
+
+/******************** TEXTURE ********************/
+
+static void benchTexture()
+{
+    static const UInt32 formats[]
+    {
+        DRM_FORMAT_ARGB8888, DRM_FORMAT_XRGB8888, DRM_FORMAT_ABGR8888, DRM_FORMAT_XBGR8888,
+        DRM_FORMAT_RGB565, DRM_FORMAT_BGR888, DRM_FORMAT_ARGB2101010, DRM_FORMAT_ABGR16161616F,
+        DRM_FORMAT_C8, DRM_FORMAT_NV12, DRM_FORMAT_YUV420, DRM_FORMAT_P010
+    };
+
+    static const UInt32 waylandFormats[]
+    {
+        WL_SHM_FORMAT_ARGB8888, WL_SHM_FORMAT_XRGB8888, WL_SHM_FORMAT_RGB565, WL_SHM_FORMAT_ABGR8888
+    };
+
+    const UInt32 n { sizeof(formats) / sizeof(formats[0]) };
+    UInt32 i { 0 };
+
+    bench("texture.formatBytesPerPixel", [&]
+    {
+        sink = sink + LTexture::formatBytesPerPixel(formats[i++ % n]);
+    });
+
+    bench("texture.formatPlanes", [&]
+    {
+        sink = sink + LTexture::formatPlanes(formats[i++ % n]);
+    });
+
+    bench("texture.waylandFormatToDRM", [&]
+    {
+        sink = sink + LTexture::waylandFormatToDRM(waylandFormats[i++ & 3]);
+    });
+}
+
+/******************** BASELINE ********************/
+
+static bool saveResults(const char *path)
+{
+    std::ofstream file(path);
+
+    if (!file)
+        return false;
+
+    file.precision(3);
+
+    for (const Result &result : results)
+        file << result.name << ' ' << std::fixed << result.nsPerOp << '\n';
+
+    return file.good();
+}
+
+// Returns the number of regressions beyond the threshold
+static Int32 compareResults(const char *path)
+{
+    std::ifstream file(path);
+
+    if (!file)
+    {
+        fprintf(stderr, "LMicroBenchmark: Failed to open baseline %s.\n", path);
+        return -1;
+    }
+
+    std::map<std::string, Float64> baseline;
+    std::string name;
+    Float64 nsPerOp;
+
+    while (file >> name >> nsPerOp)
+        baseline[name] = nsPerOp;
+
+    Int32 regressions { 0 };
+    printf("\n%-40s %14s %14s %9s\n", "Comparison", "baseline", "current", "change");
+
+    for (const Result &result : results)
+    {
+        auto it { baseline.find(result.name) };
+
+        if (it == baseline.end() || it->second <= 0.0)
+        {
+            printf("%-40s %14s %14.1f\n", result.name.c_str(), "-", result.nsPerOp);
+            continue;
+        }
+
+        const Float64 change { 100.0 * (result.nsPerOp - it->second) / it->second };
+        const bool regression { change > options.threshold };
+        regressions += regression;
+        printf("%-40s %14.1f %14.1f %+8.1f%%%s\n",
+               result.name.c_str(), it->second, result.nsPerOp, change, regression ? " REGRESSION" : "");
+    }
+
+    return regressions;
+}
+
+/******************** MAIN ********************/
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] [benchmark prefix...]\n\n"
+            "  -s <seed>       Seed of the synthetic workloads (default 1)\n"
+            "  -r <repeats>    Samples per benchmark, the median is reported (default 7)\n"
+            "  -m <ms>         Minimum duration of each sample (default 50)\n"
+            "  -o <file>       Save the results\n"
+            "  -b <file>       Compare with results saved with -o, exits with 1 on regressions\n"
+            "  -t <percent>    Regression threshold for -b (default 10)\n",
+            name);
+}
+
+int main(int argc, char *argv[])
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "hs:r:m:o:b:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            options.seed = strtoul(optarg, nullptr, 10);
+            break;
+        case 'r':
+            options.repeats = std::max(1, atoi(optarg));
+            break;
+        case 'm':
+            options.minMs = atof(optarg);
+            break;
+        case 'o':
+            options.output = optarg;
+            break;
+        case 'b':
+            options.baseline = optarg;
+            break;
+        case 't':
+            options.threshold = atof(optarg);
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    for (Int32 i = optind; i < argc; i++)
+        options.filters.push_back(argv[i]);
+
+    // Views require a compositor instance, it is never started
+    LCompositor compositor;
+
+    benchRegion();
+    benchSceneHitTest();
+    benchSceneDamage();
+    benchPainter();
+    benchTexture();
+
+    if (options.output && !saveResults(options.output))
+    {
+        fprintf(stderr, "LMicroBenchmark: Failed to save results to %s.\n", options.output);
+        return 1;
+    }
+
+    if (options.baseline)
+        return compareResults(options.baseline) == 0 ? 0 : 1;
+
+    return 0;
+}
@@ -0,0 +1,985 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <wayland-client.h>
+#include "xdg-shell-client-protocol.h"
+#include "recording.h"
+
+#define DRM_FORMAT_ARGB8888 0x34325241
+#define DRM_FORMAT_XRGB8888 0x34325258
+
+/* A frame interval is only measured if the surface requested the callback shortly after the
+ * previous one was done, so that idle periods are not counted */
+#define MAX_FRAME_REQUEST_DELAY_US 50000
+
+enum ObjectType
+{
+    ObjectSurface,
+    ObjectBuffer,
+    ObjectSubsurface,
+    ObjectXdgSurface,
+    ObjectXdgToplevel,
+    ObjectXdgPopup
+};
+
+struct Object
+{
+    enum ObjectType type;
+};
+
+struct XdgSurface;
+
+struct Surface
+{
+    struct Object base;
+    struct wl_surface *surface;
+    struct XdgSurface *xdgSurface;
+    bool bufferAttached;
+    int64_t lastDone;
+};
+
+struct Buffer
+{
+    struct Object base;
+    struct wl_buffer *buffer;
+    uint8_t *data;
+    size_t size;
+    int32_t width, height, stride;
+};
+
+struct Subsurface
+{
+    struct Object base;
+    struct wl_subsurface *subsurface;
+};
+
+struct XdgSurface
+{
+    struct Object base;
+    struct xdg_surface *xdgSurface;
+    struct Surface *surface;
+    uint32_t serial;
+    bool configured;
+    bool pendingAck;
+};
+
+struct XdgRole
+{
+    struct Object base;
+    void *proxy;
+};
+
+struct FrameCallback
+{
+    struct wl_list link;
+    struct wl_callback *callback;
+    struct Surface *surface;
+    int64_t requested;
+};
+
+struct Client
+{
+    bool connected;
+    struct wl_display *display;
+    struct wl_registry *registry;
+    struct wl_compositor *compositor;
+    struct wl_subcompositor *subcompositor;
+    struct wl_shm *shm;
+    struct xdg_wm_base *xdg_wm_base;
+    struct Object **objects;
+    uint32_t objectsCount;
+    struct wl_list callbacks;
+};
+
+static struct Client *clients = NULL;
+static uint32_t clientsCount = 0;
+
+static double *intervals = NULL;
+static size_t intervalsCount = 0, intervalsCapacity = 0;
+static size_t framesCount = 0;
+
+static void noop() {}
+
+static int64_t nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void addInterval(double ms)
+{
+    if (intervalsCount == intervalsCapacity)
+    {
+        intervalsCapacity = intervalsCapacity ? intervalsCapacity * 2 : 4096;
+        intervals = realloc(intervals, intervalsCapacity * sizeof(double));
+    }
+
+    intervals[intervalsCount++] = ms;
+}
+
+/* Objects */
+
+static struct Object *getObject(struct Client *client, uint32_t id, enum ObjectType type)
+{
+    if (id >= client->objectsCount || !client->objects[id] || client->objects[id]->type != type)
+        return NULL;
+
+    return client->objects[id];
+}
+
+static void setObject(struct Client *client, uint32_t id, struct Object *object)
+{
+    if (id >= client->objectsCount)
+    {
+        uint32_t count = client->objectsCount ? client->objectsCount : 64;
+
+        while (count <= id)
+            count *= 2;
+
+        client->objects = realloc(client->objects, count * sizeof(struct Object*));
+        memset(&client->objects[client->objectsCount], 0, (count - client->objectsCount) * sizeof(struct Object*));
+        client->objectsCount = count;
+    }
+
+    client->objects[id] = object;
+}
+
+static void destroyBuffer(struct Buffer *buffer)
+{
+    if (buffer->buffer)
+        wl_buffer_destroy(buffer->buffer);
+
+    if (buffer->data)
+        munmap(buffer->data, buffer->size);
+
+    free(buffer);
+}
+
+static void destroyObject(struct Client *client, uint32_t id)
+{
+    if (id >= client->objectsCount || !client->objects[id])
+        return;
+
+    struct Object *object = client->objects[id];
+    client->objects[id] = NULL;
+
+    switch (object->type)
+    {
+    case ObjectSurface:
+    {
+        struct Surface *surface = (struct Surface*)object;
+        struct FrameCallback *callback;
+
+        wl_list_for_each(callback, &client->callbacks, link)
+            if (callback->surface == surface)
+                callback->surface = NULL;
+
+        if (surface->xdgSurface)
+            surface->xdgSurface->surface = NULL;
+
+        wl_surface_destroy(surface->surface);
+        free(surface);
+        break;
+    }
+    case ObjectBuffer:
+        destroyBuffer((struct Buffer*)object);
+        break;
+    case ObjectSubsurface:
+        wl_subsurface_destroy(((struct Subsurface*)object)->subsurface);
+        free(object);
+        break;
+    case ObjectXdgSurface:
+    {
+        struct XdgSurface *xdgSurface = (struct XdgSurface*)object;
+
+        if (xdgSurface->surface)
+            xdgSurface->surface->xdgSurface = NULL;
+
+        xdg_surface_destroy(xdgSurface->xdgSurface);
+        free(xdgSurface);
+        break;
+    }
+    case ObjectXdgToplevel:
+        xdg_toplevel_destroy(((struct XdgRole*)object)->proxy);
+        free(object);
+        break;
+    case ObjectXdgPopup:
+        xdg_popup_destroy(((struct XdgRole*)object)->proxy);
+        free(object);
+        break;
+    }
+}
+
+/* Listeners */
+
+static void xdg_wm_base_handle_ping(void *data, struct xdg_wm_base *wm, uint32_t serial)
+{
+    (void)data;
+    xdg_wm_base_pong(wm, serial);
+}
+
+static const struct xdg_wm_base_listener xdg_wm_base_listener =
+{
+    .ping = &xdg_wm_base_handle_ping
+};
+
+static void xdg_surface_handle_configure(void *data, struct xdg_surface *xdg_surface, uint32_t serial)
+{
+    (void)xdg_surface;
+    struct XdgSurface *xdgSurface = data;
+    xdgSurface->serial = serial;
+    xdgSurface->configured = true;
+    xdgSurface->pendingAck = true;
+}
+
+static const struct xdg_surface_listener xdg_surface_listener =
+{
+    .configure = &xdg_surface_handle_configure
+};
+
+static const struct xdg_toplevel_listener xdg_toplevel_listener =
+{
+    .configure = &noop,
+    .close = &noop
+};
+
+static const struct xdg_popup_listener xdg_popup_listener =
+{
+    .configure = &noop,
+    .popup_done = &noop,
+    .repositioned = &noop
+};
+
+static void wl_callback_handle_done(void *data, struct wl_callback *wl_callback, uint32_t time)
+{
+    (void)time;
+    struct FrameCallback *callback = data;
+    const int64_t now = nowUs();
+
+    framesCount++;
+
+    if (callback->surface)
+    {
+        if (callback->surface->lastDone != 0 && callback->requested - callback->surface->lastDone <= MAX_FRAME_REQUEST_DELAY_US)
+            addInterval((double)(now - callback->surface->lastDone) / 1000.0);
+
+        callback->surface->lastDone = now;
+    }
+
+    wl_callback_destroy(wl_callback);
+    wl_list_remove(&callback->link);
+    free(callback);
+}
+
+static const struct wl_callback_listener wl_callback_listener =
+{
+    .done = &wl_callback_handle_done
+};
+
+static void wl_registry_handle_global(void *data, struct wl_registry *registry, uint32_t name, const char *interface, uint32_t version)
+{
+    struct Client *client = data;
+
+    if (strcmp(interface, wl_compositor_interface.name) == 0)
+        client->compositor = wl_registry_bind(registry, name, &wl_compositor_interface, version < 5 ? version : 5);
+    else if (strcmp(interface, wl_subcompositor_interface.name) == 0)
+        client->subcompositor = wl_registry_bind(registry, name, &wl_subcompositor_interface, 1);
+    else if (strcmp(interface, wl_shm_interface.name) == 0)
+        client->shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    else if (strcmp(interface, xdg_wm_base_interface.name) == 0)
+    {
+        client->xdg_wm_base = wl_registry_bind(registry, name, &xdg_wm_base_interface, version < 3 ? version : 3);
+        xdg_wm_base_add_listener(client->xdg_wm_base, &xdg_wm_base_listener, NULL);
+    }
+}
+
+static const struct wl_registry_listener wl_registry_listener =
+{
+    .global = &wl_registry_handle_global,
+    .global_remove = &noop
+};
+
+/* Clients */
+
+static struct Client *getClient(uint32_t id)
+{
+    if (id >= clientsCount)
+    {
+        uint32_t count = clientsCount ? clientsCount * 2 : 16;
+
+        while (count <= id)
+            count *= 2;
+
+        clients = realloc(clients, count * sizeof(struct Client));
+        memset(&clients[clientsCount], 0, (count - clientsCount) * sizeof(struct Client));
+        clientsCount = count;
+    }
+
+    return &clients[id];
+}
+
+static void connectClient(struct Client *client)
+{
+    memset(client, 0, sizeof(struct Client));
+    wl_list_init(&client->callbacks);
+    client->display = wl_display_connect(NULL);
+
+    if (!client->display)
+    {
+        fprintf(stderr, "Failed to connect to the Wayland display.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    client->registry = wl_display_get_registry(client->display);
+    wl_registry_add_listener(client->registry, &wl_registry_listener, client);
+    wl_display_roundtrip(client->display);
+
+    if (!client->compositor || !client->subcompositor || !client->shm || !client->xdg_wm_base)
+    {
+        fprintf(stderr, "The compositor is missing required globals.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    client->connected = true;
+}
+
+static void disconnectClient(struct Client *client)
+{
+    if (!client->connected)
+        return;
+
+    struct FrameCallback *callback, *tmp;
+
+    wl_list_for_each_safe(callback, tmp, &client->callbacks, link)
+    {
+        wl_callback_destroy(callback->callback);
+        free(callback);
+    }
+
+    // Roles first, then xdg_surfaces and finally wl_surfaces and buffers
+    for (int pass = 0; pass < 3; pass++)
+    {
+        for (uint32_t id = 0; id < client->objectsCount; id++)
+        {
+            struct Object *object = client->objects[id];
+
+            if (!object)
+                continue;
+
+            const int objectPass = (object->type == ObjectXdgToplevel || object->type == ObjectXdgPopup || object->type == ObjectSubsurface) ? 0 :
+                                   object->type == ObjectXdgSurface ? 1 : 2;
+
+            if (objectPass == pass)
+                destroyObject(client, id);
+        }
+    }
+
+    free(client->objects);
+    wl_display_disconnect(client->display);
+    client->connected = false;
+    client->objects = NULL;
+    client->objectsCount = 0;
+}
+
+static bool checkClient(struct Client *client)
+{
+    if (!client->connected)
+        return false;
+
+    if (wl_display_get_error(client->display) != 0)
+    {
+        fprintf(stderr, "Client disconnected by the compositor (error %d), its remaining requests are ignored.\n",
+                wl_display_get_error(client->display));
+        disconnectClient(client);
+        return false;
+    }
+
+    return true;
+}
+
+/* Flushes pending requests and dispatches the events of all clients until the timeout
+ * (in microseconds) expires */
+static void dispatchClients(int64_t timeout)
+{
+    struct pollfd *fds = alloca(sizeof(struct pollfd) * (clientsCount + 1));
+    const int64_t until = nowUs() + timeout;
+
+    while (true)
+    {
+        nfds_t n = 0;
+
+        for (uint32_t i = 0; i < clientsCount; i++)
+        {
+            if (!checkClient(&clients[i]))
+                continue;
+
+            wl_display_dispatch_pending(clients[i].display);
+            fds[n].fd = wl_display_get_fd(clients[i].display);
+            fds[n].events = POLLIN;
+            fds[n].revents = 0;
+
+            if (wl_display_flush(clients[i].display) == -1 && errno == EAGAIN)
+                fds[n].events |= POLLOUT;
+
+            n++;
+        }
+
+        int64_t remaining = until - nowUs();
+
+        if (remaining < 0)
+            remaining = 0;
+
+        if (poll(fds, n, (int)(remaining / 1000)) <= 0)
+            return;
+
+        nfds_t j = 0;
+
+        for (uint32_t i = 0; i < clientsCount && j < n; i++)
+        {
+            if (!clients[i].connected)
+                continue;
+
+            if (fds[j].revents & POLLIN)
+                wl_display_dispatch(clients[i].display);
+
+            j++;
+        }
+
+        if (remaining == 0)
+            return;
+    }
+}
+
+/* Records */
+
+static void createBuffer(struct Client *client, uint32_t id, const int32_t *args)
+{
+    struct Buffer *buffer = (struct Buffer*)getObject(client, id, ObjectBuffer);
+
+    // Recreated when the client resizes its pool
+    if (buffer)
+    {
+        client->objects[id] = NULL;
+        destroyBuffer(buffer);
+    }
+
+    const int32_t width = args[0];
+    const int32_t height = args[1];
+    const bool shm = args[4];
+    const int32_t stride = shm ? args[2] : width * 4;
+    uint32_t format = shm ? (uint32_t)args[3] : DRM_FORMAT_ARGB8888;
+
+    if (width <= 0 || height <= 0 || stride <= 0)
+        return;
+
+    if (format == DRM_FORMAT_ARGB8888)
+        format = WL_SHM_FORMAT_ARGB8888;
+    else if (format == DRM_FORMAT_XRGB8888)
+        format = WL_SHM_FORMAT_XRGB8888;
+
+    buffer = calloc(1, sizeof(struct Buffer));
+    buffer->base.type = ObjectBuffer;
+    buffer->width = width;
+    buffer->height = height;
+    buffer->stride = stride;
+    buffer->size = (size_t)stride * height;
+
+    int fd = memfd_create("LReplay", MFD_CLOEXEC);
+
+    if (fd < 0 || ftruncate(fd, buffer->size) < 0)
+    {
+        fprintf(stderr, "Failed to allocate a %dx%d buffer.\n", width, height);
+        exit(EXIT_FAILURE);
+    }
+
+    buffer->data = mmap(NULL, buffer->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    // DMA and EGL buffers are replaced by a solid SHM buffer of the same size
+    if (!shm)
+        for (size_t i = 0; i < buffer->size / 4; i++)
+            ((uint32_t*)buffer->data)[i] = 0xFF808080;
+
+    struct wl_shm_pool *pool = wl_shm_create_pool(client->shm, fd, buffer->size);
+    buffer->buffer = wl_shm_pool_create_buffer(pool, 0, width, height, stride, format);
+    wl_shm_pool_destroy(pool);
+    close(fd);
+    setObject(client, id, &buffer->base);
+}
+
+static void writeBufferData(struct Client *client, uint32_t id, const int32_t *args, uint32_t size)
+{
+    struct Buffer *buffer = (struct Buffer*)getObject(client, id, ObjectBuffer);
+
+    if (!buffer || size < sizeof(int32_t))
+        return;
+
+    const int32_t n = args[0];
+    const int32_t *boxes = &args[1];
+    const uint8_t *pixels = (const uint8_t*)&boxes[4 * n];
+    const size_t pixelsSize = size - sizeof(int32_t) * (1 + 4 * n);
+    size_t area = 0;
+
+    for (int32_t i = 0; i < n; i++)
+        area += (size_t)boxes[4 * i + 2] * boxes[4 * i + 3];
+
+    if (area == 0)
+        return;
+
+    // The pixel size is not stored, the rows of all boxes share it
+    const size_t pixelSize = pixelsSize / area;
+
+    for (int32_t i = 0; i < n; i++)
+    {
+        const int32_t *box = &boxes[4 * i];
+        const size_t rowSize = box[2] * pixelSize;
+
+        for (int32_t y = box[1]; y < box[1] + box[3]; y++)
+        {
+            const size_t offset = (size_t)y * buffer->stride + box[0] * pixelSize;
+
+            if (offset + rowSize <= buffer->size)
+                memcpy(&buffer->data[offset], pixels, rowSize);
+
+            pixels += rowSize;
+        }
+    }
+}
+
+static void setRegion(struct Client *client, struct Surface *surface, bool opaque, const int32_t *args, uint32_t count)
+{
+    struct wl_region *region = NULL;
+
+    if (!args[0])
+    {
+        region = wl_compositor_create_region(client->compositor);
+
+        for (uint32_t i = 1; i + 3 < count; i += 4)
+            wl_region_add(region, args[i], args[i + 1], args[i + 2], args[i + 3]);
+    }
+
+    if (opaque)
+        wl_surface_set_opaque_region(surface->surface, region);
+    else
+        wl_surface_set_input_region(surface->surface, region);
+
+    if (region)
+        wl_region_destroy(region);
+}
+
+static void commit(struct Client *client, struct Surface *surface)
+{
+    struct XdgSurface *xdgSurface = surface->xdgSurface;
+
+    if (xdgSurface)
+    {
+        // Buffers can not be attached before the initial configure
+        while (surface->bufferAttached && !xdgSurface->configured && checkClient(client))
+            wl_display_roundtrip(client->display);
+
+        if (xdgSurface->pendingAck)
+        {
+            xdg_surface_ack_configure(xdgSurface->xdgSurface, xdgSurface->serial);
+            xdgSurface->pendingAck = false;
+        }
+    }
+
+    surface->bufferAttached = false;
+    wl_surface_commit(surface->surface);
+}
+
+static void replayRecord(const struct RecordHeader *record)
+{
+    const int32_t *args = (const int32_t*)(record + 1);
+    const uint32_t count = record->size / sizeof(int32_t);
+    struct Client *client = getClient(record->client);
+
+    if (record->type == ClientCreate)
+    {
+        disconnectClient(client);
+        connectClient(client);
+        return;
+    }
+
+    if (!checkClient(client))
+        return;
+
+    const uint32_t version = wl_proxy_get_version((struct wl_proxy*)client->compositor);
+    struct Surface *surface = (struct Surface*)getObject(client, record->object, ObjectSurface);
+    struct Subsurface *subsurface = (struct Subsurface*)getObject(client, record->object, ObjectSubsurface);
+    struct XdgSurface *xdgSurface = (struct XdgSurface*)getObject(client, record->object, ObjectXdgSurface);
+
+    switch (record->type)
+    {
+    case ClientDestroy:
+        disconnectClient(client);
+        break;
+    case SurfaceCreate:
+        surface = calloc(1, sizeof(struct Surface));
+        surface->base.type = ObjectSurface;
+        surface->surface = wl_compositor_create_surface(client->compositor);
+        setObject(client, record->object, &surface->base);
+        break;
+    case SurfaceAttach:
+    {
+        if (!surface)
+            break;
+
+        struct Buffer *buffer = (struct Buffer*)getObject(client, args[0], ObjectBuffer);
+
+        // Unknown buffer (failed to be recorded)
+        if (args[0] != 0 && !buffer)
+            break;
+
+        if (version >= 5)
+        {
+            wl_surface_attach(surface->surface, buffer ? buffer->buffer : NULL, 0, 0);
+
+            if (args[1] != 0 || args[2] != 0)
+                wl_surface_offset(surface->surface, args[1], args[2]);
+        }
+        else
+            wl_surface_attach(surface->surface, buffer ? buffer->buffer : NULL, args[1], args[2]);
+
+        surface->bufferAttached = buffer != NULL;
+        break;
+    }
+    case SurfaceDamage:
+        if (surface)
+            wl_surface_damage(surface->surface, args[0], args[1], args[2], args[3]);
+        break;
+    case SurfaceDamageBuffer:
+        if (surface && version >= 4)
+            wl_surface_damage_buffer(surface->surface, args[0], args[1], args[2], args[3]);
+        else if (surface)
+            wl_surface_damage(surface->surface, 0, 0, INT32_MAX, INT32_MAX);
+        break;
+    case SurfaceFrame:
+        if (surface)
+        {
+            struct FrameCallback *callback = calloc(1, sizeof(struct FrameCallback));
+            callback->surface = surface;
+            callback->requested = nowUs();
+            callback->callback = wl_surface_frame(surface->surface);
+            wl_callback_add_listener(callback->callback, &wl_callback_listener, callback);
+            wl_list_insert(&client->callbacks, &callback->link);
+        }
+        break;
+    case SurfaceCommit:
+        if (surface)
+            commit(client, surface);
+        break;
+    case SurfaceOpaqueRegion:
+    case SurfaceInputRegion:
+        if (surface && count > 0)
+            setRegion(client, surface, record->type == SurfaceOpaqueRegion, args, count);
+        break;
+    case SurfaceBufferScale:
+        if (surface && version >= 3)
+            wl_surface_set_buffer_scale(surface->surface, args[0]);
+        break;
+    case SurfaceBufferTransform:
+        if (surface && version >= 2)
+            wl_surface_set_buffer_transform(surface->surface, args[0]);
+        break;
+    case SurfaceOffset:
+        if (surface && version >= 5)
+            wl_surface_offset(surface->surface, args[0], args[1]);
+        break;
+    case BufferCreate:
+        createBuffer(client, record->object, args);
+        break;
+    case BufferData:
+        writeBufferData(client, record->object, args, record->size);
+        break;
+    case SubsurfaceCreate:
+    {
+        struct Surface *child = (struct Surface*)getObject(client, args[0], ObjectSurface);
+        struct Surface *parent = (struct Surface*)getObject(client, args[1], ObjectSurface);
+
+        if (!child || !parent)
+            break;
+
+        subsurface = calloc(1, sizeof(struct Subsurface));
+        subsurface->base.type = ObjectSubsurface;
+        subsurface->subsurface = wl_subcompositor_get_subsurface(client->subcompositor, child->surface, parent->surface);
+        setObject(client, record->object, &subsurface->base);
+        break;
+    }
+    case SubsurfacePosition:
+        if (subsurface)
+            wl_subsurface_set_position(subsurface->subsurface, args[0], args[1]);
+        break;
+    case SubsurfacePlaceAbove:
+    case SubsurfacePlaceBelow:
+    {
+        struct Surface *sibling = (struct Surface*)getObject(client, args[0], ObjectSurface);
+
+        if (!subsurface || !sibling)
+            break;
+
+        if (record->type == SubsurfacePlaceAbove)
+            wl_subsurface_place_above(subsurface->subsurface, sibling->surface);
+        else
+            wl_subsurface_place_below(subsurface->subsurface, sibling->surface);
+        break;
+    }
+    case SubsurfaceSync:
+        if (subsurface)
+            wl_subsurface_set_sync(subsurface->subsurface);
+        break;
+    case SubsurfaceDesync:
+        if (subsurface)
+            wl_subsurface_set_desync(subsurface->subsurface);
+        break;
+    case XdgSurfaceCreate:
+    {
+        struct Surface *target = (struct Surface*)getObject(client, args[0], ObjectSurface);
+
+        if (!target)
+            break;
+
+        xdgSurface = calloc(1, sizeof(struct XdgSurface));
+        xdgSurface->base.type = ObjectXdgSurface;
+        xdgSurface->surface = target;
+        xdgSurface->xdgSurface = xdg_wm_base_get_xdg_surface(client->xdg_wm_base, target->surface);
+        xdg_surface_add_listener(xdgSurface->xdgSurface, &xdg_surface_listener, xdgSurface);
+        target->xdgSurface = xdgSurface;
+        setObject(client, record->object, &xdgSurface->base);
+        break;
+    }
+    case XdgSurfaceGeometry:
+        if (xdgSurface)
+            xdg_surface_set_window_geometry(xdgSurface->xdgSurface, args[0], args[1], args[2], args[3]);
+        break;
+    case XdgToplevelCreate:
+    {
+        xdgSurface = (struct XdgSurface*)getObject(client, args[0], ObjectXdgSurface);
+
+        if (!xdgSurface)
+            break;
+
+        struct XdgRole *toplevel = calloc(1, sizeof(struct XdgRole));
+        toplevel->base.type = ObjectXdgToplevel;
+        toplevel->proxy = xdg_surface_get_toplevel(xdgSurface->xdgSurface);
+        xdg_toplevel_add_listener(toplevel->proxy, &xdg_toplevel_listener, NULL);
+        setObject(client, record->object, &toplevel->base);
+        break;
+    }
+    case XdgPopupCreate:
+    {
+        xdgSurface = (struct XdgSurface*)getObject(client, args[0], ObjectXdgSurface);
+        struct XdgSurface *parent = (struct XdgSurface*)getObject(client, args[1], ObjectXdgSurface);
+
+        if (!xdgSurface || !parent || count < 13)
+            break;
+
+        struct xdg_positioner *positioner = xdg_wm_base_create_positioner(client->xdg_wm_base);
+        xdg_positioner_set_size(positioner, args[2], args[3]);
+        xdg_positioner_set_anchor_rect(positioner, args[4], args[5], args[6], args[7]);
+        xdg_positioner_set_anchor(positioner, args[8]);
+        xdg_positioner_set_gravity(positioner, args[9]);
+        xdg_positioner_set_constraint_adjustment(positioner, args[10]);
+        xdg_positioner_set_offset(positioner, args[11], args[12]);
+
+        struct XdgRole *popup = calloc(1, sizeof(struct XdgRole));
+        popup->base.type = ObjectXdgPopup;
+        popup->proxy = xdg_surface_get_popup(xdgSurface->xdgSurface, parent->xdgSurface, positioner);
+        xdg_popup_add_listener(popup->proxy, &xdg_popup_listener, NULL);
+        xdg_positioner_destroy(positioner);
+        setObject(client, record->object, &popup->base);
+        break;
+    }
+    case SurfaceDestroy:
+    case BufferDestroy:
+    case SubsurfaceDestroy:
+    case XdgSurfaceDestroy:
+    case XdgToplevelDestroy:
+    case XdgPopupDestroy:
+        destroyObject(client, record->object);
+        break;
+    }
+}
+
+/* Statistics */
+
+static int64_t compositorTicks(int pid)
+{
+    char path[64];
+    char stat[1024];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE *file = fopen(path, "r");
+
+    if (!file)
+        return -1;
+
+    const size_t len = fread(stat, 1, sizeof(stat) - 1, file);
+    fclose(file);
+    stat[len] = '\0';
+
+    // Skip the command name, which may contain spaces
+    const char *fields = strrchr(stat, ')');
+    unsigned long utime, stime;
+
+    if (!fields || sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2)
+        return -1;
+
+    return utime + stime;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(double p)
+{
+    return intervalsCount ? intervals[(size_t)(p * (intervalsCount - 1))] : 0.0;
+}
+
+static void printUsage()
+{
+    fprintf(stderr,
+            "Usage: LReplay [-f] [-s speed] [-l loops] [-p pid] recording\n\n"
+            "  -f        Replay as fast as possible, ignoring the recorded timestamps\n"
+            "  -s speed  Replay speed factor (default 1.0)\n"
+            "  -l loops  Number of times the recording is replayed (default 1)\n"
+            "  -p pid    Compositor process to measure the CPU usage of\n");
+}
+
+int main(int argc, char *argv[])
+{
+    bool fast = false;
+    double speed = 1.0;
+    int loops = 1;
+    int pid = -1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "fs:l:p:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f': fast = true; break;
+        case 's': speed = atof(optarg); break;
+        case 'l': loops = atoi(optarg); break;
+        case 'p': pid = atoi(optarg); break;
+        default: printUsage(); return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc || speed <= 0.0 || loops <= 0)
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    const char *path = argv[optind];
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+
+    if (fd < 0 || fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(struct FileHeader))
+    {
+        fprintf(stderr, "Failed to open %s.\n", path);
+        return EXIT_FAILURE;
+    }
+
+    const uint8_t *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        fprintf(stderr, "Failed to map %s.\n", path);
+        return EXIT_FAILURE;
+    }
+
+    const struct FileHeader *header = (const struct FileHeader*)data;
+
+    if (header->magic != RECORDING_MAGIC || header->version != RECORDING_VERSION)
+    {
+        fprintf(stderr, "%s is not a supported session recording.\n", path);
+        return EXIT_FAILURE;
+    }
+
+    const uint8_t *end = data + st.st_size;
+    const int64_t startTicks = pid > 0 ? compositorTicks(pid) : -1;
+    const int64_t start = nowUs();
+
+    for (int loop = 0; loop < loops; loop++)
+    {
+        const int64_t loopStart = nowUs();
+        const uint8_t *it = data + sizeof(struct FileHeader);
+
+        while (it + sizeof(struct RecordHeader) <= end)
+        {
+            const struct RecordHeader *record = (const struct RecordHeader*)it;
+
+            // Truncated recording (the compositor was killed)
+            if (it + sizeof(struct RecordHeader) + record->size > end)
+                break;
+
+            it += sizeof(struct RecordHeader) + record->size;
+
+            if (fast)
+                dispatchClients(0);
+            else
+            {
+                const int64_t target = loopStart + (int64_t)(record->time / speed);
+                const int64_t now = nowUs();
+                dispatchClients(target > now ? target - now : 0);
+            }
+
+            replayRecord(record);
+        }
+
+        dispatchClients(0);
+
+        for (uint32_t i = 0; i < clientsCount; i++)
+            disconnectClient(&clients[i]);
+    }
+
+    const double duration = (double)(nowUs() - start) / 1000000.0;
+    const int64_t endTicks = pid > 0 ? compositorTicks(pid) : -1;
+    double mean = 0.0;
+
+    for (size_t i = 0; i < intervalsCount; i++)
+        mean += intervals[i];
+
+    if (intervalsCount)
+    {
+        mean /= intervalsCount;
+        qsort(intervals, intervalsCount, sizeof(double), &compareDoubles);
+    }
+
+    printf("{\n");
+    printf("  \"recording\": \"");
+
+    for (const char *c = path; *c; c++)
+        printf(*c == '"' || *c == '\\' ? "\\%c" : "%c", *c);
+
+    printf("\",\n");
+    printf("  \"loops\": %d,\n", loops);
+    printf("  \"realtime\": %s,\n", fast ? "false" : "true");
+    printf("  \"duration_s\": %.3f,\n", duration);
+    printf("  \"frames\": %zu,\n", framesCount);
+    printf("  \"frame_interval_ms\": { \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f },\n",
+           mean, percentile(0.5), percentile(0.9), percentile(0.99), percentile(1.0));
+
+    if (startTicks >= 0 && endTicks >= 0)
+        printf("  \"compositor_cpu_percent\": %.2f\n", 100.0 * (double)(endTicks - startTicks) / sysconf(_SC_CLK_TCK) / duration);
+    else
+        printf("  \"compositor_cpu_percent\": null\n");
+
+    printf("}\n");
+    munmap((void*)data, st.st_size);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <stdint.h>
+
+/* Session recording format written by Louvre::LSessionRecorder
+ * (must match src/lib/core/private/LSessionRecorderPrivate.h) */
+
+#define RECORDING_MAGIC 0x4345524C
+#define RECORDING_VERSION 1
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+};
+
+struct RecordHeader
+{
+    uint32_t type;
+    uint32_t size;
+    uint64_t time;
+    uint32_t client;
+    uint32_t object;
+};
+
+enum RecordType
+{
+    ClientCreate,
+    ClientDestroy,
+
+    SurfaceCreate,
+    SurfaceDestroy,
+    SurfaceAttach,
+    SurfaceDamage,
+    SurfaceDamageBuffer,
+    SurfaceFrame,
+    SurfaceCommit,
+    SurfaceOpaqueRegion,
+    SurfaceInputRegion,
+    SurfaceBufferScale,
+    SurfaceBufferTransform,
+    SurfaceOffset,
+
+    BufferCreate,
+    BufferData,
+    BufferDestroy,
+
+    SubsurfaceCreate,
+    SubsurfaceDestroy,
+    SubsurfacePosition,
+    SubsurfacePlaceAbove,
+    SubsurfacePlaceBelow,
+    SubsurfaceSync,
+    SubsurfaceDesync,
+
+    XdgSurfaceCreate,
+    XdgSurfaceDestroy,
+    XdgSurfaceGeometry,
+    XdgToplevelCreate,
+    XdgToplevelDestroy,
+    XdgPopupCreate,
+    XdgPopupDestroy
+};
+
+#endif
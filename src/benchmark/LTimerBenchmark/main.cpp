@@ -0,0 +1,157 @@
+#include <LCompositor.h>
+#include <LTimer.h>
+#include <LLog.h>
+#include <wayland-server.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include <time.h>
+
+/* Starts and cancels N timers using one wl_event_loop timer source per timer
+ * (the previous LTimer implementation) and N LTimers through their public API,
+ * then measures the expiry of N LTimers dispatched by the compositor loop.
+ * The LTimers run inside a compositor that is started but whose outputs are
+ * never initialized, so the timerfd re-arms and dispatching are included. */
+
+using namespace Louvre;
+
+static Int32 n { 100000 };
+
+static double ms(const timespec &a, const timespec &b)
+{
+    return (b.tv_sec - a.tv_sec) * 1000.0 + (b.tv_nsec - a.tv_nsec) / 1000000.0;
+}
+
+static Int32 dummyCallback(void *)
+{
+    return 0;
+}
+
+class Compositor final : public LCompositor
+{
+public:
+    std::vector<UInt32> intervals;
+    std::vector<std::unique_ptr<LTimer>> timers;
+    Int32 expired { 0 };
+    timespec expiryBegin;
+
+    void initialized() override
+    {
+        std::mt19937 rng(1);
+        intervals.resize(n);
+
+        for (UInt32 &interval : intervals)
+            interval = 1 + rng() % 60000;
+
+        benchEventLoop();
+        benchStartCancel();
+        startExpiry();
+    }
+
+    // Timers must be destroyed while the compositor is still running
+    void uninitialized() override
+    {
+        timers.clear();
+    }
+
+    // One timerfd per timer
+    void benchEventLoop()
+    {
+        wl_event_loop *loop { wl_event_loop_create() };
+        std::vector<wl_event_source*> sources(n);
+        timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (Int32 i = 0; i < n; i++)
+        {
+            sources[i] = wl_event_loop_add_timer(loop, &dummyCallback, nullptr);
+            wl_event_source_timer_update(sources[i], intervals[i]);
+        }
+
+        for (Int32 i = 0; i < n; i++)
+            wl_event_source_timer_update(sources[i], 0);
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("wl_event_loop timers: start + cancel %d timers: %.3f ms\n", n, ms(t0, t1));
+
+        for (wl_event_source *source : sources)
+            wl_event_source_remove(source);
+
+        wl_event_loop_destroy(loop);
+    }
+
+    void benchStartCancel()
+    {
+        timers.reserve(n);
+
+        for (Int32 i = 0; i < n; i++)
+            timers.emplace_back(new LTimer([this](LTimer *)
+            {
+                if (++expired == n)
+                {
+                    timespec expiryEnd;
+                    clock_gettime(CLOCK_MONOTONIC, &expiryEnd);
+                    printf("LTimer: expire %d timers: %.3f ms (including the wait of the longest interval)\n", n, ms(expiryBegin, expiryEnd));
+                    finish();
+                }
+            }));
+
+        timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (Int32 i = 0; i < n; i++)
+            timers[i]->start(intervals[i]);
+
+        for (Int32 i = 0; i < n; i++)
+            timers[i]->cancel();
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("LTimer: start + cancel %d timers: %.3f ms\n", n, ms(t0, t1));
+
+        // Restarting a running timer moves it to another deadline
+        for (Int32 i = 0; i < n; i++)
+            timers[i]->start(intervals[i]);
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+
+        for (Int32 i = 0; i < n; i++)
+            timers[i]->start(intervals[n - 1 - i]);
+
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        printf("LTimer: restart %d running timers: %.3f ms\n", n, ms(t0, t1));
+
+        for (Int32 i = 0; i < n; i++)
+            timers[i]->cancel();
+    }
+
+    // Short intervals, so all of them expire within a few loop iterations
+    void startExpiry()
+    {
+        clock_gettime(CLOCK_MONOTONIC, &expiryBegin);
+
+        for (Int32 i = 0; i < n; i++)
+            timers[i]->start(1 + i % 10);
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+        n = std::max(1, atoi(argv[1]));
+
+    Compositor compositor;
+
+    if (!compositor.start())
+    {
+        LLog::fatal("[LTimerBenchmark] Failed to start compositor.");
+        return 1;
+    }
+
+    while (compositor.state() != LCompositor::Uninitialized)
+        compositor.processLoop(-1);
+
+    return 0;
+}
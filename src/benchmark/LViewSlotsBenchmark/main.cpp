@@ -0,0 +1,208 @@
+#include <private/LSceneViewPrivate.h>
+#include <private/LViewPrivate.h>
+#include <LCompositor.h>
+#include <LFramebuffer.h>
+#include <LScene.h>
+#include <LSceneView.h>
+#include <LSolidColorView.h>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+/* Compares per-view data stored in a std::map keyed by the thread id (the previous implementation)
+ * with the dense arrays indexed by the output thread slot, with one thread per output serialized by
+ * a mutex like the compositor lock. The previous implementation no longer exists, so both are timed
+ * with a synthetic model of the per-view state update of calcNewDamage(). The dense slots are then
+ * timed again with the real LSceneView::LSceneViewPrivate::calcNewDamage() over a scene of the same
+ * number of views, to check the model against the actual damage pass. */
+
+using namespace Louvre;
+
+using ViewThreadData = LView::LViewPrivate::ViewThreadData;
+
+static double ms(const timespec &a, const timespec &b)
+{
+    return (b.tv_sec - a.tv_sec) * 1000.0 + (b.tv_nsec - a.tv_nsec) / 1000000.0;
+}
+
+static std::mutex renderMutex;
+
+class BenchFramebuffer final : public LFramebuffer
+{
+public:
+    BenchFramebuffer(const LSize &size) : m_sizeB(size), m_rect(0, 0, size.w(), size.h())
+    {
+        m_type = Render;
+    }
+
+    Float32 scale() const override { return 1.f; }
+    const LSize &sizeB() const override { return m_sizeB; }
+    const LRect &rect() const override { return m_rect; }
+    GLuint id() const override { return 0; }
+    Int32 buffersCount() const override { return 1; }
+    Int32 currentBufferIndex() const override { return 0; }
+    const LTexture *texture(Int32) const override { return nullptr; }
+    void setFramebufferDamage(const LRegion *) override {}
+    Transform transform() const override { return Normal; }
+
+private:
+    LSize m_sizeB;
+    LRect m_rect;
+};
+
+// Synthetic model: same comparisons and region updates calcNewDamage() does for a view that moves every frame
+static inline void damagePass(ViewThreadData &data, LOutput *output, const LRect &rect, LRegion &newDamage)
+{
+    data.o = output;
+
+    if (data.prevRect != rect || data.changedOrder || !data.prevMapped)
+    {
+        data.changedOrder = false;
+        data.prevMapped = true;
+        data.prevRect = rect;
+        newDamage.addRegion(data.prevClipping);
+    }
+
+    LRegion currentClipping;
+    currentClipping.addRect(rect);
+    data.prevClipping.subtractRegion(currentClipping);
+    newDamage.addRegion(data.prevClipping);
+    data.prevClipping = currentClipping;
+}
+
+template<class Lookup>
+static double run(Int32 outputs, Int32 views, Int32 frames, Lookup lookup)
+{
+    std::vector<std::thread> threads;
+    timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (Int32 slot = 1; slot <= outputs; slot++)
+    {
+        threads.emplace_back([=]()
+        {
+            LOutput *output { (LOutput*)(uintptr_t)slot };
+            LRegion newDamage;
+
+            for (Int32 frame = 0; frame < frames; frame++)
+            {
+                renderMutex.lock();
+                newDamage.clear();
+
+                for (Int32 i = 0; i < views; i++)
+                {
+                    const LRect rect((i * 7 + frame) % 1920, (i * 13 + frame) % 1080, 64, 64);
+                    damagePass(lookup(i, slot), output, rect, newDamage);
+                }
+
+                renderMutex.unlock();
+            }
+        });
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return ms(t0, t1) / (frames * outputs);
+}
+
+// Damage pass of LSceneView::render() without painting, each thread uses its own slot
+static double runScene(Int32 outputs, Int32 views, Int32 frames)
+{
+    LScene scene;
+    LSceneView *sceneView { scene.mainView() };
+    std::vector<std::unique_ptr<LSolidColorView>> solidViews(views);
+
+    for (auto &view : solidViews)
+    {
+        view = std::make_unique<LSolidColorView>(0.5f, 0.5f, 0.5f, 1.f, sceneView);
+        view->setSize(64, 64);
+    }
+
+    BenchFramebuffer fb(LSize(1920, 1080));
+    std::vector<std::thread> threads;
+    timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (Int32 slot = 1; slot <= outputs; slot++)
+    {
+        threads.emplace_back([&, slot]()
+        {
+            for (Int32 frame = 0; frame < frames; frame++)
+            {
+                renderMutex.lock();
+                LSceneView::LSceneViewPrivate *imp { sceneView->imp() };
+                imp->fb = &fb;
+                imp->currentThreadSlot = slot;
+                imp->currentThreadData = &imp->threadData(slot);
+
+                for (Int32 i = 0; i < views; i++)
+                    solidViews[i]->setPos((i * 7 + frame) % 1920, (i * 13 + frame) % 1080);
+
+                imp->clearTmpVariables(imp->currentThreadData);
+                imp->updateFlatViews(sceneView);
+
+                for (UInt32 i = imp->flat.views.size(); i-- > 0;)
+                    imp->calcNewDamage(i);
+
+                renderMutex.unlock();
+            }
+        });
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    for (Int32 slot = 1; slot <= outputs; slot++)
+        sceneView->imp()->removeThreadData(slot);
+
+    sceneView->imp()->fb = nullptr;
+    return ms(t0, t1) / (frames * outputs);
+}
+
+int main(int argc, char *argv[])
+{
+    const Int32 views { argc > 1 ? atoi(argv[1]) : 5000 };
+    const Int32 frames { argc > 2 ? atoi(argv[2]) : 200 };
+
+    // Not started, views only need it to exist
+    LCompositor compositor;
+
+    for (Int32 outputs = 2; outputs <= 4; outputs++)
+    {
+        // Previous implementation
+        std::vector<std::map<std::thread::id, ViewThreadData>> maps(views);
+
+        const double mapMs { run(outputs, views, frames, [&](Int32 i, Int32) -> ViewThreadData&
+        {
+            return maps[i][std::this_thread::get_id()];
+        })};
+
+        // Dense slots
+        std::vector<std::unique_ptr<LView::LViewPrivate>> privates(views);
+
+        for (auto &p : privates)
+            p = std::make_unique<LView::LViewPrivate>();
+
+        const double slotsMs { run(outputs, views, frames, [&](Int32 i, Int32 slot) -> ViewThreadData&
+        {
+            return privates[i]->threadData(slot);
+        })};
+
+        printf("%d outputs, %d views: std::map %.3f ms/frame, dense slots %.3f ms/frame (%.1f%%)\n",
+               outputs, views, mapMs, slotsMs, 100.0 * (mapMs - slotsMs) / mapMs);
+
+        printf("%d outputs, %d views: calcNewDamage() with dense slots %.3f ms/frame\n",
+               outputs, views, runScene(outputs, views, frames));
+    }
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+# exec <compositor> [LBenchmark options and scenarios]
+COMPOSITOR=${1:-louvre-weston-clone}
+shift
+NAME=$(basename $COMPOSITOR)
+$COMPOSITOR &
+export COM_PID=$!
+taskset -cp 0 $COM_PID
+sleep 2
+./LBenchmark -c $NAME -o Suite-$NAME.json "$@"
+kill -9 $COM_PID
+sleep 1
+reset
+echo "PID: $COM_PID"
+cat Suite-$NAME.json
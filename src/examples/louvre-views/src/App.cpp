@@ -86,21 +86,27 @@ App::App(const char *appName, const char *appExec, const char *iconPath) :
     else
         exec = appExec;
 
-    LTexture *tmp = { nullptr };
+    // Show the default icon until the app icon is decoded
+    texture = G::textures()->defaultAppIcon;
 
     if (iconPath)
-        tmp = LOpenGL::loadTexture(iconPath);
-
-    if (tmp)
     {
-        LTexture *hires = tmp->copyB(LSize(DOCK_ITEM_HEIGHT * 4));
-        texture = hires->copyB(LSize(DOCK_ITEM_HEIGHT * 2));
-        delete hires;
-        delete tmp;
-    }
+        iconRequest = LOpenGL::loadTextureAsync(iconPath, [this](LTexture *icon)
+        {
+            iconRequest = 0;
+
+            if (!icon)
+                return;
 
-    if (!texture)
-        texture = G::textures()->defaultAppIcon;
+            texture = icon;
+
+            for (DockApp *dapp : dockApps)
+            {
+                dapp->setTexture(texture);
+                dapp->dock->update();
+            }
+        }, LSize(DOCK_ITEM_HEIGHT * 2));
+    }
 
     for (Output *output : G::outputs())
         new DockApp(this, output->dock);
@@ -110,6 +116,7 @@ App::App(const char *appName, const char *appExec, const char *iconPath) :
 
 App::~App()
 {
+    LOpenGL::cancelTextureLoad(iconRequest);
     launchAnimation.stop();
 
     while (!dockApps.empty())
@@ -55,6 +55,9 @@ public:
     // App icon texture
     LTexture *texture { nullptr };
 
+    // Pending LOpenGL::loadTextureAsync() request of the icon
+    UInt64 iconRequest { 0 };
+
     // Name texture (for topbar)
     LTexture *nameTexture { nullptr };
 
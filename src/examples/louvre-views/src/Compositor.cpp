@@ -117,6 +117,9 @@ void Compositor::uninitialized()
     for (Client *c : (std::vector<Client*>&)clients())
         if (c->pid != -1)
             kill(c->pid, SIGKILL);
+
+    // LXCursorTheme instances must be destroyed before the compositor is uninitialized
+    G::unloadCursors();
 }
 
 LClient *Compositor::createClientRequest(const void *params)
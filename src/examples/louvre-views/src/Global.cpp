@@ -1,6 +1,7 @@
 #include <LLog.h>
 #include <string.h>
 #include <LXCursor.h>
+#include <LXCursorTheme.h>
 #include <LCursor.h>
 #include <LOpenGL.h>
 #include <LSeat.h>
@@ -16,6 +17,7 @@
 #include "Surface.h"
 
 static G::Cursors xCursors;
+static LXCursorTheme *xCursorTheme { nullptr };
 static G::Fonts _fonts;
 static std::vector<App*>_apps;
 static Tooltip *_tooltip;
@@ -149,22 +151,57 @@ Tooltip *G::tooltip()
     return _tooltip;
 }
 
-void G::loadCursors()
+static void assignCursors(LXCursorTheme *theme)
 {
-    xCursors.arrow = LXCursor::loadXCursorB("arrow");
+    // Use the size of the HiDPI outputs if any
+    Float32 scale { 1.f };
+
+    for (LOutput *output : G::compositor()->outputs())
+        scale = std::max(scale, output->scale());
+
+    xCursors.arrow = (LXCursor*)theme->image("arrow", scale);
 
     if (xCursors.arrow)
         LCompositor::compositor()->cursor()->replaceDefaultB(xCursors.arrow->texture(), xCursors.arrow->hotspotB());
 
-    xCursors.hand2 = LXCursor::loadXCursorB("hand2");
-    xCursors.top_left_corner = LXCursor::loadXCursorB("top_left_corner");
-    xCursors.top_right_corner= LXCursor::loadXCursorB("top_right_corner");
-    xCursors.bottom_left_corner = LXCursor::loadXCursorB("bottom_left_corner");
-    xCursors.bottom_right_corner = LXCursor::loadXCursorB("bottom_right_corner");
-    xCursors.left_side = LXCursor::loadXCursorB("left_side");
-    xCursors.top_side = LXCursor::loadXCursorB("top_side");
-    xCursors.right_side = LXCursor::loadXCursorB("right_side");
-    xCursors.bottom_side = LXCursor::loadXCursorB("bottom_side");
+    xCursors.hand2 = (LXCursor*)theme->image("hand2", scale);
+    xCursors.top_left_corner = (LXCursor*)theme->image("top_left_corner", scale);
+    xCursors.top_right_corner = (LXCursor*)theme->image("top_right_corner", scale);
+    xCursors.bottom_left_corner = (LXCursor*)theme->image("bottom_left_corner", scale);
+    xCursors.bottom_right_corner = (LXCursor*)theme->image("bottom_right_corner", scale);
+    xCursors.left_side = (LXCursor*)theme->image("left_side", scale);
+    xCursors.top_side = (LXCursor*)theme->image("top_side", scale);
+    xCursors.right_side = (LXCursor*)theme->image("right_side", scale);
+    xCursors.bottom_side = (LXCursor*)theme->image("bottom_side", scale);
+}
+
+void G::loadCursors()
+{
+    // Parsed in the background, assigned when loaded and again when an output scale changes
+    xCursorTheme = new LXCursorTheme(nullptr, 64, &assignCursors);
+    xCursorTheme->preload({
+        "arrow",
+        "hand2",
+        "top_left_corner",
+        "top_right_corner",
+        "bottom_left_corner",
+        "bottom_right_corner",
+        "left_side",
+        "top_side",
+        "right_side",
+        "bottom_side" });
+}
+
+void G::unloadCursors()
+{
+    if (!xCursorTheme)
+        return;
+
+    // The cursor may still be using one of the theme textures
+    LCompositor::compositor()->cursor()->setVisible(false);
+    delete xCursorTheme;
+    xCursorTheme = nullptr;
+    xCursors = Cursors();
 }
 
 G::Cursors &G::cursors()
@@ -177,6 +214,8 @@ G::Textures *G::textures()
     return &_textures;
 }
 
+/* Loaded synchronously, unlike the wallpapers and app icons, since setTexViewConf() copies the atlas
+ * into views created during initialization and the UI must be complete in the first frame */
 void G::loadTextures()
 {
     LTexture *tmp = loadAssetsTexture("dock_app.png");
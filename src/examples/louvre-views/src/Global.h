@@ -197,6 +197,7 @@ public:
 
     // Cursors
     static void loadCursors();
+    static void unloadCursors();
     static Cursors &cursors();
 
     // Textures
@@ -35,65 +35,55 @@ void Output::loadWallpaper()
         bufferSize = currentMode()->sizeB();
     }
 
-    if (wallpaperView)
-    {
-        if (wallpaperView->texture())
-        {
-            if (bufferSize == wallpaperView->texture()->sizeB())
-            {
-                wallpaperView->enableDstSize(true);
-                wallpaperView->setDstSize(size());
-                return;
-            }
-
-            delete wallpaperView->texture();
-        }
-    }
-    else
+    if (!wallpaperView)
     {
         wallpaperView = new LTextureView(nullptr, &G::compositor()->backgroundLayer);
         wallpaperView->enableParentOffset(false);
+        LRegion trans;
+        wallpaperView->setTranslucentRegion(&trans);
     }
 
-    LTexture *tmpWallpaper = LOpenGL::loadTexture(std::filesystem::path(getenvString("HOME")) / ".config/Louvre/wallpaper.jpg");
-
-    if (!tmpWallpaper)
-        tmpWallpaper = G::loadAssetsTexture("wallpaper.png", false);
+    // The current wallpaper is stretched until the new one is loaded
+    wallpaperView->enableDstSize(true);
+    wallpaperView->setDstSize(size());
+    wallpaperView->setPos(pos());
 
-    if (tmpWallpaper)
-    {
-        // Clip and scale wallpaper so that it covers the entire screen
+    if (wallpaperView->texture() && bufferSize == wallpaperView->texture()->sizeB())
+        return;
 
-        LRect srcB;
-        Float32 w = Float32(bufferSize.w() * tmpWallpaper->sizeB().h()) / Float32(bufferSize.h());
+    LOpenGL::cancelTextureLoad(wallpaperRequest);
 
-        if (w >= tmpWallpaper->sizeB().w())
+    // Clipped and scaled by the texture loader threads so that it covers the entire screen
+    wallpaperRequest = LOpenGL::loadTextureAsync(std::filesystem::path(getenvString("HOME")) / ".config/Louvre/wallpaper.jpg",
+    [this, bufferSize](LTexture *texture)
+    {
+        if (texture)
         {
-            srcB.setX(0);
-            srcB.setW(tmpWallpaper->sizeB().w());
-            srcB.setH((tmpWallpaper->sizeB().w() * bufferSize.h()) / bufferSize.w());
-            srcB.setY((tmpWallpaper->sizeB().h() - srcB.h()) / 2);
+            wallpaperRequest = 0;
+            setWallpaper(texture);
+            return;
         }
-        else
+
+        wallpaperRequest = LOpenGL::loadTextureAsync(G::compositor()->defaultAssetsPath() / "wallpaper.png",
+        [this](LTexture *texture)
         {
-            srcB.setY(0);
-            srcB.setH(tmpWallpaper->sizeB().h());
-            srcB.setW((tmpWallpaper->sizeB().h() * bufferSize.w()) / bufferSize.h());
-            srcB.setX((tmpWallpaper->sizeB().w() - srcB.w()) / 2);
-        }
-        wallpaperView->setTexture(tmpWallpaper->copyB(bufferSize, srcB));
-        wallpaperView->enableDstSize(true);
-        wallpaperView->setDstSize(size());
-        delete tmpWallpaper;
-    }
-    else
-    {
-        wallpaperView->setVisible(false);
-    }
+            wallpaperRequest = 0;
+            setWallpaper(texture);
+        }, bufferSize, true);
+    }, bufferSize, true);
+}
+
+void Output::setWallpaper(LTexture *texture)
+{
+    if (wallpaperView->texture())
+        delete wallpaperView->texture();
 
-    LRegion trans;
-    wallpaperView->setTranslucentRegion(&trans);
+    wallpaperView->setTexture(texture);
+    wallpaperView->setVisible(texture != nullptr);
+    wallpaperView->enableDstSize(true);
+    wallpaperView->setDstSize(size());
     wallpaperView->setPos(pos());
+    repaint();
 }
 
 void Output::setWorkspace(Workspace *ws, UInt32 animMs, Float32 curve, Float32 start)
@@ -467,6 +457,8 @@ void Output::paintGL()
 
 void Output::uninitializeGL()
 {
+    LOpenGL::cancelTextureLoad(wallpaperRequest);
+    wallpaperRequest = 0;
     G::compositor()->outputUnplugHandled = false;
 
     // Find another output
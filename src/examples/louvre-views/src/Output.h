@@ -29,6 +29,7 @@ public:
     void setGammaRequest(LClient *client, const LGammaTable *gamma) override;
 
     void loadWallpaper();
+    void setWallpaper(LTexture *texture);
 
     void setWorkspace(Workspace *ws, UInt32 animMs, Float32 curve = 2.f, Float32 start = 0.f);
     void updateWorkspacesPos();
@@ -61,6 +62,9 @@ public:
     // Wallpaper for this output
     LTextureView *wallpaperView = nullptr;
 
+    // Pending LOpenGL::loadTextureAsync() request of the wallpaper
+    UInt64 wallpaperRequest = 0;
+
     // Dock for this output
     Dock *dock = nullptr;
 };
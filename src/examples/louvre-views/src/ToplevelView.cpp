@@ -25,14 +25,17 @@ static void onPointerEnterResizeArea(InputRect *rect, void *data, const LPoint &
 {
     ToplevelView *view = (ToplevelView*)rect->parent();
     Pointer *pointer = (Pointer*)view->seat()->pointer();
-    LXCursor *cursor = (LXCursor*)data;
+    // Points to a G::cursors() field, which is assigned once the cursor theme is loaded
+    LXCursor *cursor = data ? *(LXCursor**)data : nullptr;
 
     if (pointer->resizingToplevel() || pointer->movingToplevel())
         return;
 
     if (data)
     {
-        G::compositor()->cursor()->setTextureB(cursor->texture(), cursor->hotspotB());
+        if (cursor)
+            G::compositor()->cursor()->setTextureB(cursor->texture(), cursor->hotspotB());
+
         pointer->cursorOwner = view;
     }
     // Topbar input
@@ -187,14 +190,14 @@ ToplevelView::ToplevelView(Toplevel *toplevel) :
     maskBR(G::DecorationMaskBR, &sceneBR),
     topbarInput(this, nullptr),
     buttonsContainer(this, this),
-    resizeT(this, G::cursors().top_side, LToplevelRole::ResizeEdge::Top),
-    resizeB(this, G::cursors().bottom_side, LToplevelRole::ResizeEdge::Bottom),
-    resizeL(this, G::cursors().left_side, LToplevelRole::ResizeEdge::Left),
-    resizeR(this, G::cursors().right_side, LToplevelRole::ResizeEdge::Right),
-    resizeTL(this, G::cursors().top_left_corner, LToplevelRole::ResizeEdge::TopLeft),
-    resizeTR(this, G::cursors().top_right_corner, LToplevelRole::ResizeEdge::TopRight),
-    resizeBL(this, G::cursors().bottom_left_corner, LToplevelRole::ResizeEdge::BottomLeft),
-    resizeBR(this, G::cursors().bottom_right_corner, LToplevelRole::ResizeEdge::BottomRight),
+    resizeT(this, &G::cursors().top_side, LToplevelRole::ResizeEdge::Top),
+    resizeB(this, &G::cursors().bottom_side, LToplevelRole::ResizeEdge::Bottom),
+    resizeL(this, &G::cursors().left_side, LToplevelRole::ResizeEdge::Left),
+    resizeR(this, &G::cursors().right_side, LToplevelRole::ResizeEdge::Right),
+    resizeTL(this, &G::cursors().top_left_corner, LToplevelRole::ResizeEdge::TopLeft),
+    resizeTR(this, &G::cursors().top_right_corner, LToplevelRole::ResizeEdge::TopRight),
+    resizeBL(this, &G::cursors().bottom_left_corner, LToplevelRole::ResizeEdge::BottomLeft),
+    resizeBR(this, &G::cursors().bottom_right_corner, LToplevelRole::ResizeEdge::BottomRight),
     closeButton(&buttonsContainer, this, ToplevelButton::Close),
     minimizeButton(&buttonsContainer, this, ToplevelButton::Minimize),
     maximizeButton(&buttonsContainer, this, ToplevelButton::Maximize),
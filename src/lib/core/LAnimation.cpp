@@ -2,10 +2,14 @@
 #include <private/LCompositorPrivate.h>
 #include <LTime.h>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Maximum displacement from the target considered settled
+#define LANIMATION_SPRING_EPSILON 0.001f
 
 LAnimation::LAnimation(UInt32 durationMs, const Callback &onUpdate, const Callback &onFinish) : LPRIVATE_INIT_UNIQUE(LAnimation)
 {
-    compositor()->imp()->animations.push_back(this);
     imp()->duration = durationMs;
     imp()->onUpdate = onUpdate;
     imp()->onFinish = onFinish;
@@ -14,13 +18,7 @@ LAnimation::LAnimation(UInt32 durationMs, const Callback &onUpdate, const Callba
 LAnimation::~LAnimation()
 {
     stop();
-
-    auto it = std::find(compositor()->imp()->animations.begin(), compositor()->imp()->animations.end(), this);
-    if (it != compositor()->imp()->animations.end())
-    {
-        compositor()->imp()->animationsVectorChanged = true;
-        compositor()->imp()->animations.erase(it);
-    }
+    compositor()->imp()->removeAnimation(this);
 }
 
 void LAnimation::oneShot(UInt32 durationMs, const Callback &onUpdate, const Callback &onFinish)
@@ -59,19 +57,86 @@ UInt32 LAnimation::duration() const
     return imp()->duration;
 }
 
+void LAnimation::setEasing(Easing easing)
+{
+    if (imp()->running || easing == Custom || easing == Spring)
+        return;
+
+    imp()->easing = easing;
+    imp()->easingCurve = nullptr;
+}
+
+void LAnimation::setEasingCurve(const EasingCurve &curve)
+{
+    if (imp()->running)
+        return;
+
+    imp()->easingCurve = curve;
+    imp()->easing = curve ? Custom : Linear;
+}
+
+void LAnimation::setSpring(Float32 stiffness, Float32 damping, Float32 mass)
+{
+    if (imp()->running || stiffness <= 0.f || mass <= 0.f || damping < 0.f)
+        return;
+
+    imp()->easing = Spring;
+    imp()->easingCurve = nullptr;
+    imp()->spring.stiffness = stiffness;
+    imp()->spring.damping = damping;
+    imp()->spring.mass = mass;
+
+    // Time until the envelope of the slowest mode falls below epsilon
+    const Float64 w0 { sqrt(stiffness/mass) };
+    const Float64 zeta { damping / (2.0 * sqrt(stiffness * mass)) };
+    Float64 decay;
+
+    if (zeta < 1.0)
+        decay = zeta * w0;
+    else
+        decay = w0 * (zeta - sqrt(zeta * zeta - 1.0));
+
+    Float64 seconds { decay > 0.0 ? -log(LANIMATION_SPRING_EPSILON) / decay : 10.0 };
+
+    // The critically and overdamped solutions have a polynomial factor, extend until settled
+    while (seconds < 60.0 && fabs(1.0 - imp()->springValue(seconds)) > LANIMATION_SPRING_EPSILON)
+        seconds *= 1.25;
+
+    imp()->duration = (UInt32)ceil(std::min(seconds, 60.0) * 1000.0);
+}
+
+LAnimation::Easing LAnimation::easing() const
+{
+    return imp()->easing;
+}
+
+Float32 LAnimation::progress() const
+{
+    return imp()->progress;
+}
+
 Float32 LAnimation::value() const
 {
     return imp()->value;
 }
 
+LOutput *LAnimation::output() const
+{
+    return imp()->output;
+}
+
 void LAnimation::start()
 {
     if (imp()->running)
         return;
 
     imp()->value = 0.f;
-    imp()->beginTime = LTime::ms();
+    imp()->progress = 0.f;
+    imp()->beginTime = LAnimationPrivate::timespecToNs(LTime::ns());
+    imp()->lastTimes.clear();
+    imp()->output = nullptr;
     imp()->running = true;
+    compositor()->imp()->addAnimation(this);
     compositor()->repaintAllOutputs();
 }
 
@@ -81,8 +146,13 @@ void LAnimation::stop()
         return;
 
     imp()->value = 1.f;
+    imp()->progress = 1.f;
     imp()->running = false;
 
+    // One-shot animations keep their slot until destroyed by processAnimations()
+    if (!imp()->destroyOnFinish)
+        compositor()->imp()->removeAnimation(this);
+
     if (imp()->onFinish)
         imp()->onFinish(this);
 
@@ -94,3 +164,66 @@ bool LAnimation::running() const
 {
     return imp()->running;
 }
+
+void LAnimation::LAnimationPrivate::update(Int64 time)
+{
+    const Int64 elapsed { std::max(time - beginTime, (Int64)0) };
+    const Int64 durationNs { (Int64)duration * 1000000 };
+
+    if (elapsed >= durationNs)
+    {
+        progress = 1.f;
+        value = 1.f;
+        return;
+    }
+
+    progress = (Float32)((Float64)elapsed/(Float64)durationNs);
+
+    switch (easing)
+    {
+    case Linear:
+        value = progress;
+        break;
+    case EaseIn:
+        value = progress * progress * progress;
+        break;
+    case EaseOut:
+        value = 1.f - powf(1.f - progress, 3.f);
+        break;
+    case EaseInOut:
+        value = progress < 0.5f ? 4.f * progress * progress * progress : 1.f - powf(-2.f * progress + 2.f, 3.f) / 2.f;
+        break;
+    case Custom:
+        value = easingCurve(progress);
+        break;
+    case Spring:
+        value = springValue((Float64)elapsed / 1000000000.0);
+        break;
+    }
+}
+
+Float32 LAnimation::LAnimationPrivate::springValue(Float64 t) const
+{
+    // Displacement from 1 starting at rest at 0
+    const Float64 w0 { sqrt(spring.stiffness/spring.mass) };
+    const Float64 zeta { spring.damping / (2.0 * sqrt(spring.stiffness * spring.mass)) };
+    Float64 displacement;
+
+    if (zeta < 1.0)
+    {
+        const Float64 wd { w0 * sqrt(1.0 - zeta * zeta) };
+        displacement = exp(-zeta * w0 * t) * (-cos(wd * t) - (zeta * w0 / wd) * sin(wd * t));
+    }
+    else if (zeta == 1.0)
+        displacement = -(1.0 + w0 * t) * exp(-w0 * t);
+    else
+    {
+        const Float64 root { sqrt(zeta * zeta - 1.0) };
+        const Float64 r1 { -w0 * (zeta - root) };
+        const Float64 r2 { -w0 * (zeta + root) };
+        const Float64 a { r2 / (r1 - r2) };
+        displacement = a * exp(r1 * t) + (-1.0 - a) * exp(r2 * t);
+    }
+
+    return (Float32)(1.0 + displacement);
+}
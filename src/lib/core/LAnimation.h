@@ -9,10 +9,10 @@
  * @brief Time-based animations.
  *
  * An LAnimation can be used for creating graphical animations. It has a fixed duration in milliseconds, and is synchronized
- * with each output's refresh rate.\n
+ * with each output's refresh rate, using the predicted presentation time of the output being repainted as time source.\n
  * After started, the `onUpdate()` callback is triggered before each LOutput::paintGL() call, allowing you to
- * access the value() property, which is a 32-bit floating-point number linearly interpolated from 0.f to 1.f,
- * indicating the completion percentage of the animation.
+ * access the value() property, which is a 32-bit floating-point number going from 0.f to 1.f according to the easing curve
+ * (linearly by default), indicating the completion percentage of the animation.
  *
  * @note It is essential to manually invoke LOutput::repaint() on the outputs you are animating; otherwise, the `onUpdate()` callback may not be invoked.
  *
@@ -27,6 +27,40 @@ public:
      */
     using Callback = std::function<void(LAnimation*)>;
 
+    /**
+     * @brief Custom easing curve.
+     *
+     * Maps the linear progress() (from 0.f to 1.f) to the value() property.
+     * It should return 0.f for 0.f and 1.f for 1.f.
+     */
+    using EasingCurve = std::function<Float32(Float32)>;
+
+    /**
+     * @brief Easing curves.
+     *
+     * Curve used to map the linear progress() to the value() property.
+     */
+    enum Easing : UInt8
+    {
+        /// The value() is equal to progress()
+        Linear,
+
+        /// Cubic, starts slow and accelerates
+        EaseIn,
+
+        /// Cubic, starts fast and decelerates
+        EaseOut,
+
+        /// Cubic, slow at the beginning and end
+        EaseInOut,
+
+        /// Custom curve assigned with setEasingCurve()
+        Custom,
+
+        /// Damped spring assigned with setSpring()
+        Spring
+    };
+
     /**
      * @brief Creates a reusable animation.
      *
@@ -101,15 +135,79 @@ public:
      */
     UInt32 duration() const;
 
+    /**
+     * @brief Sets the easing curve.
+     *
+     * Changes how the value() property evolves in time. The default curve is @ref Linear.
+     *
+     * @note It is not permissible to invoke this method while the animation is in progress, and attempting to do so will yield no results.
+     *       To assign a @ref Custom curve or a @ref Spring use setEasingCurve() or setSpring() instead.
+     *
+     * @param easing One of @ref Linear, @ref EaseIn, @ref EaseOut or @ref EaseInOut.
+     */
+    void setEasing(Easing easing);
+
+    /**
+     * @brief Sets a custom easing curve.
+     *
+     * @note It is not permissible to invoke this method while the animation is in progress, and attempting to do so will yield no results.
+     *
+     * @param curve Function mapping the linear progress to the value() property. Passing `nullptr` restores the @ref Linear curve.
+     */
+    void setEasingCurve(const EasingCurve &curve);
+
+    /**
+     * @brief Animates the value() property using a damped spring.
+     *
+     * The value() starts at 0.f and settles at 1.f following a damped harmonic oscillator, it can exceed 1.f if the spring is underdamped.
+     * The duration is automatically set to the time the spring needs to settle.
+     *
+     * @note It is not permissible to invoke this method while the animation is in progress, and attempting to do so will yield no results.
+     *
+     * @param stiffness Spring stiffness, must be greater than 0.
+     * @param damping Damping coefficient, a value of `2 * sqrt(stiffness * mass)` is critically damped.
+     * @param mass Mass attached to the spring, must be greater than 0.
+     */
+    void setSpring(Float32 stiffness, Float32 damping, Float32 mass = 1.f);
+
+    /**
+     * @brief Current easing curve.
+     */
+    Easing easing() const;
+
     /**
      * @brief Returns a number linearly interpolated from 0 to 1.
      *
-     * This method returns a value indicating the percentage of completion of the animation. The value is linearly interpolated between 0 (start of the animation) and 1 (end of the animation).
+     * This method returns a value indicating the percentage of time elapsed since the animation started, relative to its duration.
      *
-     * @return The interpolated completion value ranging from 0 to 1.
+     * @return The linear completion value ranging from 0 to 1.
+     */
+    Float32 progress() const;
+
+    /**
+     * @brief Returns the animation value.
+     *
+     * The progress() mapped through the easing curve, going from 0 (start of the animation) to 1 (end of the animation).
+     * With the default @ref Linear curve it is equal to progress().
+     *
+     * @note Values are evaluated at the predicted presentation time of the output being repainted, so during
+     *       the `onUpdate()` callback they match the instant the frame is going to be displayed on output().
+     *       Each output has its own timeline: the callback is triggered before each paintGL() of every output,
+     *       and the value only goes backwards between outputs of different refresh rates or phases, never
+     *       within the frames of the same output.
+     *
+     * @return The eased completion value.
      */
     Float32 value() const;
 
+    /**
+     * @brief Output the value() was evaluated for.
+     *
+     * The output about to be repainted during the `onUpdate()` callback, or `nullptr` if the
+     * animation was processed without an output or has not been updated yet.
+     */
+    LOutput *output() const;
+
     /**
      * @brief Starts the animation.
      */
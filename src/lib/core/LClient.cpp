@@ -101,6 +101,11 @@ const std::vector<TearingControl::GTearingControlManager *> &LClient::tearingCon
     return imp()->tearingControlManagerGlobals;
 }
 
+const std::vector<ScreenCopy::GScreenCopyManager *> &LClient::screenCopyManagerGlobals() const
+{
+    return imp()->screenCopyManagerGlobals;
+}
+
 const std::vector<Viewporter::GViewporter *> &LClient::viewporterGlobals() const
 {
     return imp()->viewporterGlobals;
@@ -200,6 +200,13 @@ public:
      */
     const std::vector<Protocols::TearingControl::GTearingControlManager*> &tearingControlManagerGlobals() const;
 
+    /**
+     * Resources created when the client binds to the
+     * [zwlr_screencopy_manager_v1](https://wayland.app/protocols/wlr-screencopy-unstable-v1#zwlr_screencopy_manager_v1) global
+     * of the wlroots Screencopy protocol.
+     */
+    const std::vector<Protocols::ScreenCopy::GScreenCopyManager*> &screenCopyManagerGlobals() const;
+
     LPRIVATE_IMP_UNIQUE(LClient)
 };
 
@@ -1,4 +1,5 @@
 #include <protocols/Wayland/private/GOutputPrivate.h>
+#include <protocols/ScreenCopy/private/RScreenCopyFramePrivate.h>
 
 #include <private/LCompositorPrivate.h>
 #include <private/LClientPrivate.h>
@@ -8,6 +9,11 @@
 #include <private/LCursorPrivate.h>
 #include <private/LAnimationPrivate.h>
 #include <private/LViewPrivate.h>
+#include <private/LPainterPrivate.h>
+#include <private/LTracePrivate.h>
+#include <private/LPointerPrivate.h>
+#include <private/LXCursorThemePrivate.h>
+#include <private/LOpenGLPrivate.h>
 
 #include <LNamespaces.h>
 #include <LPopupRole.h>
@@ -133,7 +139,7 @@ bool LCompositor::start()
 {
     if (compositor() != this)
     {
-        LLog::warning("[LCompositor::start] Compositor already running. Two Louvre compositors can not live in the same process.");
+        LLOG_WARNING("[LCompositor::start] Compositor already running. Two Louvre compositors can not live in the same process.");
         return false;
     }
 
@@ -141,11 +147,17 @@ bool LCompositor::start()
 
     if (state() != CompositorState::Uninitialized)
     {
-        LLog::warning("[LCompositor::start] Attempting to start a compositor already running. Ignoring...");
+        LLOG_WARNING("[LCompositor::start] Attempting to start a compositor already running. Ignoring...");
         return false;
     }
 
     imp()->threadId = std::this_thread::get_id();
+    LTRACE_THREAD_NAME("Main");
+    imp()->threadsData.clear();
+    imp()->threadsData.reserve(8);
+    imp()->threadsData.emplace_back();
+    imp()->threadsData[LCompositorPrivate::MainThreadSlot].threadId = imp()->threadId;
+    imp()->threadsData[LCompositorPrivate::MainThreadSlot].used = true;
     imp()->state = CompositorState::Initializing;
 
     compositor()->imp()->epollFd = epoll_create1(EPOLL_CLOEXEC);
@@ -153,25 +165,25 @@ bool LCompositor::start()
 
     if (!imp()->initWayland())
     {
-        LLog::fatal("[LCompositor::start] Failed to init Wayland.");
+        LLOG_FATAL("[LCompositor::start] Failed to init Wayland.");
         goto fail;
     }
 
     if (!imp()->initSeat())
     {
-        LLog::fatal("[LCompositor::start] Failed to init seat.");
+        LLOG_FATAL("[LCompositor::start] Failed to init seat.");
         goto fail;
     }
 
     if (!imp()->initGraphicBackend())
     {
-        LLog::fatal("[LCompositor::start] Failed to init graphic backend.");
+        LLOG_FATAL("[LCompositor::start] Failed to init graphic backend.");
         goto fail;
     }
 
     if (!imp()->initInputBackend())
     {
-        LLog::fatal("[LCompositor::start] Failed to init input backend.");
+        LLOG_FATAL("[LCompositor::start] Failed to init input backend.");
         goto fail;
     }
 
@@ -205,6 +217,19 @@ Int32 LCompositor::processLoop(Int32 msTimeout)
     if (!seat()->enabled())
         msTimeout = 100;
 
+    // Poll main thread readbacks (e.g. hardware cursor) until they complete
+    else if (imp()->painter && !imp()->painter->imp()->pendingReadbacks.empty() && (msTimeout < 0 || msTimeout > 1))
+        msTimeout = 1;
+
+    // Wake up in time to dispatch coalesced pointer motion
+    if (seat()->enabled() && seat()->pointer())
+    {
+        const Int32 motionTimeout { seat()->pointer()->imp()->motionFlushTimeout() };
+
+        if (motionTimeout >= 0 && (msTimeout < 0 || msTimeout > motionTimeout))
+            msTimeout = motionTimeout;
+    }
+
     epoll_event events[3];
 
     Int32 nEvents = epoll_wait(imp()->epollFd,
@@ -212,6 +237,7 @@ Int32 LCompositor::processLoop(Int32 msTimeout)
                          3,
                          msTimeout);
 
+    LTRACE_SCOPE("processLoop");
     imp()->lock();
     imp()->sendPresentationTime();
     imp()->processRemovedGlobals();
@@ -236,6 +262,7 @@ Int32 LCompositor::processLoop(Int32 msTimeout)
         {
             if (seat()->enabled())
             {
+                LTRACE_SCOPE("dispatchClients");
                 wl_event_loop_dispatch(imp()->eventLoop, 0);
                 cursor()->imp()->textureUpdate();
                 flushClients();
@@ -255,10 +282,35 @@ Int32 LCompositor::processLoop(Int32 msTimeout)
         }
     }
 
+    // Outputs added with addOutputAsync() or changing mode with LOutput::setModeAsync()
+    if (imp()->asyncOutputOperations > 0)
+    {
+        const std::vector<LOutput*> outputsCopy { imp()->outputs };
+
+        for (LOutput *output : outputsCopy)
+            output->imp()->processAsyncOperation();
+    }
+
+    for (size_t i = 0; i < imp()->xCursorThemes.size(); i++)
+        imp()->xCursorThemes[i]->imp()->update();
+
+    // Textures requested with LOpenGL::loadTextureAsync()
+    LOpenGL::LOpenGLPrivate::processLoadedTextures(LCompositorPrivate::MainThreadSlot);
+
     if (seat()->enabled())
     {
-        imp()->destroyPendingRenderBuffers(nullptr);
+        if (seat()->pointer() && seat()->pointer()->imp()->motionFlushTimeout() == 0)
+        {
+            seat()->pointer()->imp()->flushMotion();
+            cursor()->imp()->textureUpdate();
+            flushClients();
+        }
+
+        imp()->destroyPendingRenderBuffers(LCompositorPrivate::MainThreadSlot);
         imp()->destroyNativeTextures(imp()->nativeTexturesToDestroy);
+
+        if (imp()->painter)
+            imp()->painter->imp()->processReadbacks(false);
     }
 
     if (state() == CompositorState::Uninitializing)
@@ -270,6 +322,7 @@ Int32 LCompositor::processLoop(Int32 msTimeout)
         while (!outputs().empty())
             removeOutput(outputs().back());
 
+        LOpenGL::LOpenGLPrivate::unitTextureLoader();
         imp()->unitInputBackend(true);
 
         if (imp()->cursor)
@@ -279,18 +332,24 @@ Int32 LCompositor::processLoop(Int32 msTimeout)
         imp()->unitSeat();
         imp()->unitWayland();
 
-        retry:
-        for (LAnimation *a : imp()->animations)
+        imp()->processingAnimations = true;
+
+        for (size_t i = 0; i < imp()->animations.size(); i++)
         {
+            LAnimation *a { imp()->animations[i] };
+
+            if (!a)
+                continue;
+
             if (a->imp()->destroyOnFinish)
-            {
                 delete a;
-                goto retry;
-            }
             else
                 a->stop();
         }
 
+        imp()->processingAnimations = false;
+        imp()->compactAnimations();
+
         while (!imp()->oneShotTimers.empty())
             delete imp()->oneShotTimers.back();
 
@@ -391,13 +450,14 @@ bool LCompositor::addOutput(LOutput *output)
             return true;
 
     imp()->outputs.push_back(output);
+    output->imp()->threadSlot = imp()->acquireThreadSlot();
 
     if (imp()->outputs.size() == 1)
         cursor()->imp()->setOutput(output);
 
     if (!output->imp()->initialize())
     {
-        LLog::error("[LCompositor::addOutput] Failed to initialize output %s.", output->name());
+        LLOG_ERROR("[LCompositor::addOutput] Failed to initialize output %s.", output->name());
         removeOutput(output);
         return false;
     }
@@ -405,6 +465,23 @@ bool LCompositor::addOutput(LOutput *output)
     return true;
 }
 
+bool LCompositor::addOutputAsync(LOutput *output)
+{
+    for (LOutput *o : outputs())
+        if (o == output)
+            return false;
+
+    imp()->outputs.push_back(output);
+    output->imp()->threadSlot = imp()->acquireThreadSlot();
+
+    if (imp()->outputs.size() == 1)
+        cursor()->imp()->setOutput(output);
+
+    output->imp()->state = LOutput::PendingInitialize;
+    output->imp()->startAsyncOperation(LOutput::LOutputPrivate::AsyncInitialize, nullptr);
+    return true;
+}
+
 void LCompositor::removeOutput(LOutput *output)
 {
     if (!isGraphicBackendInitialized())
@@ -420,6 +497,12 @@ void LCompositor::removeOutput(LOutput *output)
             if (output->threadId() == std::this_thread::get_id())
                 return;
 
+            // Wait for a pending asynchronous initialization or mode change
+            output->imp()->finishAsyncOperation(false);
+
+            // Stop moving its cursor plane from the input thread
+            cursor()->imp()->fastPathRemoveOutput(output);
+
             output->imp()->callLockACK.store(false);
             output->imp()->callLock.store(false);
             output->repaint();
@@ -446,9 +529,23 @@ void LCompositor::removeOutput(LOutput *output)
                 s->sendOutputLeaveEvent(output);
 
             for (LView *v : imp()->views)
-                v->imp()->removeThread(v, o->threadId());
+                v->imp()->removeThread(v, output->imp()->threadSlot);
+
+            imp()->releaseThreadSlot(output->imp()->threadSlot);
+            output->imp()->threadSlot = UINT32_MAX;
 
             LVectorRemoveOne(imp()->outputs, output);
+            cursor()->imp()->fastPathRefresh();
+
+            // Fail pending screen captures
+            while (!output->imp()->screenCopyFrames.empty())
+            {
+                Protocols::ScreenCopy::RScreenCopyFrame *frame { output->imp()->screenCopyFrames.back() };
+                frame->imp()->release();
+                frame->failed();
+            }
+
+            output->imp()->screenCopyDamage.clear();
 
             // Remove all wl_outputs from clients
             for (LClient *c : clients())
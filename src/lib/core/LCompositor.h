@@ -681,6 +681,23 @@ public:
      */
     bool addOutput(LOutput *output);
 
+    /**
+     * @brief Initializes the specified output asynchronously.
+     *
+     * Unlike addOutput(), this method returns immediately instead of blocking the main loop while the graphic backend
+     * creates the output rendering context and performs the mode setting, so clients and other outputs keep running
+     * normally, for example, while a monitor is being plugged.\n
+     * The output is added to outputs() immediately with the LOutput::PendingInitialize state, the LOutput::initializeGL() event
+     * is triggered from its rendering thread and LOutput::initializeCompleted() is invoked from the main thread once the operation finishes.
+     *
+     * @note Adding an already added output is a no-op.
+     *
+     * @param output The output to initialize, obtained from LSeat::outputs().
+     *
+     * @return `true` if the initialization was started, `false` if the output was already added.
+     */
+    bool addOutputAsync(LOutput *output);
+
     /**
      * @brief Uninitializes the specified output.
      *
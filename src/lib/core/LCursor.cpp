@@ -27,7 +27,7 @@ LCursor::LCursor() : LPRIVATE_INIT_UNIQUE(LCursor)
             LOUVRE_DEFAULT_CURSOR_STRIDE,
             DRM_FORMAT_ARGB8888,
             louvre_default_cursor_data()))
-        LLog::warning("[LCursor::LCursor] Failed to create default cursor texture.");
+        LLOG_WARNING("[LCursor::LCursor] Failed to create default cursor texture.");
 
     imp()->defaultTexture = &imp()->louvreTexture;
     imp()->defaultHotspotB = LPointF(9);
@@ -36,7 +36,7 @@ LCursor::LCursor() : LPRIVATE_INIT_UNIQUE(LCursor)
 
     if (imp()->glFramebuffer == 0)
     {
-        LLog::error("[LCursor::LCursor] Failed to create GL framebuffer.");
+        LLOG_ERROR("[LCursor::LCursor] Failed to create GL framebuffer.");
         imp()->hasFb = false;
         goto skipGL;
     }
@@ -46,7 +46,7 @@ LCursor::LCursor() : LPRIVATE_INIT_UNIQUE(LCursor)
 
     if (imp()->glRenderbuffer == 0)
     {
-        LLog::error("[LCursor::LCursor] Failed to create GL renderbuffer.");
+        LLOG_ERROR("[LCursor::LCursor] Failed to create GL renderbuffer.");
         imp()->hasFb = false;
         glDeleteFramebuffers(1, &imp()->glFramebuffer);
         goto skipGL;
@@ -58,7 +58,7 @@ LCursor::LCursor() : LPRIVATE_INIT_UNIQUE(LCursor)
 
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
     {
-        LLog::error("[LCursor::LCursor] GL_FRAMEBUFFER incomplete.");
+        LLOG_ERROR("[LCursor::LCursor] GL_FRAMEBUFFER incomplete.");
         imp()->hasFb = false;
         glDeleteRenderbuffers(1, &imp()->glRenderbuffer);
         glDeleteFramebuffers(1, &imp()->glFramebuffer);
@@ -134,6 +134,43 @@ void LCursor::setTextureB(const LTexture *texture, const LPointF &hotspot)
     imp()->update();
 }
 
+void LCursor::preloadTexture(const LTexture *texture)
+{
+    if (!texture || !texture->initialized() || !imp()->hasFb)
+        return;
+
+    for (LOutput *o : compositor()->outputs())
+    {
+        if (o->state() != LOutput::Initialized || !hasHardwareSupport(o))
+            continue;
+
+        const LSizeF sizeB { imp()->size * o->fractionalScale() };
+
+        if (!imp()->findCachedBuffer(texture, sizeB, o->transform()))
+            texture2Buffer(this, o, (LTexture*)texture, sizeB, o->transform(), false);
+    }
+}
+
+void LCursor::enableHardwareFastPath(bool enabled)
+{
+    if (enabled == hardwareFastPathEnabled())
+        return;
+
+    imp()->fastPath.mutex.lock();
+    imp()->fastPath.enabled = enabled;
+
+    if (!enabled)
+        imp()->fastPath.active = false;
+
+    imp()->fastPath.mutex.unlock();
+    imp()->posChanged = true;
+}
+
+bool LCursor::hardwareFastPathEnabled() const
+{
+    return imp()->fastPath.enabled;
+}
+
 void LCursor::move(Float32 x, Float32 y)
 {
     imp()->setPos(imp()->pos + LPointF(x,y));
@@ -177,10 +214,25 @@ void LCursor::setVisible(bool state)
 
     if (!visible())
     {
+        imp()->fastPath.mutex.lock();
+        imp()->fastPath.active = false;
+        imp()->fastPath.mutex.unlock();
+
         for (LOutput *o : compositor()->outputs())
+        {
+            o->imp()->cursorReadbackSerial++;
+
+            // Updated by textureUpdate() once the backend is done with them
+            if (o->state() != LOutput::Initialized)
+            {
+                imp()->textureChanged = true;
+                continue;
+            }
+
             compositor()->imp()->graphicBackend->outputSetCursorTexture(
                         o,
                         nullptr);
+        }
     }
     else if (texture())
     {
@@ -214,7 +266,8 @@ bool LCursor::visible() const
 
 bool LCursor::hasHardwareSupport(const LOutput *output) const
 {
-    if (!imp()->hasFb)
+    // The backend may be initializing it or changing its mode from another thread
+    if (!imp()->hasFb || output->state() != LOutput::Initialized)
         return false;
 
     return compositor()->imp()->graphicBackend->outputHasHardwareCursorSupport((LOutput*)output);
@@ -73,6 +73,20 @@ public:
      */
     void setTextureB(const LTexture *texture, const LPointF &hotspot);
 
+    /**
+     * @brief Pre-render a texture for hardware cursor planes.
+     *
+     * Converting a texture into a hardware cursor buffer requires a render and readback, which Louvre caches
+     * for the most recently used textures (keyed by texture, size, scale and transform).
+     * This method fills the cache in advance for each initialized output with hardware cursor support, using the current cursor size,
+     * so that a later setTextureB() call with the same texture only needs a copy. Useful for example to pre-warm the shapes of an LXCursor theme.
+     *
+     * @note Changes to the texture content, the cursor size or the outputs scale/transform invalidate the cached buffers.
+     *
+     * @param texture The texture to pre-render.
+     */
+    void preloadTexture(const LTexture *texture);
+
     /**
      * @brief Get the current cursor texture.
      */
@@ -220,6 +234,7 @@ public:
      * @brief Check for hardware compositing support.
      *
      * Indicates whether the specified output supports hardware compositing.
+     * Always `false` for outputs that are not in the LOutput::Initialized state.
      *
      * @return `true` if hardware compositing is supported and `false` otherwise.
      */
@@ -234,6 +249,28 @@ public:
      */
     LOutput *output() const;
 
+    /**
+     * @brief Move hardware cursor planes directly from input events.
+     *
+     * When the input backend reads events from a dedicated thread (see the **LOUVRE_INPUT_THREAD** environment variable),
+     * relative pointer motion immediately updates the position of the cursor planes of outputs with hardware cursor support,
+     * clamped to the outputs layout, without waiting for the main thread. The position is later reconciled with pos() once
+     * the event is processed by LPointer::pointerMoveEvent(), so the cursor remains smooth even when the main thread is busy.
+     *
+     * Disable it if your LPointer::pointerMoveEvent() override does not move the cursor according to the relative motion
+     * (for example while the pointer is locked). Enabled by default.
+     *
+     * @param enabled `true` to enable the fast path, `false` to disable it.
+     */
+    void enableHardwareFastPath(bool enabled);
+
+    /**
+     * @brief Checks if the hardware cursor fast path is enabled.
+     *
+     * @see enableHardwareFastPath()
+     */
+    bool hardwareFastPathEnabled() const;
+
     /**
      * @brief Vector of intersected outputs.
      *
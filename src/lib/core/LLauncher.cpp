@@ -120,25 +120,25 @@ pid_t LLauncher::startDaemon(const std::string &name)
 
     if (daemonPID != -1)
     {
-        LLog::error("[LLauncher::startDaemon] Failed to start daemon, already running.");
+        LLOG_ERROR("[LLauncher::startDaemon] Failed to start daemon, already running.");
         goto error;
     }
 
     if (LCompositor::compositor())
     {
-        LLog::error("[LLauncher::startDaemon] Failed to start daemon. Must be launched before an LCompositor instance is created.");
+        LLOG_ERROR("[LLauncher::startDaemon] Failed to start daemon. Must be launched before an LCompositor instance is created.");
         goto error;
     }
 
     if (pipe(pipeA) != 0)
     {
-        LLog::error("[LLauncher::startDaemon] Failed to start daemon. Failed to create pipe: %s.", strerror(errno));
+        LLOG_ERROR("[LLauncher::startDaemon] Failed to start daemon. Failed to create pipe: %s.", strerror(errno));
         goto error;
     }
 
     if (pipe(pipeB) != 0)
     {
-        LLog::error("[LLauncher::startDaemon] Failed to start daemon. Failed to create pipe: %s.", strerror(errno));
+        LLOG_ERROR("[LLauncher::startDaemon] Failed to start daemon. Failed to create pipe: %s.", strerror(errno));
         goto closePipeA;
     }
 
@@ -147,7 +147,7 @@ pid_t LLauncher::startDaemon(const std::string &name)
 
     if (daemonPID == -1)
     {
-        LLog::error("[LLauncher::startDaemon] Failed to start daemon. Failed to create daemon fork: %s.", strerror(errno));
+        LLOG_ERROR("[LLauncher::startDaemon] Failed to start daemon. Failed to create daemon fork: %s.", strerror(errno));
         goto closePipeB;
     }
     else if (daemonPID == 0)
@@ -156,7 +156,7 @@ pid_t LLauncher::startDaemon(const std::string &name)
         Int32 ret = daemonLoop();
         close(pipeA[0]);
         close(pipeB[1]);
-        LLog::debug("[%s] Daemon exited with status %d.", name.c_str(), ret);
+        LLOG_DEBUG("[%s] Daemon exited with status %d.", name.c_str(), ret);
 
         if (daemonGID != -1)
             kill(-daemonGID , SIGTERM);
@@ -167,7 +167,7 @@ pid_t LLauncher::startDaemon(const std::string &name)
     {
         close(pipeA[0]);
         close(pipeB[1]);
-        LLog::debug("[LLauncher::startDaemon] LLauncher daemon started successfully with PID: %d.", daemonPID);
+        LLOG_DEBUG("[LLauncher::startDaemon] LLauncher daemon started successfully with PID: %d.", daemonPID);
         return daemonPID;
     }
 
@@ -190,13 +190,13 @@ pid_t LLauncher::launch(const std::string &command)
 {
     if (daemonPID < 0)
     {
-        LLog::error("[LLauncher::launch] Can not launch %s. Daemon is not running.", command.c_str());
+        LLOG_ERROR("[LLauncher::launch] Can not launch %s. Daemon is not running.", command.c_str());
         return -1;
     }
 
     if (command.empty())
     {
-        LLog::error("[LLauncher::launch] Can not launch %s. Invalid command.", command.c_str());
+        LLOG_ERROR("[LLauncher::launch] Can not launch %s. Invalid command.", command.c_str());
         return -1;
     }
 
@@ -247,9 +247,9 @@ pid_t LLauncher::launch(const std::string &command)
             pid_t pid = atoi(res.c_str());
 
             if (pid > 0)
-                LLog::debug("[LLauncher::launch] Command %s executed successfuly. PID: %d.", command.c_str(), pid);
+                LLOG_DEBUG("[LLauncher::launch] Command %s executed successfuly. PID: %d.", command.c_str(), pid);
             else
-                LLog::error("[LLauncher::launch] Command %s failed. PID: %d.", command.c_str(), pid);
+                LLOG_ERROR("[LLauncher::launch] Command %s failed. PID: %d.", command.c_str(), pid);
 
             return pid;
         }
@@ -260,7 +260,7 @@ pid_t LLauncher::launch(const std::string &command)
     return -1;
 
     stop:
-    LLog::error("[LLauncher::launch] Command %s failed. Daemon died.", command.c_str());
+    LLOG_ERROR("[LLauncher::launch] Command %s failed. Daemon died.", command.c_str());
     stopDaemon();
     return -1;
 }
@@ -275,5 +275,5 @@ void LLauncher::stopDaemon()
     close(pipeB[0]);
     close(pipeA[1]);
 
-    LLog::debug("[LLauncher::stopDaemon] Daemon stopped.");
+    LLOG_DEBUG("[LLauncher::stopDaemon] Daemon stopped.");
 }
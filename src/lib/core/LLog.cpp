@@ -1,9 +1,16 @@
 #include <LLog.h>
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
 #include <stdio.h>
 #include <stdarg.h>
 #include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
 
 #define KNRM  "\x1B[0m"
 #define KRED  "\x1B[31m"
@@ -16,10 +23,341 @@
 
 #define BRELN "\n"
 
+// Entries per thread, must be a power of two
+#define RING_SIZE 512
+#define ENTRY_TEXT_SIZE 496
+
+// Time after which the writer prints the repeat count of a message that is no longer being repeated
+#define REPEATS_TIMEOUT_MS 500
+
 int level = 0;
 
 using namespace Louvre;
 
+enum Level : UInt32
+{
+    Log,
+    Fatal,
+    Error,
+    Warning,
+    Debug
+};
+
+struct Entry
+{
+    UInt64 time;
+    Level level;
+    Char8 text[ENTRY_TEXT_SIZE];
+};
+
+/* Single producer (the owner thread), single consumer (the writer thread) */
+struct Ring
+{
+    std::atomic<UInt32> head { 0 };
+    std::atomic<UInt32> tail { 0 };
+    std::atomic<UInt32> dropped { 0 };
+
+    // Set when the owner thread exits, the writer deletes it once empty
+    std::atomic<bool> orphan { false };
+    Char8 tag[16];
+    Entry entries[RING_SIZE];
+
+    // Last message (only accessed by the owner thread)
+    Char8 lastText[ENTRY_TEXT_SIZE] {};
+    Level lastLevel { Level(UINT32_MAX) }; // None yet
+
+    /* Level of the last message (high 32 bits) and times it was repeated (low 32 bits),
+     * taken by the owner thread when the message changes or by the writer after a timeout */
+    std::atomic<UInt64> repeats { 0 };
+};
+
+struct RingOwner
+{
+    Ring *ring { nullptr };
+
+    ~RingOwner()
+    {
+        if (ring)
+            ring->orphan.store(true, std::memory_order_release);
+    }
+};
+
+static thread_local RingOwner ringOwner;
+static std::mutex ringsMutex;
+static std::vector<Ring*> rings;
+static std::thread *writer { nullptr };
+static std::atomic<bool> writerRunning { false };
+static std::atomic<bool> writerWaiting { false };
+static std::mutex writerMutex;
+static std::condition_variable writerCondition;
+static std::atomic<UInt32> generation { 0 };
+static std::atomic<UInt32> flushedGeneration { 0 };
+static UInt64 startTime { 0 };
+
+static UInt64 nowNs()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (UInt64)time.tv_sec * 1000000000 + (UInt64)time.tv_nsec;
+}
+
+static Ring *threadRing()
+{
+    if (ringOwner.ring)
+        return ringOwner.ring;
+
+    Ring *ring { new Ring() };
+
+    if (gettid() == getpid())
+        strcpy(ring->tag, "main");
+    else if (pthread_getname_np(pthread_self(), ring->tag, sizeof(ring->tag)) != 0 || ring->tag[0] == '\0')
+        snprintf(ring->tag, sizeof(ring->tag), "%d", gettid());
+
+    ringsMutex.lock();
+    rings.push_back(ring);
+    ringsMutex.unlock();
+    ringOwner.ring = ring;
+    return ring;
+}
+
+static void writeEntry(const Entry &entry, const char *tag)
+{
+    const Float64 time { Float64(entry.time - startTime) / 1000000000.0 };
+
+    switch (entry.level)
+    {
+    case Log:
+        fprintf(stdout, "%s" BRELN, entry.text);
+        break;
+    case Fatal:
+        fprintf(stderr, "[%12.6f] [%s] %sLouvre fatal:%s %s" BRELN, time, tag, KRED, KNRM, entry.text);
+        break;
+    case Error:
+        fprintf(stderr, "[%12.6f] [%s] %sLouvre error:%s %s" BRELN, time, tag, KRED, KNRM, entry.text);
+        break;
+    case Warning:
+        fprintf(stdout, "[%12.6f] [%s] %sLouvre warning:%s %s" BRELN, time, tag, KYEL, KNRM, entry.text);
+        break;
+    case Debug:
+        fprintf(stdout, "[%12.6f] [%s] %sLouvre debug:%s %s" BRELN, time, tag, KGRN, KNRM, entry.text);
+        break;
+    }
+}
+
+static void push(Ring *ring, Level level, UInt64 time, const char *text)
+{
+    const UInt32 head { ring->head.load(std::memory_order_relaxed) };
+
+    // Full, never block the caller
+    if (head - ring->tail.load(std::memory_order_acquire) == RING_SIZE)
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Entry &entry { ring->entries[head & (RING_SIZE - 1)] };
+    entry.time = time;
+    entry.level = level;
+    strcpy(entry.text, text);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+static void writeRepeats(const char *tag, Level level, UInt64 time, UInt32 repeats)
+{
+    Entry entry;
+    entry.time = time;
+    entry.level = level;
+    snprintf(entry.text, sizeof(entry.text), "Previous message repeated %u times.", repeats);
+    writeEntry(entry, tag);
+}
+
+/* Called by the writer, so that the count of a message that is no longer being repeated is not kept
+ * until the thread logs something else. Takes the count only, the level is kept for further repeats */
+static bool takeRepeats(Ring *ring, UInt64 time)
+{
+    UInt64 repeats { ring->repeats.load(std::memory_order_relaxed) };
+
+    while ((repeats & 0xFFFFFFFF) != 0)
+    {
+        if (ring->repeats.compare_exchange_weak(repeats, repeats & ~UInt64(0xFFFFFFFF), std::memory_order_relaxed))
+        {
+            writeRepeats(ring->tag, Level(repeats >> 32), time, repeats & 0xFFFFFFFF);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Writes the entries of all rings ordered by time, returns false if there were none.
+ * If flushRepeats is true, pending repeat counts are written as well */
+static bool drain(bool flushRepeats)
+{
+    std::vector<Ring*> current;
+    bool wrote { false };
+
+    ringsMutex.lock();
+    current = rings;
+    ringsMutex.unlock();
+
+    while (true)
+    {
+        Ring *next { nullptr };
+        UInt64 nextTime { 0 };
+
+        for (Ring *ring : current)
+        {
+            const UInt32 tail { ring->tail.load(std::memory_order_relaxed) };
+
+            if (tail == ring->head.load(std::memory_order_acquire))
+                continue;
+
+            const UInt64 time { ring->entries[tail & (RING_SIZE - 1)].time };
+
+            if (!next || time < nextTime)
+            {
+                next = ring;
+                nextTime = time;
+            }
+        }
+
+        if (!next)
+            break;
+
+        const UInt32 tail { next->tail.load(std::memory_order_relaxed) };
+        writeEntry(next->entries[tail & (RING_SIZE - 1)], next->tag);
+        next->tail.store(tail + 1, std::memory_order_release);
+        wrote = true;
+    }
+
+    for (Ring *ring : current)
+    {
+        if (flushRepeats && takeRepeats(ring, nowNs()))
+            wrote = true;
+
+        if (const UInt32 dropped = ring->dropped.exchange(0, std::memory_order_relaxed))
+        {
+            fprintf(stderr, "[%12.6f] [%s] %sLouvre warning:%s %u messages dropped." BRELN,
+                    Float64(nowNs() - startTime) / 1000000000.0, ring->tag, KYEL, KNRM, dropped);
+            wrote = true;
+        }
+    }
+
+    // Threads that exited
+    ringsMutex.lock();
+
+    for (auto it = rings.begin(); it != rings.end();)
+    {
+        Ring *ring { *it };
+
+        if (ring->orphan.load(std::memory_order_acquire) &&
+            ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire))
+        {
+            // The thread can no longer write its repeat count
+            if (takeRepeats(ring, nowNs()))
+                wrote = true;
+
+            it = rings.erase(it);
+            delete ring;
+        }
+        else
+            it++;
+    }
+
+    ringsMutex.unlock();
+
+    if (wrote)
+    {
+        fflush(stdout);
+        fflush(stderr);
+    }
+
+    return wrote;
+}
+
+static bool pendingRepeats()
+{
+    std::lock_guard<std::mutex> lock { ringsMutex };
+
+    for (Ring *ring : rings)
+        if ((ring->repeats.load(std::memory_order_relaxed) & 0xFFFFFFFF) != 0)
+            return true;
+
+    return false;
+}
+
+/* Producers only notify the writer while it is waiting, see wakeWriter() */
+static void writerLoop()
+{
+    pthread_setname_np(pthread_self(), "LLog");
+    bool timedOut { false };
+
+    while (writerRunning.load())
+    {
+        const UInt32 gen { generation.load() };
+        drain(timedOut);
+        flushedGeneration.store(gen, std::memory_order_release);
+        flushedGeneration.notify_all();
+
+        const auto wake = [gen]
+        {
+            return generation.load() != gen || !writerRunning.load();
+        };
+
+        std::unique_lock<std::mutex> lock { writerMutex };
+        writerWaiting.store(true);
+
+        // Only wake up periodically while a repeat count is pending
+        if (pendingRepeats())
+            timedOut = !writerCondition.wait_for(lock, std::chrono::milliseconds(REPEATS_TIMEOUT_MS), wake);
+        else
+        {
+            writerCondition.wait(lock, wake);
+            timedOut = false;
+        }
+
+        writerWaiting.store(false);
+    }
+
+    drain(true);
+    flushedGeneration.store(generation.load(std::memory_order_acquire), std::memory_order_release);
+    flushedGeneration.notify_all();
+}
+
+/* The generation is incremented before writerWaiting is checked, and the writer sets writerWaiting before
+ * checking the generation, so either the writer sees the new generation or the producer sees it waiting */
+static UInt32 wakeWriter()
+{
+    const UInt32 gen { generation.fetch_add(1) + 1 };
+
+    if (writerWaiting.load())
+    {
+        std::lock_guard<std::mutex> lock { writerMutex };
+        writerCondition.notify_one();
+    }
+
+    return gen;
+}
+
+static void stopWriter()
+{
+    if (!writerRunning.exchange(false))
+        return;
+
+    wakeWriter();
+    writer->join();
+    delete writer;
+    writer = nullptr;
+}
+
+/* The writer thread does not exist in forked processes, they write directly
+ * (queued messages belong to the parent) */
+static void onFork()
+{
+    writerRunning.store(false);
+    writer = nullptr;
+}
+
 void LLog::init()
 {
     char *env = getenv("LOUVRE_DEBUG");
@@ -28,65 +366,119 @@ void LLog::init()
         level = atoi(env);
     else
         level = 0;
+
+    // Called by LLauncher and LCompositor
+    if (startTime != 0)
+        return;
+
+    startTime = nowNs();
+    writerRunning.store(true);
+    writer = new std::thread(&writerLoop);
+    pthread_atfork(nullptr, nullptr, &onFork);
+    atexit(&stopWriter);
 }
 
-void LLog::fatal(const char *format, ...)
+void LLog::flush()
 {
-    if (level >= 1)
+    if (!writerRunning.load(std::memory_order_acquire))
+        return;
+
+    const UInt32 gen { wakeWriter() };
+
+    UInt32 flushed { flushedGeneration.load(std::memory_order_acquire) };
+
+    while ((Int32)(flushed - gen) < 0 && writerRunning.load(std::memory_order_acquire))
     {
-        fprintf(stderr, "%sLouvre fatal:%s ", KRED, KNRM);
-        va_list args;
-        va_start(args, format);
-        vfprintf(stderr, format, args);
-        va_end(args);
-        fprintf(stderr, BRELN);
+        flushedGeneration.wait(flushed, std::memory_order_acquire);
+        flushed = flushedGeneration.load(std::memory_order_acquire);
     }
 }
 
-void LLog::error(const char *format, ...)
+static void vprint(Level messageLevel, const char *format, va_list args)
 {
-    if (level >= 2)
+    if (messageLevel != Log && level < (int)messageLevel)
+        return;
+
+    const UInt64 time { nowNs() };
+    Char8 text[ENTRY_TEXT_SIZE];
+    vsnprintf(text, sizeof(text), format, args);
+
+    // Before init() or in forked processes
+    if (!writerRunning.load(std::memory_order_acquire))
     {
-        fprintf(stderr, "%sLouvre error:%s ", KRED, KNRM);
-        va_list args;
-        va_start(args, format);
-        vfprintf(stderr, format, args);
-        va_end(args);
-        fprintf(stderr, BRELN);
+        Entry entry;
+        entry.time = startTime == 0 ? 0 : time;
+        entry.level = messageLevel;
+        memcpy(entry.text, text, sizeof(text));
+        writeEntry(entry, "main");
+        return;
     }
-}
 
-void LLog::warning(const char *format, ...)
-{
-    if (level >= 3)
+    Ring *ring { threadRing() };
+
+    if (ring->lastLevel == messageLevel && strcmp(ring->lastText, text) == 0)
     {
-        printf("%sLouvre warning:%s ", KYEL, KNRM);
-        va_list args;
-        va_start(args, format);
-        vprintf(format, args);
-        va_end(args);
-        printf(BRELN);
+        // The writer prints the count if nothing else is logged within REPEATS_TIMEOUT_MS
+        if ((ring->repeats.fetch_add(1, std::memory_order_relaxed) & 0xFFFFFFFF) == 0)
+            wakeWriter();
+
+        return;
     }
-}
 
-void LLog::debug(const char *format, ...)
-{
-    if (level >= 4)
+    const UInt64 repeats { ring->repeats.exchange(UInt64(messageLevel) << 32, std::memory_order_relaxed) };
+
+    if ((repeats & 0xFFFFFFFF) != 0)
     {
-        printf("%sLouvre debug:%s ", KGRN, KNRM);
-        va_list args;
-        va_start(args, format);
-        vprintf(format, args);
-        va_end(args);
-        printf(BRELN);
+        Char8 repeated[64];
+        snprintf(repeated, sizeof(repeated), "Previous message repeated %u times.", UInt32(repeats & 0xFFFFFFFF));
+        push(ring, Level(repeats >> 32), time, repeated);
     }
+
+    memcpy(ring->lastText, text, sizeof(text));
+    ring->lastLevel = messageLevel;
+    push(ring, messageLevel, time, text);
+    wakeWriter();
+
+    if (messageLevel == Fatal)
+        LLog::flush();
 }
 
 void LLog::log(const char *format, ...)
 {
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    vprint(Log, format, args);
     va_end(args);
-    printf(BRELN);
-}
\ No newline at end of file
+}
+
+void LLog::fatal(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprint(Fatal, format, args);
+    va_end(args);
+}
+
+void LLog::error(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprint(Error, format, args);
+    va_end(args);
+}
+
+void LLog::warning(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprint(Warning, format, args);
+    va_end(args);
+}
+
+void LLog::debug(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vprint(Debug, format, args);
+    va_end(args);
+}
@@ -9,6 +9,46 @@
 #define FORMAT_CHECK __attribute__((format(printf, 1, 2)))
 #endif
 
+/**
+ * @brief Highest verbosity level compiled in
+ *
+ * The LLOG_FATAL(), LLOG_ERROR(), LLOG_WARNING() and LLOG_DEBUG() macros of levels greater than this value expand to nothing,
+ * and their arguments are not evaluated. The LLog methods themselves are always available.
+ * Louvre is built with the value of the `log_max_level` meson option (4 by default), and code including this header can define
+ * it before the first include to strip its own messages.
+ */
+#ifndef LOUVRE_LOG_MAX_LEVEL
+#define LOUVRE_LOG_MAX_LEVEL 4
+#endif
+
+/// Calls LLog::fatal() if @ref LOUVRE_LOG_MAX_LEVEL >= 1, otherwise expands to nothing.
+#if LOUVRE_LOG_MAX_LEVEL >= 1
+#define LLOG_FATAL(...) Louvre::LLog::fatal(__VA_ARGS__)
+#else
+#define LLOG_FATAL(...) ((void)0)
+#endif
+
+/// Calls LLog::error() if @ref LOUVRE_LOG_MAX_LEVEL >= 2, otherwise expands to nothing.
+#if LOUVRE_LOG_MAX_LEVEL >= 2
+#define LLOG_ERROR(...) Louvre::LLog::error(__VA_ARGS__)
+#else
+#define LLOG_ERROR(...) ((void)0)
+#endif
+
+/// Calls LLog::warning() if @ref LOUVRE_LOG_MAX_LEVEL >= 3, otherwise expands to nothing.
+#if LOUVRE_LOG_MAX_LEVEL >= 3
+#define LLOG_WARNING(...) Louvre::LLog::warning(__VA_ARGS__)
+#else
+#define LLOG_WARNING(...) ((void)0)
+#endif
+
+/// Calls LLog::debug() if @ref LOUVRE_LOG_MAX_LEVEL >= 4, otherwise expands to nothing.
+#if LOUVRE_LOG_MAX_LEVEL >= 4
+#define LLOG_DEBUG(...) Louvre::LLog::debug(__VA_ARGS__)
+#else
+#define LLOG_DEBUG(...) ((void)0)
+#endif
+
 /**
  * @brief Debugging information
  *
@@ -17,6 +57,15 @@
  *
  * All messages are directed to the **stdout** stream, except for those generated by error() and fatal(), which are written to the **stderr** stream.
  *
+ * Messages are formatted by the calling thread into its own lock-free ring buffer and written by a background thread started by init(),
+ * so logging never blocks on I/O. Each message is prefixed with the time in seconds since init() was called (monotonic clock) and the name
+ * of the thread that generated it. Messages a thread repeats consecutively (same level and formatted text) are printed once, followed by the number
+ * of times they were repeated. Only consecutive repeats are collapsed, messages alternating with others are printed each time and are not rate limited.\n
+ * If a thread generates messages faster than they can be written, the exceeding ones are dropped and reported.
+ *
+ * Messages logged with the LLOG_FATAL(), LLOG_ERROR(), LLOG_WARNING() and LLOG_DEBUG() macros are removed at compile time
+ * if their level is above @ref LOUVRE_LOG_MAX_LEVEL.
+ *
  * ## Verbosity levels
  *
  * #### LOUVRE_DEBUG=0
@@ -42,6 +91,13 @@ public:
      */
     static void init();
 
+    /**
+     * @brief Write pending messages
+     *
+     * Blocks until all messages generated so far are written. Called automatically after fatal() and when the process exits.
+     */
+    static void flush();
+
     /// Prints general messages independent of the value of **LOUVRE_DEBUG**.
     FORMAT_CHECK static void log(const char *format, ...);
 
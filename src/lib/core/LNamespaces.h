@@ -27,6 +27,7 @@
 #define LOUVRE_FRACTIONAL_SCALE_VERSION 1
 #define LOUVRE_GAMMA_CONTROL_MANAGER_VERSION 1
 #define LOUVRE_TEARING_CONTROL_MANAGER_VERSION 1
+#define LOUVRE_SCREEN_COPY_MANAGER_VERSION 3
 
 #define L_UNUSED(object){(void)object;}
 
@@ -182,6 +183,7 @@ namespace Louvre
     class LKeyboard;
     class LCursor;
     class LXCursor;
+    class LXCursorTheme;
 
     // Other
     class LDMABuffer;
@@ -189,6 +191,8 @@ namespace Louvre
     // Utils
     class LLog;
     class LTime;
+    class LTrace;
+    class LSessionRecorder;
     class LTimer;
     class LLauncher;
     class LGammaTable;
@@ -495,6 +499,13 @@ namespace Louvre
 
             class RTearingControl;
         };
+
+        namespace ScreenCopy
+        {
+            class GScreenCopyManager;
+
+            class RScreenCopyFrame;
+        };
     }
 
     /// @cond OMIT
@@ -554,6 +565,7 @@ namespace Louvre
 
         /* OUTPUT TIME */
         clockid_t                           (*outputGetClock)(LOutput *output);
+        UInt64                              (*outputGetCopiedBytes)(LOutput *output);
 
         /* OUTPUT CURSOR */
         bool                                (*outputHasHardwareCursorSupport)(LOutput *output);
@@ -1,15 +1,31 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <other/stb_image.h>
-#include <LOpenGL.h>
+#include <private/LOpenGLPrivate.h>
+#include <private/LCompositorPrivate.h>
+#include <private/LOutputPrivate.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <GL/gl.h>
 #include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <EGL/egl.h>
 #include <LRect.h>
 #include <LTexture.h>
 #include <LOutput.h>
 #include <LLog.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <condition_variable>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <map>
 
 using namespace Louvre;
 
@@ -20,7 +36,7 @@ char *LOpenGL::openShader(const std::filesystem::path &file)
 
     if (fp == NULL)
     {
-        LLog::error("[LOpenGL::openShader] Error while opening shader file: %s.\n", file.c_str());
+        LLOG_ERROR("[LOpenGL::openShader] Error while opening shader file: %s.\n", file.c_str());
         return nullptr;
     }
 
@@ -109,7 +125,7 @@ GLuint LOpenGL::compileShader(GLenum type, const char *shaderString)
 
         glGetShaderInfoLog(shader, infoLen, &infoLen, errorLog);
 
-        LLog::error("[LOpenGL::compileShader] %s", errorLog);
+        LLOG_ERROR("[LOpenGL::compileShader] %s", errorLog);
 
         glDeleteShader(shader);
         delete[] errorLog;
@@ -119,6 +135,249 @@ GLuint LOpenGL::compileShader(GLenum type, const char *shaderString)
     return shader;
 }
 
+/* Program binary cache file header, followed by the binary */
+struct ProgramBinaryHeader
+{
+    Char8 magic[8];
+    UInt32 version;
+    GLenum format;
+    UInt64 key;
+    UInt64 length;
+    UInt64 checksum;
+};
+
+#define PROGRAM_BINARY_MAGIC "LPRGBIN"
+#define PROGRAM_BINARY_VERSION 1
+
+static UInt64 fnv1a(const void *data, size_t size, UInt64 hash = 0xcbf29ce484222325)
+{
+    const UInt8 *bytes { (const UInt8*)data };
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+static UInt64 fnv1aString(const char *string, UInt64 hash)
+{
+    if (!string)
+        string = "";
+
+    // Include the null terminator so that concatenations do not collide
+    return fnv1a(string, strlen(string) + 1, hash);
+}
+
+static bool programBinarySupported(PFNGLGETPROGRAMBINARYOESPROC *getProgramBinary, PFNGLPROGRAMBINARYOESPROC *programBinary)
+{
+    if (getenvString("LOUVRE_SHADER_CACHE") == "0" || !LOpenGL::hasExtension("GL_OES_get_program_binary"))
+        return false;
+
+    GLint formats { 0 };
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+
+    if (formats <= 0)
+        return false;
+
+    *getProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+    *programBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+    return *getProgramBinary && *programBinary;
+}
+
+static std::filesystem::path programBinaryDir()
+{
+    std::filesystem::path dir;
+    const char *xdgCacheHome { getenv("XDG_CACHE_HOME") };
+
+    if (xdgCacheHome && xdgCacheHome[0] == '/')
+        dir = xdgCacheHome;
+    else
+    {
+        const char *home { getenv("HOME") };
+
+        if (!home || home[0] == '\0')
+            return dir;
+
+        dir = std::filesystem::path(home) / ".cache";
+    }
+
+    return dir / "Louvre" / "shaders";
+}
+
+static bool loadProgramBinary(GLuint program, const std::filesystem::path &file, UInt64 key, PFNGLPROGRAMBINARYOESPROC programBinary)
+{
+    const Int32 fd { open(file.c_str(), O_RDONLY | O_CLOEXEC) };
+
+    if (fd == -1)
+        return false;
+
+    ProgramBinaryHeader header;
+    struct stat st;
+    std::vector<UInt8> binary;
+    bool valid { false };
+
+    if (fstat(fd, &st) == -1 ||
+        read(fd, &header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != PROGRAM_BINARY_VERSION ||
+        header.key != key ||
+        header.length == 0 ||
+        (UInt64)st.st_size != sizeof(header) + header.length)
+        goto done;
+
+    binary.resize(header.length);
+
+    if (read(fd, binary.data(), binary.size()) != (ssize_t)binary.size() ||
+        fnv1a(binary.data(), binary.size()) != header.checksum)
+        goto done;
+
+    // The driver rejects binaries of other versions or configurations by failing to link
+    programBinary(program, header.format, binary.data(), binary.size());
+
+    GLint linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    valid = linked && glGetError() == GL_NO_ERROR;
+
+done:
+    close(fd);
+
+    // Invalid, replaced after compiling from source
+    if (!valid)
+        LLOG_DEBUG("[LOpenGL::linkProgram] Discarding invalid program binary %s.", file.c_str());
+
+    return valid;
+}
+
+static void storeProgramBinary(GLuint program, const std::filesystem::path &file, UInt64 key, PFNGLGETPROGRAMBINARYOESPROC getProgramBinary)
+{
+    GLint length { 0 };
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+
+    if (length <= 0)
+        return;
+
+    ProgramBinaryHeader header {};
+    std::vector<UInt8> binary(length);
+    getProgramBinary(program, length, &length, &header.format, binary.data());
+
+    if (glGetError() != GL_NO_ERROR || length <= 0)
+        return;
+
+    binary.resize(length);
+    memcpy(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic));
+    header.version = PROGRAM_BINARY_VERSION;
+    header.key = key;
+    header.length = length;
+    header.checksum = fnv1a(binary.data(), binary.size());
+
+    std::error_code error;
+    std::filesystem::create_directories(file.parent_path(), error);
+
+    if (error)
+        return;
+
+    // Written to a temporary file and renamed so that other processes or threads never read partial binaries
+    std::filesystem::path tmp { file };
+    tmp += "." + std::to_string(getpid()) + "." + std::to_string(gettid()) + ".tmp";
+    const Int32 fd { open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+
+    if (fd == -1)
+        return;
+
+    const bool written {
+        write(fd, &header, sizeof(header)) == sizeof(header) &&
+        write(fd, binary.data(), binary.size()) == (ssize_t)binary.size() };
+
+    close(fd);
+
+    if (!written || rename(tmp.c_str(), file.c_str()) != 0)
+        unlink(tmp.c_str());
+}
+
+GLuint LOpenGL::linkProgram(const char *vertexShaderString, const char *fragmentShaderString)
+{
+    PFNGLGETPROGRAMBINARYOESPROC getProgramBinary { nullptr };
+    PFNGLPROGRAMBINARYOESPROC programBinary { nullptr };
+    const bool cache { programBinarySupported(&getProgramBinary, &programBinary) };
+    std::filesystem::path file;
+    UInt64 key { 0 };
+    GLuint program;
+
+    if (cache)
+    {
+        key = fnv1aString((const char*)glGetString(GL_VENDOR), 0xcbf29ce484222325);
+        key = fnv1aString((const char*)glGetString(GL_RENDERER), key);
+        key = fnv1aString((const char*)glGetString(GL_VERSION), key);
+        key = fnv1aString(vertexShaderString, key);
+        key = fnv1aString(fragmentShaderString, key);
+
+        const std::filesystem::path dir { programBinaryDir() };
+
+        if (!dir.empty())
+        {
+            Char8 name[32];
+            snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+            file = dir / name;
+            program = glCreateProgram();
+
+            if (loadProgramBinary(program, file, key, programBinary))
+                return program;
+
+            glDeleteProgram(program);
+        }
+    }
+
+    const GLuint vertexShader { compileShader(GL_VERTEX_SHADER, vertexShaderString) };
+    const GLuint fragmentShader { compileShader(GL_FRAGMENT_SHADER, fragmentShaderString) };
+
+    if (!vertexShader || !fragmentShader)
+    {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    program = glCreateProgram();
+
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+
+    // The program keeps its own copy once linked
+    glDetachShader(program, vertexShader);
+    glDetachShader(program, fragmentShader);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    if (!linked)
+    {
+        GLint infoLen = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLen);
+
+        if (infoLen > 1)
+        {
+            GLchar *errorLog = new GLchar[infoLen];
+            glGetProgramInfoLog(program, infoLen, &infoLen, errorLog);
+            LLOG_ERROR("[LOpenGL::linkProgram] %s", errorLog);
+            delete[] errorLog;
+        }
+
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    if (!file.empty())
+        storeProgramBinary(program, file, key, getProgramBinary);
+
+    return program;
+}
+
 LTexture *LOpenGL::loadTexture(const std::filesystem::path &file)
 {
     Int32 width, height, channels;
@@ -126,7 +385,7 @@ LTexture *LOpenGL::loadTexture(const std::filesystem::path &file)
 
     if (!image)
     {
-        LLog::error("[LOpenGL::loadTexture] Failed to load image %s: %s.", file.c_str(), stbi_failure_reason());
+        LLOG_ERROR("[LOpenGL::loadTexture] Failed to load image %s: %s.", file.c_str(), stbi_failure_reason());
         return nullptr;
     }
 
@@ -150,6 +409,336 @@ LTexture *LOpenGL::loadTexture(const std::filesystem::path &file)
     return texture;
 }
 
+/* Asynchronous texture loading */
+
+struct DecodedImage
+{
+    std::vector<UInt8> pixels;
+    LSize size;
+};
+
+struct TextureRequest
+{
+    UInt64 id;
+    UInt32 threadSlot;
+    LOpenGL::TextureCallback callback;
+};
+
+// Requests with the same parameters share a single decode while it is pending
+struct TextureDecode
+{
+    std::string key;
+    std::filesystem::path file;
+    LSize sizeB;
+    bool crop;
+    std::vector<TextureRequest> requests;
+};
+
+struct TextureResult
+{
+    TextureRequest request;
+    std::shared_ptr<const DecodedImage> image;
+};
+
+static struct TextureLoader
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<std::thread> workers;
+    std::map<std::string, std::shared_ptr<TextureDecode>> decodes;
+    std::deque<std::shared_ptr<TextureDecode>> queue;
+    std::vector<TextureResult> results;
+    std::atomic<UInt32> resultsCount { 0 };
+    UInt64 lastId { 0 };
+    bool running { false };
+
+    ~TextureLoader()
+    {
+        LOpenGL::LOpenGLPrivate::unitTextureLoader();
+    }
+} textureLoader;
+
+/* Box filter weighted by alpha, so fully transparent pixels do not darken the edges.
+ * Enlarging is nearest neighbor. */
+static void scaleImage(const UInt8 *src, Int32 srcStride, const LRect &srcRect, DecodedImage &dst)
+{
+    const Float32 scaleX { Float32(srcRect.w()) / Float32(dst.size.w()) };
+    const Float32 scaleY { Float32(srcRect.h()) / Float32(dst.size.h()) };
+    dst.pixels.resize(dst.size.w() * dst.size.h() * 4);
+    UInt8 *out { dst.pixels.data() };
+
+    for (Int32 y = 0; y < dst.size.h(); y++)
+    {
+        const Int32 y0 { srcRect.y() + Int32(Float32(y) * scaleY) };
+        const Int32 y1 { std::max(y0 + 1, srcRect.y() + Int32(Float32(y + 1) * scaleY)) };
+
+        for (Int32 x = 0; x < dst.size.w(); x++)
+        {
+            const Int32 x0 { srcRect.x() + Int32(Float32(x) * scaleX) };
+            const Int32 x1 { std::max(x0 + 1, srcRect.x() + Int32(Float32(x + 1) * scaleX)) };
+            UInt64 r { 0 }, g { 0 }, b { 0 }, a { 0 };
+
+            for (Int32 sy = y0; sy < y1; sy++)
+            {
+                const UInt8 *pixel { &src[sy * srcStride + x0 * 4] };
+
+                for (Int32 sx = x0; sx < x1; sx++, pixel += 4)
+                {
+                    r += pixel[0] * pixel[3];
+                    g += pixel[1] * pixel[3];
+                    b += pixel[2] * pixel[3];
+                    a += pixel[3];
+                }
+            }
+
+            const UInt64 count { UInt64(x1 - x0) * UInt64(y1 - y0) };
+
+            if (a > 0)
+            {
+                out[0] = r / a;
+                out[1] = g / a;
+                out[2] = b / a;
+            }
+            else
+                out[0] = out[1] = out[2] = 0;
+
+            out[3] = a / count;
+            out += 4;
+        }
+    }
+}
+
+static std::shared_ptr<const DecodedImage> decodeImage(const TextureDecode &decode)
+{
+    Int32 width, height, channels;
+    UInt8 *pixels { stbi_load(decode.file.c_str(), &width, &height, &channels, STBI_rgb_alpha) };
+
+    if (!pixels)
+    {
+        LLOG_ERROR("[LOpenGL::loadTextureAsync] Failed to load image %s: %s.", decode.file.c_str(), stbi_failure_reason());
+        return nullptr;
+    }
+
+    std::shared_ptr<DecodedImage> image { std::make_shared<DecodedImage>() };
+
+    if (decode.sizeB.w() <= 0 || decode.sizeB.h() <= 0 || decode.sizeB == LSize(width, height))
+    {
+        image->size.setW(width);
+        image->size.setH(height);
+        image->pixels.assign(pixels, pixels + width * height * 4);
+        free(pixels);
+        return image;
+    }
+
+    LRect srcRect(0, 0, width, height);
+
+    // Keep the aspect ratio clipping the center
+    if (decode.crop)
+    {
+        const Int32 w { Int32((Int64(decode.sizeB.w()) * height) / decode.sizeB.h()) };
+
+        if (w <= width)
+        {
+            srcRect.setW(std::max(1, w));
+            srcRect.setX((width - srcRect.w()) / 2);
+        }
+        else
+        {
+            srcRect.setH(std::max(1, Int32((Int64(decode.sizeB.h()) * width) / decode.sizeB.w())));
+            srcRect.setY((height - srcRect.h()) / 2);
+        }
+    }
+
+    image->size = decode.sizeB;
+    scaleImage(pixels, width * 4, srcRect, *image);
+    free(pixels);
+    return image;
+}
+
+static void textureWorkerLoop()
+{
+    pthread_setname_np(pthread_self(), "LTextureLoader");
+    std::unique_lock<std::mutex> lock { textureLoader.mutex };
+
+    while (true)
+    {
+        textureLoader.cond.wait(lock, []{ return !textureLoader.running || !textureLoader.queue.empty(); });
+
+        if (!textureLoader.running)
+            return;
+
+        std::shared_ptr<TextureDecode> decode { textureLoader.queue.front() };
+        textureLoader.queue.pop_front();
+        lock.unlock();
+
+        std::shared_ptr<const DecodedImage> image { decodeImage(*decode) };
+
+        lock.lock();
+
+        // New requests can no longer join this decode
+        textureLoader.decodes.erase(decode->key);
+
+        if (!textureLoader.running)
+            return;
+
+        for (TextureRequest &request : decode->requests)
+            textureLoader.results.push_back({std::move(request), image});
+
+        if (decode->requests.empty())
+            continue;
+
+        textureLoader.resultsCount.store(textureLoader.results.size());
+
+        // Wake up the main loop (LCompositorPrivate::unlockPoll() requires the compositor lock)
+        UInt64 eventValue { 1 };
+        ssize_t n = write(LCompositor::compositor()->imp()->events[0].data.fd, &eventValue, sizeof(eventValue));
+        L_UNUSED(n);
+    }
+}
+
+UInt64 LOpenGL::loadTextureAsync(const std::filesystem::path &file, const TextureCallback &onLoaded, const LSize &sizeB, bool crop)
+{
+    UInt32 threadSlot { LCompositor::compositor()->imp()->currentThreadSlot() };
+
+    if (threadSlot == LCompositor::LCompositorPrivate::InvalidThreadSlot)
+        threadSlot = LCompositor::LCompositorPrivate::MainThreadSlot;
+
+    const std::string key { file.string() + '\n' + std::to_string(sizeB.w()) + 'x' + std::to_string(sizeB.h()) + (crop ? "c" : "") };
+    std::lock_guard<std::mutex> lock { textureLoader.mutex };
+
+    if (!textureLoader.running)
+    {
+        textureLoader.running = true;
+        const UInt32 workers { std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u) };
+
+        for (UInt32 i = 0; i < workers; i++)
+            textureLoader.workers.emplace_back(&textureWorkerLoop);
+    }
+
+    const UInt64 id { ++textureLoader.lastId };
+    std::shared_ptr<TextureDecode> &decode { textureLoader.decodes[key] };
+
+    if (!decode)
+    {
+        decode = std::make_shared<TextureDecode>();
+        decode->key = key;
+        decode->file = file;
+        decode->sizeB = sizeB;
+        decode->crop = crop;
+        textureLoader.queue.push_back(decode);
+        textureLoader.cond.notify_one();
+    }
+
+    decode->requests.push_back({id, threadSlot, onLoaded});
+    return id;
+}
+
+void LOpenGL::cancelTextureLoad(UInt64 request)
+{
+    std::lock_guard<std::mutex> lock { textureLoader.mutex };
+
+    const auto matches = [request](const TextureRequest &r) { return r.id == request; };
+
+    for (auto &decode : textureLoader.decodes)
+        std::erase_if(decode.second->requests, matches);
+
+    std::erase_if(textureLoader.results, [&matches](const TextureResult &r) { return matches(r.request); });
+    textureLoader.resultsCount.store(textureLoader.results.size());
+}
+
+void LOpenGL::LOpenGLPrivate::dropTextureRequests(UInt32 threadSlot)
+{
+    std::lock_guard<std::mutex> lock { textureLoader.mutex };
+
+    const auto matches = [threadSlot](const TextureRequest &r) { return r.threadSlot == threadSlot; };
+
+    for (auto &decode : textureLoader.decodes)
+        std::erase_if(decode.second->requests, matches);
+
+    std::erase_if(textureLoader.results, [&matches](const TextureResult &r) { return matches(r.request); });
+    textureLoader.resultsCount.store(textureLoader.results.size());
+}
+
+void LOpenGL::LOpenGLPrivate::processLoadedTextures(UInt32 threadSlot)
+{
+    if (textureLoader.resultsCount.load() == 0)
+        return;
+
+    std::vector<TextureResult> loaded;
+
+    textureLoader.mutex.lock();
+
+    for (auto it = textureLoader.results.begin(); it != textureLoader.results.end();)
+    {
+        if (it->request.threadSlot == threadSlot)
+        {
+            loaded.push_back(std::move(*it));
+            it = textureLoader.results.erase(it);
+        }
+        else
+            it++;
+    }
+
+    textureLoader.resultsCount.store(textureLoader.results.size());
+
+    // Decoded for rendering threads, uploaded before their next frame
+    if (threadSlot == LCompositor::LCompositorPrivate::MainThreadSlot)
+        for (const TextureResult &result : textureLoader.results)
+            for (LOutput *output : LCompositor::compositor()->outputs())
+                if (output->imp()->threadSlot == result.request.threadSlot)
+                    output->repaint();
+
+    textureLoader.mutex.unlock();
+
+    for (TextureResult &result : loaded)
+    {
+        LTexture *texture { nullptr };
+
+        if (result.image)
+        {
+            const DecodedImage &image { *result.image };
+            texture = new LTexture();
+
+            if (!texture->setDataB(image.size, image.size.w() * 4, DRM_FORMAT_ABGR8888, image.pixels.data()))
+            {
+                // The image is shared with other requests
+                std::vector<UInt8> swapped { image.pixels };
+
+                for (size_t i = 0; i < swapped.size(); i += 4)
+                    std::swap(swapped[i], swapped[i + 2]);
+
+                if (!texture->setDataB(image.size, image.size.w() * 4, DRM_FORMAT_ARGB8888, swapped.data()))
+                {
+                    delete texture;
+                    texture = nullptr;
+                }
+            }
+        }
+
+        if (result.request.callback)
+            result.request.callback(texture);
+        else
+            delete texture;
+    }
+}
+
+void LOpenGL::LOpenGLPrivate::unitTextureLoader()
+{
+    textureLoader.mutex.lock();
+    textureLoader.running = false;
+    textureLoader.mutex.unlock();
+    textureLoader.cond.notify_all();
+
+    for (std::thread &worker : textureLoader.workers)
+        worker.join();
+
+    textureLoader.workers.clear();
+    textureLoader.decodes.clear();
+    textureLoader.queue.clear();
+    textureLoader.results.clear();
+    textureLoader.resultsCount.store(0);
+}
+
 bool LOpenGL::hasExtension(const char *extension)
 {
     const char *extensions = (const char*)glGetString(GL_EXTENSIONS);
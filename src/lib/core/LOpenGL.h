@@ -2,7 +2,9 @@
 #define LOPENGL_H
 
 #include <LNamespaces.h>
+#include <LPoint.h>
 #include <filesystem>
+#include <functional>
 
 /**
  * @brief OpenGL utility functions.
@@ -14,8 +16,16 @@ class Louvre::LOpenGL
 public:
     /// @cond OMIT
     LOpenGL() = delete;
+    class LOpenGLPrivate;
     /// @endcond
 
+    /**
+     * @brief Callback type used by loadTextureAsync().
+     *
+     * @param texture The loaded texture, owned by the receiver, or `nullptr` if the image could not be loaded.
+     */
+    using TextureCallback = std::function<void(LTexture *texture)>;
+
     /**
      * @brief Open a GLSL shader file.
      *
@@ -51,6 +61,23 @@ public:
      */
     static GLuint compileShader(GLenum type, const char *shaderString);
 
+    /**
+     * @brief Compile and link a program.
+     *
+     * Compiles the vertex and fragment shaders and links them into a new program.
+     *
+     * If the driver supports the `GL_OES_get_program_binary` extension, the linked program binary is stored
+     * in `$XDG_CACHE_HOME/Louvre/shaders` (or `~/.cache/Louvre/shaders`), keyed by the driver vendor, renderer and version strings
+     * and a hash of both shader sources. Later calls with the same sources load the cached binary instead of compiling them,
+     * falling back to compiling from source if it is missing, corrupted or rejected by the driver.\n
+     * The cache can be disabled by setting the **LOUVRE_SHADER_CACHE** environment variable to 0.
+     *
+     * @param vertexShaderString String with the vertex shader source code.
+     * @param fragmentShaderString String with the fragment shader source code.
+     * @returns The program ID or 0 if an error occurs.
+     */
+    static GLuint linkProgram(const char *vertexShaderString, const char *fragmentShaderString);
+
     /**
      * @brief Create a texture from an image file.
      *
@@ -63,6 +90,39 @@ public:
      */
     static LTexture *loadTexture(const std::filesystem::path &file);
 
+    /**
+     * @brief Create a texture from an image file asynchronously.
+     *
+     * Unlike loadTexture(), the image is decoded and scaled by a pool of background threads so the calling thread is never blocked.
+     * Only the texture upload is performed on the calling thread: the main thread during the main loop iteration after decoding finishes,
+     * or an output rendering thread right before its next paintGL() event, which is scheduled automatically.\n
+     * The callback is invoked from that same thread with the compositor locked.
+     *
+     * Concurrent requests for the same file and parameters are decoded only once, each one still receives its own texture.
+     *
+     * @note Requests made from an output rendering thread are discarded without invoking their callbacks if the output is
+     *       uninitialized before they are completed, since the thread that would upload the texture no longer exists.
+     *
+     * @note The image format is always converted to `DRM_FORMAT_ARGB8888` or `DRM_FORMAT_ABGR8888`.
+     *
+     * @param file Path to the image file, see loadTexture() for the supported formats.
+     * @param onLoaded Callback invoked with the new texture or `nullptr` on failure.
+     * @param sizeB Size the image is scaled to in buffer coordinates, pass (0,0) to keep its original size.
+     * @param crop If `true`, the image keeps its aspect ratio and is scaled to cover sizeB, cropping its center. Otherwise it is stretched.
+     *
+     * @returns An identifier that can be passed to cancelTextureLoad().
+     */
+    static UInt64 loadTextureAsync(const std::filesystem::path &file, const TextureCallback &onLoaded, const LSize &sizeB = LSize(), bool crop = false);
+
+    /**
+     * @brief Cancel a request made with loadTextureAsync().
+     *
+     * The callback of the request is not invoked. Requests that already completed are ignored.
+     *
+     * @param request The identifier returned by loadTextureAsync().
+     */
+    static void cancelTextureLoad(UInt64 request);
+
     /**
      * @brief Check if a specific OpenGL extension is available.
      *
@@ -43,7 +43,11 @@ LOutput::LOutput(const void *params) : m_imp(std::make_unique<LOutputPrivate>(th
         p->callback(this);
 }
 
-LOutput::~LOutput() {}
+LOutput::~LOutput()
+{
+    // Usually already finished by LCompositor::removeOutput()
+    imp()->finishAsyncOperation(false);
+}
 
 bool LOutput::fractionalOversamplingEnabled() const
 {
@@ -61,6 +65,10 @@ void LOutput::enableFractionalOversampling(bool enabled)
     {
         imp()->stateFlags.setFlag(LOutputPrivate::FractionalOversamplingEnabled, enabled);
 
+        // Direct rendering doesn't need the intermediate framebuffer, it is recreated if enabled again
+        if (!enabled)
+            imp()->fractionalFb.imp()->releaseThreadsData();
+
         if (usingFractionalScale())
             repaint();
     }
@@ -150,8 +158,10 @@ void LOutput::setTransform(LFramebuffer::Transform transform)
         return;
 
     LSize prevSizeB = imp()->sizeB;
+    cursor()->imp()->fastPathRemoveOutput(this);
     imp()->transform = transform;
     imp()->updateRect();
+    cursor()->imp()->fastPathRefresh();
 
     if (state() == Initialized && prevSizeB != imp()->sizeB)
     {
@@ -186,6 +196,12 @@ void LOutput::setMode(const LOutputMode *mode)
         if (o->threadId() == std::this_thread::get_id())
             return;
 
+    // Wait for a pending asynchronous operation
+    imp()->finishAsyncOperation(true);
+
+    if (mode == currentMode())
+        return;
+
     imp()->callLockACK.store(false);
     imp()->callLock.store(false);
     compositor()->imp()->unlock();
@@ -200,11 +216,36 @@ void LOutput::setMode(const LOutputMode *mode)
 
     compositor()->imp()->lock();
     imp()->state = ChangingMode;
+    cursor()->imp()->fastPathRemoveOutput(this);
     compositor()->imp()->graphicBackend->outputSetMode(this, (LOutputMode*)mode);
     imp()->state = Initialized;
+    cursor()->imp()->fastPathRefresh();
     imp()->callLock.store(true);
 }
 
+bool LOutput::setModeAsync(const LOutputMode *mode)
+{
+    if (mode == currentMode() || imp()->asyncOperation.load() != LOutputPrivate::NoAsyncOperation)
+        return false;
+
+    // Setting output mode from a rendering thread is not allowed
+    for (LOutput *o : compositor()->outputs())
+        if (o->threadId() == std::this_thread::get_id())
+            return false;
+
+    if (imp()->state != Initialized)
+    {
+        setMode(mode);
+        return false;
+    }
+
+    // Frames are skipped until backendResizeGL() restores the Initialized state
+    imp()->state = ChangingMode;
+    cursor()->imp()->fastPathRemoveOutput(this);
+    imp()->startAsyncOperation(LOutputPrivate::AsyncSetMode, mode);
+    return true;
+}
+
 Int32 LOutput::currentBuffer() const
 {
     return compositor()->imp()->graphicBackend->outputGetCurrentBufferIndex((LOutput*)this);
@@ -246,6 +287,7 @@ void LOutput::setScale(Float32 scale)
         return;
 
     repaint();
+    cursor()->imp()->fastPathRemoveOutput(this);
     imp()->scale = ceilf(scale);
     imp()->fractionalScale = scale;
 
@@ -265,6 +307,7 @@ void LOutput::setScale(Float32 scale)
     imp()->updateRect();
     imp()->updateGlobals();
     cursor()->imp()->textureChanged = true;
+    cursor()->imp()->fastPathRefresh();
 
     for (LSurface *s : compositor()->surfaces())
         s->imp()->sendPreferredScale();
@@ -358,3 +401,20 @@ const std::thread::id &LOutput::threadId() const
 {
     return imp()->threadId;
 }
+
+UInt64 LOutput::copiedBytes() const
+{
+    return compositor()->imp()->graphicBackend->outputGetCopiedBytes((LOutput*)this);
+}
+
+std::vector<LOutput::FrameStats> LOutput::frameStats() const
+{
+    std::vector<FrameStats> stats;
+    const UInt64 count { std::min(imp()->frameCount, (UInt64)LOUTPUT_FRAME_STATS_SIZE) };
+    stats.reserve(count);
+
+    for (UInt64 frame = imp()->frameCount - count; frame < imp()->frameCount; frame++)
+        stats.push_back(imp()->frameStats[frame % LOUTPUT_FRAME_STATS_SIZE]);
+
+    return stats;
+}
@@ -139,6 +139,9 @@
  * For this reason, Louvre offers the option to render using oversampling, where all the screen content is rendered in a larger buffer, and then that rendered buffer is scaled down to the screen framebuffer.
  * This method almost completely eliminates aliasing but has the disadvantage of consuming more computational power, potentially decreasing performance.
  * Without oversampling the content is directly rendered on the screen, making it efficient but retaining aliasing artifacts.
+ * In that mode the intermediate framebuffer is released, textures are snapped to the screen pixel grid to avoid seams between adjacent
+ * elements, and those mapped 1:1 to screen pixels (e.g. buffers from clients supporting the fractional scaling protocol) are sampled
+ * without filtering to keep them sharp.
  * Louvre allows you to toggle oversampling on and off instantly at any time using enableFractionalOversampling().
  * For example, you could enable it when displaying a desktop with floating windows and disable it when displaying a fullscreen window.
  *
@@ -200,6 +203,29 @@ public:
         VerticalBGR     = 5  ///< Vertical BGR layout.
     };
 
+    /**
+     * @brief Performance statistics of a frame.
+     *
+     * Collected by the library each time paintGL() is invoked, see frameStats().\n
+     * Times are in nanoseconds and timestamps use `CLOCK_MONOTONIC`.
+     * The damage, opaque and translucent times are only measured when rendering with an LScene, and are 0 otherwise.
+     */
+    struct FrameStats
+    {
+        UInt64 frame;               ///< Number of the frame, incremented after each paintGL() call.
+        Int64 paintTime;            ///< Timestamp at which the frame started to be processed.
+        Int64 totalTime;            ///< CPU time of the whole frame, including paintGL() and the flush.
+        Int64 damageTime;           ///< CPU time spent calculating the damage of the scene views.
+        Int64 opaqueTime;           ///< CPU time spent in the opaque pass of the scene.
+        Int64 translucentTime;      ///< CPU time spent in the translucent pass of the scene.
+        Int64 flushTime;            ///< CPU time spent after paintGL() returns (fractional scaling, screen captures and client flush).
+        Int64 gpuTime;              ///< GPU time of the frame, -1 if timer queries are not supported or the result is not available yet.
+        UInt64 damagedArea;         ///< Area in buffer pixels of the damage set with setBufferDamage(), or the whole current mode if not set.
+        UInt32 drawCalls;           ///< Number of draw calls issued by the output LPainter.
+        UInt32 textureUploads;      ///< Number of CPU texture uploads made by any thread since the previous frame of this output. The counter is shared by all outputs, so uploads are not attributed to the output that uses the textures.
+        Int64 presentationTime;     ///< Timestamp of the page flip that presented the frame, -1 if not presented yet.
+    };
+
     /**
      * @brief Constructor of the LOutput class.
      */
@@ -428,6 +454,22 @@ public:
      */
     void setMode(const LOutputMode *mode);
 
+    /**
+     * @brief Set the output mode asynchronously.
+     *
+     * Unlike setMode(), this method returns immediately instead of blocking the main loop while the graphic backend
+     * performs the mode setting, so clients and other outputs keep running normally.\n
+     * The resizeGL() event is triggered from the output thread once the new mode is applied, and setModeCompleted() is
+     * invoked from the main thread once the operation finishes.
+     *
+     * @note If the output is not initialized the mode is assigned immediately as with setMode() and setModeCompleted() is not invoked.
+     *
+     * @param mode One of the modes listed in modes().
+     * @return `true` if the mode change was started and setModeCompleted() will be invoked, `false` if the mode is already the current one,
+     *         the output is not initialized, another asynchronous operation is in progress or when called from a rendering thread.
+     */
+    bool setModeAsync(const LOutputMode *mode);
+
     /**
      * @brief Set the output scale factor.
      *
@@ -488,6 +530,7 @@ public:
      * @note Oversampling is always turned off for integer scales.
      *       You can instantly turn oversampling on or off when using a fractional scale.
      *       However, it is recommended to perform a full repaint in such cases to ensure the framebuffers stay synchronized.
+     *       Disabling it releases the intermediate framebuffer used for oversampling.
      *
      * @param enabled `true` to enable oversampling for fractional scales, `false` to disable.
      */
@@ -605,6 +648,27 @@ public:
      */
     const std::thread::id &threadId() const;
 
+    /**
+     * @brief Bytes copied to the GPU of this output from other GPUs.
+     *
+     * On multi-GPU setups, CPU textures are allocated in the main GPU and copied to the GPU of the output
+     * the first time they are used in it. Later updates only copy the damaged rects.\n
+     * This method returns the total number of bytes copied to the renderer GPU of this output so far,
+     * which is shared by all outputs driven by the same GPU. It is always 0 on single GPU setups.
+     */
+    UInt64 copiedBytes() const;
+
+    /**
+     * @brief Statistics of the last painted frames.
+     *
+     * Returns the statistics of up to the last 128 frames, from oldest to newest.\n
+     * Collection is always enabled and only adds a few timestamps and counters per frame. The GPU time is measured with
+     * `GL_EXT_disjoint_timer_query` when available and, like the presentation time, is filled in a few frames later.
+     *
+     * @see FrameStats
+     */
+    std::vector<FrameStats> frameStats() const;
+
     /**
      * @name Virtual Methods
      */
@@ -625,6 +689,35 @@ public:
      */
     virtual void initializeGL();
 
+    /**
+     * @brief Asynchronous initialization completed.
+     *
+     * Invoked from the main thread once the initialization started with LCompositor::addOutputAsync() finishes.
+     * If it failed, the output has already been removed from LCompositor::outputs().
+     *
+     * @note Not invoked if the output is removed with LCompositor::removeOutput() before the initialization finishes.
+     *
+     * @param success `true` if the output was initialized (after initializeGL()), `false` otherwise.
+     *
+     * #### Default Implementation
+     * @snippet LOutputDefault.cpp initializeCompleted
+     */
+    virtual void initializeCompleted(bool success);
+
+    /**
+     * @brief Asynchronous mode change completed.
+     *
+     * Invoked from the main thread once the mode change started with setModeAsync() finishes.
+     *
+     * @note Not invoked if the output is removed with LCompositor::removeOutput() before the mode change finishes.
+     *
+     * @param success `true` if the new mode was applied, `false` otherwise.
+     *
+     * #### Default Implementation
+     * @snippet LOutputDefault.cpp setModeCompleted
+     */
+    virtual void setModeCompleted(bool success);
+
     /**
      * @brief Paint Event.
      *
@@ -708,6 +801,28 @@ public:
      */
     virtual void setGammaRequest(LClient *client, const LGammaTable *gamma);
 
+    /**
+     * @brief Screen capture request.
+     *
+     * Clients using the [wlr screencopy](https://wayland.app/protocols/wlr-screencopy-unstable-v1#zwlr_screencopy_manager_v1)
+     * protocol can request to capture the content of an output or part of it.\n
+     * If allowed, the region is copied directly into the client's buffer right after the next frame is rendered,
+     * with `glReadPixels()` for shared memory buffers or a GPU copy for DMA buffers.
+     *
+     * @warning The default implementation allows all clients to capture the screen. For security reasons, consider
+     *          permitting only authorized clients, the mechanism to identify them is left to the developer's discretion.
+     *
+     * @note The hardware cursor plane is not included in the capture.
+     *
+     * @param client Pointer to the client making the request.
+     * @param region Region to capture in surface coordinates relative to the output, already clipped to its size().
+     * @return `true` to allow the capture, `false` to deny it.
+     *
+     * #### Default Implementation
+     * @snippet LOutputDefault.cpp screenCopyRequest
+     */
+    virtual bool screenCopyRequest(LClient *client, const LRect &region);
+
 ///@}
 
     LPRIVATE_IMP_UNIQUE(LOutput)
@@ -10,7 +10,9 @@
 #include <LLog.h>
 
 #include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
 #include <cstdio>
+#include <cstdlib>
 #include <string.h>
 
 using namespace Louvre;
@@ -32,11 +34,20 @@ static void makeExternalShader(std::string &shader)
 
 void LPainter::bindTextureMode(const TextureParams &p)
 {
+    if (imp()->software)
+    {
+        imp()->software->bindTextureMode(p);
+        return;
+    }
+
     GLenum target = p.texture->target();
     imp()->switchTarget(target);
 
     Float32 fbScale;
 
+    // Rendering directly with a fractional scale (no oversampling)
+    bool directFractional = false;
+
     if (imp()->fb->type() == LFramebuffer::Output)
     {
         LOutputFramebuffer *outputFB = (LOutputFramebuffer*)imp()->fb;
@@ -50,6 +61,7 @@ void LPainter::bindTextureMode(const TextureParams &p)
             else
             {
                 fbScale = outputFB->output()->fractionalScale();
+                directFractional = true;
             }
         }
         else
@@ -281,6 +293,27 @@ void LPainter::bindTextureMode(const TextureParams &p)
     srcFbW = srcFbX2 * fbScale - srcFbX1;
     srcFbH = srcFbY2 * fbScale - srcFbY1;
 
+    GLint filter = GL_LINEAR;
+
+    if (directFractional)
+    {
+        /* Snap both edges of the texture to the framebuffer pixel grid, otherwise adjacent textures
+         * can leave seams or blend half pixels of each other */
+        srcFbX2 = roundf(srcFbX1 + srcFbW);
+        srcFbY2 = roundf(srcFbY1 + srcFbH);
+        srcFbX1 = roundf(srcFbX1);
+        srcFbY1 = roundf(srcFbY1);
+        srcFbW = srcFbX2 - srcFbX1;
+        srcFbH = srcFbY2 - srcFbY1;
+
+        // When a texel maps exactly to a pixel there is nothing to interpolate
+        const Float32 texW = Float32(rotate ? p.texture->sizeB().h() : p.texture->sizeB().w());
+        const Float32 texH = Float32(rotate ? p.texture->sizeB().w() : p.texture->sizeB().h());
+
+        if (fabs(fabs(srcFbW) - texW) < 0.5f && fabs(fabs(srcFbH) - texH) < 0.5f)
+            filter = GL_NEAREST;
+    }
+
     imp()->srcRect.x = srcFbX1;
     imp()->srcRect.y = srcFbY1;
 
@@ -291,8 +324,8 @@ void LPainter::bindTextureMode(const TextureParams &p)
     imp()->shaderSetMode(3);
     imp()->shaderSetActiveTexture(0);
     glBindTexture(target, p.texture->id(imp()->output));
-    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, filter);
     glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 }
@@ -300,24 +333,52 @@ void LPainter::bindTextureMode(const TextureParams &p)
 void LPainter::bindColorMode()
 {
     imp()->shaderSetMode(1);
+
+    if (imp()->software)
+        imp()->software->bindColorMode();
 }
 
 void LPainter::drawBox(const LBox &box)
 {
+    if (imp()->software)
+    {
+        imp()->software->drawBoxes(&box, 1);
+        imp()->drawCalls++;
+        return;
+    }
+
     imp()->setViewport(box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    imp()->drawCalls++;
 }
 
 void LPainter::drawRect(const LRect &rect)
 {
+    if (imp()->software)
+    {
+        const LBox box { rect.x(), rect.y(), rect.x() + rect.w(), rect.y() + rect.h() };
+        imp()->software->drawBoxes(&box, 1);
+        imp()->drawCalls++;
+        return;
+    }
+
     imp()->setViewport(rect.x(), rect.y(), rect.w(), rect.h());
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    imp()->drawCalls++;
 }
 
 void LPainter::drawRegion(const LRegion &region)
 {
     Int32 n;
     LBox *box = region.boxes(&n);
+    imp()->drawCalls += n;
+
+    if (imp()->software)
+    {
+        imp()->software->drawBoxes(box, n);
+        return;
+    }
+
     for (Int32 i = 0; i < n; i++)
     {
         imp()->setViewport(box->x1,
@@ -353,7 +414,10 @@ LPainter::LPainter() : LPRIVATE_INIT_UNIQUE(LPainter)
 {
     imp()->painter = this;
 
-    compositor()->imp()->threadsMap[std::this_thread::get_id()].painter = this;
+    const UInt32 slot { compositor()->imp()->currentThreadSlot() };
+
+    if (slot != LCompositor::LCompositorPrivate::InvalidThreadSlot)
+        compositor()->imp()->threadsData[slot].painter = this;
 
     imp()->updateExtensions();
     imp()->updateCPUFormats();
@@ -575,37 +639,18 @@ LPainter::LPainter() : LPRIVATE_INIT_UNIQUE(LPainter)
         }
         )";
 
-    std::string fShaderStrScalerExternal = fShaderStr;
+    std::string fShaderStrScalerExternal = fShaderStrScaler;
     makeExternalShader(fShaderStrScalerExternal);
 
-    imp()->vertexShader = LOpenGL::compileShader(GL_VERTEX_SHADER, vShaderStr);
-    imp()->fragmentShader = LOpenGL::compileShader(GL_FRAGMENT_SHADER, fShaderStr);
-    imp()->fragmentShaderExternal = LOpenGL::compileShader(GL_FRAGMENT_SHADER, fShaderStrExternal.c_str());
-    imp()->fragmentShaderScaler = LOpenGL::compileShader(GL_FRAGMENT_SHADER, fShaderStrScaler);
-    imp()->fragmentShaderScalerExternal = LOpenGL::compileShader(GL_FRAGMENT_SHADER, fShaderStrScalerExternal.c_str());
-
-    GLint linked;
+    /* Linked programs are loaded from the on-disk program binary cache when possible,
+     * see LOpenGL::linkProgram() */
 
     /************** SCALER PROGRAM **************/
 
-    imp()->programObjectScaler = glCreateProgram();
-    glAttachShader(imp()->programObjectScaler, imp()->vertexShader);
-    glAttachShader(imp()->programObjectScaler, imp()->fragmentShaderScaler);
+    imp()->programObjectScaler = LOpenGL::linkProgram(vShaderStr, fShaderStrScaler);
 
-    // Link the program
-    glLinkProgram(imp()->programObjectScaler);
-
-    // Check the link status
-    glGetProgramiv(imp()->programObjectScaler, GL_LINK_STATUS, &linked);
-
-    if (!linked)
-    {
-        GLint infoLen = 0;
-        glGetProgramiv(imp()->programObjectScaler, GL_INFO_LOG_LENGTH, &infoLen);
-        glDeleteProgram(imp()->programObjectScaler);
-        imp()->programObjectScaler = 0;
-        LLog::error("[LPainter::LPainter] Failed to compile scaler shader.");
-    }
+    if (!imp()->programObjectScaler)
+        LLOG_ERROR("[LPainter::LPainter] Failed to compile scaler shader.");
     else
     {
         imp()->currentProgram = imp()->programObjectScaler;
@@ -615,24 +660,10 @@ LPainter::LPainter() : LPRIVATE_INIT_UNIQUE(LPainter)
 
     /************** SCALER PROGRAM EXTERNAL **************/
 
-    imp()->programObjectScalerExternal = glCreateProgram();
-    glAttachShader(imp()->programObjectScalerExternal, imp()->vertexShader);
-    glAttachShader(imp()->programObjectScalerExternal, imp()->fragmentShaderScalerExternal);
-
-    // Link the program
-    glLinkProgram(imp()->programObjectScalerExternal);
+    imp()->programObjectScalerExternal = LOpenGL::linkProgram(vShaderStr, fShaderStrScalerExternal.c_str());
 
-    // Check the link status
-    glGetProgramiv(imp()->programObjectScalerExternal, GL_LINK_STATUS, &linked);
-
-    if (!linked)
-    {
-        GLint infoLen = 0;
-        glGetProgramiv(imp()->programObjectScalerExternal, GL_INFO_LOG_LENGTH, &infoLen);
-        glDeleteProgram(imp()->programObjectScalerExternal);
-        imp()->programObjectScalerExternal = 0;
-        LLog::error("[LPainter::LPainter] Failed to compile scaler shader external.");
-    }
+    if (!imp()->programObjectScalerExternal)
+        LLOG_ERROR("[LPainter::LPainter] Failed to compile scaler shader external.");
     else
     {
         imp()->currentProgram = imp()->programObjectScalerExternal;
@@ -642,23 +673,10 @@ LPainter::LPainter() : LPRIVATE_INIT_UNIQUE(LPainter)
 
     /************** RENDER PROGRAM EXTERNAL **************/
 
-    imp()->programObjectExternal = glCreateProgram();
-    glAttachShader(imp()->programObjectExternal, imp()->vertexShader);
-    glAttachShader(imp()->programObjectExternal, imp()->fragmentShaderExternal);
-
-    // Link the program
-    glLinkProgram(imp()->programObjectExternal);
-
-    // Check the link status
-    glGetProgramiv(imp()->programObjectExternal, GL_LINK_STATUS, &linked);
+    imp()->programObjectExternal = LOpenGL::linkProgram(vShaderStr, fShaderStrExternal.c_str());
 
-    if (!linked)
-    {
-        GLint infoLen = 0;
-        glGetProgramiv(imp()->programObjectExternal, GL_INFO_LOG_LENGTH, &infoLen);
-        glDeleteProgram(imp()->programObjectExternal);
-        LLog::error("[LPainter::LPainter] Failed to compile external OES shader.");
-    }
+    if (!imp()->programObjectExternal)
+        LLOG_ERROR("[LPainter::LPainter] Failed to compile external OES shader.");
     else
     {
         imp()->currentProgram = imp()->programObjectExternal;
@@ -671,23 +689,10 @@ LPainter::LPainter() : LPRIVATE_INIT_UNIQUE(LPainter)
 
     /************** RENDER PROGRAM **************/
 
-    imp()->programObject = glCreateProgram();
-    glAttachShader(imp()->programObject, imp()->vertexShader);
-    glAttachShader(imp()->programObject, imp()->fragmentShader);
-
-    // Link the program
-    glLinkProgram(imp()->programObject);
+    imp()->programObject = LOpenGL::linkProgram(vShaderStr, fShaderStr);
 
-    // Check the link status
-    glGetProgramiv(imp()->programObject, GL_LINK_STATUS, &linked);
-
-    if (!linked)
-    {
-        GLint infoLen = 0;
-        glGetProgramiv(imp()->programObject, GL_INFO_LOG_LENGTH, &infoLen);
-        glDeleteProgram(imp()->programObject);
+    if (!imp()->programObject)
         exit(-1);
-    }
 
     imp()->currentProgram = imp()->programObject;
 #if LPAINTER_TRACK_UNIFORMS == 1
@@ -711,19 +716,28 @@ LPainter::LPainter() : LPRIVATE_INIT_UNIQUE(LPainter)
 
     imp()->shaderSetColorFactor(1.f, 1.f, 1.f, 1.f);
     imp()->shaderSetAlpha(1.f);
+
+    if (LSoftwareRenderer::enabled())
+        imp()->software = new LSoftwareRenderer(this);
 }
 
 LPainter::~LPainter()
 {
+    delete imp()->software;
+    imp()->software = nullptr;
+    imp()->finishReadbacks();
+    imp()->finishTimerQueries();
     glDeleteProgram(imp()->programObject);
     glDeleteProgram(imp()->programObjectExternal);
-    glDeleteShader(imp()->fragmentShaderExternal);
-    glDeleteShader(imp()->fragmentShader);
-    glDeleteShader(imp()->vertexShader);
+    glDeleteProgram(imp()->programObjectScaler);
+    glDeleteProgram(imp()->programObjectScalerExternal);
 }
 
 void LPainter::bindFramebuffer(LFramebuffer *framebuffer)
 {
+    if (imp()->software)
+        imp()->software->bindFramebuffer(framebuffer);
+
     if (!framebuffer)
     {
         imp()->fbId = 0;
@@ -744,6 +758,24 @@ LFramebuffer *LPainter::boundFramebuffer() const
 void LPainter::LPainterPrivate::updateExtensions()
 {
     openGLExtensions.EXT_read_format_bgra = LOpenGL::hasExtension("GL_EXT_read_format_bgra");
+    openGLExtensions.OES_texture_npot = LOpenGL::hasExtension("GL_OES_texture_npot");
+    openGLExtensions.EXT_disjoint_timer_query = LOpenGL::hasExtension("GL_EXT_disjoint_timer_query");
+
+    if (openGLExtensions.EXT_disjoint_timer_query)
+    {
+        glGenQueriesEXT = (PFNGLGENQUERIESEXTPROC)eglGetProcAddress("glGenQueriesEXT");
+        glDeleteQueriesEXT = (PFNGLDELETEQUERIESEXTPROC)eglGetProcAddress("glDeleteQueriesEXT");
+        glBeginQueryEXT = (PFNGLBEGINQUERYEXTPROC)eglGetProcAddress("glBeginQueryEXT");
+        glEndQueryEXT = (PFNGLENDQUERYEXTPROC)eglGetProcAddress("glEndQueryEXT");
+        glGetQueryObjectuivEXT = (PFNGLGETQUERYOBJECTUIVEXTPROC)eglGetProcAddress("glGetQueryObjectuivEXT");
+        glGetQueryObjectui64vEXT = (PFNGLGETQUERYOBJECTUI64VEXTPROC)eglGetProcAddress("glGetQueryObjectui64vEXT");
+        openGLExtensions.EXT_disjoint_timer_query = glGenQueriesEXT && glDeleteQueriesEXT && glBeginQueryEXT &&
+            glEndQueryEXT && glGetQueryObjectuivEXT && glGetQueryObjectui64vEXT;
+    }
+
+    // "OpenGL ES N.M ..."
+    const char *version { (const char*)glGetString(GL_VERSION) };
+    GLES3 = version && strncmp(version, "OpenGL ES ", 10) == 0 && atoi(&version[10]) >= 3;
 }
 
 void LPainter::LPainterPrivate::updateCPUFormats()
@@ -894,6 +926,9 @@ void LPainter::setViewport(Int32 x, Int32 y, Int32 w, Int32 h)
 void LPainter::setClearColor(Float32 r, Float32 g, Float32 b, Float32 a)
 {
     glClearColor(r,g,b,a);
+
+    if (imp()->software)
+        imp()->software->clearColor = {r, g, b, a};
 }
 
 void LPainter::setColorFactor(Float32 r, Float32 g, Float32 b, Float32 a)
@@ -906,6 +941,12 @@ void LPainter::clearScreen()
     if (!imp()->fb)
         return;
 
+    if (imp()->software)
+    {
+        imp()->software->clearScreen();
+        return;
+    }
+
     glDisable(GL_BLEND);
     imp()->setViewport(imp()->fb->rect().x(), imp()->fb->rect().y(), imp()->fb->rect().w(), imp()->fb->rect().h());
     glClear(GL_COLOR_BUFFER_BIT);
@@ -916,3 +957,234 @@ void LPainter::bindProgram()
 {
     glUseProgram(imp()->programObject);
 }
+
+bool LPainter::LPainterPrivate::readPixelsAsync(const LRect &src, GLenum format, const LTexture::ReadPixelsCallback &callback)
+{
+    if (src.w() <= 0 || src.h() <= 0 || !callback)
+        return false;
+
+    Readback *readback { nullptr };
+
+    // Pick the next free slot of the ring, if all are busy wait for the oldest
+    while (true)
+    {
+        for (UInt32 i = 0; i < LPAINTER_READBACK_RING_SIZE; i++)
+        {
+            Readback &slot { readbacks[(readbackIndex + i) % LPAINTER_READBACK_RING_SIZE] };
+
+            if (!slot.busy)
+            {
+                readback = &slot;
+                readbackIndex = (readbackIndex + i + 1) % LPAINTER_READBACK_RING_SIZE;
+                break;
+            }
+        }
+
+        if (readback)
+            break;
+
+        // All slots are being completed (nested calls from callbacks)
+        if (pendingReadbacks.empty())
+            return false;
+
+        Readback *oldest { pendingReadbacks.front() };
+
+        if (oldest->fence)
+            glClientWaitSync(oldest->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+
+        processReadbacks(false);
+    }
+
+    const GLenum readFormat { (format == GL_BGRA_EXT && !openGLExtensions.EXT_read_format_bgra) ? GL_RGBA : format };
+    const GLsizeiptr bytes { src.w() * src.h() * 4 };
+
+    readback->size = src.size();
+    readback->swizzle = readFormat != format;
+    readback->callback = callback;
+    readback->busy = true;
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    if (GLES3)
+    {
+        if (readback->pbo == 0)
+            glGenBuffers(1, &readback->pbo);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+
+        if (readback->pboSize < bytes)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+            readback->pboSize = bytes;
+        }
+
+        // Returns immediately, the copy happens on the GPU timeline
+        glReadPixels(src.x(), src.y(), src.w(), src.h(), readFormat, GL_UNSIGNED_BYTE, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+    }
+    else
+    {
+        readback->pixels = (UChar8*)malloc(bytes);
+        glReadPixels(src.x(), src.y(), src.w(), src.h(), readFormat, GL_UNSIGNED_BYTE, readback->pixels);
+    }
+
+    pendingReadbacks.push_back(readback);
+    return true;
+}
+
+void LPainter::LPainterPrivate::processReadbacks(bool wait)
+{
+    while (!pendingReadbacks.empty())
+    {
+        Readback *readback { pendingReadbacks.front() };
+        UChar8 *pixels { readback->pixels };
+
+        if (readback->fence)
+        {
+            const GLenum status { glClientWaitSync(readback->fence, 0, wait ? 1000000000 : 0) };
+
+            if (status == GL_TIMEOUT_EXPIRED && !wait)
+                return;
+
+            glDeleteSync(readback->fence);
+            readback->fence = nullptr;
+
+            if (status != GL_WAIT_FAILED)
+            {
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->pbo);
+                const UChar8 *mapped { (const UChar8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback->size.area() * 4, GL_MAP_READ_BIT) };
+
+                if (mapped)
+                {
+                    pixels = (UChar8*)malloc(readback->size.area() * 4);
+                    memcpy(pixels, mapped, readback->size.area() * 4);
+                    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                }
+
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            }
+        }
+
+        // Removed before invoking the callback since it may schedule new readbacks
+        pendingReadbacks.pop_front();
+        readback->pixels = nullptr;
+        LTexture::ReadPixelsCallback callback;
+        std::swap(callback, readback->callback);
+        readback->busy = false;
+
+        if (pixels && readback->swizzle)
+        {
+            UChar8 tmp;
+
+            for (Int32 i = 0; i < readback->size.area() * 4; i+=4)
+            {
+                tmp = pixels[i];
+                pixels[i] = pixels[i+2];
+                pixels[i+2] = tmp;
+            }
+        }
+
+        callback(pixels, readback->size, readback->size.w() * 4);
+        free(pixels);
+    }
+}
+
+void LPainter::LPainterPrivate::finishReadbacks()
+{
+    processReadbacks(true);
+
+    for (UInt32 i = 0; i < LPAINTER_READBACK_RING_SIZE; i++)
+    {
+        if (readbacks[i].pbo)
+        {
+            glDeleteBuffers(1, &readbacks[i].pbo);
+            readbacks[i].pbo = 0;
+            readbacks[i].pboSize = 0;
+        }
+    }
+}
+
+void LPainter::LPainterPrivate::beginTimerQuery(UInt64 frame)
+{
+    if (!openGLExtensions.EXT_disjoint_timer_query || currentTimerQuery)
+        return;
+
+    TimerQuery *query { &timerQueries[timerQueryIndex] };
+
+    // All queries still in flight, skip this frame
+    if (query->busy)
+        return;
+
+    if (query->id == 0)
+        glGenQueriesEXT(1, &query->id);
+
+    timerQueryIndex = (timerQueryIndex + 1) % LPAINTER_TIMER_QUERY_RING_SIZE;
+    query->frame = frame;
+    query->busy = true;
+    glBeginQueryEXT(GL_TIME_ELAPSED_EXT, query->id);
+    currentTimerQuery = query;
+}
+
+void LPainter::LPainterPrivate::endTimerQuery()
+{
+    if (!currentTimerQuery)
+        return;
+
+    glEndQueryEXT(GL_TIME_ELAPSED_EXT);
+    currentTimerQuery = nullptr;
+}
+
+void LPainter::LPainterPrivate::processTimerQueries()
+{
+    if (!openGLExtensions.EXT_disjoint_timer_query)
+        return;
+
+    // Results are invalid if the GPU was reset or its clock changed
+    GLint disjoint { 0 };
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+    // Oldest query first, they finish in submission order
+    for (UInt32 i = 0; i < LPAINTER_TIMER_QUERY_RING_SIZE; i++)
+    {
+        TimerQuery &query { timerQueries[(timerQueryIndex + i) % LPAINTER_TIMER_QUERY_RING_SIZE] };
+
+        if (!query.busy || &query == currentTimerQuery)
+            continue;
+
+        GLuint available { 0 };
+        glGetQueryObjectuivEXT(query.id, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+
+        if (!available)
+            return;
+
+        GLuint64 elapsed { 0 };
+        glGetQueryObjectui64vEXT(query.id, GL_QUERY_RESULT_EXT, &elapsed);
+        query.busy = false;
+
+        if (disjoint || !output)
+            continue;
+
+        LOutput::FrameStats *stats { output->imp()->frameStatsOf(query.frame) };
+
+        if (stats)
+            stats->gpuTime = elapsed;
+    }
+}
+
+void LPainter::LPainterPrivate::finishTimerQueries()
+{
+    endTimerQuery();
+
+    for (UInt32 i = 0; i < LPAINTER_TIMER_QUERY_RING_SIZE; i++)
+    {
+        if (timerQueries[i].id)
+        {
+            glDeleteQueriesEXT(1, &timerQueries[i].id);
+            timerQueries[i].id = 0;
+        }
+
+        timerQueries[i].busy = false;
+    }
+}
@@ -12,7 +12,8 @@
  * The LPainter class offers basic methods for 2D rendering without the need to use OpenGL functions directly.
  * It can draw texture rects or solid colors, clear the screen and set the viewport.\n
  * Its goal is to abstract the rendering API, allowing for portable compositors, independent of the renderer used.\n
- * Currently, the library only offers the OpenGL ES 2.0 renderer, but in the future others such as Vulkan, Pixman, etc. could be incorporated.\n
+ * The library renders with OpenGL ES 2.0 by default. Setting the **LOUVRE_RENDERER** environment variable to `pixman` makes the painter
+ * composite into CPU images with Pixman instead, uploading only the damaged pixels to the framebuffers (see @ref software-renderer).\n
  * Each LOutput has its own LPainter, which can be accessed from LOutput::painter().\n
  *
  * @note You are not obligated to use LPainter methods for rendering. You have the flexibility to use OpenGL functions and your
@@ -6,12 +6,14 @@
 #include <private/LToplevelRolePrivate.h>
 #include <private/LSeatPrivate.h>
 #include <private/LCompositorPrivate.h>
+#include <private/LCursorPrivate.h>
 #include <LCursor.h>
 #include <LOutput.h>
 #include <LPopupRole.h>
 #include <LTime.h>
 #include <LKeyboard.h>
 #include <LDNDManager.h>
+#include <LOutputMode.h>
 
 using namespace Louvre;
 using namespace Louvre::Protocols;
@@ -98,11 +100,13 @@ void LPointer::sendMoveEvent(const LPoint &localPos)
     if (seat()->dndManager()->focus())
         seat()->dndManager()->focus()->client()->dataDevice().imp()->sendDNDMotionEventS(x, y);
 
+    // Use the timestamp of the input event when available
+    const UInt32 ms { imp()->motionTimeUs != 0 ? static_cast<UInt32>(imp()->motionTimeUs / 1000) : LTime::ms() };
+
     for (Wayland::GSeat *s : focus()->client()->seatGlobals())
     {
         if (s->pointerResource())
         {
-            UInt32 ms = LTime::ms();
             s->pointerResource()->motion(ms, x, y);
             s->pointerResource()->frame();
         }
@@ -399,6 +403,110 @@ LSurface *LPointer::focus() const
     return imp()->pointerFocusSurface;
 }
 
+void LPointer::enableMotionCoalescing(bool enabled)
+{
+    if (!enabled)
+        imp()->flushMotion();
+
+    imp()->motionCoalescing = enabled;
+}
+
+bool LPointer::motionCoalescingEnabled() const
+{
+    return imp()->motionCoalescing;
+}
+
+UInt64 LPointer::coalescedMotionEvents() const
+{
+    return imp()->coalescedMotionEvents;
+}
+
+void LPointer::resetCoalescedMotionEvents()
+{
+    imp()->coalescedMotionEvents = 0;
+}
+
+static UInt64 nowUs()
+{
+    const timespec ts { LTime::ns() };
+    return static_cast<UInt64>(ts.tv_sec) * 1000000 + static_cast<UInt64>(ts.tv_nsec) / 1000;
+}
+
+void LPointer::LPointerPrivate::backendMoveEvent(Float32 dx, Float32 dy, UInt64 timeUs, bool fastPath)
+{
+    if (!motionCoalescing)
+    {
+        dispatchMotion(dx, dy, timeUs, fastPath);
+        return;
+    }
+
+    if (pendingMotionEvents > 0)
+        coalescedMotionEvents++;
+
+    pendingMotionX += dx;
+    pendingMotionY += dy;
+    pendingMotionFastPath = fastPath;
+    pendingMotionEvents++;
+
+    if (timeUs > pendingMotionTimeUs)
+        pendingMotionTimeUs = timeUs;
+
+    // The first motion after an idle period is dispatched immediately, the rest at most once per frame
+    if (motionFlushTimeout() == 0)
+        flushMotion();
+}
+
+void LPointer::LPointerPrivate::dispatchMotion(Float32 dx, Float32 dy, UInt64 timeUs, bool fastPath)
+{
+    if (fastPath)
+        cursor()->imp()->fastPathConsume(dx, dy);
+
+    motionTimeUs = timeUs;
+    seat()->pointer()->pointerMoveEvent(dx, dy, false);
+    motionTimeUs = 0;
+}
+
+void LPointer::LPointerPrivate::flushMotion()
+{
+    if (pendingMotionEvents == 0)
+        return;
+
+    const Float32 dx { static_cast<Float32>(pendingMotionX) };
+    const Float32 dy { static_cast<Float32>(pendingMotionY) };
+    const UInt64 timeUs { pendingMotionTimeUs };
+    pendingMotionX = pendingMotionY = 0.0;
+    pendingMotionEvents = 0;
+    pendingMotionTimeUs = 0;
+    lastMotionFlushUs = nowUs();
+    dispatchMotion(dx, dy, timeUs, pendingMotionFastPath);
+}
+
+UInt64 LPointer::LPointerPrivate::motionFlushPeriodUs() const
+{
+    // Refresh period of the fastest output, refreshRate() is in mHz
+    UInt32 maxRefreshRate { 0 };
+
+    for (LOutput *output : compositor()->outputs())
+        if (output->currentMode() && output->currentMode()->refreshRate() > maxRefreshRate)
+            maxRefreshRate = output->currentMode()->refreshRate();
+
+    return maxRefreshRate > 0 ? 1000000000 / maxRefreshRate : 16666;
+}
+
+Int32 LPointer::LPointerPrivate::motionFlushTimeout()
+{
+    if (pendingMotionEvents == 0)
+        return -1;
+
+    const UInt64 elapsedUs { nowUs() - lastMotionFlushUs };
+    const UInt64 periodUs { motionFlushPeriodUs() };
+
+    if (elapsedUs >= periodUs)
+        return 0;
+
+    return static_cast<Int32>((periodUs - elapsedUs + 999) / 1000);
+}
+
 void LPointer::LPointerPrivate::sendLeaveEvent(LSurface *surface)
 {
     if (seat()->dndManager()->focus() && seat()->dndManager()->focus() == surface)
@@ -248,6 +248,44 @@ public:
      */
     bool isButtonPressed(Button button) const;
 
+    /**
+     * @brief Merge relative pointer motion between frames.
+     *
+     * High polling rate mice can generate several motion events per frame, each one calling pointerMoveEvent(),
+     * which usually involves hit-testing surfaces or views and sending events to clients.\n
+     * When enabled, relative motion events received less than a refresh period (of the fastest output) after the last dispatched one
+     * are accumulated, and pointerMoveEvent() is called once with their exact sum, using the timestamp of the latest event
+     * for the events sent to clients. Pending motion is always dispatched before button and axis events, so their order is preserved.
+     *
+     * @note LSeat::nativeInputEvent() is still called for each input event, allowing you to forward full-rate relative motion
+     *       to clients that need it.
+     *
+     * Disabled by default.
+     *
+     * @see coalescedMotionEvents()
+     */
+    void enableMotionCoalescing(bool enabled);
+
+    /**
+     * @brief Checks if motion coalescing is enabled.
+     *
+     * @see enableMotionCoalescing()
+     */
+    bool motionCoalescingEnabled() const;
+
+    /**
+     * @brief Number of motion events merged into others.
+     *
+     * Motion events that did not produce their own pointerMoveEvent() call since the compositor started
+     * or resetCoalescedMotionEvents() was called.
+     */
+    UInt64 coalescedMotionEvents() const;
+
+    /**
+     * @brief Resets the coalescedMotionEvents() counter.
+     */
+    void resetCoalescedMotionEvents();
+
     /**
      * @name Client Events
      *
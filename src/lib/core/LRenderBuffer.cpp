@@ -22,9 +22,7 @@ LRenderBuffer::LRenderBuffer(const LSize &sizeB, bool alpha) : LPRIVATE_INIT_UNI
 
 LRenderBuffer::~LRenderBuffer()
 {
-    for (auto &pair : imp()->threadsMap)
-        if (pair.second.textureId)
-            compositor()->imp()->addRenderBufferToDestroy(pair.first, pair.second);
+    imp()->releaseThreadsData();
 }
 
 void LRenderBuffer::setSizeB(const LSize &sizeB)
@@ -45,12 +43,7 @@ void LRenderBuffer::setSizeB(const LSize &sizeB)
     if (imp()->texture.imp()->sizeB != sizeB)
     {
         imp()->texture.imp()->sizeB = sizeB;
-
-        for (auto &pair : imp()->threadsMap)
-            if (pair.second.textureId)
-                compositor()->imp()->addRenderBufferToDestroy(pair.first, pair.second);
-
-        imp()->threadsMap.clear();
+        imp()->releaseThreadsData();
     }
 }
 
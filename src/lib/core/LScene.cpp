@@ -2,6 +2,7 @@
 #include <private/LViewPrivate.h>
 #include <private/LSceneViewPrivate.h>
 #include <private/LSurfacePrivate.h>
+#include <private/LOutputPrivate.h>
 #include <LSurfaceView.h>
 #include <LOutput.h>
 #include <LCursor.h>
@@ -57,12 +58,8 @@ void LScene::handleResizeGL(LOutput *output)
 
 void LScene::handleUninitializeGL(LOutput *output)
 {
-    L_UNUSED(output);
     imp()->mutex.lock();
-    auto it = imp()->view.imp()->threadsMap.find(output->threadId());
-
-    if (it != imp()->view.imp()->threadsMap.end())
-        imp()->view.imp()->threadsMap.erase(it);
+    imp()->view.imp()->removeThreadData(output->imp()->threadSlot);
     imp()->mutex.unlock();
 }
 
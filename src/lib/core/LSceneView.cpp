@@ -2,6 +2,8 @@
 #include <private/LSceneViewPrivate.h>
 #include <private/LViewPrivate.h>
 #include <private/LPainterPrivate.h>
+#include <private/LOutputPrivate.h>
+#include <private/LTracePrivate.h>
 #include <LFramebuffer.h>
 #include <LRenderBuffer.h>
 #include <LOutput.h>
@@ -29,6 +31,9 @@ LSceneView::~LSceneView()
     while (!children().empty())
         children().front()->setParent(nullptr);
 
+    for (UInt32 slot = 0; slot < imp()->threadsData.size(); slot++)
+        imp()->removeThreadData(slot);
+
     if (!isLScene())
         delete imp()->fb;
 }
@@ -55,7 +60,10 @@ void LSceneView::damageAll(LOutput *output)
     if (!output)
         return;
 
-    LSceneViewPrivate::ThreadData *oD = &imp()->threadsMap[output->threadId()];
+    if (output->imp()->threadSlot == LCompositor::LCompositorPrivate::InvalidThreadSlot)
+        return;
+
+    LSceneViewPrivate::ThreadData *oD = &imp()->threadData(output->imp()->threadSlot);
 
     if (isLScene())
         oD->manuallyAddedDamage.addRect(output->rect());
@@ -70,7 +78,10 @@ void LSceneView::addDamage(LOutput *output, const LRegion &damage)
     if (!output)
         return;
 
-    LSceneViewPrivate::ThreadData *oD = &imp()->threadsMap[output->threadId()];
+    if (output->imp()->threadSlot >= imp()->threadsData.size())
+        return;
+
+    LSceneViewPrivate::ThreadData *oD = &imp()->threadsData[output->imp()->threadSlot];
 
     if (oD->o)
         oD->manuallyAddedDamage.addRegion(damage);
@@ -86,7 +97,13 @@ bool LSceneView::isLScene() const
 
 void LSceneView::render(const LRegion *exclude)
 {
-    LPainter *painter = compositor()->imp()->threadsMap[std::this_thread::get_id()].painter;
+    LTRACE_SCOPE("LSceneView::render");
+    const UInt32 slot { compositor()->imp()->currentThreadSlot() };
+
+    if (slot == LCompositor::LCompositorPrivate::InvalidThreadSlot)
+        return;
+
+    LPainter *painter = compositor()->imp()->threadsData[slot].painter;
 
     if (!painter)
         return;
@@ -101,8 +118,9 @@ void LSceneView::render(const LRegion *exclude)
         rb->setPos(pos());
     }
 
-    LSceneViewPrivate::ThreadData *oD = &imp()->threadsMap[std::this_thread::get_id()];
+    LSceneViewPrivate::ThreadData *oD = &imp()->threadData(slot);
     imp()->currentThreadData = oD;
+    imp()->currentThreadSlot = slot;
 
     // If painter was not cached
     if (!oD->p)
@@ -142,8 +160,14 @@ void LSceneView::render(const LRegion *exclude)
         }
     }
 
-    for (std::list<LView*>::const_reverse_iterator it = children().crbegin(); it != children().crend(); it++)
-        imp()->calcNewDamage(*it);
+    // Phase times are only recorded for the main scene view, nested ones are part of its passes
+    LOutput::FrameStats *stats { isLScene() && oD->o ? oD->o->imp()->currentFrameStats : nullptr };
+    Int64 phaseBegin { stats ? LOutput::LOutputPrivate::monotonicNs() : 0 };
+
+    imp()->updateFlatViews(this);
+
+    for (UInt32 i = imp()->flat.views.size(); i-- > 0;)
+        imp()->calcNewDamage(i);
 
     // Save new damage for next frame and add old damage to current damage
     if (imp()->fb->buffersCount() > 1)
@@ -164,18 +188,35 @@ void LSceneView::render(const LRegion *exclude)
         oD->prevDamageList.push_back(front);
     }
 
-    glDisable(GL_BLEND);
+    if (stats)
+    {
+        const Int64 now { LOutput::LOutputPrivate::monotonicNs() };
+        stats->damageTime += now - phaseBegin;
+        phaseBegin = now;
+    }
+
+    painter->imp()->setBlendingEnabled(false);
 
-    for (std::list<LView*>::const_reverse_iterator it = children().crbegin(); it != children().crend(); it++)
-        imp()->drawOpaqueDamage(*it);
+    for (UInt32 i = imp()->flat.views.size(); i-- > 0;)
+        imp()->drawOpaqueDamage(i);
 
     painter->imp()->shaderSetColorFactorEnabled(0);
     imp()->drawBackground(!isLScene() && imp()->clearColor.a >= 1.f);
 
-    glEnable(GL_BLEND);
+    if (stats)
+    {
+        const Int64 now { LOutput::LOutputPrivate::monotonicNs() };
+        stats->opaqueTime += now - phaseBegin;
+        phaseBegin = now;
+    }
+
+    painter->imp()->setBlendingEnabled(true);
+
+    for (UInt32 i = 0; i < imp()->flat.views.size(); i++)
+        imp()->drawTranslucentDamage(i);
 
-    for (std::list<LView*>::const_iterator it = children().cbegin(); it != children().cend(); it++)
-        imp()->drawTranslucentDamage(*it);
+    if (stats)
+        stats->translucentTime += LOutput::LOutputPrivate::monotonicNs() - phaseBegin;
 
     if (!isLScene())
     {
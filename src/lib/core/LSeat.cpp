@@ -153,7 +153,7 @@ Int32 LSeat::openDevice(const char *path, Int32 *fd)
     Int32 id = libseat_open_device(libseatHandle(), path, fd);
 
     if (id == -1)
-        LLog::error("[LSeat::openDevice] Failed to open device %s, id %d, %d.", path, id, *fd);
+        LLOG_ERROR("[LSeat::openDevice] Failed to open device %s, id %d, %d.", path, id, *fd);
 
     return id;
 }
@@ -166,7 +166,7 @@ Int32 LSeat::closeDevice(Int32 id)
     Int32 ret = libseat_close_device(libseatHandle(), id);
 
     if (ret == -1)
-        LLog::error("[LSeat::closeDevice] Failed to close device %d.", id);
+        LLOG_ERROR("[LSeat::closeDevice] Failed to close device %d.", id);
 
     return ret;
 }
@@ -192,3 +192,13 @@ LPopupRole *LSeat::topmostPopup() const
 
     return nullptr;
 }
+
+const LSeat::InputLatency &LSeat::inputLatency() const
+{
+    return imp()->inputLatency;
+}
+
+void LSeat::resetInputLatency()
+{
+    imp()->inputLatency = InputLatency();
+}
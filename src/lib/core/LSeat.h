@@ -51,6 +51,27 @@ public:
         Touch = 4
     };
 
+    /**
+     * @brief Input latency statistics
+     *
+     * Histogram of the time elapsed between the kernel timestamp of input events and
+     * the moment they are dispatched by the compositor (see inputLatency()).
+     */
+    struct InputLatency
+    {
+        /// Bucket `i` counts events with a latency in the range [2^i, 2^(i+1)) microseconds, bucket 0 also includes latencies under 1 µs
+        UInt64 histogram[32] {};
+
+        /// Number of events recorded
+        UInt64 count = 0;
+
+        /// Sum of all latencies in microseconds
+        UInt64 totalUs = 0;
+
+        /// Maximum latency in microseconds
+        UInt64 maxUs = 0;
+    };
+
     /**
      * @brief LSeat class constructor.
      *
@@ -259,6 +280,21 @@ public:
      */
     LPopupRole *topmostPopup() const;
 
+    /**
+     * @brief Input latency histogram.
+     *
+     * Latency statistics of the pointer and keyboard events dispatched since the compositor started or resetInputLatency() was called.
+     * Only events with kernel timestamps provided by the input backend are recorded.
+     *
+     * @note The Libinput backend can read events from a dedicated thread to reduce latency, see the **LOUVRE_INPUT_THREAD** environment variable.
+     */
+    const InputLatency &inputLatency() const;
+
+    /**
+     * @brief Clears the inputLatency() statistics.
+     */
+    void resetInputLatency();
+
 /// @}
 
 /// @name Virtual Methods
@@ -297,6 +333,9 @@ public:
      * @param event Opaque handle to the native backend event. In the Libinput backend it corresponds to a [libinput_event](https://wayland.freedesktop.org/libinput/doc/latest/api/structlibinput__event.html) struct 
      * and in the X11 backend to a [XEvent](https://www.x.org/releases/X11R7.6/doc/libX11/specs/libX11/libX11.html) struct.
      *
+     * @note With the Libinput input thread enabled (see @ref input), the libinput context is locked while this method is invoked,
+     *       so the event can be passed to libinput functions, but the input thread is blocked until it returns.
+     *
      * #### Default implementation
      * @snippet LSeatDefault.cpp backendNativeEvent
      */
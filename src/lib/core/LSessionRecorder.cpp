@@ -0,0 +1,324 @@
+#include <protocols/LinuxDMABuf/LDMABuffer.h>
+#include <protocols/Wayland/RRegion.h>
+#include <protocols/Wayland/RSurface.h>
+#include <private/LSessionRecorderPrivate.h>
+#include <private/LCompositorPrivate.h>
+#include <private/LSurfacePrivate.h>
+#include <LTexture.h>
+#include <LRegion.h>
+#include <LLog.h>
+#include <drm_fourcc.h>
+#include <time.h>
+#include <vector>
+
+using namespace Louvre;
+
+FILE *LSessionRecorder::LSessionRecorderPrivate::file { nullptr };
+Int64 LSessionRecorder::LSessionRecorderPrivate::startTime { 0 };
+UInt32 LSessionRecorder::LSessionRecorderPrivate::clientsCount { 0 };
+std::unordered_map<wl_client*, LSessionRecorder::LSessionRecorderPrivate::ClientEntry*> LSessionRecorder::LSessionRecorderPrivate::clients;
+std::unordered_map<wl_resource*, LSessionRecorder::LSessionRecorderPrivate::BufferEntry*> LSessionRecorder::LSessionRecorderPrivate::buffers;
+
+using Private = LSessionRecorder::LSessionRecorderPrivate;
+
+static Int64 nowUs()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (Int64)time.tv_sec * 1000000 + (Int64)time.tv_nsec / 1000;
+}
+
+static void onClientDestroy(wl_listener *listener, void *)
+{
+    Private::ClientEntry *entry { wl_container_of(listener, entry, destroyListener) };
+    Private::writeRecord(Private::ClientDestroy, entry->id, 0, nullptr, 0);
+    entry->destroyed = true;
+}
+
+static void onBufferDestroy(wl_listener *listener, void *data)
+{
+    Private::BufferEntry *entry { wl_container_of(listener, entry, destroyListener) };
+    Private::writeRecord(Private::BufferDestroy, entry->client, entry->id, nullptr, 0);
+    Private::buffers.erase((wl_resource*)data);
+    delete entry;
+}
+
+bool LSessionRecorder::start(const std::filesystem::path &path)
+{
+    stop();
+
+    LSessionRecorderPrivate::file = fopen(path.c_str(), "wb");
+
+    if (!LSessionRecorderPrivate::file)
+    {
+        LLOG_ERROR("[LSessionRecorder::start] Failed to open %s.", path.c_str());
+        return false;
+    }
+
+    // Buffer contents are written in large chunks
+    setvbuf(LSessionRecorderPrivate::file, nullptr, _IOFBF, 1 << 22);
+
+    const LSessionRecorderPrivate::FileHeader header { LSessionRecorderPrivate::Magic, LSessionRecorderPrivate::Version };
+    fwrite(&header, sizeof(header), 1, LSessionRecorderPrivate::file);
+    LSessionRecorderPrivate::startTime = nowUs();
+    LSessionRecorderPrivate::clientsCount = 0;
+    LLOG_DEBUG("[LSessionRecorder::start] Recording session to %s.", path.c_str());
+    return true;
+}
+
+void LSessionRecorder::stop()
+{
+    if (!LSessionRecorderPrivate::file)
+        return;
+
+    for (auto &client : LSessionRecorderPrivate::clients)
+    {
+        if (!client.second->destroyed)
+            wl_list_remove(&client.second->destroyListener.link);
+
+        delete client.second;
+    }
+
+    for (auto &buffer : LSessionRecorderPrivate::buffers)
+    {
+        wl_list_remove(&buffer.second->destroyListener.link);
+        delete buffer.second;
+    }
+
+    LSessionRecorderPrivate::clients.clear();
+    LSessionRecorderPrivate::buffers.clear();
+    fclose(LSessionRecorderPrivate::file);
+    LSessionRecorderPrivate::file = nullptr;
+}
+
+bool LSessionRecorder::recording()
+{
+    return LSessionRecorderPrivate::file != nullptr;
+}
+
+bool LSessionRecorder::LSessionRecorderPrivate::clientId(wl_client *client, bool create, UInt32 *id)
+{
+    auto it { clients.find(client) };
+    ClientEntry *entry;
+
+    if (it == clients.end())
+    {
+        if (!create)
+            return false;
+
+        entry = new ClientEntry();
+        clients[client] = entry;
+    }
+    else
+    {
+        entry = it->second;
+
+        if (!entry->destroyed)
+        {
+            *id = entry->id;
+            return true;
+        }
+
+        // A new client reusing the address of a destroyed one
+        if (!create)
+            return false;
+    }
+
+    entry->id = ++clientsCount;
+    entry->destroyed = false;
+    entry->destroyListener.notify = &onClientDestroy;
+    wl_client_add_destroy_listener(client, &entry->destroyListener);
+    writeRecord(ClientCreate, entry->id, 0, nullptr, 0);
+    *id = entry->id;
+    return true;
+}
+
+void LSessionRecorder::LSessionRecorderPrivate::writeRecord(Type type, UInt32 client, UInt32 object, const void *payload, UInt32 size)
+{
+    const RecordHeader header { type, size, (UInt64)(nowUs() - startTime), client, object };
+    fwrite(&header, sizeof(header), 1, file);
+
+    if (size > 0)
+        fwrite(payload, size, 1, file);
+}
+
+void LSessionRecorder::LSessionRecorderPrivate::record(Type type, wl_resource *object, std::initializer_list<Int32> args)
+{
+    const bool destroy { type == SurfaceDestroy || type == SubsurfaceDestroy || type == XdgSurfaceDestroy ||
+                         type == XdgToplevelDestroy || type == XdgPopupDestroy };
+    UInt32 client;
+
+    if (!clientId(wl_resource_get_client(object), !destroy, &client))
+        return;
+
+    writeRecord(type, client, wl_resource_get_id(object), args.begin(), args.size() * sizeof(Int32));
+}
+
+void LSessionRecorder::LSessionRecorderPrivate::recordRegion(Type type, wl_resource *object, wl_resource *region)
+{
+    UInt32 client;
+
+    if (!clientId(wl_resource_get_client(object), true, &client))
+        return;
+
+    std::vector<Int32> payload { region == nullptr };
+
+    if (region)
+    {
+        Protocols::Wayland::RRegion *rRegion { (Protocols::Wayland::RRegion*)wl_resource_get_user_data(region) };
+        Int32 n;
+        LBox *boxes { rRegion->region().boxes(&n) };
+
+        for (Int32 i = 0; i < n; i++)
+            payload.insert(payload.end(), { boxes[i].x1, boxes[i].y1, boxes[i].x2 - boxes[i].x1, boxes[i].y2 - boxes[i].y1 });
+    }
+
+    writeRecord(type, client, wl_resource_get_id(object), payload.data(), payload.size() * sizeof(Int32));
+}
+
+void LSessionRecorder::LSessionRecorderPrivate::recordAttach(wl_resource *surface, wl_resource *buffer, Int32 x, Int32 y)
+{
+    UInt32 bufferId { 0 };
+
+    if (buffer)
+    {
+        Int32 width { 0 }, height { 0 }, stride { 0 };
+        UInt32 format { DRM_FORMAT_ARGB8888 };
+        bool shm { false };
+
+        if (wl_shm_buffer *shmBuffer = wl_shm_buffer_get(buffer))
+        {
+            width = wl_shm_buffer_get_width(shmBuffer);
+            height = wl_shm_buffer_get_height(shmBuffer);
+            stride = wl_shm_buffer_get_stride(shmBuffer);
+            format = LTexture::waylandFormatToDRM(wl_shm_buffer_get_format(shmBuffer));
+            shm = true;
+        }
+        else if (isDMABuffer(buffer))
+        {
+            const LDMAPlanes *planes { ((LDMABuffer*)wl_resource_get_user_data(buffer))->planes() };
+            width = planes->width;
+            height = planes->height;
+            format = planes->format;
+        }
+        else
+        {
+            LCompositor::compositor()->imp()->eglQueryWaylandBufferWL(LCompositor::eglDisplay(), buffer, EGL_WIDTH, &width);
+            LCompositor::compositor()->imp()->eglQueryWaylandBufferWL(LCompositor::eglDisplay(), buffer, EGL_HEIGHT, &height);
+        }
+
+        if (!shm)
+            stride = width * 4;
+
+        BufferEntry *entry;
+        auto it { buffers.find(buffer) };
+
+        if (it == buffers.end())
+        {
+            UInt32 client;
+
+            if (!clientId(wl_resource_get_client(buffer), true, &client))
+                return;
+
+            entry = new BufferEntry();
+            entry->destroyListener.notify = &onBufferDestroy;
+            wl_resource_add_destroy_listener(buffer, &entry->destroyListener);
+            buffers[buffer] = entry;
+            entry->client = client;
+            entry->id = wl_resource_get_id(buffer);
+            entry->width = -1;
+        }
+        else
+            entry = it->second;
+
+        // New buffer or a SHM buffer whose pool was resized
+        if (entry->width != width || entry->height != height || entry->stride != stride || entry->format != format || entry->shm != shm)
+        {
+            entry->width = width;
+            entry->height = height;
+            entry->stride = stride;
+            entry->format = format;
+            entry->shm = shm;
+            entry->captured = false;
+            const Int32 payload[] { width, height, stride, (Int32)format, shm };
+            writeRecord(BufferCreate, entry->client, entry->id, payload, sizeof(payload));
+        }
+
+        bufferId = entry->id;
+    }
+
+    record(SurfaceAttach, surface, { (Int32)bufferId, x, y });
+}
+
+void LSessionRecorder::LSessionRecorderPrivate::recordCommit(LSurface *surface)
+{
+    LSurface::LSurfacePrivate *imp { surface->imp() };
+    wl_resource *buffer { imp->pending.buffer };
+
+    if (buffer && imp->stateFlags.check(LSurface::LSurfacePrivate::BufferAttached))
+    {
+        auto it { buffers.find(buffer) };
+        wl_shm_buffer *shmBuffer { wl_shm_buffer_get(buffer) };
+
+        if (it != buffers.end() && it->second->shm && shmBuffer)
+        {
+            BufferEntry *entry { it->second };
+            LRegion region;
+
+            // Transformed or scaled damage is not worth translating
+            if (!entry->captured || imp->pending.transform != LFramebuffer::Normal || imp->stateFlags.check(LSurface::LSurfacePrivate::ViewportIsScaled | LSurface::LSurfacePrivate::ViewportIsCropped))
+            {
+                region.addRect(0, 0, entry->width, entry->height);
+                entry->captured = true;
+            }
+            else
+            {
+                // Same margins used when the buffer is uploaded
+                const Int32 scale { imp->pending.bufferScale };
+
+                for (const LRect &r : imp->pendingDamage)
+                    region.addRect((r.x() - 2) * scale, (r.y() - 2) * scale, (r.w() + 4) * scale, (r.h() + 4) * scale);
+
+                for (const LRect &r : imp->pendingDamageB)
+                    region.addRect(r.x() - 2, r.y() - 2, r.w() + 4, r.h() + 4);
+
+                region.clip(0, 0, entry->width, entry->height);
+            }
+
+            Int32 n;
+            LBox *boxes { region.boxes(&n) };
+
+            if (n > 0)
+            {
+                const UInt32 pixelSize { LTexture::formatBytesPerPixel(entry->format) };
+                std::vector<Int32> rects { n };
+                UInt32 size { (UInt32)sizeof(Int32) * (1 + 4 * n) };
+
+                for (Int32 i = 0; i < n; i++)
+                {
+                    rects.insert(rects.end(), { boxes[i].x1, boxes[i].y1, boxes[i].x2 - boxes[i].x1, boxes[i].y2 - boxes[i].y1 });
+                    size += (boxes[i].x2 - boxes[i].x1) * (boxes[i].y2 - boxes[i].y1) * pixelSize;
+                }
+
+                const RecordHeader header { BufferData, size, (UInt64)(nowUs() - startTime), entry->client, entry->id };
+                fwrite(&header, sizeof(header), 1, file);
+                fwrite(rects.data(), rects.size() * sizeof(Int32), 1, file);
+
+                wl_shm_buffer_begin_access(shmBuffer);
+                const UChar8 *pixels { (const UChar8*)wl_shm_buffer_get_data(shmBuffer) };
+
+                for (Int32 i = 0; i < n; i++)
+                {
+                    const UInt32 rowSize { (boxes[i].x2 - boxes[i].x1) * pixelSize };
+
+                    for (Int32 y = boxes[i].y1; y < boxes[i].y2; y++)
+                        fwrite(&pixels[y * entry->stride + boxes[i].x1 * pixelSize], rowSize, 1, file);
+                }
+
+                wl_shm_buffer_end_access(shmBuffer);
+            }
+        }
+    }
+
+    record(SurfaceCommit, surface->surfaceResource()->resource());
+}
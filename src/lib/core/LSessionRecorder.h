@@ -0,0 +1,58 @@
+#ifndef LSESSIONRECORDER_H
+#define LSESSIONRECORDER_H
+
+#include <LNamespaces.h>
+#include <filesystem>
+
+/**
+ * @brief Recording of client sessions for replay
+ *
+ * Records the surface related requests of all clients (wl_surface, wl_subsurface, xdg_surface, xdg_toplevel and xdg_popup)
+ * with their timestamps into a file, together with the contents of the SHM buffers they commit.
+ * Each buffer is saved completely the first time it is committed and afterwards only its damaged rects, which is the
+ * same data the compositor uploads to the GPU.\n
+ * DMA and EGL buffers are recorded with their size only.
+ *
+ * The `LReplay` client included in the benchmarks directory re-issues the recorded requests against any compositor,
+ * so that the same workload can be replayed on every build to compare frame times and CPU usage.
+ *
+ * Recording can also be started when the compositor starts by setting the **LOUVRE_RECORD_SESSION** environment variable
+ * to the destination file path.
+ *
+ * @note These methods must be called from the main thread.
+ */
+class Louvre::LSessionRecorder
+{
+public:
+    /// @cond OMIT
+    LSessionRecorder() = delete;
+    class LSessionRecorderPrivate;
+    /// @endcond
+
+    /**
+     * @brief Start recording
+     *
+     * Stops the current recording (if any) and starts a new one. Clients already connected are recorded from their next request,
+     * so the recording should be started before launching the clients to replay.
+     *
+     * @param path Destination file, overwritten if it already exists.
+     * @return `true` on success, `false` if the file could not be created.
+     */
+    static bool start(const std::filesystem::path &path);
+
+    /**
+     * @brief Stop recording
+     *
+     * Flushes and closes the current recording file.
+     */
+    static void stop();
+
+    /**
+     * @brief Recording state
+     *
+     * Returns `true` while a session is being recorded, `false` otherwise.
+     */
+    static bool recording();
+};
+
+#endif // LSESSIONRECORDER_H
@@ -27,6 +27,8 @@ LSurface::~LSurface()
     for (LSurfaceView *view : imp()->views)
         view->imp()->surface = nullptr;
 
+    imp()->holdBuffer(nullptr);
+
     if (imp()->texture && imp()->texture != imp()->textureBackup && imp()->texture->imp()->pendingDelete)
         delete imp()->texture;
 
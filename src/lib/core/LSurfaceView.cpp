@@ -2,6 +2,8 @@
 #include <private/LViewPrivate.h>
 #include <private/LPainterPrivate.h>
 #include <private/LSurfacePrivate.h>
+#include <private/LCompositorPrivate.h>
+#include <private/LOutputPrivate.h>
 #include <LSubsurfaceRole.h>
 #include <LOutput.h>
 
@@ -227,7 +229,7 @@ bool LSurfaceView::isRenderable() const
 
 void LSurfaceView::requestNextFrame(LOutput *output)
 {
-    if (!imp()->surface || !output)
+    if (!imp()->surface || !output || output->imp()->threadSlot == LCompositor::LCompositorPrivate::InvalidThreadSlot)
         return;
 
     LView *view = this;
@@ -235,7 +237,7 @@ void LSurfaceView::requestNextFrame(LOutput *output)
     if (forceRequestNextFrameEnabled())
     {
         imp()->surface->requestNextFrame();
-        view->imp()->threadsMap[output->threadId()].lastRenderedDamageId = imp()->surface->damageId();
+        view->imp()->threadData(output->imp()->threadSlot).lastRenderedDamageId = imp()->surface->damageId();
         return;
     }
 
@@ -248,7 +250,8 @@ void LSurfaceView::requestNextFrame(LOutput *output)
     {
         // If the view is visible on another output and has not rendered the new damage
         // prevent clearing the damage immediately
-        if (o != output && (view->imp()->threadsMap[o->threadId()].lastRenderedDamageId < imp()->surface->damageId()))
+        if (o != output && (o->imp()->threadSlot >= view->imp()->threadsData.size() ||
+            view->imp()->threadsData[o->imp()->threadSlot].lastRenderedDamageId < imp()->surface->damageId()))
         {
             clearDamage = false;
             o->repaint();
@@ -263,7 +266,7 @@ void LSurfaceView::requestNextFrame(LOutput *output)
             imp()->surface->parent()->requestNextFrame(false);
     }
 
-    view->imp()->threadsMap[output->threadId()].lastRenderedDamageId = imp()->surface->damageId();
+    view->imp()->threadData(output->imp()->threadSlot).lastRenderedDamageId = imp()->surface->damageId();
 }
 
 const LRegion *LSurfaceView::damage() const
@@ -6,13 +6,18 @@
 #include <private/LCursorPrivate.h>
 #include <private/LOutputPrivate.h>
 #include <private/LRenderBufferPrivate.h>
+#include <private/LTracePrivate.h>
 #include <LTextureView.h>
 #include <LRect.h>
+#include <LTime.h>
 #include <LLog.h>
 
 #include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
+#include <drm_fourcc.h>
+#include <algorithm>
 
 using namespace Louvre;
 using namespace std;
@@ -20,6 +25,7 @@ using namespace std;
 LTexture::LTexture() : LPRIVATE_INIT_UNIQUE(LTexture)
 {
     imp()->texture = this;
+    imp()->serial = LTime::nextSerial();
     compositor()->imp()->textures.push_back(this);
 }
 
@@ -28,6 +34,9 @@ LTexture::~LTexture()
     while (!imp()->textureViews.empty())
         imp()->textureViews.back()->setTexture(nullptr);
 
+    if (compositor()->imp()->cursor)
+        compositor()->imp()->cursor->imp()->removeCachedBuffers(this);
+
     imp()->deleteTexture();
     LVectorRemoveOneUnordered(compositor()->imp()->textures, this);
 }
@@ -139,6 +148,7 @@ bool LTexture::setDataB(const LSize &size, UInt32 stride, UInt32 format, const v
     if (imp()->sourceType == Framebuffer)
         return false;
 
+    LTRACE_SCOPE("textureUpload");
     imp()->deleteTexture();
 
     if (compositor()->imp()->graphicBackend->textureCreateFromCPUBuffer(this, size, stride, format, buffer))
@@ -146,6 +156,15 @@ bool LTexture::setDataB(const LSize &size, UInt32 stride, UInt32 format, const v
         imp()->format = format;
         imp()->sizeB = size;
         imp()->sourceType = CPU;
+
+        if (imp()->softwareCopy)
+        {
+            compositor()->imp()->textureUploads.fetch_add(1, std::memory_order_relaxed);
+
+            if (LSoftwareRenderer::enabled())
+                LSoftwareRenderer::textureSetData(this, size, stride, format, buffer);
+        }
+
         return true;
     }
 
@@ -189,21 +208,161 @@ bool LTexture::updateRect(const LRect &rect, UInt32 stride, const void *buffer)
 
     if (initialized() && imp()->sourceType != Framebuffer)
     {
-        imp()->serial++;
+        LTRACE_SCOPE("textureUpdate");
+        imp()->serial = LTime::nextSerial();
+
+        if (imp()->softwareCopy)
+            compositor()->imp()->textureUploads.fetch_add(1, std::memory_order_relaxed);
+
+        LSoftwareRenderer::textureUpdateRect(this, rect, stride, buffer);
         return compositor()->imp()->graphicBackend->textureUpdateRect(this, stride, rect, buffer);
     }
 
     return false;
 }
 
+/* Draws src (in texels) into the bound framebuffer using the scaler program, averaging itersX * itersY samples
+ * per destination pixel. The samples are centered within the footprint of each destination pixel. */
+static void scalerPass(LPainter *painter, GLuint textureId, GLenum textureTarget, const LSize &texSize,
+                       const LRectF &src, const LSize &dst, Int32 itersX, Int32 itersY)
+{
+    if (textureTarget == GL_TEXTURE_EXTERNAL_OES)
+    {
+        glUseProgram(painter->imp()->programObjectScalerExternal);
+        painter->imp()->currentUniformsScaler = &painter->imp()->uniformsScalerExternal;
+    }
+    else
+    {
+        glUseProgram(painter->imp()->programObjectScaler);
+        painter->imp()->currentUniformsScaler = &painter->imp()->uniformsScaler;
+    }
+
+    const Float32 stepX { src.w() / Float32(dst.w() * itersX) };
+    const Float32 stepY { src.h() / Float32(dst.h() * itersY) };
+    const Float32 x { src.x() - stepX * 0.5f * Float32(itersX - 1) };
+    const Float32 y { src.y() - stepY * 0.5f * Float32(itersY - 1) };
+
+    // Keep the samples half a texel inside src to prevent bleeding from neighbour texels
+    Float32 x1 { (src.x() + 0.5f) / Float32(texSize.w()) };
+    Float32 x2 { (src.x() + src.w() - 0.5f) / Float32(texSize.w()) };
+    Float32 y1 { (src.y() + 0.5f) / Float32(texSize.h()) };
+    Float32 y2 { (src.y() + src.h() - 0.5f) / Float32(texSize.h()) };
+
+    if (x1 > x2)
+        std::swap(x1, x2);
+
+    if (y1 > y2)
+        std::swap(y1, y2);
+
+    glScissor(0, 0, dst.w(), dst.h());
+    glViewport(0, 0, dst.w(), dst.h());
+    glActiveTexture(GL_TEXTURE0);
+    LTexture::LTexturePrivate::setTextureParams(textureId, textureTarget, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+    glUniform1i(painter->imp()->currentUniformsScaler->activeTexture, 0);
+    glUniform2f(painter->imp()->currentUniformsScaler->texSize, texSize.w(), texSize.h());
+    glUniform4f(painter->imp()->currentUniformsScaler->srcRect, x, y + src.h(), src.w(), -src.h());
+    glUniform4f(painter->imp()->currentUniformsScaler->samplerBounds, x1, y1, x2, y2);
+    glUniform2f(painter->imp()->currentUniformsScaler->pixelSize, stepX / Float32(texSize.w()), stepY / Float32(texSize.h()));
+    glUniform2i(painter->imp()->currentUniformsScaler->iters, itersX, itersY);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+}
+
+/* Separable box filter: a horizontal pass into an intermediate texture followed by a vertical one,
+ * so that the cost per pixel grows linearly with the downscaling factor instead of quadratically. */
+static bool scaleBox(LPainter *painter, GLuint textureId, GLenum textureTarget, const LSize &texSize,
+                     const LRect &src, const LSize &dst, GLuint framebuffer)
+{
+    const Int32 limit { 32 };
+    const Int32 wScale { std::clamp(Int32(ceilf(fabs(Float32(src.w()) / Float32(dst.w())))), 1, limit) };
+    const Int32 hScale { std::clamp(Int32(ceilf(fabs(Float32(src.h()) / Float32(dst.h())))), 1, limit) };
+
+    // A single pass is enough when only one axis is downscaled
+    if (wScale == 1 || hScale == 1)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        scalerPass(painter, textureId, textureTarget, texSize, src, dst, wScale, hScale);
+        return true;
+    }
+
+    const LSize tmpSize { dst.w(), abs(src.h()) };
+    GLuint tmpFramebuffer, tmpTexture;
+    glGenFramebuffers(1, &tmpFramebuffer);
+
+    if (!tmpFramebuffer)
+        return false;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, tmpFramebuffer);
+    glGenTextures(1, &tmpTexture);
+    LTexture::LTexturePrivate::setTextureParams(tmpTexture, GL_TEXTURE_2D, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tmpSize.w(), tmpSize.h(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tmpTexture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        glDeleteTextures(1, &tmpTexture);
+        glDeleteFramebuffers(1, &tmpFramebuffer);
+        return false;
+    }
+
+    scalerPass(painter, textureId, textureTarget, texSize, src, tmpSize, wScale, 1);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    scalerPass(painter, tmpTexture, GL_TEXTURE_2D, tmpSize, LRect(0, tmpSize), dst, 1, hScale);
+    glDeleteTextures(1, &tmpTexture);
+    glDeleteFramebuffers(1, &tmpFramebuffer);
+    return true;
+}
+
+/* Copies src into an intermediate texture, generates its mipmaps and samples them with trilinear filtering.
+ * Requires NPOT mipmaps support (GL_OES_texture_npot). */
+static bool scaleMipmap(LPainter *painter, GLuint textureId, GLenum textureTarget, const LSize &texSize,
+                        const LRect &src, const LSize &dst, GLuint framebuffer)
+{
+    if (!painter->imp()->openGLExtensions.OES_texture_npot)
+        return false;
+
+    const LSize tmpSize { abs(src.w()), abs(src.h()) };
+    GLuint tmpFramebuffer, tmpTexture;
+    glGenFramebuffers(1, &tmpFramebuffer);
+
+    if (!tmpFramebuffer)
+        return false;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, tmpFramebuffer);
+    glGenTextures(1, &tmpTexture);
+    LTexture::LTexturePrivate::setTextureParams(tmpTexture, GL_TEXTURE_2D, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_LINEAR, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tmpSize.w(), tmpSize.h(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tmpTexture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        glDeleteTextures(1, &tmpTexture);
+        glDeleteFramebuffers(1, &tmpFramebuffer);
+        return false;
+    }
+
+    painter->imp()->scaleTexture(textureId, textureTarget, tmpFramebuffer, GL_NEAREST, texSize, src, tmpSize);
+    glBindTexture(GL_TEXTURE_2D, tmpTexture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    painter->imp()->scaleTexture(tmpTexture, GL_TEXTURE_2D, framebuffer, GL_LINEAR_MIPMAP_LINEAR, tmpSize, LRect(0, tmpSize), dst);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glDeleteTextures(1, &tmpTexture);
+    glDeleteFramebuffers(1, &tmpFramebuffer);
+    return true;
+}
+
 LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualityScaling) const
+{
+    return copyB(dst, src, highQualityScaling ? Box : Linear);
+}
+
+LTexture *LTexture::copyB(const LSize &dst, const LRect &src, ScalingFilter filter) const
 {
     if (!initialized())
         return nullptr;
 
     if (dst.w() < 0 || dst.h() < 0)
     {
-        LLog::error("[LTexture::copyB] Failed to copy texture. Invalid destination size.");
+        LLOG_ERROR("[LTexture::copyB] Failed to copy texture. Invalid destination size.");
         return nullptr;
     }
 
@@ -211,7 +370,7 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
 
     if (!painter)
     {
-        LLog::error("[LTexture::copyB] Failed to copy texture. No painter found.");
+        LLOG_ERROR("[LTexture::copyB] Failed to copy texture. No painter found.");
         return nullptr;
     }
 
@@ -230,7 +389,7 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
 
     if (srcRect.w() == 0 || srcRect.h() == 0 || dstSize.w() == 0 || dstSize.h() == 0)
     {
-        LLog::error("[LTexture::copyB] Failed to copy texture. Invalid size.");
+        LLOG_ERROR("[LTexture::copyB] Failed to copy texture. Invalid size.");
         return nullptr;
     }
 
@@ -238,7 +397,7 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
     LTexture *textureCopy;
     bool ret = false;
 
-    if (highQualityScaling)
+    if (filter != Linear)
     {
         Float32 wScaleF = fabs(Float32(srcRect.w()) / Float32(dstSize.w()));
         Float32 hScaleF = fabs(Float32(srcRect.h()) / Float32(dstSize.h()));
@@ -248,35 +407,9 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
             goto skipHQ;
 
         GLenum textureTarget = target();
-        GLuint prevProgram = painter->imp()->currentProgram;
-
-        if (textureTarget == GL_TEXTURE_EXTERNAL_OES)
-        {
-            if (!painter->imp()->programObjectScalerExternal)
-                goto skipHQ;
-
-            glUseProgram(painter->imp()->programObjectScalerExternal);
-            painter->imp()->currentUniformsScaler = &painter->imp()->uniformsScalerExternal;
-        }
-        else
-        {
-            glUseProgram(painter->imp()->programObjectScaler);
-            painter->imp()->currentUniformsScaler = &painter->imp()->uniformsScaler;
-        }
 
-        Int32 wScale = ceilf(wScaleF);
-        Int32 hScale = ceilf(hScaleF);
-
-        Float32 limit = 10.f;
-
-        if (wScale > limit)
-            wScale = limit;
-
-        if (hScale > limit)
-            hScale = limit;
-
-        Float32 pixSizeW = wScaleF / Float32(sizeB().w() * wScale);
-        Float32 pixSizeH = hScaleF / Float32(sizeB().h() * hScale);
+        if (textureTarget == GL_TEXTURE_EXTERNAL_OES && !painter->imp()->programObjectScalerExternal && filter == Box)
+            goto skipHQ;
 
         GLuint framebuffer;
         glGenFramebuffers(1, &framebuffer);
@@ -287,38 +420,26 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dstSize.w(), dstSize.h(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texCopy, 0);
         glDisable(GL_BLEND);
-        glScissor(0, 0, dstSize.w(), dstSize.h());
-        glViewport(0, 0, dstSize.w(), dstSize.h());
-        glActiveTexture(GL_TEXTURE0);
-        glUniform1i(painter->imp()->currentUniformsScaler->activeTexture, 0);
-        glUniform2f(painter->imp()->currentUniformsScaler->texSize, sizeB().w(), sizeB().h());
-        glUniform4f(painter->imp()->currentUniformsScaler->srcRect, srcRect.x(), srcRect.y() + srcRect.h(), srcRect.w(), -srcRect.h());
-
-        Float32 tmp;
-        Float32 x1 = (Float32(srcRect.x()) + 0.f * Float32(srcRect.w())) / Float32(sizeB().w());
-        Float32 y1 = (Float32(srcRect.y() + srcRect.h()) + Float32(-srcRect.h()) - 0.f * Float32(-srcRect.h())) / Float32(sizeB().h());
-        Float32 x2 = (Float32(srcRect.x()) + 1.f * Float32(srcRect.w())) / Float32(sizeB().w());
-        Float32 y2 = (Float32(srcRect.y() + srcRect.h()) + Float32(-srcRect.h()) - 1.f * Float32(-srcRect.h())) / Float32(sizeB().h());
-
-        if (x1 > x2)
-        {
-            tmp = x1;
-            x1 = x2;
-            x2 = tmp;
-        }
 
-        if (y1 > y2)
+        bool scaled = false;
+
+        if (filter == Mipmap)
+            scaled = scaleMipmap(painter, textureId, textureTarget, sizeB(), srcRect, dstSize, framebuffer);
+
+        // Box is also the fallback when mipmaps are not supported
+        if (!scaled && (textureTarget != GL_TEXTURE_EXTERNAL_OES || painter->imp()->programObjectScalerExternal))
+            scaled = scaleBox(painter, textureId, textureTarget, sizeB(), srcRect, dstSize, framebuffer);
+
+        // The scaler passes bypass the painter program tracking
+        glUseProgram(painter->imp()->currentProgram);
+
+        if (!scaled)
         {
-            tmp = y1;
-            y1 = y2;
-            y2 = tmp;
+            glDeleteTextures(1, &texCopy);
+            glDeleteFramebuffers(1, &framebuffer);
+            goto skipHQ;
         }
 
-        glUniform4f(painter->imp()->currentUniformsScaler->samplerBounds, x1, y1, x2, y2);
-        imp()->setTextureParams(textureId, textureTarget, GL_REPEAT, GL_REPEAT, GL_LINEAR, GL_LINEAR);
-        glUniform2f(painter->imp()->currentUniformsScaler->pixelSize, pixSizeW, pixSizeH);
-        glUniform2i(painter->imp()->currentUniformsScaler->iters, wScale, hScale);
-        glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
         textureCopy = new LTexture();
 
         if (compositor()->imp()->graphicBackend->backendGetRendererGPUs() == 1)
@@ -331,7 +452,6 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
             UChar8 *cpuBuffer = (UChar8*)malloc(dstSize.w() * dstSize.h() * 4);
             GLenum glFormat = painter->imp()->openGLExtensions.EXT_read_format_bgra ? GL_BGRA_EXT : GL_RGBA;
             imp()->readPixels(LRect(0, dstSize), 0, dstSize.w(), glFormat, GL_UNSIGNED_BYTE, cpuBuffer);
-            textureCopy = new LTexture();
 
             if (glFormat == GL_BGRA_EXT)
                 ret = textureCopy->setDataB(dstSize, dstSize.w() * 4, DRM_FORMAT_ARGB8888, cpuBuffer);
@@ -358,12 +478,11 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
         }
 
         glDeleteFramebuffers(1, &framebuffer);
-        glUseProgram(prevProgram);
 
         if (ret)
             return textureCopy;
 
-        LLog::error("[LTexture::copyB] Failed to create texture. Graphical backend error.");
+        LLOG_ERROR("[LTexture::copyB] Failed to create texture. Graphical backend error.");
         delete textureCopy;
         return nullptr;
     }
@@ -428,7 +547,7 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
 
         if (framebuffer == 0)
         {
-            LLog::error("[LTexture::copyB] Failed to copy texture. Could not create framebuffer.");
+            LLOG_ERROR("[LTexture::copyB] Failed to copy texture. Could not create framebuffer.");
             return nullptr;
         }
 
@@ -439,7 +558,7 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
 
         if (renderbuffer == 0)
         {
-            LLog::error("[LTexture::copyB] Failed to copy texture. Could not create renderbuffer.");
+            LLOG_ERROR("[LTexture::copyB] Failed to copy texture. Could not create renderbuffer.");
             glDeleteFramebuffers(1, &framebuffer);
             return nullptr;
         }
@@ -452,7 +571,7 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
 
         if (status != GL_FRAMEBUFFER_COMPLETE)
         {
-            LLog::error("[LTexture::copyB] Failed to copy texture. Incomplete framebuffer.");
+            LLOG_ERROR("[LTexture::copyB] Failed to copy texture. Incomplete framebuffer.");
             glDeleteRenderbuffers(1, &renderbuffer);
             glDeleteFramebuffers(1, &framebuffer);
             return nullptr;
@@ -496,7 +615,7 @@ LTexture *LTexture::copyB(const LSize &dst, const LRect &src, bool highQualitySc
     if (ret)
         return textureCopy;
 
-    LLog::error("[LTexture::copyB] Failed to create texture. Graphical backend error.");
+    LLOG_ERROR("[LTexture::copyB] Failed to create texture. Graphical backend error.");
     delete textureCopy;
     return nullptr;
 }
@@ -505,14 +624,39 @@ bool LTexture::save(const std::filesystem::path &name) const
 {
     if (name.empty())
     {
-        LLog::error("[LTexture::save] Failed to save texture. Invalid path.");
+        LLOG_ERROR("[LTexture::save] Failed to save texture. Invalid path.");
         return false;
     }
 
+    return readPixelsAsync(LRect(0, sizeB()), DRM_FORMAT_ABGR8888, [name](const UChar8 *pixels, const LSize &size, UInt32 stride)
+    {
+        if (!pixels)
+        {
+            LLOG_ERROR("[LTexture::save] Failed to save texture: %s. Readback failed.", name.c_str());
+            return;
+        }
+
+        if (stbi_write_png(name.c_str(), size.w(), size.h(), 4, pixels, stride))
+            LLOG_DEBUG("[LTexture::save] Texture saved successfully: %s.", name.c_str());
+        else
+            LLOG_ERROR("[LTexture::save] Failed to save texture: %s. STB Image error.", name.c_str());
+    });
+}
+
+bool LTexture::readPixelsAsync(const LRect &rect, UInt32 format, const ReadPixelsCallback &callback) const
+{
     const char *error;
     LPainter *painter;
     GLuint framebuffer;
-    UChar8 *buffer;
+    GLuint renderbuffer { 0 };
+    GLenum glFormat;
+    bool ret;
+
+    if (!callback)
+    {
+        error = "Invalid callback";
+        goto printError;
+    }
 
     if (!initialized())
     {
@@ -520,9 +664,25 @@ bool LTexture::save(const std::filesystem::path &name) const
         goto printError;
     }
 
-    if (sizeB().area() <= 0)
+    if (rect.w() <= 0 || rect.h() <= 0 || rect.x() < 0 || rect.y() < 0 ||
+        rect.x() + rect.w() > sizeB().w() || rect.y() + rect.h() > sizeB().h())
+    {
+        error = "Invalid rect";
+        goto printError;
+    }
+
+    switch (format)
     {
-        error = "Invalid size";
+    case DRM_FORMAT_ABGR8888:
+    case DRM_FORMAT_XBGR8888:
+        glFormat = GL_RGBA;
+        break;
+    case DRM_FORMAT_ARGB8888:
+    case DRM_FORMAT_XRGB8888:
+        glFormat = GL_BGRA_EXT;
+        break;
+    default:
+        error = "Unsupported format";
         goto printError;
     }
 
@@ -552,27 +712,14 @@ bool LTexture::save(const std::filesystem::path &name) const
         glBindTexture(textureTarget, textureId);
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureTarget, textureId, 0);
 
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        {
-            LLog::warning("[LTexture::save] Failed to read texture directly using a framebuffer. Trying drawing the texture instead.");
-            goto draw;
-        }
-
-        buffer = (UChar8 *)malloc(sizeB().w()*sizeB().h()*4);
-        imp()->readPixels(LRect(0, sizeB()),
-                          0, sizeB().w(),
-                          GL_RGBA,
-                          GL_UNSIGNED_BYTE, buffer);
-        glDeleteFramebuffers(1, &framebuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+            goto read;
 
-        goto save;
+        LLOG_WARNING("[LTexture::readPixelsAsync] Failed to read texture directly using a framebuffer. Trying drawing the texture instead.");
     }
 
-    draw:
-
     /* If first attempt fails, then render texture into a render buffer and then to read the framebuffer. */
     {
-        GLuint renderbuffer;
         glGenRenderbuffers(1, &renderbuffer);
 
         if (renderbuffer == 0)
@@ -595,35 +742,25 @@ bool LTexture::save(const std::filesystem::path &name) const
         }
 
         painter->imp()->scaleTexture((LTexture*)this, LSize(sizeB().w(), -sizeB().h()), sizeB());
-        buffer = (UChar8 *)malloc(sizeB().w()*sizeB().h()*4);
-        imp()->readPixels(LRect(0, sizeB()),
-                          0, sizeB().w(),
-                          GL_RGBA,
-                          GL_UNSIGNED_BYTE, buffer);
-        glDeleteRenderbuffers(1, &renderbuffer);
-        glDeleteFramebuffers(1, &framebuffer);
     }
 
-    save:
+    read:
 
-    {
+    ret = painter->imp()->readPixelsAsync(rect, glFormat, callback);
 
-        const Int32 ret { stbi_write_png(name.c_str(), sizeB().w(), sizeB().h(), 4, buffer, sizeB().w() * 4) };
-        free(buffer);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (renderbuffer)
+        glDeleteRenderbuffers(1, &renderbuffer);
 
-        if (ret)
-        {
-            LLog::debug("[LTexture::save] Texture saved successfully: %s.", name.c_str());
-            return true;
-        }
+    glDeleteFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, painter->imp()->fbId);
 
-        error = "STB Image error";
-        goto printError;
-    }
+    if (ret)
+        return true;
+
+    error = "Readback failed";
 
     printError:
-    LLog::error("[LTexture::save] Failed to save texture: %s. %s.", name.c_str(), error);
+    LLOG_ERROR("[LTexture::readPixelsAsync] Failed to read texture pixels. %s.", error);
     return false;
 }
 
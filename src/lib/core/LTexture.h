@@ -4,6 +4,7 @@
 #include <LObject.h>
 #include <LRect.h>
 #include <drm_fourcc.h>
+#include <functional>
 
 /**
  * @brief OpenGL texture abstraction
@@ -39,6 +40,31 @@ public:
         Native = 4
     };
 
+    /**
+     * @brief Filters used by copyB() when downscaling.
+     */
+    enum ScalingFilter
+    {
+        /// Single bilinear pass, the fastest but produces aliasing when downscaling by more than 2x
+        Linear,
+
+        /// Trilinear sampling of generated mipmaps, cheap for large factors but slightly blurry (falls back to Box if unsupported)
+        Mipmap,
+
+        /// Separable two-pass box filter, the highest quality with a cost proportional to the downscaling factor
+        Box
+    };
+
+    /**
+     * @brief Callback used by readPixelsAsync().
+     *
+     * @param pixels The requested pixels (rows ordered as in the texture) or `nullptr` if the readback failed.
+     *               The memory is owned by Louvre and is only valid during the call.
+     * @param size The size of the read rect.
+     * @param stride The number of bytes between consecutive rows.
+     */
+    using ReadPixelsCallback = std::function<void(const UChar8 *pixels, const LSize &size, UInt32 stride)>;
+
     /**
      * @brief Create an empty texture.
      */
@@ -132,20 +158,51 @@ public:
      * @param dst The destination size of the copied texture. Passing an empty Louvre::LSize means the same texture size is used.
      * @param src The rectangular area within the texture to be copied. Passing an empty Louvre::LRect means the entire texture is used.
      * @param highQualityScaling Set this value to `true` to enable high-quality scaling, which produces better results when resizing to a significantly different size from the original.
+     *                           Equivalent to the Box filter, or Linear if `false`.
      * @return A pointer to the copied LTexture object.
      */
     LTexture *copyB(const LSize &dst = LSize(), const LRect &src = LRect(), bool highQualityScaling = true) const;
 
+    /**
+     * @brief Create a copy of the texture using a specific scaling filter.
+     *
+     * Same as copyB(const LSize &, const LRect &, bool) but allows choosing the trade-off between quality and performance
+     * when downscaling. Filters other than Linear are only applied when the texture is downscaled by more than 2x.
+     *
+     * @param dst The destination size of the copied texture. Passing an empty Louvre::LSize means the same texture size is used.
+     * @param src The rectangular area within the texture to be copied. Passing an empty Louvre::LRect means the entire texture is used.
+     * @param filter The filter used to scale the texture.
+     * @return A pointer to the copied LTexture object.
+     */
+    LTexture *copyB(const LSize &dst, const LRect &src, ScalingFilter filter) const;
+
     /**
      * @brief Save the texture as a PNG file.
      *
-     * This method allows you to save the texture as a PNG image file at the specified @p path.
+     * This method allows you to save the texture as a PNG image file at the specified @p path.\n
+     * The pixels are read with readPixelsAsync(), so the file is written once the GPU finishes, usually on the next frame of the
+     * calling thread. The final result is reported with LLog.
      *
      * @param name The file path where the PNG image will be saved.
-     * @return `true` if the save operation is successful, `false` otherwise.
+     * @return `true` if the texture readback was scheduled, `false` otherwise.
      */
     bool save(const std::filesystem::path &name) const;
 
+    /**
+     * @brief Read the texture pixels asynchronously.
+     *
+     * Unlike a synchronous `glReadPixels()` call, this method does not stall the GPU pipeline. The pixels are packed into a
+     * ring of pixel buffer objects and the @p callback is invoked from the calling thread once the GPU finishes, usually
+     * on the next frame (or the next LCompositor::processLoop() iteration when called from the main thread).\n
+     * If pixel buffer objects are not supported (OpenGL ES < 3.0) the pixels are read synchronously, but the callback is still deferred.
+     *
+     * @param rect The rect to read in buffer coordinates, it must be within the texture bounds.
+     * @param format The pixel format of the result, either `DRM_FORMAT_ABGR8888` or `DRM_FORMAT_ARGB8888` (and their X variants).
+     * @param callback Function invoked with the result.
+     * @return `true` if the readback was scheduled, `false` otherwise (the callback is never invoked).
+     */
+    bool readPixelsAsync(const LRect &rect, UInt32 format, const ReadPixelsCallback &callback) const;
+
     /**
      * @brief Get the size of the texture in buffer coordinates.
      *
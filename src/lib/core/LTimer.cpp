@@ -5,18 +5,12 @@
 LTimer::LTimer(const Callback &onTimeout) : LPRIVATE_INIT_UNIQUE(LTimer)
 {
     imp()->onTimeoutCallback = onTimeout;
-
-    if (compositor()->display())
-        imp()->waylandEventSource = wl_event_loop_add_timer(LCompositor::eventLoop(), &LTimer::LTimerPrivate::waylandTimeoutCallback, this);
+    imp()->timer = this;
 }
 
 LTimer::~LTimer()
 {
-    if (compositor()->display())
-    {
-        wl_event_source_timer_update(imp()->waylandEventSource, 0);
-        wl_event_source_remove(imp()->waylandEventSource);
-    }
+    compositor()->imp()->timerWheel.remove(imp());
 
     if (imp()->destroyOnTimeout)
         LVectorRemoveOneUnordered(compositor()->imp()->oneShotTimers, this);
@@ -26,13 +20,13 @@ void LTimer::oneShot(UInt32 intervalMs, const Callback &onTimeout)
 {
     if (!onTimeout)
     {
-        LLog::error("[LTimer::oneShot] Cannot create one shot LTimer without onTimeout callback.");
+        LLOG_ERROR("[LTimer::oneShot] Cannot create one shot LTimer without onTimeout callback.");
         return;
     }
 
     if (!compositor()->display())
     {
-        LLog::error("[LTimer::oneShot] Failed to create one shot LTimer, no active LCompositor instance.");
+        LLOG_ERROR("[LTimer::oneShot] Failed to create one shot LTimer, no active LCompositor instance.");
         return;
     }
 
@@ -62,9 +56,7 @@ void LTimer::cancel()
     if (running())
     {
         imp()->running = false;
-
-        if (compositor()->display())
-            wl_event_source_timer_update(imp()->waylandEventSource, 0);
+        compositor()->imp()->timerWheel.remove(imp());
 
         if (imp()->destroyOnTimeout)
         {
@@ -79,9 +71,7 @@ void LTimer::stop()
     if (running())
     {
         imp()->running = false;
-
-        if (compositor()->display())
-            wl_event_source_timer_update(imp()->waylandEventSource, 0);
+        compositor()->imp()->timerWheel.remove(imp());
 
         if (imp()->onTimeoutCallback)
             imp()->onTimeoutCallback(this);
@@ -98,18 +88,32 @@ void LTimer::start(UInt32 intervalMs)
 {
     if (!compositor()->display())
     {
-        LLog::error("[LTimer::oneShot] Failed to start LTimer, no active LCompositor instance.");
+        LLOG_ERROR("[LTimer::oneShot] Failed to start LTimer, no active LCompositor instance.");
         return;
     }
 
-    if (!imp()->waylandEventSource)
-        imp()->waylandEventSource = wl_event_loop_add_timer(LCompositor::eventLoop(), &LTimer::LTimerPrivate::waylandTimeoutCallback, this);
+    LTimerPrivate::Wheel &wheel { compositor()->imp()->timerWheel };
+
+    if (!wheel.source)
+        wheel.source = wl_event_loop_add_timer(LCompositor::eventLoop(), &LTimerPrivate::Wheel::waylandTimeoutCallback, &wheel);
 
     imp()->interval = intervalMs;
     imp()->running = true;
 
     if (intervalMs > 0)
-        wl_event_source_timer_update(imp()->waylandEventSource, intervalMs);
+    {
+        const UInt64 now { LTimerPrivate::Wheel::now() };
+
+        // The wheel can jump forward only if no timer is overdue
+        if (wheel.nextTick() > now)
+            wheel.current = now;
+
+        wheel.insert(imp(), now + intervalMs);
+        wheel.arm(now);
+    }
     else
-        imp()->waylandTimeoutCallback(this);
+    {
+        wheel.remove(imp());
+        stop();
+    }
 }
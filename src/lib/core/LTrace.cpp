@@ -0,0 +1,114 @@
+#include <private/LTracePrivate.h>
+#include <LLog.h>
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace Louvre;
+
+std::mutex LTrace::LTracePrivate::ringsMutex;
+std::vector<std::unique_ptr<LTrace::LTracePrivate::Ring>> LTrace::LTracePrivate::rings;
+thread_local LTrace::LTracePrivate::Ring *LTrace::LTracePrivate::threadRing { nullptr };
+
+LTrace::LTracePrivate::Ring *LTrace::LTracePrivate::createThreadRing()
+{
+    std::lock_guard<std::mutex> lock { ringsMutex };
+    rings.emplace_back(std::make_unique<Ring>());
+    threadRing = rings.back().get();
+    threadRing->tid = gettid();
+    return threadRing;
+}
+
+void LTrace::LTracePrivate::setThreadName(const char *name)
+{
+    if (!threadRing)
+        createThreadRing();
+
+    std::lock_guard<std::mutex> lock { ringsMutex };
+    threadRing->threadName = name;
+}
+
+bool LTrace::enabled()
+{
+    return LOUVRE_TRACING == 1;
+}
+
+bool LTrace::dump(const std::filesystem::path &path)
+{
+#if LOUVRE_TRACING == 1
+    FILE *file { fopen(path.c_str(), "w") };
+
+    if (!file)
+    {
+        LLOG_ERROR("[LTrace::dump] Failed to open %s.", path.c_str());
+        return false;
+    }
+
+    const pid_t pid { getpid() };
+    std::vector<LTracePrivate::Span> spans;
+    bool first { true };
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    std::lock_guard<std::mutex> lock { LTracePrivate::ringsMutex };
+
+    for (const auto &ring : LTracePrivate::rings)
+    {
+        if (!ring->threadName.empty())
+        {
+            fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",", pid, ring->tid, ring->threadName.c_str());
+            first = false;
+        }
+
+        const UInt64 head { ring->head.load(std::memory_order_acquire) };
+        UInt64 begin { head > LTRACE_RING_SIZE ? head - LTRACE_RING_SIZE : 0 };
+
+        if (begin < ring->tail)
+            begin = ring->tail;
+
+        spans.clear();
+
+        for (UInt64 i = begin; i < head; i++)
+            spans.push_back(ring->spans[i % LTRACE_RING_SIZE]);
+
+        // Skip the spans the thread may have overwritten (or is writing) while they were copied
+        const UInt64 newHead { ring->head.load(std::memory_order_acquire) };
+        const UInt64 validBegin { newHead + 1 > LTRACE_RING_SIZE ? newHead + 1 - LTRACE_RING_SIZE : 0 };
+
+        for (UInt64 i = std::max(begin, validBegin); i < head; i++)
+        {
+            const LTracePrivate::Span &span { spans[i - begin] };
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                    first ? "" : ",",
+                    span.name,
+                    Float64(span.begin) / 1000.0,
+                    Float64(span.end - span.begin) / 1000.0,
+                    pid,
+                    ring->tid);
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    const bool ok { ferror(file) == 0 };
+    fclose(file);
+
+    if (!ok)
+        LLOG_ERROR("[LTrace::dump] Failed to write %s.", path.c_str());
+
+    return ok;
+#else
+    L_UNUSED(path);
+    LLOG_WARNING("[LTrace::dump] Louvre was built without tracing support, set the tracing Meson option to enable it.");
+    return false;
+#endif
+}
+
+void LTrace::clear()
+{
+    std::lock_guard<std::mutex> lock { LTrace::LTracePrivate::ringsMutex };
+
+    for (const auto &ring : LTrace::LTracePrivate::rings)
+        ring->tail = ring->head.load(std::memory_order_acquire);
+}
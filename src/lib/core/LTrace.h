@@ -0,0 +1,53 @@
+#ifndef LTRACE_H
+#define LTRACE_H
+
+#include <LNamespaces.h>
+#include <filesystem>
+
+/**
+ * @brief Tracing of the compositor hot paths
+ *
+ * When Louvre is built with the `tracing` Meson option (`meson setup build -Dtracing=true`), the main loop, surface commits,
+ * buffer uploads, scene rendering, output painting, page flips and input dispatching record timed spans into
+ * per-thread ring buffers, keeping only the most recent ones.\n
+ * Recording is lock-free and only costs two clock readings per span. When built without the option (default), the spans are
+ * compiled out and these methods do nothing.
+ *
+ * The recorded spans can be saved at any time with dump() in the Chrome trace event format, which can be opened with
+ * [Perfetto](https://ui.perfetto.dev) or `chrome://tracing`.
+ */
+class Louvre::LTrace
+{
+public:
+    /// @cond OMIT
+    LTrace() = delete;
+    class LTracePrivate;
+    /// @endcond
+
+    /**
+     * @brief Tracing support
+     *
+     * Returns `true` if Louvre was built with tracing support, `false` otherwise.
+     */
+    static bool enabled();
+
+    /**
+     * @brief Save the recorded spans
+     *
+     * Writes the spans currently stored in the ring buffers of all threads to a Chrome trace event JSON file.\n
+     * It can be called from any thread while the compositor is running.
+     *
+     * @param path Destination file, overwritten if it already exists.
+     * @return `true` on success, `false` if the file could not be written or tracing is not enabled.
+     */
+    static bool dump(const std::filesystem::path &path);
+
+    /**
+     * @brief Discard the recorded spans
+     *
+     * Spans recorded before this call are excluded from later dumps.
+     */
+    static void clear();
+};
+
+#endif // LTRACE_H
@@ -93,6 +93,8 @@ void LView::setParent(LView *view)
     if (parent())
         parent()->imp()->children.erase(imp()->parentLink);
 
+    LViewPrivate::treeSerial++;
+
     if (view)
     {
         view->imp()->children.push_back(this);
@@ -126,6 +128,7 @@ void LView::insertAfter(LView *prev, bool switchParent)
         parent()->imp()->children.erase(imp()->parentLink);
         parent()->imp()->children.push_front(this);
         imp()->parentLink = parent()->imp()->children.begin();
+        LViewPrivate::treeSerial++;
 
         imp()->markAsChangedOrder();
 
@@ -161,6 +164,8 @@ void LView::insertAfter(LView *prev, bool switchParent)
             parent()->imp()->children.erase(imp()->parentLink);
             imp()->parentLink = parent()->imp()->children.insert(std::next(prev->imp()->parentLink), this);
         }
+
+        LViewPrivate::treeSerial++;
     }
 }
 
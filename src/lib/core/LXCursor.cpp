@@ -14,7 +14,7 @@ LXCursor *LXCursor::loadXCursorB(const char *cursor, const char *theme, Int32 su
 
     if (!x11Cursor)
     {
-        LLog::error("[LXCursor::loadXCursorB] Failed to load X Cursor.");
+        LLOG_ERROR("[LXCursor::loadXCursorB] Failed to load X Cursor.");
         return nullptr;
     }
 
@@ -28,7 +28,7 @@ LXCursor *LXCursor::loadXCursorB(const char *cursor, const char *theme, Int32 su
                                                     DRM_FORMAT_ABGR8888,
                                                     x11Cursor->pixels))
     {
-        LLog::error("[LXCursor::loadXCursorB] Failed to create texture from X Cursor.");
+        LLOG_ERROR("[LXCursor::loadXCursorB] Failed to create texture from X Cursor.");
         delete newCursor;
         XcursorImageDestroy(x11Cursor);
         return nullptr;
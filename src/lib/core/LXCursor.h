@@ -55,6 +55,7 @@ public:
 
     LPRIVATE_IMP_UNIQUE(LXCursor)
     /// @cond OMIT
+    friend class LXCursorTheme;
     LXCursor();
     /// @endcond
 };
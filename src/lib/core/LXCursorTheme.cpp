@@ -0,0 +1,321 @@
+#include <private/LXCursorThemePrivate.h>
+#include <private/LXCursorPrivate.h>
+#include <private/LCompositorPrivate.h>
+#include <LOutput.h>
+#include <LLog.h>
+#include <X11/Xcursor/Xcursor.h>
+#include <pthread.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace Louvre;
+
+static UInt64 hashImage(const XcursorImage *image)
+{
+    UInt64 hash { 0xcbf29ce484222325 };
+
+    const auto add = [&hash](const void *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= ((const UInt8*)data)[i];
+            hash *= 0x100000001b3;
+        }
+    };
+
+    add(&image->width, sizeof(image->width));
+    add(&image->height, sizeof(image->height));
+    add(&image->xhot, sizeof(image->xhot));
+    add(&image->yhot, sizeof(image->yhot));
+    add(image->pixels, sizeof(XcursorPixel) * image->width * image->height);
+    return hash;
+}
+
+LXCursorTheme::LXCursorTheme(const char *theme, Int32 size, const Callback &onLoaded) : LPRIVATE_INIT_UNIQUE(LXCursorTheme)
+{
+    imp()->theme = this;
+
+    if (theme)
+        imp()->name = theme;
+
+    imp()->size = size > 0 ? size : 24;
+    imp()->onLoaded = onLoaded;
+    imp()->sizesB.insert(imp()->size);
+    imp()->updateSizes();
+    imp()->worker = std::thread(&LXCursorThemePrivate::workerLoop, imp());
+    compositor()->imp()->xCursorThemes.push_back(this);
+}
+
+LXCursorTheme::~LXCursorTheme()
+{
+    LVectorRemoveOneUnordered(compositor()->imp()->xCursorThemes, this);
+
+    imp()->mutex.lock();
+    imp()->running = false;
+    imp()->mutex.unlock();
+    imp()->jobsCond.notify_one();
+    imp()->worker.join();
+}
+
+const std::string &LXCursorTheme::name() const
+{
+    return imp()->name;
+}
+
+Int32 LXCursorTheme::size() const
+{
+    return imp()->size;
+}
+
+void LXCursorTheme::setOnLoadedCallback(const Callback &onLoaded)
+{
+    imp()->onLoaded = onLoaded;
+}
+
+void LXCursorTheme::preload(const std::vector<std::string> &cursors)
+{
+    imp()->update();
+
+    for (const std::string &cursor : cursors)
+        if (imp()->names.insert(cursor).second)
+            for (Int32 sizeB : imp()->sizesB)
+                imp()->schedule(cursor, sizeB);
+}
+
+const LXCursorTheme::Cursor *LXCursorTheme::cursor(const char *cursor, Float32 scale)
+{
+    imp()->update();
+
+    const std::string name { cursor };
+    const Int32 sizeB { imp()->size * std::max(1, (Int32)ceilf(scale)) };
+
+    if (imp()->names.insert(name).second)
+        for (Int32 s : imp()->sizesB)
+            imp()->schedule(name, s);
+
+    // Scales of outputs not added to the compositor
+    imp()->schedule(name, sizeB);
+
+    const auto it { imp()->cursors.find(name) };
+
+    if (it == imp()->cursors.end() || it->second.empty())
+        return nullptr;
+
+    const auto exact { it->second.find(sizeB) };
+
+    if (exact != it->second.end())
+        return &exact->second;
+
+    // Still loading, use the closest size
+    const Cursor *closest { nullptr };
+
+    for (const auto &loaded : it->second)
+        if (!closest || std::abs(loaded.first - sizeB) < std::abs(closest->sizeB - sizeB))
+            closest = &loaded.second;
+
+    return closest;
+}
+
+const LXCursor *LXCursorTheme::image(const char *cursor, Float32 scale, UInt32 ms)
+{
+    const Cursor *c { this->cursor(cursor, scale) };
+    return c ? c->frameAt(ms).image : nullptr;
+}
+
+bool LXCursorTheme::loading() const
+{
+    return imp()->pendingJobs > 0;
+}
+
+void LXCursorTheme::wait()
+{
+    imp()->update();
+
+    while (imp()->pendingJobs > 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock { imp()->mutex };
+            imp()->resultsCond.wait(lock, [this]{ return !imp()->results.empty(); });
+        }
+
+        imp()->uploadResults();
+    }
+}
+
+const LXCursorTheme::Frame &LXCursorTheme::Cursor::frameAt(UInt32 ms) const
+{
+    if (durationMs == 0)
+        return frames.front();
+
+    ms %= durationMs;
+
+    // The first frame begins at 0
+    const auto it { std::upper_bound(frames.begin(), frames.end(), ms, [](UInt32 ms, const Frame &frame)
+    {
+        return ms < frame.beginMs;
+    })};
+
+    return *(it - 1);
+}
+
+void LXCursorTheme::LXCursorThemePrivate::workerLoop()
+{
+    pthread_setname_np(pthread_self(), "LXCursorTheme");
+    std::unique_lock<std::mutex> lock { mutex };
+
+    while (true)
+    {
+        jobsCond.wait(lock, [this]{ return !running || !jobs.empty(); });
+
+        if (!running)
+            return;
+
+        Job job { std::move(jobs.front()) };
+        jobs.pop_front();
+        lock.unlock();
+
+        XcursorImages *xImages { XcursorLibraryLoadImages(job.name.c_str(), name.empty() ? nullptr : name.c_str(), job.sizeB) };
+
+        if (xImages)
+        {
+            job.images.resize(xImages->nimage);
+
+            for (Int32 i = 0; i < xImages->nimage; i++)
+            {
+                const XcursorImage *xImage { xImages->images[i] };
+                ParsedImage &image { job.images[i] };
+                image.hash = hashImage(xImage);
+                image.width = xImage->width;
+                image.height = xImage->height;
+                image.delay = xImage->delay;
+                image.hotspot.setX((Int32)xImage->xhot);
+                image.hotspot.setY((Int32)xImage->yhot);
+                image.pixels.assign(xImage->pixels, xImage->pixels + xImage->width * xImage->height);
+            }
+
+            XcursorImagesDestroy(xImages);
+        }
+
+        lock.lock();
+        results.push_back(std::move(job));
+        hasResults.store(true);
+        resultsCond.notify_all();
+
+        // Wake up the main loop (LCompositorPrivate::unlockPoll() requires the compositor lock)
+        UInt64 eventValue { 1 };
+        ssize_t n = write(compositor()->imp()->events[0].data.fd, &eventValue, sizeof(eventValue));
+        L_UNUSED(n);
+    }
+}
+
+void LXCursorTheme::LXCursorThemePrivate::schedule(const std::string &cursor, Int32 sizeB)
+{
+    if (!scheduled.emplace(cursor, sizeB).second)
+        return;
+
+    pendingJobs++;
+    mutex.lock();
+    jobs.push_back({cursor, sizeB, {}});
+    mutex.unlock();
+    jobsCond.notify_one();
+}
+
+void LXCursorTheme::LXCursorThemePrivate::update()
+{
+    updateSizes();
+    uploadResults();
+}
+
+bool LXCursorTheme::LXCursorThemePrivate::uploadResults()
+{
+    if (!hasResults.load())
+        return false;
+
+    std::vector<Job> done;
+    mutex.lock();
+    done.swap(results);
+    hasResults.store(false);
+    mutex.unlock();
+
+    bool loaded { false };
+
+    for (Job &job : done)
+    {
+        pendingJobs--;
+
+        LXCursorTheme::Cursor cursor;
+        cursor.durationMs = 0;
+        cursor.sizeB = job.sizeB;
+
+        for (ParsedImage &parsed : job.images)
+        {
+            LXCursor *image { nullptr };
+            const auto range { images.equal_range(parsed.hash) };
+
+            for (auto it = range.first; it != range.second; it++)
+            {
+                if (it->second.width == parsed.width &&
+                    it->second.height == parsed.height &&
+                    it->second.hotspot == parsed.hotspot &&
+                    it->second.pixels == parsed.pixels)
+                {
+                    image = it->second.image.get();
+                    break;
+                }
+            }
+
+            if (!image)
+            {
+                image = new LXCursor();
+                image->imp()->hotspotB = parsed.hotspot;
+
+                if (!image->imp()->texture.setDataB(LSize((Int32)parsed.width, (Int32)parsed.height),
+                                                    parsed.width * 4,
+                                                    DRM_FORMAT_ABGR8888,
+                                                    parsed.pixels.data()))
+                {
+                    LLOG_ERROR("[LXCursorThemePrivate::uploadResults] Failed to create texture from X Cursor %s.", job.name.c_str());
+                    delete image;
+                    continue;
+                }
+
+                images.emplace(parsed.hash, UniqueImage { std::unique_ptr<LXCursor>(image), parsed.width, parsed.height, parsed.hotspot, std::move(parsed.pixels) });
+            }
+
+            cursor.frames.push_back({image, parsed.delay, cursor.durationMs});
+            cursor.durationMs += parsed.delay;
+        }
+
+        if (cursor.frames.empty())
+        {
+            LLOG_WARNING("[LXCursorThemePrivate::uploadResults] X Cursor %s not found.", job.name.c_str());
+            continue;
+        }
+
+        if (cursor.frames.size() == 1)
+        {
+            cursor.frames.front().delayMs = 0;
+            cursor.durationMs = 0;
+        }
+
+        cursors[job.name][job.sizeB] = std::move(cursor);
+        loaded = true;
+    }
+
+    if (loaded && onLoaded)
+        onLoaded(theme);
+
+    return loaded;
+}
+
+void LXCursorTheme::LXCursorThemePrivate::updateSizes()
+{
+    for (LOutput *output : compositor()->outputs())
+    {
+        const Int32 sizeB { size * std::max(1, (Int32)ceilf(output->scale())) };
+
+        if (sizesB.insert(sizeB).second)
+            for (const std::string &cursor : names)
+                schedule(cursor, sizeB);
+    }
+}
@@ -0,0 +1,158 @@
+#ifndef LXCURSORTHEME_H
+#define LXCURSORTHEME_H
+
+#include <LObject.h>
+#include <LPoint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Cached XCursor theme
+ *
+ * The LXCursorTheme class keeps the cursors of an [XCursor](https://www.x.org/archive/X11R7.7/doc/man/man3/Xcursor.3.xhtml) theme
+ * loaded and ready to be assigned to LCursor, without blocking the main thread.
+ *
+ * Unlike LXCursor::loadXCursorB(), theme files are parsed by a background thread, only the texture upload is done on the main thread.
+ * Cursors are loaded lazily when first requested with cursor() or in advance with preload(), and each one is loaded in all the
+ * buffer sizes required by the scales of the current outputs (size() * LOutput::scale()). When an output scale changes, the missing
+ * sizes are loaded automatically.
+ *
+ * Identical images (for example, cursor names that are aliases of the same file or repeated animation frames) share the same
+ * LXCursor and texture. Animated cursors provide all their frames with precomputed timings, see Cursor::frameAt().
+ *
+ * The onLoaded callback set with setOnLoadedCallback() is invoked from the main thread each time new cursors finish loading.
+ *
+ * @note Instances must be created after the compositor is initialized, and destroyed before it is uninitialized.
+ *
+ * @see LXCursor
+ */
+class Louvre::LXCursorTheme : public LObject
+{
+public:
+    /**
+     * @brief Type definition for the loaded callback function.
+     * @param theme Pointer to the LXCursorTheme instance that loaded new cursors.
+     */
+    using Callback = std::function<void(LXCursorTheme*)>;
+
+    /**
+     * @brief Frame of a cursor.
+     */
+    struct Frame
+    {
+        /// Texture and hotspot of the frame, owned by the theme and possibly shared with other frames
+        const LXCursor *image;
+
+        /// Time the frame is displayed in milliseconds (0 for static cursors)
+        UInt32 delayMs;
+
+        /// Time since the beginning of the animation at which the frame is displayed in milliseconds
+        UInt32 beginMs;
+    };
+
+    /**
+     * @brief A cursor loaded in a specific size.
+     */
+    struct Cursor
+    {
+        /// Frames of the cursor, static cursors have a single frame
+        std::vector<Frame> frames;
+
+        /// Duration of a complete animation loop in milliseconds (0 for static cursors)
+        UInt32 durationMs;
+
+        /// Buffer size this cursor was loaded for
+        Int32 sizeB;
+
+        /**
+         * @brief Frame to display at a given time.
+         *
+         * @param ms Time since the animation started in milliseconds, looped by durationMs.
+         */
+        const Frame &frameAt(UInt32 ms) const;
+    };
+
+    /**
+     * @brief Constructor of the LXCursorTheme class.
+     *
+     * @param theme Name of the cursor theme. Pass `nullptr` to use the default theme.
+     * @param size Size of the cursors in surface coordinates, multiplied by the scale of each output to get the buffer sizes to load.
+     * @param onLoaded Callback invoked each time new cursors finish loading.
+     */
+    LXCursorTheme(const char *theme = nullptr, Int32 size = 24, const Callback &onLoaded = nullptr);
+
+    /**
+     * @brief Destructor of the LXCursorTheme class.
+     *
+     * Stops the background thread and destroys all the loaded images and textures.
+     */
+    ~LXCursorTheme();
+
+    /// @cond OMIT
+    LXCursorTheme(const LXCursorTheme&) = delete;
+    LXCursorTheme& operator= (const LXCursorTheme&) = delete;
+    /// @endcond
+
+    /**
+     * @brief Name of the theme passed in the constructor, empty for the default theme.
+     */
+    const std::string &name() const;
+
+    /**
+     * @brief Size of the cursors in surface coordinates.
+     */
+    Int32 size() const;
+
+    /**
+     * @brief Set the callback function invoked each time new cursors finish loading.
+     */
+    void setOnLoadedCallback(const Callback &onLoaded);
+
+    /**
+     * @brief Start loading cursors in the background.
+     *
+     * The cursors are loaded in the buffer sizes required by the current outputs and kept in sync with their scales.
+     *
+     * @param cursors Names of the cursors to load.
+     */
+    void preload(const std::vector<std::string> &cursors);
+
+    /**
+     * @brief Get a cursor.
+     *
+     * If the cursor has not been loaded yet in the buffer size required by the given scale, it is scheduled for loading
+     * and the loaded size closest to it is returned instead, or `nullptr` if none is available yet.
+     *
+     * @param cursor Name of the cursor.
+     * @param scale Scale of the output where the cursor is displayed (e.g. LOutput::scale()).
+     *
+     * @returns The cursor or `nullptr` if it is still loading or does not exist in the theme.
+     */
+    const Cursor *cursor(const char *cursor, Float32 scale = 1.f);
+
+    /**
+     * @brief Get the image of a cursor at a given time.
+     *
+     * Equivalent to `cursor(cursor, scale)->frameAt(ms).image`.
+     *
+     * @returns The image or `nullptr` if the cursor is still loading or does not exist in the theme.
+     */
+    const LXCursor *image(const char *cursor, Float32 scale = 1.f, UInt32 ms = 0);
+
+    /**
+     * @brief Check if there are cursors being loaded.
+     */
+    bool loading() const;
+
+    /**
+     * @brief Block until all scheduled cursors are loaded.
+     *
+     * The onLoaded callback is invoked before returning if new cursors were loaded.
+     */
+    void wait();
+
+LPRIVATE_IMP_UNIQUE(LXCursorTheme)
+};
+
+#endif // LXCURSORTHEME_H
@@ -10,6 +10,7 @@
 #include <protocols/FractionalScale/private/GFractionalScaleManagerPrivate.h>
 #include <protocols/GammaControl/private/GGammaControlManagerPrivate.h>
 #include <protocols/TearingControl/private/GTearingControlManagerPrivate.h>
+#include <protocols/ScreenCopy/private/GScreenCopyManagerPrivate.h>
 #include <LCompositor.h>
 #include <LToplevelRole.h>
 #include <LCursor.h>
@@ -69,6 +70,9 @@ bool LCompositor::createGlobalsRequest()
     wl_global_create(display(), &wp_tearing_control_manager_v1_interface,
                      LOUVRE_TEARING_CONTROL_MANAGER_VERSION, this, &Protocols::TearingControl::GTearingControlManager::GTearingControlManagerPrivate::bind);
 
+    wl_global_create(display(), &zwlr_screencopy_manager_v1_interface,
+                     LOUVRE_SCREEN_COPY_MANAGER_VERSION, this, &Protocols::ScreenCopy::GScreenCopyManager::GScreenCopyManagerPrivate::bind);
+
     wl_display_init_shm(display());
 
     return true;
@@ -17,6 +17,23 @@ void LOutput::initializeGL()
 }
 //! [initializeGL]
 
+//! [initializeCompleted]
+void LOutput::initializeCompleted(bool success)
+{
+    if (success)
+        repaint();
+}
+//! [initializeCompleted]
+
+//! [setModeCompleted]
+void LOutput::setModeCompleted(bool success)
+{
+    L_UNUSED(success)
+
+    /* No default implementation */
+}
+//! [setModeCompleted]
+
 //! [paintGL]
 void LOutput::paintGL()
 {
@@ -119,3 +136,14 @@ void LOutput::setGammaRequest(LClient *client, const LGammaTable *gamma)
     /* No default implementation */
 }
 //! [setGammaRequest]
+
+//! [screenCopyRequest]
+bool LOutput::screenCopyRequest(LClient *client, const LRect &region)
+{
+    L_UNUSED(client)
+    L_UNUSED(region)
+
+    /* Allow all clients to capture the output */
+    return true;
+}
+//! [screenCopyRequest]
@@ -55,7 +55,8 @@ void LSeat::outputPlugged(LOutput *output)
     else
         output->setPos(compositor()->outputs().back()->pos() + LPoint(compositor()->outputs().back()->size().w(), 0));
 
-    compositor()->addOutput(output);
+    // Initialized without blocking the main loop, see LOutput::initializeCompleted()
+    compositor()->addOutputAsync(output);
     compositor()->repaintAllOutputs();
 }
 //! [outputPlugged]
@@ -2,19 +2,63 @@
 #define LANIMATIONPRIVATE_H
 
 #include <LAnimation.h>
+#include <time.h>
+#include <vector>
+#include <limits>
 
 using namespace Louvre;
 
 LPRIVATE_CLASS(LAnimation)
     Float32 value = 0.f;
+    Float32 progress = 0.f;
     UInt32 duration;
-    UInt32 beginTime;
-    bool processed = false;
+
+    // CLOCK_MONOTONIC nanoseconds
+    Int64 beginTime;
+
+    /* Latest time the animation was evaluated at for each output (nullptr when processed without an output).
+     * Each output follows its own timeline, so outputs with different refresh rates or phases never see
+     * the value go backwards nor values predicted for another output */
+    std::vector<std::pair<const LOutput*, Int64>> lastTimes;
+
+    // Output value() was last evaluated for
+    LOutput *output = nullptr;
+
+    // Returns the last evaluation time slot of the output, adding it if needed
+    inline Int64 &lastTime(const LOutput *out)
+    {
+        for (auto &entry : lastTimes)
+            if (entry.first == out)
+                return entry.second;
+
+        return lastTimes.emplace_back(out, std::numeric_limits<Int64>::min()).second;
+    }
+
+    // Index in LCompositorPrivate::animations or -1 if not active
+    Int32 slot = -1;
     bool pendingDestroy = false;
     bool running = false;
     bool destroyOnFinish = false;
     Callback onUpdate = nullptr;
     Callback onFinish = nullptr;
+
+    Easing easing = Linear;
+    EasingCurve easingCurve = nullptr;
+
+    struct SpringParams
+    {
+        Float32 stiffness;
+        Float32 damping;
+        Float32 mass;
+    } spring;
+
+    void update(Int64 time);
+    Float32 springValue(Float64 seconds) const;
+
+    inline static Int64 timespecToNs(const timespec &time)
+    {
+        return (Int64)time.tv_sec * 1000000000 + (Int64)time.tv_nsec;
+    }
 };
 
 #endif // LANIMATIONPRIVATE_H
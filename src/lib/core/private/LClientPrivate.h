@@ -31,6 +31,7 @@ LPRIVATE_CLASS(LClient)
     std::vector<FractionalScale::GFractionalScaleManager*> fractionalScaleManagerGlobals;
     std::vector<GammaControl::GGammaControlManager*> gammaControlManagerGlobals;
     std::vector<TearingControl::GTearingControlManager*> tearingControlManagerGlobals;
+    std::vector<ScreenCopy::GScreenCopyManager*> screenCopyManagerGlobals;
 
     // Singleton Globals
     Wayland::GDataDeviceManager *dataDeviceManagerGlobal = nullptr;
@@ -7,6 +7,10 @@
 #include <private/LCursorPrivate.h>
 #include <private/LAnimationPrivate.h>
 #include <private/LToplevelRolePrivate.h>
+#include <private/LTracePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
+#include <private/LUDMABufImporter.h>
+#include <private/LOpenGLPrivate.h>
 #include <LKeyboard.h>
 #include <LPointer.h>
 #include <LTime.h>
@@ -93,6 +97,9 @@ static void clientConnectedEvent(wl_listener *listener, void *data)
     // Listen for client disconnection
     wl_client_add_destroy_listener(client, destroyListener);
 
+    if (LUDMABufImporter::enabled())
+        LUDMABufImporter::addClient(client);
+
     // Let the developer create his own client implementation
     LClient *newClient =  compositor->createClientRequest(params);
 
@@ -108,7 +115,7 @@ bool LCompositor::LCompositorPrivate::initWayland()
 
     if (!display)
     {
-        LLog::fatal("[LCompositorPrivate::initWayland] Unable to create Wayland display.\n");
+        LLOG_FATAL("[LCompositorPrivate::initWayland] Unable to create Wayland display.\n");
         return false;
     }
 
@@ -120,7 +127,7 @@ bool LCompositor::LCompositorPrivate::initWayland()
 
         if (socketFd == -1)
         {
-            LLog::error("[LCompositorPrivate::initWayland] Failed to add custom socket %s. Trying wl_display_add_socket_auto instead.", socket);
+            LLOG_ERROR("[LCompositorPrivate::initWayland] Failed to add custom socket %s. Trying wl_display_add_socket_auto instead.", socket);
             goto useAutoSocket;
         }
 
@@ -135,14 +142,14 @@ bool LCompositor::LCompositorPrivate::initWayland()
 
         if (!socket)
         {
-            LLog::fatal("[LCompositorPrivate::initWayland] Failed to add auto socket.");
+            LLOG_FATAL("[LCompositorPrivate::initWayland] Failed to add auto socket.");
             return false;
         }
     }
 
     if (!compositor->createGlobalsRequest())
     {
-        LLog::fatal("[LCompositorPrivate::initWayland] Failed to create globals.");
+        LLOG_FATAL("[LCompositorPrivate::initWayland] Failed to create globals.");
         return false;
     }
 
@@ -159,11 +166,26 @@ bool LCompositor::LCompositorPrivate::initWayland()
     // Listen for client connections
     clientConnectedListener.notify = &clientConnectedEvent;
     wl_display_add_client_created_listener(display, &clientConnectedListener);
+    LUDMABufImporter::init(display);
+
+    if (const char *recordPath = getenv("LOUVRE_RECORD_SESSION"))
+        LSessionRecorder::start(recordPath);
+
     return true;
 }
 
 void LCompositor::LCompositorPrivate::unitWayland()
 {
+    if (timerWheel.source)
+    {
+        wl_event_source_remove(timerWheel.source);
+        timerWheel.source = nullptr;
+        timerWheel.armed = 0;
+    }
+
+    LSessionRecorder::stop();
+    LUDMABufImporter::unit();
+
     if (display)
     {
         wl_display_destroy(display);
@@ -208,7 +230,7 @@ bool LCompositor::LCompositorPrivate::initGraphicBackend()
             graphicBackendHandle = nullptr;
             graphicBackend = nullptr;
 
-            LLog::error("[LCompositorPrivate::initGraphicBackend] Could not initialize pre-loaded backend.");
+            LLOG_ERROR("[LCompositorPrivate::initGraphicBackend] Could not initialize pre-loaded backend.");
             goto loadEnvBackend;
         }
     }
@@ -239,7 +261,7 @@ bool LCompositor::LCompositorPrivate::initGraphicBackend()
                 dlclose(graphicBackendHandle);
                 graphicBackendHandle = nullptr;
                 graphicBackend = nullptr;
-                LLog::error("[LCompositorPrivate::initGraphicBackend] Failed to initialize %s backend.", backendName.c_str());
+                LLOG_ERROR("[LCompositorPrivate::initGraphicBackend] Failed to initialize %s backend.", backendName.c_str());
 
                 if (usingEnvs)
                 {
@@ -254,7 +276,7 @@ bool LCompositor::LCompositorPrivate::initGraphicBackend()
         }
         else
         {
-            LLog::error("[LCompositorPrivate::initGraphicBackend] Failed to load %s backend.", backendPathName.c_str());
+            LLOG_ERROR("[LCompositorPrivate::initGraphicBackend] Failed to load %s backend.", backendPathName.c_str());
 
             if (usingEnvs)
             {
@@ -268,7 +290,7 @@ bool LCompositor::LCompositorPrivate::initGraphicBackend()
         }
     }
 
-    LLog::debug("[LCompositorPrivate::initGraphicBackend] Graphic backend initialized successfully.");
+    LLOG_DEBUG("[LCompositorPrivate::initGraphicBackend] Graphic backend initialized successfully.");
     isGraphicBackendInitialized = true;
 
     mainEGLDisplay = graphicBackend->backendGetAllocatorEGLDisplay();
@@ -302,7 +324,7 @@ bool LCompositor::LCompositorPrivate::initInputBackend()
             inputBackendHandle = nullptr;
             inputBackend = nullptr;
 
-            LLog::error("[LCompositorPrivate::initInputBackend] Could not initialize pre-loaded backend.");
+            LLOG_ERROR("[LCompositorPrivate::initInputBackend] Could not initialize pre-loaded backend.");
             goto loadEnvBackend;
         }
     }
@@ -333,7 +355,7 @@ bool LCompositor::LCompositorPrivate::initInputBackend()
                 dlclose(inputBackendHandle);
                 inputBackendHandle = nullptr;
                 inputBackend = nullptr;
-                LLog::error("[LCompositorPrivate::initInputBackend] Failed to initialize %s backend.", backendName.c_str());
+                LLOG_ERROR("[LCompositorPrivate::initInputBackend] Failed to initialize %s backend.", backendName.c_str());
 
                 if (usingEnvs)
                 {
@@ -348,7 +370,7 @@ bool LCompositor::LCompositorPrivate::initInputBackend()
         }
         else
         {
-            LLog::error("[LCompositorPrivate::initInputBackend] Failed to load %s backend.", backendPathName.c_str());
+            LLOG_ERROR("[LCompositorPrivate::initInputBackend] Failed to load %s backend.", backendPathName.c_str());
 
             if (usingEnvs)
             {
@@ -362,7 +384,7 @@ bool LCompositor::LCompositorPrivate::initInputBackend()
         }
     }
 
-    LLog::debug("[LCompositorPrivate::initInputBackend] Input backend initialized successfully.");
+    LLOG_DEBUG("[LCompositorPrivate::initInputBackend] Input backend initialized successfully.");
     isInputBackendInitialized = true;
     return true;
 }
@@ -372,7 +394,7 @@ void LCompositor::LCompositorPrivate::unitInputBackend(bool closeLib)
     if (inputBackend && isInputBackendInitialized)
     {
         inputBackend->uninitialize();
-        LLog::debug("[LCompositorPrivate::unitInputBackend] Input backend uninitialized successfully.");
+        LLOG_DEBUG("[LCompositorPrivate::unitInputBackend] Input backend uninitialized successfully.");
     }
 
     isInputBackendInitialized = false;
@@ -398,7 +420,7 @@ void LCompositor::LCompositorPrivate::unitGraphicBackend(bool closeLib)
     if (isGraphicBackendInitialized && graphicBackend)
     {
         graphicBackend->backendUninitialize();
-        LLog::debug("[LCompositorPrivate::unitGraphicBackend] Graphic backend uninitialized successfully.");
+        LLOG_DEBUG("[LCompositorPrivate::unitGraphicBackend] Graphic backend uninitialized successfully.");
     }
 
     mainEGLDisplay = EGL_NO_DISPLAY;
@@ -454,27 +476,27 @@ void LCompositor::LCompositorPrivate::unitSeat()
         {
             delete seat->imp()->keyboard;
             seat->imp()->keyboard = nullptr;
-            LLog::debug("[LCompositorPrivate::unitSeat] Keyboard uninitialized successfully.");
+            LLOG_DEBUG("[LCompositorPrivate::unitSeat] Keyboard uninitialized successfully.");
         }
 
         if (seat->pointer())
         {
             delete seat->imp()->pointer;
             seat->imp()->pointer = nullptr;
-            LLog::debug("[LCompositorPrivate::unitSeat] Pointer uninitialized successfully.");
+            LLOG_DEBUG("[LCompositorPrivate::unitSeat] Pointer uninitialized successfully.");
         }
 
         if (seat->dndManager())
         {
             delete seat->imp()->dndManager;
             seat->imp()->dndManager = nullptr;
-            LLog::debug("[LCompositorPrivate::unitSeat] DND Manager uninitialized successfully.");
+            LLOG_DEBUG("[LCompositorPrivate::unitSeat] DND Manager uninitialized successfully.");
         }
 
         delete seat;
         seat = nullptr;
 
-        LLog::debug("[LCompositorPrivate::unitSeat] Seat uninitialized successfully.");
+        LLOG_DEBUG("[LCompositorPrivate::unitSeat] Seat uninitialized successfully.");
     }
 }
 
@@ -487,7 +509,7 @@ bool LCompositor::LCompositorPrivate::loadGraphicBackend(const std::filesystem::
 
     if (!graphicBackendHandle)
     {
-        LLog::warning("[LCompositorPrivate::loadGraphicBackend] No graphic backend found at (%s)", path.c_str());
+        LLOG_WARNING("[LCompositorPrivate::loadGraphicBackend] No graphic backend found at (%s)", path.c_str());
         return false;
     }
 
@@ -495,7 +517,7 @@ bool LCompositor::LCompositorPrivate::loadGraphicBackend(const std::filesystem::
 
     if (!getAPI)
     {
-        LLog::error("[LCompositorPrivate::loadGraphicBackend] Failed to load graphic backend (%s)", path.c_str());
+        LLOG_ERROR("[LCompositorPrivate::loadGraphicBackend] Failed to load graphic backend (%s)", path.c_str());
         dlclose(graphicBackendHandle);
         return false;
     }
@@ -503,7 +525,7 @@ bool LCompositor::LCompositorPrivate::loadGraphicBackend(const std::filesystem::
     graphicBackend = getAPI();
 
     if (graphicBackend)
-        LLog::debug("[LCompositorPrivate::loadGraphicBackend] Graphic backend loaded successfully (%s).", path.c_str());
+        LLOG_DEBUG("[LCompositorPrivate::loadGraphicBackend] Graphic backend loaded successfully (%s).", path.c_str());
 
     return true;
 }
@@ -517,7 +539,7 @@ bool LCompositor::LCompositorPrivate::loadInputBackend(const std::filesystem::pa
 
     if (!inputBackendHandle)
     {
-        LLog::warning("[LCompositorPrivate::loadInputBackend] No input backend found at (%s).", path.c_str());
+        LLOG_WARNING("[LCompositorPrivate::loadInputBackend] No input backend found at (%s).", path.c_str());
         return false;
     }
 
@@ -525,7 +547,7 @@ bool LCompositor::LCompositorPrivate::loadInputBackend(const std::filesystem::pa
 
     if (!getAPI)
     {
-        LLog::warning("[LCompositorPrivate::loadInputBackend] Failed to load input backend (%s).", path.c_str());
+        LLOG_WARNING("[LCompositorPrivate::loadInputBackend] Failed to load input backend (%s).", path.c_str());
         dlclose(inputBackendHandle);
         return false;
     }
@@ -533,7 +555,7 @@ bool LCompositor::LCompositorPrivate::loadInputBackend(const std::filesystem::pa
     inputBackend = getAPI();
 
     if (inputBackend)
-        LLog::debug("[LCompositorPrivate::loadInputBackend] Input backend loaded successfully (%s).", path.c_str());
+        LLOG_DEBUG("[LCompositorPrivate::loadInputBackend] Input backend loaded successfully (%s).", path.c_str());
 
     return true;
 }
@@ -568,79 +590,143 @@ void LCompositor::LCompositorPrivate::insertSurfaceBefore(LSurface *nextSurface,
     surfaceToInsert->orderChanged();
 }
 
-bool LCompositor::LCompositorPrivate::runningAnimations()
+void LCompositor::LCompositorPrivate::addAnimation(LAnimation *animation)
+{
+    if (animation->imp()->slot >= 0)
+        return;
+
+    animation->imp()->slot = animations.size();
+    animations.push_back(animation);
+}
+
+void LCompositor::LCompositorPrivate::removeAnimation(LAnimation *animation)
+{
+    if (animation->imp()->slot < 0)
+        return;
+
+    animations[animation->imp()->slot] = nullptr;
+    animation->imp()->slot = -1;
+    animationsTombstones++;
+
+    if (!processingAnimations)
+        compactAnimations();
+}
+
+void LCompositor::LCompositorPrivate::compactAnimations()
 {
-    bool running = false;
+    if (animationsTombstones == 0)
+        return;
+
+    UInt32 slot { 0 };
 
-    for (LAnimation *anim : animations)
+    for (LAnimation *a : animations)
     {
-        anim->imp()->processed = false;
+        if (!a)
+            continue;
 
-        if (anim->imp()->running || anim->imp()->pendingDestroy)
-            running = true;
+        a->imp()->slot = slot;
+        animations[slot++] = a;
     }
 
-    return running;
+    animations.resize(slot);
+    animationsTombstones = 0;
 }
 
-void LCompositor::LCompositorPrivate::processAnimations()
+void LCompositor::LCompositorPrivate::processAnimations(LOutput *output)
 {
-    Int64 elapsed;
-    retry:
-    animationsVectorChanged = false;
-    for (LAnimation *a : animations)
+    if (processingAnimations || !runningAnimations())
+        return;
+
+    const Int64 time { output ? output->imp()->predictedPresentationTime : LAnimation::LAnimationPrivate::timespecToNs(LTime::ns()) };
+    processingAnimations = true;
+
+    // Animations started from callbacks are appended and processed in the same pass
+    for (size_t i = 0; i < animations.size(); i++)
     {
-        if (a->imp()->processed)
+        LAnimation *a { animations[i] };
+
+        if (!a)
             continue;
 
         if (a->imp()->pendingDestroy)
         {
             delete a;
-            goto retry;
+            continue;
         }
 
-        a->imp()->processed = true;
-
         if (!a->imp()->running)
             continue;
 
-        elapsed = (Int64)LTime::ms() - (Int64)a->imp()->beginTime;
+        Int64 &lastTime { a->imp()->lastTime(output) };
 
-        if (elapsed > (Int64)a->imp()->duration)
-            elapsed = a->imp()->duration;
+        if (time <= lastTime)
+            continue;
 
-        a->imp()->value = (Float32)elapsed/(Float32)a->imp()->duration;
+        lastTime = time;
+        a->imp()->output = output;
+        a->imp()->update(time);
 
         if (a->imp()->onUpdate)
         {
             a->imp()->onUpdate(a);
 
-            if (animationsVectorChanged)
-                goto retry;
+            // Destroyed or stopped from the callback
+            if (animations[i] != a || !a->imp()->running)
+                continue;
         }
 
-        if (a->imp()->value == 1.f)
-        {
+        if (a->imp()->progress == 1.f)
             a->stop();
+    }
 
-            if (animationsVectorChanged)
-                goto retry;
-        }
+    processingAnimations = false;
+    compactAnimations();
+}
 
-    }
+UInt32 LCompositor::LCompositorPrivate::acquireThreadSlot()
+{
+    UInt32 slot { 1 };
+
+    while (slot < threadsData.size() && threadsData[slot].used)
+        slot++;
+
+    if (slot == threadsData.size())
+        threadsData.emplace_back();
+
+    threadsData[slot].used = true;
+    return slot;
 }
 
-void LCompositor::LCompositorPrivate::destroyPendingRenderBuffers(std::thread::id *id)
+void LCompositor::LCompositorPrivate::releaseThreadSlot(UInt32 slot)
 {
-    std::thread::id threadId = std::this_thread::get_id();
+    if (slot == MainThreadSlot || slot >= threadsData.size())
+        return;
 
-    if (id != nullptr)
-        threadId = *id;
+    LOpenGL::LOpenGLPrivate::dropTextureRequests(slot);
+    threadsData[slot] = ThreadData();
+}
 
-    ThreadData &threadData = threadsMap[threadId];
+UInt32 LCompositor::LCompositorPrivate::threadSlot(std::thread::id thread) const
+{
+    for (UInt32 slot = 0; slot < threadsData.size(); slot++)
+        if (threadsData[slot].used && threadsData[slot].threadId == thread)
+            return slot;
+
+    return InvalidThreadSlot;
+}
+
+void LCompositor::LCompositorPrivate::destroyPendingRenderBuffers(UInt32 slot)
+{
+    if (slot >= threadsData.size())
+        return;
+
+    ThreadData &threadData = threadsData[slot];
 
     while (!threadData.renderBuffersToDestroy.empty())
     {
+        if (threadData.painter && threadData.painter->imp()->software)
+            threadData.painter->imp()->software->removeTarget(threadData.renderBuffersToDestroy.back().framebufferId);
+
         glDeleteTextures(1, &threadData.renderBuffersToDestroy.back().textureId);
         glDeleteFramebuffers(1, &threadData.renderBuffersToDestroy.back().framebufferId);
         threadData.renderBuffersToDestroy.pop_back();
@@ -649,17 +735,25 @@ void LCompositor::LCompositorPrivate::destroyPendingRenderBuffers(std::thread::i
 
 void LCompositor::LCompositorPrivate::addRenderBufferToDestroy(std::thread::id thread, LRenderBuffer::LRenderBufferPrivate::ThreadData &data)
 {
-    ThreadData &threadData = threadsMap[thread];
-    threadData.renderBuffersToDestroy.push_back(data);
+    const UInt32 slot { threadSlot(thread) };
+
+    // The thread (and its GL context) no longer exists
+    if (slot == InvalidThreadSlot)
+        return;
+
+    threadsData[slot].renderBuffersToDestroy.push_back(data);
 }
 
 void LCompositor::LCompositorPrivate::lock()
 {
+    LTRACE_SCOPE("lock");
     renderMutex.lock();
+    lockOwner.store(std::this_thread::get_id());
 }
 
 void LCompositor::LCompositorPrivate::unlock()
 {
+    lockOwner.store(std::thread::id());
     renderMutex.unlock();
 }
 
@@ -3,11 +3,13 @@
 
 #include <LOutput.h>
 #include <private/LRenderBufferPrivate.h>
+#include <private/LTimerPrivate.h>
 #include <LCompositor.h>
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include <sys/epoll.h>
 #include <map>
+#include <atomic>
 #include <unistd.h>
 #include <string>
 #include <filesystem>
@@ -79,6 +81,14 @@ LPRIVATE_CLASS(LCompositor)
     void lock();
     void unlock();
 
+    // Thread holding renderMutex, for code that can be called with or without the lock
+    std::atomic<std::thread::id> lockOwner;
+
+    inline bool lockedByCurrentThread() const
+    {
+        return lockOwner.load() == std::this_thread::get_id();
+    }
+
     bool loadGraphicBackend(const std::filesystem::path &path);
     bool loadInputBackend(const std::filesystem::path &path);
 
@@ -89,25 +99,64 @@ LPRIVATE_CLASS(LCompositor)
     std::list<LSurface*>surfaces;
     std::vector<LClient*>clients;
     std::vector<LOutput*>outputs;
+
+    // Outputs with a pending LOutputPrivate::asyncOperation, checked by processLoop()
+    UInt32 asyncOutputOperations = 0;
+
+    // Updated by processLoop() to upload cursors parsed in the background and track output scales
+    std::vector<LXCursorTheme*> xCursorThemes;
     std::vector<LView*>views;
     std::vector<LTexture*>textures;
+
+    /* Incremented on each CPU texture upload from any thread, sampled per frame by LOutput::frameStats().
+     * Most uploads happen on the main thread (surface commits), so it is not split per thread slot */
+    std::atomic<UInt64> textureUploads { 0 };
     bool surfacesListChanged = false;
-    std::vector<LAnimation*>animations;
-    bool animationsVectorChanged = false;
     std::vector<LTimer*>oneShotTimers;
+    LTimer::LTimerPrivate::Wheel timerWheel;
+
+    // Stable slot array of active animations, removed slots are set to nullptr and compacted after each pass
+    std::vector<LAnimation*>animations;
+    UInt32 animationsTombstones = 0;
+    bool processingAnimations = false;
+    void addAnimation(LAnimation *animation);
+    void removeAnimation(LAnimation *animation);
+    void compactAnimations();
 
-    bool runningAnimations();
-    void processAnimations();
+    inline bool runningAnimations() const
+    {
+        return animations.size() > animationsTombstones;
+    }
 
-    // Thread specific data
+    // Evaluates animations at the predicted presentation time of the output (or now if nullptr)
+    void processAnimations(LOutput *output = nullptr);
+
+    /* Thread specific data, indexed by a dense slot instead of the thread id so that per-output
+     * data (e.g. LViewPrivate::threadsData) can be stored in contiguous arrays.
+     * Slot 0 belongs to the main thread and each output takes the lowest free slot while added. */
     struct ThreadData
     {
+        std::thread::id threadId;
+        bool used = false;
         LPainter *painter = nullptr;
         std::vector<LRenderBuffer::LRenderBufferPrivate::ThreadData> renderBuffersToDestroy;
     };
 
-    std::map<std::thread::id, ThreadData> threadsMap;
-    void destroyPendingRenderBuffers(std::thread::id *id);
+    static constexpr UInt32 MainThreadSlot = 0;
+    static constexpr UInt32 InvalidThreadSlot = UINT32_MAX;
+    std::vector<ThreadData> threadsData;
+    UInt32 acquireThreadSlot();
+    void releaseThreadSlot(UInt32 slot);
+
+    // Linear search, threadsData only has a few entries
+    UInt32 threadSlot(std::thread::id thread) const;
+
+    inline UInt32 currentThreadSlot() const
+    {
+        return threadSlot(std::this_thread::get_id());
+    }
+
+    void destroyPendingRenderBuffers(UInt32 slot);
     void addRenderBufferToDestroy(std::thread::id thread, LRenderBuffer::LRenderBufferPrivate::ThreadData &data);
     static LPainter *findPainter();
 
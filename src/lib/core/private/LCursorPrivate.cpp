@@ -1,3 +1,142 @@
 #include <private/LCursorPrivate.h>
 
 LCursor::LCursorPrivate::LCursorPrivate() : defaultTexture() {}
+
+// Same rules as setPos(), keeps the cursor inside the output it is on
+static LPointF clampToOutputs(const std::vector<LCursor::LCursorPrivate::FastPath::OutputInfo> &outputs, const LPointF &pos, const LPointF &prevPos)
+{
+    const LRect *area { nullptr };
+
+    for (const auto &info : outputs)
+    {
+        if (info.rect.containsPoint(pos))
+            return pos;
+
+        if (!area && info.rect.containsPoint(prevPos))
+            area = &info.rect;
+    }
+
+    if (!area)
+        return outputs.empty() ? pos : prevPos;
+
+    LPointF clamped { pos };
+
+    if (clamped.x() > area->x() + area->w())
+        clamped.setX(area->x() + area->w());
+    if (clamped.x() < area->x())
+        clamped.setX(area->x());
+
+    if (clamped.y() > area->y() + area->h())
+        clamped.setY(area->y() + area->h());
+    if (clamped.y() < area->y())
+        clamped.setY(area->y());
+
+    return clamped;
+}
+
+void LCursor::LCursorPrivate::fastPathMove(Float32 dx, Float32 dy)
+{
+    std::lock_guard<std::mutex> lock { fastPath.mutex };
+    fastPath.unconsumed += LPointF(dx, dy);
+
+    if (!fastPath.active)
+        return;
+
+    fastPath.pos = clampToOutputs(fastPath.outputs, fastPath.pos + LPointF(dx, dy), fastPath.pos);
+    const LPointF posS { fastPath.pos - fastPath.hotspotS };
+    LRect cursorRect;
+    cursorRect.setPos(posS);
+    cursorRect.setSize(fastPath.size);
+
+    for (const auto &info : fastPath.outputs)
+        if (info.hardware && info.rect.intersects(cursorRect))
+            compositor()->imp()->graphicBackend->outputSetCursorPosition(
+                info.output,
+                planePos(info.rect, info.transform, info.fractionalScale, posS - LPointF(info.rect.pos()), fastPath.size));
+}
+
+void LCursor::LCursorPrivate::fastPathConsume(Float32 dx, Float32 dy)
+{
+    std::lock_guard<std::mutex> lock { fastPath.mutex };
+    fastPath.unconsumed -= LPointF(dx, dy);
+}
+
+LPointF LCursor::LCursorPrivate::fastPathPublish(const LPointF &hotspotS)
+{
+    fastPath.hotspotS = hotspotS;
+    fastPath.size = size;
+    fastPath.active = fastPath.enabled && isVisible;
+    fastPath.outputs.clear();
+
+    // Outputs being initialized or changing their mode are added once the backend is done with them
+    for (LOutput *o : compositor()->outputs())
+        if (o->state() == LOutput::Initialized)
+            fastPath.outputs.push_back({o, o->rect(), o->transform(), o->fractionalScale(), cursor()->hasHardwareSupport(o)});
+
+    if (fastPath.active)
+        fastPath.pos = clampToOutputs(fastPath.outputs, pos + fastPath.unconsumed, pos);
+    else
+        fastPath.pos = pos;
+
+    return fastPath.pos;
+}
+
+void LCursor::LCursorPrivate::fastPathRemoveOutput(LOutput *output)
+{
+    std::lock_guard<std::mutex> lock { fastPath.mutex };
+
+    for (auto it = fastPath.outputs.begin(); it != fastPath.outputs.end(); it++)
+    {
+        if (it->output == output)
+        {
+            fastPath.outputs.erase(it);
+            return;
+        }
+    }
+}
+
+void LCursor::LCursorPrivate::fastPathRefresh()
+{
+    std::lock_guard<std::mutex> lock { fastPath.mutex };
+    fastPathPublish(fastPath.hotspotS);
+    posChanged = true;
+}
+
+LPointF LCursor::LCursorPrivate::planePos(const LRect &outputRect, LFramebuffer::Transform transform, Float32 fractionalScale, LPointF p, const LSizeF &size)
+{
+    if (transform == LFramebuffer::Flipped)
+        p.setX(outputRect.w() - p.x() - size.w());
+    else if (transform == LFramebuffer::Rotated270)
+    {
+        Float32 tmp = p.x();
+        p.setX(outputRect.h() - p.y() - size.h());
+        p.setY(tmp);
+    }
+    else if (transform == LFramebuffer::Rotated180)
+    {
+        p.setX(outputRect.w() - p.x() - size.w());
+        p.setY(outputRect.h() - p.y() - size.h());
+    }
+    else if (transform == LFramebuffer::Rotated90)
+    {
+        Float32 tmp = p.x();
+        p.setX(p.y());
+        p.setY(outputRect.w() - tmp - size.h());
+    }
+    else if (transform == LFramebuffer::Flipped270)
+    {
+        Float32 tmp = p.x();
+        p.setX(outputRect.h() - p.y() - size.h());
+        p.setY(outputRect.w() - tmp - size.w());
+    }
+    else if (transform == LFramebuffer::Flipped180)
+        p.setY(outputRect.h() - p.y() - size.y());
+    else if (transform == LFramebuffer::Flipped90)
+    {
+        Float32 tmp = p.x();
+        p.setX(p.y());
+        p.setY(tmp);
+    }
+
+    return p * fractionalScale;
+}
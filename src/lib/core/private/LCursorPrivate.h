@@ -4,12 +4,18 @@
 #include <private/LCompositorPrivate.h>
 #include <private/LPainterPrivate.h>
 #include <private/LOutputPrivate.h>
+#include <private/LTexturePrivate.h>
 #include <LCursor.h>
 #include <algorithm>
+#include <cstring>
+#include <list>
+#include <mutex>
+
+#define LCURSOR_BUFFER_CACHE_SIZE 16
 
 using namespace Louvre;
 
-inline static void texture2Buffer(LCursor *cursor, const LSizeF &size, LFramebuffer::Transform transform);
+inline static void texture2Buffer(LCursor *cursor, LOutput *output, LTexture *texture, const LSizeF &size, LFramebuffer::Transform transform, bool upload);
 
 LPRIVATE_CLASS_NO_COPY(LCursor)
     LCursorPrivate();
@@ -32,6 +38,96 @@ LPRIVATE_CLASS_NO_COPY(LCursor)
     GLuint glFramebuffer, glRenderbuffer;
     UChar8 buffer[64*64*4];
 
+    /* Snapshot used to move hardware cursor planes directly from the input thread
+     * (see fastPathMove()), reconciled with pos each time textureUpdate() runs */
+    struct FastPath
+    {
+        struct OutputInfo
+        {
+            LOutput *output;
+            LRect rect;
+            LFramebuffer::Transform transform;
+            Float32 fractionalScale;
+            bool hardware;
+        };
+
+        std::mutex mutex;
+        bool enabled = true;
+        bool active = false;
+        LPointF pos;
+
+        // Relative motion applied by the input thread but not yet by the main thread
+        LPointF unconsumed;
+        LPointF hotspotS;
+        LSizeF size;
+        std::vector<OutputInfo> outputs;
+    } fastPath;
+
+    // Input thread
+    void fastPathMove(Float32 dx, Float32 dy);
+
+    // Main thread, before the same motion is dispatched to LPointer
+    void fastPathConsume(Float32 dx, Float32 dy);
+
+    // fastPath.mutex must be locked
+    LPointF fastPathPublish(const LPointF &hotspotS);
+
+    // Main thread, stops moving the planes of an output about to be uninitialized or reconfigured
+    void fastPathRemoveOutput(LOutput *output);
+
+    // Main thread, snapshots the current outputs again after they change
+    void fastPathRefresh();
+    static LPointF planePos(const LRect &outputRect, LFramebuffer::Transform transform, Float32 fractionalScale, LPointF p, const LSizeF &size);
+
+    // Converted hardware cursor buffers, most recently used first
+    struct CachedBuffer
+    {
+        const LTexture *texture;
+        UInt32 textureSerial;
+        LSizeF size;
+        LFramebuffer::Transform transform;
+        UChar8 buffer[64*64*4];
+    };
+    std::list<CachedBuffer> cachedBuffers;
+
+    inline CachedBuffer *findCachedBuffer(const LTexture *tex, const LSizeF &sz, LFramebuffer::Transform transform)
+    {
+        for (auto it = cachedBuffers.begin(); it != cachedBuffers.end(); it++)
+        {
+            if (it->texture == tex && it->textureSerial == tex->imp()->serial && it->size == sz && it->transform == transform)
+            {
+                if (it != cachedBuffers.begin())
+                    cachedBuffers.splice(cachedBuffers.begin(), cachedBuffers, it);
+
+                return &cachedBuffers.front();
+            }
+        }
+
+        return nullptr;
+    }
+
+    inline void cacheBuffer(const LTexture *tex, UInt32 textureSerial, const LSizeF &sz, LFramebuffer::Transform transform, const UChar8 *pixels)
+    {
+        if (findCachedBuffer(tex, sz, transform))
+            return;
+
+        if (cachedBuffers.size() >= LCURSOR_BUFFER_CACHE_SIZE)
+            cachedBuffers.pop_back();
+
+        cachedBuffers.emplace_front();
+        CachedBuffer &cached { cachedBuffers.front() };
+        cached.texture = tex;
+        cached.textureSerial = textureSerial;
+        cached.size = sz;
+        cached.transform = transform;
+        memcpy(cached.buffer, pixels, sizeof(cached.buffer));
+    }
+
+    inline void removeCachedBuffers(const LTexture *tex)
+    {
+        cachedBuffers.remove_if([tex](const CachedBuffer &cached) { return cached.texture == tex; });
+    }
+
     inline void setOutput(LOutput *out)
     {
         bool up = false;
@@ -122,8 +218,14 @@ LPRIVATE_CLASS_NO_COPY(LCursor)
         rect.setPos(newPosS);
         rect.setSize(size);
 
+        // Buffers are updated first, readbacks may wait for the GPU and the input thread must not be blocked meanwhile
         for (LOutput *o : compositor()->outputs())
         {
+            /* The backend may be initializing it or changing its mode from another thread,
+             * textureChanged is set again once it is done */
+            if (o->state() != LOutput::Initialized)
+                continue;
+
             if (o->rect().intersects(rect))
             {
                 bool found = (std::find(intersectedOutputs.begin(), intersectedOutputs.end(), o) != intersectedOutputs.end());
@@ -133,64 +235,46 @@ LPRIVATE_CLASS_NO_COPY(LCursor)
 
                 if (cursor()->hasHardwareSupport(o) && (textureChanged || !found))
                 {
-                    texture2Buffer(cursor(), size * o->fractionalScale(), o->transform());
-                    compositor()->imp()->graphicBackend->outputSetCursorTexture(o, buffer);
+                    const LSizeF sizeB { size * o->fractionalScale() };
+                    const CachedBuffer *cached { findCachedBuffer(texture, sizeB, o->transform()) };
+
+                    if (cached)
+                    {
+                        // Discard in-flight readbacks
+                        o->imp()->cursorReadbackSerial++;
+                        memcpy(buffer, cached->buffer, sizeof(buffer));
+                        compositor()->imp()->graphicBackend->outputSetCursorTexture(o, buffer);
+                    }
+                    else
+                    {
+                        // The backend buffer is updated once the readback completes
+                        texture2Buffer(cursor(), o, texture, sizeB, o->transform(), true);
+                    }
                 }
             }
             else
             {
                 LVectorRemoveOneUnordered(intersectedOutputs, o);
+                o->imp()->cursorReadbackSerial++;
                 compositor()->imp()->graphicBackend->outputSetCursorTexture(o, nullptr);
             }
+        }
 
-            if (cursor()->hasHardwareSupport(o))
-            {
-                LPointF p = newPosS - LPointF(o->pos());
-
-                if (o->transform() == LFramebuffer::Flipped)
-                    p.setX(o->rect().w() - p.x() - size.w());
-                else if (o->transform() == LFramebuffer::Rotated270)
-                {
-                    Float32 tmp = p.x();
-                    p.setX(o->rect().h() - p.y() - size.h());
-                    p.setY(tmp);
-                }
-                else if (o->transform() == LFramebuffer::Rotated180)
-                {
-                    p.setX(o->rect().w() - p.x() - size.w());
-                    p.setY(o->rect().h() - p.y() - size.h());
-                }
-                else if (o->transform() == LFramebuffer::Rotated90)
-                {
-                    Float32 tmp = p.x();
-                    p.setX(p.y());
-                    p.setY(o->rect().w() - tmp - size.h());
-                }
-                else if (o->transform() == LFramebuffer::Flipped270)
-                {
-                    Float32 tmp = p.x();
-                    p.setX(o->rect().h() - p.y() - size.h());
-                    p.setY(o->rect().w() - tmp - size.w());
-                }
-                else if (o->transform() == LFramebuffer::Flipped180)
-                    p.setY(o->rect().h() - p.y() - size.y());
-                else if (o->transform() == LFramebuffer::Flipped90)
-                {
-                    Float32 tmp = p.x();
-                    p.setX(p.y());
-                    p.setY(tmp);
-                }
+        /* Include motion the input thread already applied to the planes, and keep it
+         * from moving them until they are all updated */
+        std::lock_guard<std::mutex> fastPathLock { fastPath.mutex };
+        const LPointF planePosS { fastPathPublish(newHotspotS) - newHotspotS };
 
-                compositor()->imp()->graphicBackend->outputSetCursorPosition(o, o->scale() * p / ( o->scale() / o->fractionalScale()) );
-            }
-        }
+        for (const auto &info : fastPath.outputs)
+            if (info.hardware)
+                compositor()->imp()->graphicBackend->outputSetCursorPosition(info.output, planePos(info.rect, info.transform, info.fractionalScale, planePosS - LPointF(info.rect.pos()), size));
 
         textureChanged = false;
         posChanged = false;
     }
 };
 
-inline static void texture2Buffer(LCursor *cursor, const LSizeF &size, LFramebuffer::Transform transform)
+inline static void texture2Buffer(LCursor *cursor, LOutput *output, LTexture *texture, const LSizeF &size, LFramebuffer::Transform transform, bool upload)
 {
     LPainter *painter = cursor->compositor()->imp()->painter;
     glBindFramebuffer(GL_FRAMEBUFFER, cursor->imp()->glFramebuffer);
@@ -200,35 +284,43 @@ inline static void texture2Buffer(LCursor *cursor, const LSizeF &size, LFramebuf
         transform == LFramebuffer::Flipped ||
         transform == LFramebuffer::Flipped180 ||
         transform == LFramebuffer::Rotated180)
-        src = LRect(0, 0, cursor->texture()->sizeB().w(), -cursor->texture()->sizeB().h());
+        src = LRect(0, 0, texture->sizeB().w(), -texture->sizeB().h());
     else if (transform == LFramebuffer::Rotated90 ||
              transform == LFramebuffer::Rotated270 ||
              transform == LFramebuffer::Flipped90 ||
              transform == LFramebuffer::Flipped270)
-        src = LRect(0, 0, -cursor->texture()->sizeB().w(), cursor->texture()->sizeB().h());
+        src = LRect(0, 0, -texture->sizeB().w(), texture->sizeB().h());
 
     painter->imp()->scaleCursor(
-        cursor->texture(),
+        texture,
         src,
         LRect(0, size),
         transform);
 
-    if (painter->imp()->openGLExtensions.EXT_read_format_bgra)
-        glReadPixels(0, 0, 64, 64, GL_BGRA_EXT , GL_UNSIGNED_BYTE, cursor->imp()->buffer);
-    else
+    const UInt32 serial { upload ? ++output->imp()->cursorReadbackSerial : 0 };
+    const UInt32 textureSerial { texture->imp()->serial };
+
+    // Completed on a later processLoop() iteration, by then the output, texture or cursor state could have changed
+    painter->imp()->readPixelsAsync(LRect(0, 0, 64, 64), GL_BGRA_EXT, [=](const UChar8 *pixels, const LSize &, UInt32)
     {
-        glReadPixels(0, 0, 64, 64, GL_RGBA , GL_UNSIGNED_BYTE, cursor->imp()->buffer);
+        if (!pixels)
+            return;
 
-        UInt8 tmp;
+        const std::vector<LTexture*> &textures { cursor->compositor()->imp()->textures };
+
+        if (std::find(textures.begin(), textures.end(), texture) != textures.end() && texture->imp()->serial == textureSerial)
+            cursor->imp()->cacheBuffer(texture, textureSerial, size, transform, pixels);
+
+        const std::vector<LOutput*> &outputs { cursor->compositor()->outputs() };
+
+        if (!upload || !cursor->visible() || std::find(outputs.begin(), outputs.end(), output) == outputs.end() ||
+            output->state() != LOutput::Initialized || output->imp()->cursorReadbackSerial != serial)
+            return;
+
+        memcpy(cursor->imp()->buffer, pixels, sizeof(cursor->imp()->buffer));
+        cursor->compositor()->imp()->graphicBackend->outputSetCursorTexture(output, cursor->imp()->buffer);
+    });
 
-        // Convert to RGBA8888
-        for (Int32 i = 0; i < 64*64*4; i+=4)
-        {
-            tmp = cursor->imp()->buffer[i];
-            cursor->imp()->buffer[i] = cursor->imp()->buffer[i+2];
-            cursor->imp()->buffer[i+2] = tmp;
-        }
-    }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
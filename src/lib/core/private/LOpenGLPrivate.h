@@ -0,0 +1,23 @@
+#ifndef LOPENGLPRIVATE_H
+#define LOPENGLPRIVATE_H
+
+#include <LOpenGL.h>
+
+using namespace Louvre;
+
+class Louvre::LOpenGL::LOpenGLPrivate
+{
+public:
+    /* Uploads the textures decoded for requests made from the given thread slot and invokes their callbacks.
+     * From the main thread it also schedules a repaint of outputs with decoded textures pending */
+    static void processLoadedTextures(UInt32 threadSlot);
+
+    /* Discards the requests made from a thread slot that is being released without invoking their callbacks,
+     * the slot may be assigned to another output */
+    static void dropTextureRequests(UInt32 threadSlot);
+
+    // Stops the decoding threads and discards pending requests, called when the compositor is uninitialized
+    static void unitTextureLoader();
+};
+
+#endif // LOPENGLPRIVATE_H
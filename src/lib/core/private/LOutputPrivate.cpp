@@ -1,15 +1,24 @@
 #include <protocols/Wayland/private/GOutputPrivate.h>
+#include <protocols/ScreenCopy/private/RScreenCopyFramePrivate.h>
+#include <protocols/ScreenCopy/wlr-screencopy-unstable-v1.h>
+#include <protocols/LinuxDMABuf/LDMABuffer.h>
 #include <private/LOutputPrivate.h>
 #include <private/LOutputModePrivate.h>
 #include <private/LCompositorPrivate.h>
 #include <private/LPainterPrivate.h>
 #include <private/LCursorPrivate.h>
 #include <private/LSurfacePrivate.h>
+#include <private/LTexturePrivate.h>
+#include <private/LAnimationPrivate.h>
+#include <private/LTracePrivate.h>
+#include <private/LOpenGLPrivate.h>
 #include <LSeat.h>
 #include <LClient.h>
+#include <LLog.h>
 
 #include <LTime.h>
 #include <iostream>
+#include <pthread.h>
 
 LOutput::LOutputPrivate::LOutputPrivate(LOutput *output) : fb(output) {}
 
@@ -20,12 +29,94 @@ bool LOutput::LOutputPrivate::initialize()
     return compositor()->imp()->graphicBackend->outputInitialize(output);
 }
 
+void LOutput::LOutputPrivate::startAsyncOperation(AsyncOperation operation, const LOutputMode *mode)
+{
+    compositor()->imp()->asyncOutputOperations++;
+    asyncFinished.store(false);
+    asyncOperation.store(operation);
+    asyncThread = std::thread([this, operation, mode]
+    {
+        pthread_setname_np(pthread_self(), "LOutputAsync");
+
+        if (operation == AsyncInitialize)
+            asyncSucceeded = compositor()->imp()->graphicBackend->outputInitialize(output);
+        else
+            asyncSucceeded = compositor()->imp()->graphicBackend->outputSetMode(output, (LOutputMode*)mode);
+
+        asyncFinished.store(true);
+
+        // Wake up the main loop (LCompositorPrivate::unlockPoll() requires the compositor lock)
+        UInt64 eventValue { 1 };
+        ssize_t n = write(compositor()->imp()->events[0].data.fd, &eventValue, sizeof(eventValue));
+        L_UNUSED(n);
+    });
+}
+
+void LOutput::LOutputPrivate::finishAsyncOperation(bool notify)
+{
+    const AsyncOperation operation { asyncOperation.load() };
+
+    if (operation == NoAsyncOperation)
+        return;
+
+    /* The backend may be waiting for initializeGL() or resizeGL(), which lock the compositor.
+     * Called from ~LOutput(), which may not hold the lock */
+    if (!asyncFinished.load() && compositor()->imp()->lockedByCurrentThread())
+    {
+        compositor()->imp()->unlock();
+        asyncThread.join();
+        compositor()->imp()->lock();
+    }
+    else
+        asyncThread.join();
+
+    asyncOperation.store(NoAsyncOperation);
+    compositor()->imp()->asyncOutputOperations--;
+
+    if (operation == AsyncInitialize)
+    {
+        if (!notify)
+            return;
+
+        if (!asyncSucceeded)
+        {
+            LLOG_ERROR("[LOutputPrivate::finishAsyncOperation] Failed to initialize output %s.", output->name());
+            compositor()->removeOutput(output);
+        }
+
+        output->initializeCompleted(asyncSucceeded);
+    }
+    else
+    {
+        // resizeGL() is not triggered if the mode change fails
+        if (state == ChangingMode)
+            state = Initialized;
+
+        if (notify)
+            output->setModeCompleted(asyncSucceeded);
+    }
+}
+
+void LOutput::LOutputPrivate::processAsyncOperation()
+{
+    if (asyncOperation.load() != NoAsyncOperation && asyncFinished.load())
+        finishAsyncOperation(true);
+}
+
 void LOutput::LOutputPrivate::backendInitializeGL()
 {
+    // The main thread is not blocked waiting for the backend
+    const bool async { asyncOperation.load() == AsyncInitialize };
+
+    if (async)
+        compositor()->imp()->lock();
+
     if (output->gammaSize() != 0)
         output->setGamma(nullptr);
 
     threadId = std::this_thread::get_id();
+    compositor()->imp()->threadsData[threadSlot].threadId = threadId;
+    LTRACE_THREAD_NAME((std::string("Output ") + output->name()).c_str());
 
     painter = new LPainter();
     painter->imp()->output = output;
@@ -40,11 +131,14 @@ void LOutput::LOutputPrivate::backendInitializeGL()
     output->setScale(output->imp()->fractionalScale);
     lastPos = rect.pos();
     lastSize = rect.size();
+    output->imp()->state = LOutput::Initialized;
     cursor()->imp()->textureChanged = true;
     cursor()->imp()->update();
-    output->imp()->state = LOutput::Initialized;
     output->initializeGL();
     compositor()->flushClients();
+
+    if (async)
+        compositor()->imp()->unlock();
 }
 
 void LOutput::LOutputPrivate::backendPaintGL()
@@ -57,6 +151,8 @@ void LOutput::LOutputPrivate::backendPaintGL()
     if (output->imp()->state != LOutput::Initialized)
         return;
 
+    LTRACE_SCOPE("backendPaintGL");
+
     if (callLock)
         compositor()->imp()->lock();
 
@@ -75,14 +171,47 @@ void LOutput::LOutputPrivate::backendPaintGL()
         lastSize = rect.size();
     }
 
+    beginFrameStats();
     compositor()->imp()->sendPresentationTime();
-    compositor()->imp()->processAnimations();
+    updatePredictedPresentationTime();
+    compositor()->imp()->processAnimations(output);
+    painter->imp()->processReadbacks(false);
+    painter->imp()->processTimerQueries();
+    LOpenGL::LOpenGLPrivate::processLoadedTextures(threadSlot);
     stateFlags.remove(PendingRepaint);
     painter->bindFramebuffer(&fb);
+    painter->imp()->beginTimerQuery(frameCount);
 
     output->paintGL();
 
-    if (stateFlags.check(HasDamage) && (stateFlags.checkAll(UsingFractionalScale | FractionalOversamplingEnabled) || output->hasBufferDamageSupport()))
+    const Int64 flushBegin { monotonicNs() };
+    currentFrameStats->damagedArea = 0;
+
+    // In buffer pixels, rounded like the buffer damage below (the transform doesn't change the area)
+    if (stateFlags.check(HasDamage))
+    {
+        Int32 n;
+        const LBox *boxes { damage.boxes(&n) };
+
+        for (Int32 i = 0; i < n; i++)
+        {
+            const Int32 x1 { std::max(boxes[i].x1, rect.x()) - rect.x() };
+            const Int32 y1 { std::max(boxes[i].y1, rect.y()) - rect.y() };
+            const Int32 x2 { std::min(boxes[i].x2, rect.x() + rect.w()) - rect.x() };
+            const Int32 y2 { std::min(boxes[i].y2, rect.y() + rect.h()) - rect.y() };
+
+            if (x1 >= x2 || y1 >= y2)
+                continue;
+
+            currentFrameStats->damagedArea +=
+                UInt64(ceilf(Float32(x2) * fractionalScale) - floorf(Float32(x1) * fractionalScale)) *
+                UInt64(ceilf(Float32(y2) * fractionalScale) - floorf(Float32(y1) * fractionalScale));
+        }
+    }
+    else
+        currentFrameStats->damagedArea = UInt64(output->currentMode()->sizeB().w()) * UInt64(output->currentMode()->sizeB().h());
+
+    if (stateFlags.check(HasDamage) && (stateFlags.checkAll(UsingFractionalScale | FractionalOversamplingEnabled) || output->hasBufferDamageSupport() || !screenCopyDamage.empty()))
     {
         damage.offset(-rect.pos().x(), -rect.pos().y());
         damage.transform(rect.size(), transform);
@@ -135,7 +264,7 @@ void LOutput::LOutputPrivate::backendPaintGL()
             .srcScale = 1.f
         });
 
-        glDisable(GL_BLEND);
+        painter->imp()->setBlendingEnabled(false);
 
         if (stateFlags.check(HasDamage))
             painter->drawRegion(damage);
@@ -149,10 +278,21 @@ void LOutput::LOutputPrivate::backendPaintGL()
         updateRect();
     }
 
+    // Upload what the pixman renderer drew before presenting or copying the screen
+    if (painter->imp()->software)
+        painter->imp()->software->flush();
+
+    copyScreenCopyFrames();
+    painter->imp()->endTimerQuery();
     stateFlags.remove(HasDamage);
     compositor()->flushClients();
-    compositor()->imp()->destroyPendingRenderBuffers(&output->imp()->threadId);
+    compositor()->imp()->destroyPendingRenderBuffers(threadSlot);
     compositor()->imp()->destroyNativeTextures(nativeTexturesToDestroy);
+    endFrameStats(flushBegin);
+
+    // Readbacks scheduled during this frame are completed on the next one
+    if (!painter->imp()->pendingReadbacks.empty())
+        output->repaint();
 
     if (callLock)
         compositor()->imp()->unlock();
@@ -165,27 +305,36 @@ void LOutput::LOutputPrivate::backendResizeGL()
     if (!callLock)
         callLockACK.store(true);
 
+    // Mode changes started with setModeAsync() keep the call lock enabled
+    if (callLock)
+        compositor()->imp()->lock();
+
     if (output->imp()->state == LOutput::ChangingMode)
     {
+        // The backend discards the flips pending before the modeset
+        pageflipMutex.lock();
+        framesAwaitingPresentation.clear();
+        pageflipMutex.unlock();
+
         output->imp()->state = LOutput::Initialized;
         output->setScale(output->fractionalScale());
         output->imp()->updateRect();
         output->imp()->updateGlobals();
         cursor()->imp()->textureChanged = true;
-    }
 
-    if (output->imp()->state != LOutput::Initialized)
-        return;
-
-    if (callLock)
-        compositor()->imp()->lock();
-
-    output->resizeGL();
+        // Removed from the cursor fast path by setModeAsync()
+        cursor()->imp()->fastPathRefresh();
+    }
 
-    if (lastPos != rect.pos())
+    if (output->imp()->state == LOutput::Initialized)
     {
-        output->moveGL();
-        lastPos = rect.pos();
+        output->resizeGL();
+
+        if (lastPos != rect.pos())
+        {
+            output->moveGL();
+            lastPos = rect.pos();
+        }
     }
 
     if (callLock)
@@ -206,9 +355,11 @@ void LOutput::LOutputPrivate::backendUninitializeGL()
        compositor()->imp()->lock();
 
     output->uninitializeGL();
+    painter->imp()->finishReadbacks();
+    painter->imp()->finishTimerQueries();
     compositor()->flushClients();
     output->imp()->state = LOutput::Uninitialized;
-    compositor()->imp()->destroyPendingRenderBuffers(&output->imp()->threadId);
+    compositor()->imp()->destroyPendingRenderBuffers(threadSlot);
     compositor()->imp()->destroyNativeTextures(nativeTexturesToDestroy);
 
     if (callLock)
@@ -217,9 +368,104 @@ void LOutput::LOutputPrivate::backendUninitializeGL()
 
 void LOutput::LOutputPrivate::backendPageFlipped()
 {
+    LTRACE_SCOPE("pageFlipped");
     pageflipMutex.lock();
     stateFlags.add(HasUnhandledPresentationTime);
+
+    // Page flips complete in the order frames were submitted, flips without a painted frame (e.g. modesets) are ignored
+    if (!framesAwaitingPresentation.empty())
+    {
+        presentedFrames.emplace_back(framesAwaitingPresentation.front(), LAnimation::LAnimationPrivate::timespecToNs(presentationTime.time));
+        framesAwaitingPresentation.pop_front();
+    }
+
+    pageflipMutex.unlock();
+}
+
+LOutput::FrameStats *LOutput::LOutputPrivate::frameStatsOf(UInt64 frame)
+{
+    if (frame >= frameCount || frameCount - frame > LOUTPUT_FRAME_STATS_SIZE)
+        return nullptr;
+
+    return &frameStats[frame % LOUTPUT_FRAME_STATS_SIZE];
+}
+
+void LOutput::LOutputPrivate::beginFrameStats()
+{
+    pageflipMutex.lock();
+
+    for (const auto &presented : presentedFrames)
+        if (FrameStats *stats = frameStatsOf(presented.first))
+            stats->presentationTime = presented.second;
+
+    presentedFrames.clear();
     pageflipMutex.unlock();
+
+    currentFrameStats = &frameStats[frameCount % LOUTPUT_FRAME_STATS_SIZE];
+    *currentFrameStats = {};
+    currentFrameStats->frame = frameCount;
+    currentFrameStats->paintTime = monotonicNs();
+    currentFrameStats->gpuTime = -1;
+    currentFrameStats->presentationTime = -1;
+
+    const UInt64 textureUploads { compositor()->imp()->textureUploads.load(std::memory_order_relaxed) };
+    currentFrameStats->textureUploads = textureUploads - lastTextureUploads;
+    lastTextureUploads = textureUploads;
+    painter->imp()->drawCalls = 0;
+}
+
+void LOutput::LOutputPrivate::endFrameStats(Int64 flushBegin)
+{
+    const Int64 now { monotonicNs() };
+    currentFrameStats->flushTime = now - flushBegin;
+    currentFrameStats->totalTime = now - currentFrameStats->paintTime;
+    currentFrameStats->drawCalls = painter->imp()->drawCalls;
+
+    pageflipMutex.lock();
+    framesAwaitingPresentation.push_back(currentFrameStats->frame);
+
+    // Frames the backend never flipped are dropped once they leave the ring
+    if (framesAwaitingPresentation.size() > LOUTPUT_FRAME_STATS_SIZE)
+        framesAwaitingPresentation.pop_front();
+
+    pageflipMutex.unlock();
+
+    currentFrameStats = nullptr;
+    frameCount++;
+}
+
+void LOutput::LOutputPrivate::updatePredictedPresentationTime()
+{
+    const clockid_t clock { compositor()->imp()->graphicBackend->outputGetClock(output) };
+    timespec now;
+    clock_gettime(clock, &now);
+    const Int64 nowNs { LAnimation::LAnimationPrivate::timespecToNs(now) };
+
+    pageflipMutex.lock();
+    const Int64 lastNs { LAnimation::LAnimationPrivate::timespecToNs(presentationTime.time) };
+    Int64 period = presentationTime.period;
+    pageflipMutex.unlock();
+
+    // The backend may not report the period, refreshRate() is in mHz
+    if (period <= 0)
+    {
+        const UInt32 refreshRate { output->currentMode() ? output->currentMode()->refreshRate() : 0 };
+        period = refreshRate > 0 ? 1000000000000LL / refreshRate : 16666667;
+    }
+
+    Int64 predicted;
+
+    // Next vblank after now
+    if (lastNs <= 0 || lastNs > nowNs)
+        predicted = nowNs + period;
+    else
+        predicted = lastNs + ((nowNs - lastNs) / period + 1) * period;
+
+    // Animations use CLOCK_MONOTONIC
+    if (clock != CLOCK_MONOTONIC)
+        predicted += LAnimation::LAnimationPrivate::timespecToNs(LTime::ns()) - nowNs;
+
+    predictedPresentationTime = predicted;
 }
 
 void LOutput::LOutputPrivate::updateRect()
@@ -260,3 +506,226 @@ void LOutput::LOutputPrivate::updateGlobals()
         }
     }
 }
+
+LRegion &LOutput::LOutputPrivate::screenCopyDamageOf(GScreenCopyManager *manager)
+{
+    for (ScreenCopyDamage &entry : screenCopyDamage)
+        if (entry.manager == manager)
+            return entry.damage;
+
+    screenCopyDamage.push_back({manager, LRegion(LRect(0, output->currentMode()->sizeB()))});
+    return screenCopyDamage.back().damage;
+}
+
+void LOutput::LOutputPrivate::removeScreenCopyDamage(GScreenCopyManager *manager)
+{
+    for (auto it = screenCopyDamage.begin(); it != screenCopyDamage.end(); it++)
+    {
+        if (it->manager == manager)
+        {
+            screenCopyDamage.erase(it);
+            return;
+        }
+    }
+}
+
+void LOutput::LOutputPrivate::copyScreenCopyFrames()
+{
+    if (screenCopyDamage.empty() && screenCopyFrames.empty())
+        return;
+
+    const LRect modeRectB { 0, output->currentMode()->sizeB() };
+
+    // Without damage the entire output was repainted
+    if (stateFlags.check(HasDamage))
+        for (ScreenCopyDamage &entry : screenCopyDamage)
+            entry.damage.addRegion(damage);
+    else
+        for (ScreenCopyDamage &entry : screenCopyDamage)
+            entry.damage.addRect(modeRectB);
+
+    if (screenCopyFrames.empty())
+        return;
+
+    timespec time;
+    clock_gettime(compositor()->imp()->graphicBackend->outputGetClock(output), &time);
+
+    std::vector<RScreenCopyFrame*> done, shmFrames;
+    bool dmaCopy { false };
+
+    // The final image is always in the backend framebuffer (even with oversampling)
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // SHM copies can be released from readback callbacks invoked while scheduling another readback
+    const std::vector<RScreenCopyFrame*> frames { screenCopyFrames };
+
+    for (RScreenCopyFrame *frame : frames)
+    {
+        if (!frame->imp()->buffer)
+            continue;
+
+        const LRect &regionB { frame->regionB() };
+
+        // Frames remain valid after their manager is destroyed, but without damage tracking
+        LRegion *managerDamage { frame->screenCopyManagerGlobal() ? &screenCopyDamageOf(frame->screenCopyManagerGlobal()) : nullptr };
+        LRegion frameDamage { managerDamage ? *managerDamage : LRegion(regionB) };
+        frameDamage.clip(regionB);
+
+        if (frame->imp()->withDamage && frameDamage.empty())
+            continue;
+
+        // The mode may have changed since the frame was created
+        if (regionB.x() + regionB.w() > modeRectB.w() || regionB.y() + regionB.h() > modeRectB.h())
+        {
+            done.push_back(frame);
+            frame->failed();
+            continue;
+        }
+
+        if (wl_shm_buffer_get(frame->imp()->buffer))
+        {
+            // Frames waiting for damage only get the damaged boxes written, completed from the readback callback
+            shmFrames.push_back(frame);
+            copyScreenCopyFrameSHM(frame, frame->imp()->withDamage ? frameDamage : LRegion(regionB), time);
+
+            if (managerDamage)
+                managerDamage->subtractRect(regionB);
+
+            continue;
+        }
+
+        done.push_back(frame);
+
+        // OpenGL framebuffer rows go from bottom to top, hence the y_invert flag
+        const LRect srcB { regionB.x(), modeRectB.h() - regionB.y() - regionB.h(), regionB.w(), regionB.h() };
+
+        LDMABuffer *dmaBuffer { (LDMABuffer*)wl_resource_get_user_data(frame->imp()->buffer) };
+        LTexture *texture { dmaBuffer->texture() };
+        const GLuint textureId { texture ? texture->id(output) : 0 };
+
+        // External only targets can not be written
+        if (!textureId || texture->target() != GL_TEXTURE_2D)
+        {
+            frame->failed();
+            continue;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, textureId);
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, srcB.x(), srcB.y(), srcB.w(), srcB.h());
+        dmaCopy = true;
+
+        frame->flags(ZWLR_SCREENCOPY_FRAME_V1_FLAGS_Y_INVERT);
+
+        if (frame->imp()->withDamage)
+        {
+            Int32 n;
+            LBox *boxes { frameDamage.boxes(&n) };
+
+            for (Int32 i = 0; i < n; i++)
+            {
+                frame->damage(LRect(boxes->x1 - regionB.x(),
+                                    boxes->y1 - regionB.y(),
+                                    boxes->x2 - boxes->x1,
+                                    boxes->y2 - boxes->y1));
+                boxes++;
+            }
+        }
+
+        frame->ready(time);
+
+        if (managerDamage)
+            managerDamage->subtractRect(regionB);
+    }
+
+    // Submit the copies before clients receive the ready event (DMA-BUF implicit sync)
+    if (dmaCopy)
+        glFlush();
+
+    for (RScreenCopyFrame *frame : done)
+        frame->imp()->release();
+
+    // Keep the buffer until the readback finishes
+    for (RScreenCopyFrame *frame : shmFrames)
+        frame->imp()->detachFromOutput();
+
+    painter->bindFramebuffer(&fb);
+}
+
+void LOutput::LOutputPrivate::copyScreenCopyFrameSHM(RScreenCopyFrame *frame, const LRegion &copyRegion, const timespec &time)
+{
+    const LRect &regionB { frame->regionB() };
+    const LBox &extents { copyRegion.extents() };
+    const LRect extentsB { extents.x1, extents.y1, extents.x2 - extents.x1, extents.y2 - extents.y1 };
+    const Int32 modeH { output->currentMode()->sizeB().h() };
+
+    frame->imp()->pendingCopy = std::make_shared<RScreenCopyFrame::RScreenCopyFramePrivate::PendingCopy>();
+    frame->imp()->pendingCopy->frame = frame;
+    frame->imp()->pendingCopy->time = time;
+
+    // OpenGL framebuffer rows go from bottom to top, hence the y_invert flag
+    const LRect srcB { extentsB.x(), modeH - extentsB.y() - extentsB.h(), extentsB.w(), extentsB.h() };
+
+    /* A single readback of the damage extents, only the damaged boxes are then written into the client buffer.
+     * The callback is invoked on this thread with the compositor locked */
+    const bool scheduled { painter->imp()->readPixelsAsync(srcB,
+        frame->imp()->shmFormat == WL_SHM_FORMAT_XRGB8888 ? GL_BGRA_EXT : GL_RGBA,
+        [pendingCopy = frame->imp()->pendingCopy, copyRegion, extentsB, regionB](const UChar8 *pixels, const LSize &, UInt32 stride)
+    {
+        RScreenCopyFrame *frame { pendingCopy->frame };
+
+        // Destroyed or its buffer destroyed (failed() was already sent)
+        if (!frame)
+            return;
+
+        wl_shm_buffer *shmBuffer { frame->imp()->buffer ? wl_shm_buffer_get(frame->imp()->buffer) : nullptr };
+
+        if (!pixels || !shmBuffer)
+        {
+            frame->imp()->release();
+            frame->failed();
+            return;
+        }
+
+        Int32 n;
+        const LBox *boxes { copyRegion.boxes(&n) };
+        const Int32 dstStride { wl_shm_buffer_get_stride(shmBuffer) };
+
+        wl_shm_buffer_begin_access(shmBuffer);
+        UChar8 *dst { (UChar8*)wl_shm_buffer_get_data(shmBuffer) };
+
+        for (Int32 i = 0; i < n; i++)
+        {
+            const Int32 w { boxes[i].x2 - boxes[i].x1 };
+            const Int32 h { boxes[i].y2 - boxes[i].y1 };
+
+            // Rows of both the readback and the (y inverted) buffer go from bottom to top
+            const Int32 srcX { boxes[i].x1 - extentsB.x() };
+            const Int32 srcY { extentsB.y() + extentsB.h() - boxes[i].y2 };
+            const Int32 dstX { boxes[i].x1 - regionB.x() };
+            const Int32 dstY { regionB.y() + regionB.h() - boxes[i].y2 };
+
+            for (Int32 y = 0; y < h; y++)
+                memcpy(&dst[(dstY + y) * dstStride + dstX * 4], &pixels[(srcY + y) * stride + srcX * 4], w * 4);
+        }
+
+        wl_shm_buffer_end_access(shmBuffer);
+        frame->flags(ZWLR_SCREENCOPY_FRAME_V1_FLAGS_Y_INVERT);
+
+        if (frame->imp()->withDamage)
+            for (Int32 i = 0; i < n; i++)
+                frame->damage(LRect(boxes[i].x1 - regionB.x(),
+                                    boxes[i].y1 - regionB.y(),
+                                    boxes[i].x2 - boxes[i].x1,
+                                    boxes[i].y2 - boxes[i].y1));
+
+        const timespec time { pendingCopy->time };
+        frame->imp()->release();
+        frame->ready(time);
+    })};
+
+    if (!scheduled)
+    {
+        frame->imp()->release();
+        frame->failed();
+    }
+}
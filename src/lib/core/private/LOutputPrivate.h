@@ -8,7 +8,12 @@
 #include <LGammaTable.h>
 #include <atomic>
 #include <mutex>
+#include <thread>
 #include <functional>
+#include <deque>
+#include <time.h>
+
+#define LOUTPUT_FRAME_STATS_SIZE 128
 
 struct LOutput::Params
 {
@@ -30,7 +35,11 @@ LPRIVATE_CLASS_NO_COPY(LOutput)
         UInt32 period;
         UInt64 frame;
         UInt32 flags;
-    } presentationTime;
+    } presentationTime {};
+
+    // CLOCK_MONOTONIC nanoseconds, updated before each paintGL()
+    Int64 predictedPresentationTime = 0;
+    void updatePredictedPresentationTime();
 
     enum StateFlags : UInt32
     {
@@ -90,11 +99,88 @@ LPRIVATE_CLASS_NO_COPY(LOutput)
     std::atomic<bool> callLockACK;
     std::thread::id threadId;
 
+    /* Initialization or mode change started with LCompositor::addOutputAsync() or LOutput::setModeAsync().
+     * The blocking graphic backend call runs in asyncThread while the main loop keeps running, the result
+     * is reported from the main thread by processAsyncOperation() */
+    enum AsyncOperation : UInt8
+    {
+        NoAsyncOperation,
+        AsyncInitialize,
+        AsyncSetMode
+    };
+    std::atomic<AsyncOperation> asyncOperation { NoAsyncOperation };
+    std::atomic<bool> asyncFinished { false };
+    bool asyncSucceeded { false };
+    std::thread asyncThread;
+    void startAsyncOperation(AsyncOperation operation, const LOutputMode *mode);
+
+    // Joins the thread (releasing the compositor lock while waiting) and invokes the completion event if notify is true
+    void finishAsyncOperation(bool notify);
+
+    // Called from the main loop, no-op if the operation is still running
+    void processAsyncOperation();
+
+    // Index of LCompositorPrivate::threadsData assigned while the output is added, UINT32_MAX otherwise
+    UInt32 threadSlot = UINT32_MAX;
+
     // Raw native OpenGL textures that need to be destroyed from this thread
     std::vector<GLuint>nativeTexturesToDestroy;
 
     LGammaTable gammaTable {0};
 
+    // wlr-screencopy frames capturing this output, only accessed with the compositor locked
+    std::vector<Protocols::ScreenCopy::RScreenCopyFrame*> screenCopyFrames;
+
+    // Damage accumulated since the last copy of each screencopy manager (in buffer coordinates)
+    struct ScreenCopyDamage
+    {
+        Protocols::ScreenCopy::GScreenCopyManager *manager;
+        LRegion damage;
+    };
+    std::vector<ScreenCopyDamage> screenCopyDamage;
+
+    // Creates the entry with full damage if it does not exist
+    LRegion &screenCopyDamageOf(Protocols::ScreenCopy::GScreenCopyManager *manager);
+    void removeScreenCopyDamage(Protocols::ScreenCopy::GScreenCopyManager *manager);
+    void copyScreenCopyFrames();
+
+    // Schedules the asynchronous readback of the boxes of copyRegion into the SHM buffer of the frame
+    void copyScreenCopyFrameSHM(Protocols::ScreenCopy::RScreenCopyFrame *frame, const LRegion &copyRegion, const timespec &time);
+
+    // Incremented each time a hardware cursor readback for this output is scheduled or invalidated
+    UInt32 cursorReadbackSerial = 0;
+
+    /* Ring of the last LOUTPUT_FRAME_STATS_SIZE frames (LOutput::frameStats()), written from the
+     * output thread with the compositor locked */
+    FrameStats frameStats[LOUTPUT_FRAME_STATS_SIZE];
+
+    // Number of finished frames
+    UInt64 frameCount = 0;
+
+    // Stats of the frame being painted, nullptr outside backendPaintGL()
+    FrameStats *currentFrameStats = nullptr;
+
+    // LCompositorPrivate::textureUploads at the beginning of the last frame
+    UInt64 lastTextureUploads = 0;
+
+    // Frames finished by backendPaintGL() whose page flip hasn't arrived yet, oldest first (pageflipMutex)
+    std::deque<UInt64> framesAwaitingPresentation;
+
+    // Frame and presentation timestamp pairs set by backendPageFlipped(), stored by beginFrameStats() (pageflipMutex)
+    std::vector<std::pair<UInt64, Int64>> presentedFrames;
+
+    // Returns nullptr if the frame is no longer in the ring
+    FrameStats *frameStatsOf(UInt64 frame);
+    void beginFrameStats();
+    void endFrameStats(Int64 flushBegin);
+
+    inline static Int64 monotonicNs()
+    {
+        timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return (Int64)time.tv_sec * 1000000000 + (Int64)time.tv_nsec;
+    }
+
     // API for the graphic backend
     void *graphicBackendData {nullptr};
     void backendInitializeGL();
@@ -2,19 +2,24 @@
 #define LPAINTERPRIVATE_H
 
 #define LPAINTER_TRACK_UNIFORMS 1
+#define LPAINTER_READBACK_RING_SIZE 4
+#define LPAINTER_TIMER_QUERY_RING_SIZE 4
 
 #include <private/LTexturePrivate.h>
 #include <private/LOutputPrivate.h>
+#include <private/LSoftwareRenderer.h>
 #include <LOutputFramebuffer.h>
 #include <LPainter.h>
 #include <LRect.h>
 #include <GL/gl.h>
 #include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
+#include <list>
 
 using namespace Louvre;
 
 LPRIVATE_CLASS(LPainter)
-GLuint vertexShader, fragmentShader, fragmentShaderExternal, fragmentShaderScaler, fragmentShaderScalerExternal;
 
 // Square (left for vertex, right for fragment)
 GLfloat square[16] =
@@ -125,13 +130,40 @@ LOutput *output = nullptr;
 LPainter *painter;
 LFramebuffer *fb = nullptr;
 GLuint fbId = 0;
+
+// Pixman renderer (LOUVRE_RENDERER=pixman), nullptr when rendering with OpenGL ES
+LSoftwareRenderer *software = nullptr;
+
+inline void setBlendingEnabled(bool enabled)
+{
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+
+    if (software)
+        software->blendingEnabled = enabled;
+}
 GLenum textureTarget = GL_TEXTURE_2D;
 
 struct OpenGLExtensions
 {
     bool EXT_read_format_bgra;
+    bool OES_texture_npot;
+    bool EXT_disjoint_timer_query;
 } openGLExtensions;
 
+// GL_EXT_disjoint_timer_query entry points
+PFNGLGENQUERIESEXTPROC glGenQueriesEXT = nullptr;
+PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXT = nullptr;
+PFNGLBEGINQUERYEXTPROC glBeginQueryEXT = nullptr;
+PFNGLENDQUERYEXTPROC glEndQueryEXT = nullptr;
+PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXT = nullptr;
+PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vEXT = nullptr;
+
+// OpenGL ES 3.0 context (pixel buffer objects and fences)
+bool GLES3 = false;
+
 void updateExtensions();
 
 struct CPUFormats
@@ -146,6 +178,64 @@ void updateCPUFormats();
 void setupProgram();
 void setupProgramScaler();
 
+/* Asynchronous readbacks (LTexture::readPixelsAsync()). The bound framebuffer is packed into
+ * a ring of GL_PIXEL_PACK_BUFFERs and mapped once their fence signals, usually a frame later. */
+struct Readback
+{
+    GLuint pbo = 0;
+    GLsizeiptr pboSize = 0;
+    GLsync fence = nullptr;
+    LSize size;
+
+    // Used instead of the PBO when GLES3 is not available
+    UChar8 *pixels = nullptr;
+
+    // Swap the R and B channels before invoking the callback (no BGRA read support)
+    bool swizzle = false;
+    bool busy = false;
+    LTexture::ReadPixelsCallback callback;
+};
+
+Readback readbacks[LPAINTER_READBACK_RING_SIZE];
+UInt32 readbackIndex = 0;
+
+// Busy readbacks in submission order
+std::list<Readback*> pendingReadbacks;
+
+// Reads src from the bound framebuffer, format is GL_RGBA or GL_BGRA_EXT
+bool readPixelsAsync(const LRect &src, GLenum format, const LTexture::ReadPixelsCallback &callback);
+
+// Invokes the callbacks of finished readbacks, or all if wait is true
+void processReadbacks(bool wait);
+
+// Waits pending readbacks and releases the PBOs
+void finishReadbacks();
+
+// Draw calls issued since the output began its current frame (LOutput::FrameStats::drawCalls)
+UInt32 drawCalls = 0;
+
+/* GPU time of each output frame (LOutput::FrameStats::gpuTime). Results are read without
+ * blocking from a ring of GL_TIME_ELAPSED_EXT queries, usually a few frames later. */
+struct TimerQuery
+{
+    GLuint id = 0;
+    UInt64 frame = 0;
+    bool busy = false;
+};
+
+TimerQuery timerQueries[LPAINTER_TIMER_QUERY_RING_SIZE];
+UInt32 timerQueryIndex = 0;
+TimerQuery *currentTimerQuery = nullptr;
+
+void beginTimerQuery(UInt64 frame);
+void endTimerQuery();
+
+// Stores the available results in the output frame stats
+void processTimerQueries();
+
+// Ends the current query and releases all
+void finishTimerQueries();
+
 // Shader state update
 
 inline void shaderSetTransform(GLint transform)
@@ -473,6 +563,14 @@ inline void drawTexture(const LTexture *texture,
     if (alpha < 0.f)
         alpha = 0.f;
 
+    if (software)
+    {
+        shaderSetTexColorEnabled(false);
+        shaderSetAlpha(alpha);
+        software->drawTexture(texture, LRect(srcX, srcY, srcW, srcH), LRect(dstX, dstY, dstW, dstH), srcScale, alpha);
+        return;
+    }
+
     GLenum target = texture->target();
     switchTarget(target);
 
@@ -516,6 +614,15 @@ inline void drawColorTexture(const LTexture *texture,
                              Int32 dstX, Int32 dstY, Int32 dstW, Int32 dstH,
                              Float32 srcScale, Float32 alpha)
 {
+    if (software)
+    {
+        shaderSetTexColorEnabled(true);
+        shaderSetAlpha(alpha);
+        shaderSetColor(r, g, b);
+        software->drawTexture(texture, LRect(srcX, srcY, srcW, srcH), LRect(dstX, dstY, dstW, dstH), srcScale, alpha, true, {r, g, b});
+        return;
+    }
+
     GLenum target = texture->target();
     switchTarget(target);
 
@@ -557,6 +664,14 @@ inline void drawColorTexture(const LTexture *texture,
 inline void drawColor(Int32 dstX, Int32 dstY, Int32 dstW, Int32 dstH,
                       Float32 r, Float32 g, Float32 b, Float32 a)
 {
+    if (software)
+    {
+        shaderSetAlpha(a);
+        shaderSetColor(r, g, b);
+        software->drawColor(LRect(dstX, dstY, dstW, dstH), {r, g, b}, a);
+        return;
+    }
+
     switchTarget(GL_TEXTURE_2D);
     setViewport(dstX, dstY, dstW, dstH);
     shaderSetAlpha(a);
@@ -624,7 +739,7 @@ inline void scaleTexture(GLuint textureId, GLenum textureTarget, GLuint framebuf
     shaderSetSrcRect(src.x(), src.y() + src.h(), src.w(), -src.h());
     shaderSetColorFactor(1.f, 1.f, 1.f, 1.f);
     shaderSetTransform(LFramebuffer::Normal);
-    LTexture::LTexturePrivate::setTextureParams(textureId, textureTarget, GL_REPEAT, GL_REPEAT, minFilter, minFilter);
+    LTexture::LTexturePrivate::setTextureParams(textureId, textureTarget, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, minFilter, minFilter == GL_NEAREST ? GL_NEAREST : GL_LINEAR);
     glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
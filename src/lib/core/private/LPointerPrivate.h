@@ -35,6 +35,28 @@ LPRIVATE_CLASS(LPointer)
     // Cursor
     LCursorRole *lastCursorRequest = nullptr;
     bool lastCursorRequestWasHide = false;
+
+    // Motion coalescing
+    bool motionCoalescing = false;
+    bool pendingMotionFastPath = false;
+    Float64 pendingMotionX = 0.0;
+    Float64 pendingMotionY = 0.0;
+    UInt32 pendingMotionEvents = 0;
+    UInt64 pendingMotionTimeUs = 0;
+    UInt64 lastMotionFlushUs = 0;
+    UInt64 coalescedMotionEvents = 0;
+
+    // Timestamp of the motion being dispatched, 0 if unknown
+    UInt64 motionTimeUs = 0;
+
+    // Called by the input backend, fastPath = the motion was already applied by LCursor::LCursorPrivate::fastPathMove()
+    void backendMoveEvent(Float32 dx, Float32 dy, UInt64 timeUs, bool fastPath);
+    void dispatchMotion(Float32 dx, Float32 dy, UInt64 timeUs, bool fastPath);
+    void flushMotion();
+    UInt64 motionFlushPeriodUs() const;
+
+    // Milliseconds until the pending motion must be dispatched or -1 if there is none
+    Int32 motionFlushTimeout();
 };
 
 #endif // LPOINTERPRIVATE_H
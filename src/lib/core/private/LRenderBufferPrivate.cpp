@@ -1,6 +1,16 @@
 #include <private/LRenderBufferPrivate.h>
+#include <private/LCompositorPrivate.h>
 
 GLuint LRenderBuffer::LRenderBufferPrivate::getTextureId()
 {
     return threadsMap[std::this_thread::get_id()].textureId;
 }
+
+void LRenderBuffer::LRenderBufferPrivate::releaseThreadsData()
+{
+    for (auto &pair : threadsMap)
+        if (pair.second.textureId)
+            compositor()->imp()->addRenderBufferToDestroy(pair.first, pair.second);
+
+    threadsMap.clear();
+}
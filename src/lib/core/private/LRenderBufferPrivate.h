@@ -22,6 +22,9 @@ LPRIVATE_CLASS(LRenderBuffer)
     };
 
     GLuint getTextureId();
+
+    // Schedules the destruction of the GL storage of each thread (recreated lazily by id())
+    void releaseThreadsData();
     std::map<std::thread::id, ThreadData>threadsMap;
 
 };
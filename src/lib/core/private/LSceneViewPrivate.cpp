@@ -9,46 +9,81 @@
 
 using LVS = LView::LViewPrivate::LViewState;
 
-void LSceneView::LSceneViewPrivate::calcNewDamage(LView *view)
+void LSceneView::LSceneViewPrivate::updateFlatViews(LSceneView *sceneView)
+{
+    if (flat.treeSerial == LView::LViewPrivate::treeSerial)
+        return;
+
+    flat.treeSerial = LView::LViewPrivate::treeSerial;
+    flat.views.clear();
+
+    for (LView *child : sceneView->children())
+        flattenViews(child);
+
+    const size_t n { flat.views.size() };
+    flat.flags.resize(n);
+    flat.rect.resize(n);
+    flat.localRect.resize(n);
+    flat.opacity.resize(n);
+    flat.damage.resize(n);
+    flat.translucent.resize(n);
+    flat.opaque.resize(n);
+    flat.opaqueOverlay.resize(n);
+
+    // Nested scene views read the previous value before it is updated in calcNewDamage()
+    for (size_t i = 0; i < n; i++)
+    {
+        LView *view { flat.views[i] };
+        flat.flags[i] = 0;
+        flat.setFlag(i, FlatViews::ScalingEnabled,
+                     (view->scalingEnabled() || view->parentScalingEnabled()) && view->scalingVector() != LSizeF(1.f, 1.f));
+    }
+}
+
+void LSceneView::LSceneViewPrivate::flattenViews(LView *view)
+{
+    flat.views.push_back(view);
+
+    if (view->type() != Scene)
+        for (LView *child : view->children())
+            flattenViews(child);
+}
+
+void LSceneView::LSceneViewPrivate::calcNewDamage(UInt32 i)
 {
     ThreadData *oD = currentThreadData;
+    LView *view = flat.views[i];
 
-    // Children first
+    // Children were already processed (they come after it in the flattened tree)
     if (view->type() == Scene)
     {
         LSceneView *sceneView = (LSceneView*)view;
-        if (view->imp()->cache.scalingEnabled)
+        if (flat.hasFlag(i, FlatViews::ScalingEnabled))
             sceneView->render(nullptr);
         else
             sceneView->render(&oD->opaqueTransposedSum);
     }
-    else
-    {
-        for (std::list<LView*>::const_reverse_iterator it = view->children().crbegin(); it != view->children().crend(); it++)
-            calcNewDamage(*it);
-    }
-
-    // Quick view cache handle to reduce verbosity
-    LView::LViewPrivate::ViewCache *cache = &view->imp()->cache;
 
     view->imp()->removeFlag(LVS::RepaintCalled);
 
     // Quick output data handle
-    cache->voD = &view->imp()->threadsMap[std::this_thread::get_id()];
-    cache->voD->o = oD->o;
+    LView::LViewPrivate::ViewThreadData *voD = &view->imp()->threadData(currentThreadSlot);
+    voD->o = oD->o;
 
     // Cache mapped call
-    cache->mapped = view->mapped();
+    bool mapped = view->mapped();
 
     // Cache view rect
-    cache->rect.setPos(view->pos());
-    cache->rect.setSize(view->size());
+    LRect &rect = flat.rect[i];
+    rect.setPos(view->pos());
+    rect.setSize(view->size());
 
-    cache->scalingVector = view->scalingVector();
-    cache->scalingEnabled = (view->scalingEnabled() || view->parentScalingEnabled()) && cache->scalingVector != LSizeF(1.f, 1.f);
+    const LSizeF scalingVector = view->scalingVector();
+    const bool scalingEnabled = (view->scalingEnabled() || view->parentScalingEnabled()) && scalingVector != LSizeF(1.f, 1.f);
+    flat.setFlag(i, FlatViews::ScalingEnabled, scalingEnabled);
 
     LRegion vRegion;
-    vRegion.addRect(cache->rect);
+    vRegion.addRect(rect);
 
     if (view->clippingEnabled())
         vRegion.clip(view->clippingRect());
@@ -71,85 +106,94 @@ void LSceneView::LSceneViewPrivate::calcNewDamage(LView *view)
     if (!view->isRenderable())
         return;
 
-    cache->opacity = view->opacity();
+    const Float32 opacity = view->opacity();
+    flat.opacity[i] = opacity;
+
+    if (view->imp()->colorFactor.a <= 0.f || rect.size().area() == 0 || opacity <= 0.f || scalingVector.w() == 0.f || scalingVector.y() == 0.f || (view->clippingEnabled() && view->clippingRect().area() == 0))
+        mapped = false;
 
-    if (view->imp()->colorFactor.a <= 0.f || cache->rect.size().area() == 0 || cache->opacity <= 0.f || cache->scalingVector.w() == 0.f || cache->scalingVector.y() == 0.f || (view->clippingEnabled() && view->clippingRect().area() == 0))
-        cache->mapped = false;
+    flat.setFlag(i, FlatViews::Mapped, mapped);
 
-    bool mappingChanged = cache->mapped != cache->voD->prevMapped;
+    bool mappingChanged = mapped != voD->prevMapped;
 
-    if (oD->o && !mappingChanged && !cache->mapped)
+    if (oD->o && !mappingChanged && !mapped)
     {
         if (view->forceRequestNextFrameEnabled())
             view->requestNextFrame(oD->o);
         return;
     }
 
-    bool opacityChanged = cache->opacity != cache->voD->prevOpacity;
+    bool opacityChanged = opacity != voD->prevOpacity;
 
-    cache->localRect = LRect(cache->rect.pos() - fb->rect().pos(), cache->rect.size());
+    LRect &localRect = flat.localRect[i];
+    localRect = LRect(rect.pos() - fb->rect().pos(), rect.size());
 
-    bool rectChanged = cache->localRect != cache->voD->prevLocalRect;
+    bool rectChanged = localRect != voD->prevLocalRect;
 
-    bool colorFactorChanged = cache->voD->prevColorFactorEnabled != view->imp()->hasFlag(LVS::ColorFactor);
+    bool colorFactorChanged = voD->prevColorFactorEnabled != view->imp()->hasFlag(LVS::ColorFactor);
 
     if (!colorFactorChanged && view->imp()->hasFlag(LVS::ColorFactor))
     {
-        colorFactorChanged = cache->voD->prevColorFactor.r != view->imp()->colorFactor.r ||
-                              cache->voD->prevColorFactor.g != view->imp()->colorFactor.g ||
-                              cache->voD->prevColorFactor.b != view->imp()->colorFactor.b ||
-                              cache->voD->prevColorFactor.a != view->imp()->colorFactor.a;
+        colorFactorChanged = voD->prevColorFactor.r != view->imp()->colorFactor.r ||
+                              voD->prevColorFactor.g != view->imp()->colorFactor.g ||
+                              voD->prevColorFactor.b != view->imp()->colorFactor.b ||
+                              voD->prevColorFactor.a != view->imp()->colorFactor.a;
     }
 
+    LRegion &damage = flat.damage[i];
+    LRegion &translucent = flat.translucent[i];
+    LRegion &opaque = flat.opaque[i];
+
     // If rect or order changed (set current rect and prev rect as damage)
-    if (mappingChanged || rectChanged || cache->voD->changedOrder || opacityChanged || cache->scalingEnabled || colorFactorChanged)
+    if (mappingChanged || rectChanged || voD->changedOrder || opacityChanged || scalingEnabled || colorFactorChanged)
     {
-        cache->damage.addRect(cache->rect);
+        damage.clear();
+        damage.addRect(rect);
 
-        if (cache->voD->changedOrder)
-            cache->voD->changedOrder = false;
+        if (voD->changedOrder)
+            voD->changedOrder = false;
 
         if (mappingChanged)
-            cache->voD->prevMapped = cache->mapped;
+            voD->prevMapped = mapped;
 
         if (rectChanged)
         {
-            cache->voD->prevRect = cache->rect;
-            cache->voD->prevLocalRect = cache->localRect;
+            voD->prevRect = rect;
+            voD->prevLocalRect = localRect;
         }
 
         if (opacityChanged)
-            cache->voD->prevOpacity = cache->opacity;
+            voD->prevOpacity = opacity;
 
         if (colorFactorChanged)
         {
-            cache->voD->prevColorFactorEnabled = view->imp()->hasFlag(LVS::ColorFactor);
-            cache->voD->prevColorFactor = view->imp()->colorFactor;
+            voD->prevColorFactorEnabled = view->imp()->hasFlag(LVS::ColorFactor);
+            voD->prevColorFactor = view->imp()->colorFactor;
         }
 
-        if (!cache->mapped)
+        if (!mapped)
         {
-            oD->newDamage.addRegion(cache->voD->prevClipping);
+            oD->newDamage.addRegion(voD->prevClipping);
             return;
         }
     }
     else if (view->damage())
     {
-        cache->damage = *view->damage();
+        damage = *view->damage();
 
         // Scene views already have their damage transposed
         if (view->type() != Scene)
-            cache->damage.offset(cache->rect.pos());
+            damage.offset(rect.pos());
     }
     else
     {
-        cache->damage.clear();
+        damage.clear();
     }
 
     // Calculates the non clipped region
 
     LRegion currentClipping;
-    currentClipping.addRect(cache->rect);
+    currentClipping.addRect(rect);
 
     if (view->parentClippingEnabled())
         parentClipping(view->parent(), &currentClipping);
@@ -159,95 +203,91 @@ void LSceneView::LSceneViewPrivate::calcNewDamage(LView *view)
 
     // Calculates the new exposed view region if parent clipping or clipped region has grown
     LRegion newExposedClipping = currentClipping;
-    newExposedClipping.subtractRegion(cache->voD->prevClipping);
-    cache->damage.addRegion(newExposedClipping);
+    newExposedClipping.subtractRegion(voD->prevClipping);
+    damage.addRegion(newExposedClipping);
 
     // Add exposed now non clipped region to new output damage
-    cache->voD->prevClipping.subtractRegion(currentClipping);
-    oD->newDamage.addRegion(cache->voD->prevClipping);
+    voD->prevClipping.subtractRegion(currentClipping);
+    oD->newDamage.addRegion(voD->prevClipping);
 
     // Saves current clipped region for next frame
-    cache->voD->prevClipping = currentClipping;
+    voD->prevClipping = currentClipping;
 
     // Clip current damage to current visible region
-    cache->damage.intersectRegion(currentClipping);
+    damage.intersectRegion(currentClipping);
 
     // Remove previus opaque region to view damage
-    cache->damage.subtractRegion(oD->opaqueTransposedSum);
+    damage.subtractRegion(oD->opaqueTransposedSum);
 
     // Add clipped damage to new damage
-    oD->newDamage.addRegion(cache->damage);
+    oD->newDamage.addRegion(damage);
 
-    if (cache->opacity < 1.f || cache->scalingEnabled || view->colorFactor().a < 1.f)
+    if (opacity < 1.f || scalingEnabled || view->colorFactor().a < 1.f)
     {
-        cache->translucent.clear();
-        cache->translucent.addRect(cache->rect);
-        cache->opaque.clear();
+        translucent.clear();
+        translucent.addRect(rect);
+        opaque.clear();
     }
     else
     {
         // Store tansposed traslucent region
         if (view->translucentRegion())
         {
-            cache->translucent = *view->translucentRegion();
+            translucent = *view->translucentRegion();
 
             if (view->type() != Scene)
-                cache->translucent.offset(cache->rect.pos());
+                translucent.offset(rect.pos());
         }
         else
         {
-            cache->translucent.clear();
-            cache->translucent.addRect(cache->rect);
+            translucent.clear();
+            translucent.addRect(rect);
         }
 
         // Store tansposed opaque region
         if (view->opaqueRegion())
         {
-            cache->opaque = *view->opaqueRegion();
+            opaque = *view->opaqueRegion();
 
             if (view->type() != Scene)
-                cache->opaque.offset(cache->rect.pos());
+                opaque.offset(rect.pos());
         }
         else
         {
-            cache->opaque = cache->translucent;
-            cache->opaque.inverse(cache->rect);
+            opaque = translucent;
+            opaque.inverse(rect);
         }
     }
 
     // Clip opaque and translucent regions to current visible region
-    cache->opaque.intersectRegion(currentClipping);
-    cache->translucent.intersectRegion(currentClipping);
+    opaque.intersectRegion(currentClipping);
+    translucent.intersectRegion(currentClipping);
 
     // Check if view is ocludded
     currentClipping.subtractRegion(oD->opaqueTransposedSum);
 
-    cache->occluded = currentClipping.empty();
+    const bool occluded = currentClipping.empty();
+    flat.setFlag(i, FlatViews::Occluded, occluded);
 
-    if (oD->o && (!cache->occluded || view->forceRequestNextFrameEnabled()))
+    if (oD->o && (!occluded || view->forceRequestNextFrameEnabled()))
         view->requestNextFrame(oD->o);
 
     // Store sum of previus opaque regions (this will later be clipped when painting opaque and translucent regions)
-    cache->opaqueOverlay = oD->opaqueTransposedSum;
-    oD->opaqueTransposedSum.addRegion(cache->opaque);
+    flat.opaqueOverlay[i] = oD->opaqueTransposedSum;
+    oD->opaqueTransposedSum.addRegion(opaque);
 }
 
-void LSceneView::LSceneViewPrivate::drawOpaqueDamage(LView *view)
+void LSceneView::LSceneViewPrivate::drawOpaqueDamage(UInt32 i)
 {
     ThreadData *oD = currentThreadData;
+    LView *view = flat.views[i];
 
-    // Children first
-    if (view->type() != Scene)
-        for (std::list<LView*>::const_reverse_iterator it = view->children().crbegin(); it != view->children().crend(); it++)
-            drawOpaqueDamage(*it);
-
-    LView::LViewPrivate::ViewCache *cache = &view->imp()->cache;
-
-    if (!view->isRenderable() || !cache->mapped || cache->occluded || cache->opacity < 1.f || view->imp()->colorFactor.a < 1.f)
+    if (!view->isRenderable() || !flat.hasFlag(i, FlatViews::Mapped) || flat.hasFlag(i, FlatViews::Occluded) || flat.opacity[i] < 1.f || view->imp()->colorFactor.a < 1.f)
         return;
 
-    cache->opaque.intersectRegion(oD->newDamage);
-    cache->opaque.subtractRegion(cache->opaqueOverlay);
+    LRegion &opaque = flat.opaque[i];
+    opaque.intersectRegion(oD->newDamage);
+    opaque.subtractRegion(flat.opaqueOverlay[i]);
 
     if (view->imp()->hasFlag(LVS::ColorFactor))
     {
@@ -261,7 +301,7 @@ void LSceneView::LSceneViewPrivate::drawOpaqueDamage(LView *view)
 
     oD->p->imp()->shaderSetAlpha(1.f);
     paintParams.painter = oD->p;
-    paintParams.region = &cache->opaque;
+    paintParams.region = &opaque;
     view->paintEvent(paintParams);
 }
 
@@ -278,13 +318,13 @@ void LSceneView::LSceneViewPrivate::drawBackground(bool addToOpaqueSum)
         oD->opaqueTransposedSum.addRegion(backgroundDamage);
 }
 
-void LSceneView::LSceneViewPrivate::drawTranslucentDamage(LView *view)
+void LSceneView::LSceneViewPrivate::drawTranslucentDamage(UInt32 i)
 {
     ThreadData *oD = currentThreadData;
-    LView::LViewPrivate::ViewCache *cache = &view->imp()->cache;
+    LView *view = flat.views[i];
 
-    if (!view->isRenderable() || !cache->mapped || cache->occluded)
-        goto drawChildrenOnly;
+    if (!view->isRenderable() || !flat.hasFlag(i, FlatViews::Mapped) || flat.hasFlag(i, FlatViews::Occluded))
+        return;
 
     if (view->autoBlendFuncEnabled())
     {
@@ -306,19 +346,15 @@ void LSceneView::LSceneViewPrivate::drawTranslucentDamage(LView *view)
     else
         oD->p->imp()->shaderSetColorFactorEnabled(0);
 
-    cache->occluded = true;
-    cache->translucent.intersectRegion(oD->newDamage);
-    cache->translucent.subtractRegion(cache->opaqueOverlay);
+    flat.setFlag(i, FlatViews::Occluded, true);
+    LRegion &translucent = flat.translucent[i];
+    translucent.intersectRegion(oD->newDamage);
+    translucent.subtractRegion(flat.opaqueOverlay[i]);
 
-    oD->p->imp()->shaderSetAlpha(cache->opacity);
+    oD->p->imp()->shaderSetAlpha(flat.opacity[i]);
     paintParams.painter = oD->p;
-    paintParams.region = &cache->translucent;
+    paintParams.region = &translucent;
     view->paintEvent(paintParams);
-
-    drawChildrenOnly:
-    if (view->type() != Scene)
-        for (std::list<LView*>::const_iterator it = view->children().cbegin(); it != view->children().cend(); it++)
-            drawTranslucentDamage(*it);
 }
 
 void LSceneView::LSceneViewPrivate::parentClipping(LView *parent, LRegion *region)
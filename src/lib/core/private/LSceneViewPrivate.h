@@ -1,12 +1,12 @@
 #ifndef LSCENEVIEWPRIVATE_H
 #define LSCENEVIEWPRIVATE_H
 
+#include <private/LViewPrivate.h>
 #include <LFramebuffer.h>
 #include <LSceneView.h>
 #include <LRegion.h>
 #include <LOutput.h>
-#include <map>
-#include <thread>
+#include <vector>
 
 using namespace Louvre;
 
@@ -31,8 +31,8 @@ LPRIVATE_CLASS(LSceneView)
         bool oversampling = false;
         bool fractionalScale = false;
         LRect prevRect;
-        LCompositor *c;
-        LPainter *p;
+        LCompositor *c = nullptr;
+        LPainter *p = nullptr;
         LOutput *o = nullptr;
         Int32 n, w, h;
         LBox *boxes;
@@ -44,15 +44,77 @@ LPRIVATE_CLASS(LSceneView)
     };
 
     LRGBAF clearColor = {0,0,0,0};
-    std::map<std::thread::id, ThreadData> threadsMap;
+    // Indexed by the thread slot of each output (see LCompositorPrivate::threadsData)
+    std::vector<ThreadData> threadsData;
 
     // Quck handle to current output data
     ThreadData *currentThreadData;
+    UInt32 currentThreadSlot;
 
-    void calcNewDamage(LView *view);
-    void drawOpaqueDamage(LView *view);
+    inline ThreadData &threadData(UInt32 slot)
+    {
+        if (slot >= threadsData.size())
+            threadsData.resize(slot + 1);
+
+        return threadsData[slot];
+    }
+
+    inline void removeThreadData(UInt32 slot)
+    {
+        if (slot >= threadsData.size())
+            return;
+
+        for (LRegion *region : threadsData[slot].prevDamageList)
+            delete region;
+
+        threadsData[slot] = ThreadData();
+    }
+
+    /* Children tree flattened in pre-order (nested scene views are leaves), rebuilt only when
+     * LViewPrivate::treeSerial changes. The damage and opaque passes iterate it backwards and the
+     * translucent pass forwards, which matches the order of the recursive traversal.
+     * Hot per-frame fields are stored in parallel arrays indexed like views. */
+    struct FlatViews
+    {
+        enum Flags : UInt8
+        {
+            Mapped          = 1 << 0,
+            Occluded        = 1 << 1,
+            ScalingEnabled  = 1 << 2
+        };
+
+        UInt64 treeSerial = 0;
+        std::vector<LView*> views;
+        std::vector<UInt8> flags;
+        std::vector<LRect> rect;
+        std::vector<LRect> localRect;
+        std::vector<Float32> opacity;
+        std::vector<LRegion> damage;
+        std::vector<LRegion> translucent;
+        std::vector<LRegion> opaque;
+        std::vector<LRegion> opaqueOverlay;
+
+        inline bool hasFlag(UInt32 i, UInt8 flag) const
+        {
+            return flags[i] & flag;
+        }
+
+        inline void setFlag(UInt32 i, UInt8 flag, bool enable)
+        {
+            if (enable)
+                flags[i] |= flag;
+            else
+                flags[i] &= ~flag;
+        }
+    } flat;
+
+    void updateFlatViews(LSceneView *sceneView);
+    void flattenViews(LView *view);
+
+    void calcNewDamage(UInt32 i);
+    void drawOpaqueDamage(UInt32 i);
     void drawBackground(bool addToOpaqueSum);
-    void drawTranslucentDamage(LView *view);
+    void drawTranslucentDamage(UInt32 i);
 
     void parentClipping(LView *parent, LRegion *region);
 
@@ -5,6 +5,8 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <cstring>
+#include <algorithm>
+#include <bit>
 #include <private/LCursorPrivate.h>
 
 void LSeat::LSeatPrivate::seatEnabled(libseat *seat, void *data)
@@ -32,7 +34,7 @@ void LSeat::LSeatPrivate::seatEnabled(libseat *seat, void *data)
               compositor()->imp()->events[2].data.fd,
               &compositor()->imp()->events[2]);
 
-    LLog::debug("[LSeatPrivate::seatEnabled] %s enabled.", libseat_seat_name(seat));
+    LLOG_DEBUG("[LSeatPrivate::seatEnabled] %s enabled.", libseat_seat_name(seat));
 
     for (LOutput *o : compositor()->outputs())
         o->setGamma(&o->imp()->gammaTable);
@@ -76,7 +78,7 @@ void LSeat::LSeatPrivate::seatDisabled(libseat *seat, void *data)
               compositor()->imp()->events[2].data.fd,
               NULL);
 
-    LLog::debug("[LSeatPrivate::seatDisabled] %s disabled.", libseat_seat_name(seat));
+    LLOG_DEBUG("[LSeatPrivate::seatDisabled] %s disabled.", libseat_seat_name(seat));
 
     lseat->enabledChanged();
 }
@@ -125,7 +127,7 @@ bool LSeat::LSeatPrivate::initLibseat()
     dispatchSeat();
     LCompositor::compositor()->imp()->unlock();
 
-    LLog::debug("[LSeatPrivate::initLibseat] Using libseat.");
+    LLOG_DEBUG("[LSeatPrivate::initLibseat] Using libseat.");
     return true;
 }
 
@@ -140,3 +142,19 @@ void LSeat::LSeatPrivate::backendOutputUnplugged(LOutput *output)
     if (enabled)
         seat()->outputUnplugged(output);
 }
+
+void LSeat::LSeatPrivate::recordInputLatency(UInt64 eventTimeUs, UInt64 dispatchTimeUs)
+{
+    if (eventTimeUs == 0)
+        return;
+
+    const UInt64 latency { dispatchTimeUs > eventTimeUs ? dispatchTimeUs - eventTimeUs : 0 };
+    const UInt32 bucket { latency == 0 ? 0 : std::min(63 - std::countl_zero(latency), 31) };
+
+    inputLatency.histogram[bucket]++;
+    inputLatency.count++;
+    inputLatency.totalUs += latency;
+
+    if (latency > inputLatency.maxUs)
+        inputLatency.maxUs = latency;
+}
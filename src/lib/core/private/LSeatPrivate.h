@@ -36,6 +36,11 @@ LPRIVATE_CLASS(LSeat)
 
     void *inputBackendData                          = nullptr;
 
+    InputLatency inputLatency;
+
+    // Called by input backends, timestamps in CLOCK_MONOTONIC microseconds
+    void recordInputLatency(UInt64 eventTimeUs, UInt64 dispatchTimeUs);
+
     libseat *libseatHandle                          = nullptr;
     libseat_seat_listener listener;
     bool enabled                                    = false;
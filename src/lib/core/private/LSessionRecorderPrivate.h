@@ -0,0 +1,133 @@
+#ifndef LSESSIONRECORDERPRIVATE_H
+#define LSESSIONRECORDERPRIVATE_H
+
+#include <LSessionRecorder.h>
+#include <unordered_map>
+#include <initializer_list>
+#include <stdio.h>
+#include <wayland-server.h>
+
+using namespace Louvre;
+
+/* Recording file format (native endianness, shared with the LReplay client):
+ *
+ * FileHeader
+ * RecordHeader + payload
+ * RecordHeader + payload
+ * ...
+ *
+ * Objects are identified by the client index and the protocol object id. Unless noted,
+ * payloads are arrays of Int32. */
+class Louvre::LSessionRecorder::LSessionRecorderPrivate
+{
+public:
+    static constexpr UInt32 Magic { 0x4345524C }; // "LREC"
+    static constexpr UInt32 Version { 1 };
+
+    struct FileHeader
+    {
+        UInt32 magic;
+        UInt32 version;
+    };
+
+    struct RecordHeader
+    {
+        UInt32 type;
+
+        // Payload size in bytes
+        UInt32 size;
+
+        // Microseconds since the recording started
+        UInt64 time;
+        UInt32 client;
+        UInt32 object;
+    };
+
+    enum Type : UInt32
+    {
+        ClientCreate,           // (no payload, object 0)
+        ClientDestroy,          // (no payload, object 0)
+
+        SurfaceCreate,          // wl_surface
+        SurfaceDestroy,
+        SurfaceAttach,          // buffer (0 if null), x, y
+        SurfaceDamage,          // x, y, w, h
+        SurfaceDamageBuffer,    // x, y, w, h
+        SurfaceFrame,
+        SurfaceCommit,
+        SurfaceOpaqueRegion,    // null (1/0), then x, y, w, h per rect
+        SurfaceInputRegion,     // null (1/0), then x, y, w, h per rect
+        SurfaceBufferScale,     // scale
+        SurfaceBufferTransform, // transform
+        SurfaceOffset,          // x, y
+
+        BufferCreate,           // wl_buffer: width, height, stride, format (DRM), shm (1/0)
+        BufferData,             // boxes count, then x, y, w, h per box, then the rows of each box (UChar8)
+        BufferDestroy,
+
+        SubsurfaceCreate,       // wl_subsurface: surface, parent
+        SubsurfaceDestroy,
+        SubsurfacePosition,     // x, y
+        SubsurfacePlaceAbove,   // sibling surface
+        SubsurfacePlaceBelow,   // sibling surface
+        SubsurfaceSync,
+        SubsurfaceDesync,
+
+        XdgSurfaceCreate,       // xdg_surface: surface
+        XdgSurfaceDestroy,
+        XdgSurfaceGeometry,     // x, y, w, h
+        XdgToplevelCreate,      // xdg_toplevel: xdg_surface
+        XdgToplevelDestroy,
+        XdgPopupCreate,         // xdg_popup: xdg_surface, parent xdg_surface, width, height,
+                                // anchor rect x, y, w, h, anchor, gravity, constraint adjustment, offset x, y
+        XdgPopupDestroy
+    };
+
+    /* Entries of destroyed clients are kept until the address is reused, so that the requests
+     * emitted while their resources are destroyed can be ignored */
+    struct ClientEntry
+    {
+        wl_listener destroyListener;
+        UInt32 id;
+        bool destroyed;
+    };
+
+    struct BufferEntry
+    {
+        wl_listener destroyListener;
+        UInt32 client;
+        UInt32 id;
+        Int32 width, height, stride;
+        UInt32 format;
+        bool shm;
+
+        // False until its whole content is saved
+        bool captured;
+    };
+
+    static FILE *file;
+    static Int64 startTime;
+    static UInt32 clientsCount;
+    static std::unordered_map<wl_client*, ClientEntry*> clients;
+    static std::unordered_map<wl_resource*, BufferEntry*> buffers;
+
+    // Checked by the protocol handlers before calling the methods below
+    inline static bool active()
+    {
+        return file != nullptr;
+    }
+
+    /* Returns false if the client was destroyed (or is unknown and create is false) */
+    static bool clientId(wl_client *client, bool create, UInt32 *id);
+    static void writeRecord(Type type, UInt32 client, UInt32 object, const void *payload, UInt32 size);
+    static void record(Type type, wl_resource *object, std::initializer_list<Int32> args = {});
+    static void recordRegion(Type type, wl_resource *object, wl_resource *region);
+
+    // Records the buffer if it is new or changed, then the attach request
+    static void recordAttach(wl_resource *surface, wl_resource *buffer, Int32 x, Int32 y);
+
+    // Records the damaged rects of the pending SHM buffer, then the commit request
+    static void recordCommit(LSurface *surface);
+};
+
+#endif // LSESSIONRECORDERPRIVATE_H
@@ -0,0 +1,929 @@
+#include <private/LSoftwareRenderer.h>
+#include <private/LPainterPrivate.h>
+#include <private/LTexturePrivate.h>
+#include <private/LCompositorPrivate.h>
+#include <LOutputFramebuffer.h>
+#include <LRenderBuffer.h>
+#include <LOutput.h>
+#include <LLog.h>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#if LPAINTER_TRACK_UNIFORMS != 1
+#error "LSoftwareRenderer reads the painter state tracked with LPAINTER_TRACK_UNIFORMS"
+#endif
+
+using namespace Louvre;
+
+static pixman_format_code_t pixmanFormat(UInt32 format)
+{
+    switch (format)
+    {
+    case DRM_FORMAT_ARGB8888:
+        return PIXMAN_a8r8g8b8;
+    case DRM_FORMAT_XRGB8888:
+        return PIXMAN_x8r8g8b8;
+    case DRM_FORMAT_ABGR8888:
+        return PIXMAN_a8b8g8r8;
+    case DRM_FORMAT_XBGR8888:
+        return PIXMAN_x8b8g8r8;
+    case DRM_FORMAT_RGBA8888:
+        return PIXMAN_r8g8b8a8;
+    case DRM_FORMAT_RGBX8888:
+        return PIXMAN_r8g8b8x8;
+    case DRM_FORMAT_BGRA8888:
+        return PIXMAN_b8g8r8a8;
+    case DRM_FORMAT_BGRX8888:
+        return PIXMAN_b8g8r8x8;
+    case DRM_FORMAT_ARGB2101010:
+        return PIXMAN_a2r10g10b10;
+    case DRM_FORMAT_XRGB2101010:
+        return PIXMAN_x2r10g10b10;
+    case DRM_FORMAT_ABGR2101010:
+        return PIXMAN_a2b10g10r10;
+    case DRM_FORMAT_XBGR2101010:
+        return PIXMAN_x2b10g10r10;
+    case DRM_FORMAT_RGB888:
+        return PIXMAN_r8g8b8;
+    case DRM_FORMAT_BGR888:
+        return PIXMAN_b8g8r8;
+    case DRM_FORMAT_RGB565:
+        return PIXMAN_r5g6b5;
+    case DRM_FORMAT_BGR565:
+        return PIXMAN_b5g6r5;
+    default:
+        return (pixman_format_code_t)0;
+    }
+}
+
+static inline Float32 clamp01(Float32 value)
+{
+    return value < 0.f ? 0.f : (value > 1.f ? 1.f : value);
+}
+
+static pixman_color_t premultipliedColor(Float32 r, Float32 g, Float32 b, Float32 a)
+{
+    a = clamp01(a);
+
+    return
+    {
+        .red = UInt16(clamp01(r) * a * 0xffff),
+        .green = UInt16(clamp01(g) * a * 0xffff),
+        .blue = UInt16(clamp01(b) * a * 0xffff),
+        .alpha = UInt16(a * 0xffff)
+    };
+}
+
+// Maps coords within a w x h rect to the buffer coords of the given transform (same as LRegion::transform())
+static void transformMatrix(LFramebuffer::Transform transform, double w, double h, pixman_f_transform &m)
+{
+    pixman_f_transform_init_identity(&m);
+
+    switch (transform)
+    {
+    case LFramebuffer::Normal:
+        break;
+    case LFramebuffer::Rotated90:
+        m.m[0][0] = 0; m.m[0][1] = 1; m.m[0][2] = 0;
+        m.m[1][0] = -1; m.m[1][1] = 0; m.m[1][2] = w;
+        break;
+    case LFramebuffer::Rotated180:
+        m.m[0][0] = -1; m.m[0][1] = 0; m.m[0][2] = w;
+        m.m[1][0] = 0; m.m[1][1] = -1; m.m[1][2] = h;
+        break;
+    case LFramebuffer::Rotated270:
+        m.m[0][0] = 0; m.m[0][1] = -1; m.m[0][2] = h;
+        m.m[1][0] = 1; m.m[1][1] = 0; m.m[1][2] = 0;
+        break;
+    case LFramebuffer::Flipped:
+        m.m[0][0] = -1; m.m[0][1] = 0; m.m[0][2] = w;
+        break;
+    case LFramebuffer::Flipped90:
+        m.m[0][0] = 0; m.m[0][1] = 1; m.m[0][2] = 0;
+        m.m[1][0] = 1; m.m[1][1] = 0; m.m[1][2] = 0;
+        break;
+    case LFramebuffer::Flipped180:
+        m.m[1][0] = 0; m.m[1][1] = -1; m.m[1][2] = h;
+        break;
+    case LFramebuffer::Flipped270:
+        m.m[0][0] = 0; m.m[0][1] = -1; m.m[0][2] = h;
+        m.m[1][0] = -1; m.m[1][1] = 0; m.m[1][2] = w;
+        break;
+    }
+}
+
+// Scale used to map compositor coords to framebuffer pixels (see LPainter::LPainterPrivate::setViewport())
+static Float32 framebufferScale(LFramebuffer *framebuffer)
+{
+    if (framebuffer->type() == LFramebuffer::Output)
+    {
+        const LOutput *output { ((LOutputFramebuffer*)framebuffer)->output() };
+
+        if (output->usingFractionalScale() && !output->fractionalOversamplingEnabled())
+            return output->fractionalScale();
+    }
+
+    return framebuffer->scale();
+}
+
+bool LSoftwareRenderer::enabled()
+{
+    static const bool enabled { getenvString("LOUVRE_RENDERER") == "pixman" };
+    return enabled;
+}
+
+void LSoftwareRenderer::textureSetData(LTexture *texture, const LSize &sizeB, UInt32 stride, UInt32 format, const void *pixels)
+{
+    textureDestroy(texture);
+
+    const pixman_format_code_t pixmanFmt { pixmanFormat(format) };
+
+    // Drawn from a readback instead
+    if (!pixmanFmt || sizeB.w() <= 0 || sizeB.h() <= 0)
+        return;
+
+    texture->imp()->softwareImage = pixman_image_create_bits(pixmanFmt, sizeB.w(), sizeB.h(), nullptr, 0);
+    textureUpdateRect(texture, LRect(0, sizeB), stride, pixels);
+}
+
+void LSoftwareRenderer::textureUpdateRect(LTexture *texture, const LRect &rect, UInt32 stride, const void *pixels)
+{
+    pixman_image_t *image { texture->imp()->softwareImage };
+
+    if (!image || !pixels || rect.x() < 0 || rect.y() < 0 ||
+        rect.x() + rect.w() > pixman_image_get_width(image) ||
+        rect.y() + rect.h() > pixman_image_get_height(image))
+        return;
+
+    const Int32 bytesPerPixel { PIXMAN_FORMAT_BPP(pixman_image_get_format(image)) / 8 };
+    const Int32 imageStride { pixman_image_get_stride(image) };
+    UInt8 *dst { (UInt8*)pixman_image_get_data(image) + rect.y() * imageStride + rect.x() * bytesPerPixel };
+    const UInt8 *src { (const UInt8*)pixels };
+
+    for (Int32 y = 0; y < rect.h(); y++)
+    {
+        memcpy(dst, src, rect.w() * bytesPerPixel);
+        dst += imageStride;
+        src += stride;
+    }
+}
+
+void LSoftwareRenderer::textureDestroy(LTexture *texture)
+{
+    if (texture->imp()->softwareImage)
+    {
+        pixman_image_unref(texture->imp()->softwareImage);
+        texture->imp()->softwareImage = nullptr;
+    }
+}
+
+LSoftwareRenderer::Target::Target()
+{
+    // The image itself is the CPU copy
+    upload.imp()->softwareCopy = false;
+}
+
+LSoftwareRenderer::Target::~Target()
+{
+    if (image)
+        pixman_image_unref(image);
+}
+
+LSoftwareRenderer::LSoftwareRenderer(LPainter *painter) : painter(painter)
+{
+    pixman_transform_init_identity(&textureTransform);
+    textureFilter = PIXMAN_FILTER_NEAREST;
+    textureRepeat = PIXMAN_REPEAT_NONE;
+    LLOG_DEBUG("[LSoftwareRenderer::LSoftwareRenderer] Rendering with pixman.");
+}
+
+LSoftwareRenderer::~LSoftwareRenderer()
+{
+    releaseReadbacks(true);
+}
+
+void LSoftwareRenderer::bindFramebuffer(LFramebuffer *framebuffer)
+{
+    if (!framebuffer)
+    {
+        flush();
+        current = nullptr;
+        return;
+    }
+
+    const GLuint id { framebuffer->id() };
+    const Float32 scale { framebufferScale(framebuffer) };
+    std::unique_ptr<Target> &target { targets[id] };
+
+    if (!target)
+        target.reset(new Target());
+
+    TargetFramebuffer &fb { target->framebuffer };
+
+    const bool changed { fb.m_scale != scale ||
+                         fb.m_rect != framebuffer->rect() ||
+                         fb.m_sizeB != framebuffer->sizeB() ||
+                         fb.m_transform != framebuffer->transform() };
+
+    if (current != target.get() || changed)
+        flush();
+
+    if (changed)
+    {
+        fb.m_scale = scale;
+        fb.m_rect = framebuffer->rect();
+        fb.m_sizeB = framebuffer->sizeB();
+        fb.m_transform = framebuffer->transform();
+        fb.m_id = id;
+
+        if (target->image && (pixman_image_get_width(target->image) != fb.m_sizeB.w() ||
+                              pixman_image_get_height(target->image) != fb.m_sizeB.h()))
+        {
+            pixman_image_unref(target->image);
+            target->image = nullptr;
+        }
+
+        // Cleared to transparent, the OpenGL framebuffer content is not read back
+        if (!target->image && fb.m_sizeB.w() > 0 && fb.m_sizeB.h() > 0)
+            target->image = pixman_image_create_bits(PIXMAN_a8r8g8b8, fb.m_sizeB.w(), fb.m_sizeB.h(), nullptr, 0);
+    }
+
+    current = target.get();
+    textureDirty = true;
+}
+
+void LSoftwareRenderer::bindTextureMode(const LPainter::TextureParams &params)
+{
+    textureMode = true;
+    this->params = params;
+    textureDirty = true;
+}
+
+void LSoftwareRenderer::bindColorMode()
+{
+    textureMode = false;
+}
+
+void LSoftwareRenderer::drawBoxes(const LBox *boxes, Int32 n)
+{
+    if (!current || !current->image || n <= 0)
+        return;
+
+    std::vector<pixman_box32_t> pixels;
+    pixels.reserve(n);
+
+    for (Int32 i = 0; i < n; i++)
+    {
+        pixels.emplace_back();
+
+        if (!toPixels(boxes[i], pixels.back()))
+        {
+            pixels.pop_back();
+            continue;
+        }
+
+        current->damage.addRect(LRect(boxes[i].x1, boxes[i].y1, boxes[i].x2 - boxes[i].x1, boxes[i].y2 - boxes[i].y1));
+    }
+
+    if (pixels.empty())
+        return;
+
+    const auto *state { painter->imp()->currentState };
+
+    composite(pixels.data(), pixels.size(), {
+        .texture = textureMode,
+        .customColor = state->texColorEnabled,
+        .color = {state->color.r, state->color.g, state->color.b},
+        .alpha = state->alpha
+    });
+}
+
+void LSoftwareRenderer::drawTexture(const LTexture *texture, const LRect &src, const LRect &dst, Float32 srcScale, Float32 alpha,
+                                    bool customColor, const LRGBF &color)
+{
+    if (!current || !current->image || !texture)
+        return;
+
+    const LBox box { dst.x(), dst.y(), dst.x() + dst.w(), dst.y() + dst.h() };
+    pixman_box32_t pixels;
+
+    if (!toPixels(box, pixels))
+        return;
+
+    const bool prevTextureMode { textureMode };
+    const LPainter::TextureParams prevParams { params };
+
+    bindTextureMode({
+        .texture = texture,
+        .pos = dst.pos(),
+        .srcRect = src,
+        .dstSize = dst.size(),
+        .srcTransform = LFramebuffer::Normal,
+        .srcScale = srcScale
+    });
+
+    current->damage.addRect(dst);
+
+    composite(&pixels, 1, {
+        .texture = true,
+        .customColor = customColor,
+        .color = color,
+        .alpha = alpha < 0.f ? 0.f : alpha
+    });
+
+    textureMode = prevTextureMode;
+    params = prevParams;
+    textureDirty = true;
+}
+
+void LSoftwareRenderer::drawColor(const LRect &dst, const LRGBF &color, Float32 alpha)
+{
+    if (!current || !current->image)
+        return;
+
+    const LBox box { dst.x(), dst.y(), dst.x() + dst.w(), dst.y() + dst.h() };
+    pixman_box32_t pixels;
+
+    if (!toPixels(box, pixels))
+        return;
+
+    current->damage.addRect(dst);
+
+    composite(&pixels, 1, {
+        .texture = false,
+        .customColor = false,
+        .color = color,
+        .alpha = alpha
+    });
+}
+
+void LSoftwareRenderer::clearScreen()
+{
+    if (!current || !current->image)
+        return;
+
+    const pixman_color_t color { premultipliedColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a) };
+    const pixman_box32_t box { 0, 0, pixman_image_get_width(current->image), pixman_image_get_height(current->image) };
+    pixman_image_fill_boxes(PIXMAN_OP_SRC, current->image, &color, 1, &box);
+    current->damage.addRect(current->framebuffer.m_rect);
+}
+
+void LSoftwareRenderer::flush()
+{
+    // The bound texture may be a released readback
+    releaseReadbacks(false);
+    textureDirty = true;
+
+    if (!current || !current->image || current->damage.empty())
+        return;
+
+    Target &target { *current };
+    const TargetFramebuffer &fb { target.framebuffer };
+    target.damage.clip(fb.m_rect);
+
+    const LSize size { pixman_image_get_width(target.image), pixman_image_get_height(target.image) };
+    const Int32 stride { pixman_image_get_stride(target.image) };
+    const UInt8 *data { (const UInt8*)pixman_image_get_data(target.image) };
+
+    if (!target.upload.initialized() || target.upload.sizeB() != size)
+    {
+        if (!target.upload.setDataB(size, stride, DRM_FORMAT_ARGB8888, data))
+        {
+            LLOG_ERROR("[LSoftwareRenderer::flush] Failed to upload the software framebuffer.");
+            target.damage.clear();
+            return;
+        }
+    }
+    else
+    {
+        Int32 n;
+        const LBox *boxes { target.damage.boxes(&n) };
+        pixman_box32_t pixels;
+
+        for (Int32 i = 0; i < n; i++)
+            if (toPixels(boxes[i], pixels))
+                target.upload.updateRect(LRect(pixels.x1, pixels.y1, pixels.x2 - pixels.x1, pixels.y2 - pixels.y1),
+                                         stride,
+                                         &data[pixels.y1 * stride + pixels.x1 * 4]);
+    }
+
+    LPainter::LPainterPrivate *p { painter->imp() };
+    LFramebuffer *prevFb { p->fb };
+    const GLuint prevFbId { p->fbId };
+    const auto prevState { *p->currentState };
+
+    // Draw the upload texture with the OpenGL path
+    p->software = nullptr;
+    p->fb = &target.framebuffer;
+    p->fbId = fb.m_id;
+    glBindFramebuffer(GL_FRAMEBUFFER, p->fbId);
+    glDisable(GL_BLEND);
+    p->shaderSetColorFactorEnabled(false);
+    painter->enableCustomTextureColor(false);
+    painter->setAlpha(1.f);
+    painter->bindTextureMode({
+        .texture = &target.upload,
+        .pos = fb.m_rect.pos(),
+        .srcRect = LRect(0, fb.m_rect.size()),
+        .dstSize = fb.m_rect.size(),
+        .srcTransform = fb.m_transform,
+        .srcScale = Float32(size.w()) / Float32(LFramebuffer::is90Transform(fb.m_transform) ? fb.m_rect.h() : fb.m_rect.w())
+    });
+    painter->drawRegion(target.damage);
+    glEnable(GL_BLEND);
+
+    p->shaderSetMode(prevState.mode);
+    p->shaderSetAlpha(prevState.alpha);
+    p->shaderSetTexColorEnabled(prevState.texColorEnabled);
+    p->shaderSetColorFactor(prevState.colorFactor.x, prevState.colorFactor.y, prevState.colorFactor.w, prevState.colorFactor.h);
+    p->shaderSetColorFactorEnabled(prevState.colorFactorEnabled);
+    p->fb = prevFb;
+    p->fbId = prevFbId;
+    glBindFramebuffer(GL_FRAMEBUFFER, p->fbId);
+    p->software = this;
+    target.damage.clear();
+}
+
+void LSoftwareRenderer::removeTarget(GLuint framebufferId)
+{
+    auto it { targets.find(framebufferId) };
+
+    if (it == targets.end())
+        return;
+
+    if (current == it->second.get())
+        current = nullptr;
+
+    targets.erase(it);
+}
+
+pixman_image_t *LSoftwareRenderer::sourceImage(const LTexture *texture)
+{
+    if (texture->imp()->softwareImage)
+        return texture->imp()->softwareImage;
+
+    // Render buffers drawn by this renderer
+    if (texture->sourceType() == LTexture::Framebuffer && texture->imp()->graphicBackendData)
+    {
+        const LRenderBuffer *renderBuffer { (const LRenderBuffer*)texture->imp()->graphicBackendData };
+        auto it { targets.find(renderBuffer->id()) };
+
+        if (it != targets.end() && it->second->image && it->second.get() != current)
+            return it->second->image;
+    }
+
+    auto it { readbacks.find(texture) };
+
+    if (it != readbacks.end())
+    {
+        if (it->second.serial == texture->imp()->serial)
+            return it->second.image;
+
+        if (it->second.image)
+            pixman_image_unref(it->second.image);
+
+        readbacks.erase(it);
+    }
+
+    pixman_image_t *image { readback(texture) };
+
+    readbacks[texture] =
+    {
+        .serial = texture->imp()->serial,
+        .persistent = texture->sourceType() == LTexture::DMA || texture->sourceType() == LTexture::WL_DRM,
+        .image = image
+    };
+
+    if (!image)
+    {
+        static bool warned { false };
+
+        if (!warned)
+        {
+            LLOG_WARNING("[LSoftwareRenderer::sourceImage] Failed to read back a texture, textures that can not be attached to a framebuffer (e.g. external OES) are not drawn.");
+            warned = true;
+        }
+    }
+
+    return image;
+}
+
+void LSoftwareRenderer::releaseReadbacks(bool all)
+{
+    if (readbacks.empty())
+        return;
+
+    const auto &textures { LCompositor::compositor()->imp()->textures };
+
+    for (auto it = readbacks.begin(); it != readbacks.end();)
+    {
+        // Destroyed textures are not dereferenced, a new one at the same address has a different serial
+        if (!all && it->second.persistent &&
+            std::find(textures.begin(), textures.end(), it->first) != textures.end() &&
+            it->first->imp()->serial == it->second.serial)
+        {
+            it++;
+            continue;
+        }
+
+        if (it->second.image)
+            pixman_image_unref(it->second.image);
+
+        it = readbacks.erase(it);
+    }
+}
+
+pixman_image_t *LSoftwareRenderer::readback(const LTexture *texture)
+{
+    const LSize &size { texture->sizeB() };
+
+    if (!texture->initialized() || size.w() <= 0 || size.h() <= 0 || texture->target() != GL_TEXTURE_2D)
+        return nullptr;
+
+    GLuint framebuffer { 0 };
+    glGenFramebuffers(1, &framebuffer);
+
+    if (!framebuffer)
+        return nullptr;
+
+    pixman_image_t *image { nullptr };
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->id(painter->imp()->output), 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+    {
+        // GL_RGBA bytes are PIXMAN_a8b8g8r8 in little-endian, rows are tightly packed (stride = width * 4)
+        image = pixman_image_create_bits(PIXMAN_a8b8g8r8, size.w(), size.h(), nullptr, 0);
+
+        if (image)
+        {
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glReadPixels(0, 0, size.w(), size.h(), GL_RGBA, GL_UNSIGNED_BYTE, pixman_image_get_data(image));
+        }
+    }
+
+    glDeleteFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, painter->imp()->fbId);
+    return image;
+}
+
+bool LSoftwareRenderer::updateTextureTransform()
+{
+    if (!textureDirty)
+        return textureImage != nullptr;
+
+    textureDirty = false;
+    textureImage = nullptr;
+
+    if (!params.texture || !current || params.srcScale <= 0.f || params.dstSize.w() <= 0 || params.dstSize.h() <= 0)
+        return false;
+
+    textureImage = sourceImage(params.texture);
+
+    if (!textureImage)
+        return false;
+
+    const TargetFramebuffer &fb { current->framebuffer };
+    const double srcScale { params.srcScale };
+    const double texW { double(params.texture->sizeB().w()) / srcScale };
+    const double texH { double(params.texture->sizeB().h()) / srcScale };
+    const bool srcRotated { LFramebuffer::is90Transform(params.srcTransform) };
+    const double kx { (params.srcRect.w() <= 0.f ? 0.001 : params.srcRect.w()) / double(params.dstSize.w()) };
+    const double ky { (params.srcRect.h() <= 0.f ? 0.001 : params.srcRect.h()) / double(params.dstSize.h()) };
+
+    // Logical framebuffer pixels to surface coords of the transformed texture
+    pixman_f_transform logicalToSrc;
+    pixman_f_transform_init_identity(&logicalToSrc);
+    logicalToSrc.m[0][0] = kx / fb.m_scale;
+    logicalToSrc.m[0][2] = params.srcRect.x() + (fb.m_rect.x() - params.pos.x()) * kx;
+    logicalToSrc.m[1][1] = ky / fb.m_scale;
+    logicalToSrc.m[1][2] = params.srcRect.y() + (fb.m_rect.y() - params.pos.y()) * ky;
+
+    // Transformed texture to buffer texels
+    pixman_f_transform srcToTexels, scale;
+    transformMatrix(params.srcTransform, srcRotated ? texH : texW, srcRotated ? texW : texH, srcToTexels);
+    pixman_f_transform_init_scale(&scale, srcScale, srcScale);
+    pixman_f_transform_multiply(&srcToTexels, &scale, &srcToTexels);
+
+    // Framebuffer pixels to logical framebuffer pixels
+    const bool fbRotated { LFramebuffer::is90Transform(fb.m_transform) };
+    pixman_f_transform logicalToFb, fbToLogical;
+    transformMatrix(fb.m_transform,
+                    fbRotated ? fb.m_sizeB.h() : fb.m_sizeB.w(),
+                    fbRotated ? fb.m_sizeB.w() : fb.m_sizeB.h(),
+                    logicalToFb);
+    pixman_f_transform_invert(&fbToLogical, &logicalToFb);
+
+    pixman_f_transform m;
+    pixman_f_transform_multiply(&m, &logicalToSrc, &fbToLogical);
+    pixman_f_transform_multiply(&m, &srcToTexels, &m);
+
+    /* When each pixel maps exactly to a texel there is nothing to interpolate, which also lets pixman
+     * use its fast copy paths */
+    bool exact { true };
+
+    for (Int32 row = 0; row < 2 && exact; row++)
+    {
+        for (Int32 col = 0; col < 2; col++)
+        {
+            const double v { fabs(m.m[row][col]) };
+
+            if (v > 1e-6 && fabs(v - 1.0) > 1e-6)
+            {
+                exact = false;
+                break;
+            }
+        }
+
+        if (fabs(m.m[row][2] - round(m.m[row][2])) > 1e-3)
+            exact = false;
+    }
+
+    if (exact)
+    {
+        for (Int32 row = 0; row < 2; row++)
+            for (Int32 col = 0; col < 3; col++)
+                m.m[row][col] = round(m.m[row][col]);
+
+        textureFilter = PIXMAN_FILTER_NEAREST;
+        textureRepeat = PIXMAN_REPEAT_NONE;
+    }
+    else
+    {
+        // Same as GL_LINEAR and GL_CLAMP_TO_EDGE
+        textureFilter = PIXMAN_FILTER_BILINEAR;
+        textureRepeat = PIXMAN_REPEAT_PAD;
+    }
+
+    if (!pixman_transform_from_pixman_f_transform(&textureTransform, &m))
+    {
+        textureImage = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool LSoftwareRenderer::toPixels(const LBox &box, pixman_box32_t &pixels) const
+{
+    const TargetFramebuffer &fb { current->framebuffer };
+    const bool rotated { LFramebuffer::is90Transform(fb.m_transform) };
+    const Int32 w { rotated ? fb.m_sizeB.h() : fb.m_sizeB.w() };
+    const Int32 h { rotated ? fb.m_sizeB.w() : fb.m_sizeB.h() };
+
+    // Same rounding as the OpenGL viewport
+    Int32 x1 = floorf(Float32(box.x1 - fb.m_rect.x()) * fb.m_scale);
+    Int32 y1 = floorf(Float32(box.y1 - fb.m_rect.y()) * fb.m_scale);
+    Int32 x2 = floorf(Float32(box.x2 - fb.m_rect.x()) * fb.m_scale);
+    Int32 y2 = floorf(Float32(box.y2 - fb.m_rect.y()) * fb.m_scale);
+
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 > w) x2 = w;
+    if (y2 > h) y2 = h;
+
+    if (x1 >= x2 || y1 >= y2)
+        return false;
+
+    switch (fb.m_transform)
+    {
+    case LFramebuffer::Normal:
+        pixels = {x1, y1, x2, y2};
+        break;
+    case LFramebuffer::Rotated90:
+        pixels = {y1, w - x2, y2, w - x1};
+        break;
+    case LFramebuffer::Rotated180:
+        pixels = {w - x2, h - y2, w - x1, h - y1};
+        break;
+    case LFramebuffer::Rotated270:
+        pixels = {h - y2, x1, h - y1, x2};
+        break;
+    case LFramebuffer::Flipped:
+        pixels = {w - x2, y1, w - x1, y2};
+        break;
+    case LFramebuffer::Flipped90:
+        pixels = {y1, x1, y2, x2};
+        break;
+    case LFramebuffer::Flipped180:
+        pixels = {x1, h - y2, x2, h - y1};
+        break;
+    case LFramebuffer::Flipped270:
+        pixels = {h - y2, w - x2, h - y1, w - x1};
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+// Pixman images are premultiplied, the OpenGL path treats texture colors as straight alpha
+static void premultiply(pixman_image_t *image)
+{
+    const Int32 w { pixman_image_get_width(image) };
+    const Int32 h { pixman_image_get_height(image) };
+    const Int32 stride { pixman_image_get_stride(image) / 4 };
+    UInt32 *row { pixman_image_get_data(image) };
+
+    for (Int32 y = 0; y < h; y++, row += stride)
+    {
+        for (Int32 x = 0; x < w; x++)
+        {
+            const UInt32 p { row[x] };
+            const UInt32 a { p >> 24 };
+
+            if (a == 255)
+                continue;
+
+            const UInt32 r { (((p >> 16) & 0xFF) * a + 127) / 255 };
+            const UInt32 g { (((p >> 8) & 0xFF) * a + 127) / 255 };
+            const UInt32 b { ((p & 0xFF) * a + 127) / 255 };
+            row[x] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+}
+
+void LSoftwareRenderer::blendBox(pixman_image_t *src, pixman_image_t *mask, Int32 srcX, Int32 srcY, const pixman_box32_t &box)
+{
+    pixman_image_t *dst { current->image };
+    const Int32 w { box.x2 - box.x1 };
+    const Int32 h { box.y2 - box.y1 };
+    pixman_image_t *product { nullptr };
+
+    /* LSceneView blends the alpha of render buffers with GL_ONE, GL_ONE (sa + da), PIXMAN_OP_OVER
+     * gives sa + da * (1 - sa), so sa * da is added afterwards */
+    if (current->framebuffer.m_id != 0)
+    {
+        product = pixman_image_create_bits(PIXMAN_a8, w, h, nullptr, 0);
+
+        if (product)
+        {
+            pixman_image_composite32(PIXMAN_OP_SRC, dst, nullptr, product, box.x1, box.y1, 0, 0, 0, 0, w, h);
+            pixman_image_composite32(PIXMAN_OP_IN, src, mask, product, srcX, srcY, srcX, srcY, 0, 0, w, h);
+        }
+    }
+
+    pixman_image_composite32(PIXMAN_OP_OVER, src, mask, dst, srcX, srcY, srcX, srcY, box.x1, box.y1, w, h);
+
+    if (product)
+    {
+        static const pixman_color_t black { 0, 0, 0, 0xffff };
+        pixman_image_t *solid { pixman_image_create_solid_fill(&black) };
+        pixman_image_composite32(PIXMAN_OP_ADD, solid, product, dst, 0, 0, 0, 0, box.x1, box.y1, w, h);
+        pixman_image_unref(solid);
+        pixman_image_unref(product);
+    }
+}
+
+/* Produces the same results as the OpenGL path: the color is blended with GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA
+ * from straight alpha sources, so textures are premultiplied by their alpha before PIXMAN_OP_OVER */
+void LSoftwareRenderer::composite(const pixman_box32_t *boxes, Int32 n, const Paint &paint)
+{
+    const auto *state { painter->imp()->currentState };
+    Float32 fr { 1.f }, fg { 1.f }, fb { 1.f }, fa { 1.f };
+
+    if (state->colorFactorEnabled)
+    {
+        fr = clamp01(state->colorFactor.x);
+        fg = clamp01(state->colorFactor.y);
+        fb = clamp01(state->colorFactor.w);
+        fa = clamp01(state->colorFactor.h);
+    }
+
+    const Float32 opacity { clamp01(paint.alpha * fa) };
+    pixman_image_t *dst { current->image };
+
+    if (!paint.texture)
+    {
+        // Without blending the color is written as is, like glDisable(GL_BLEND)
+        if (!blendingEnabled)
+        {
+            const pixman_color_t color
+            {
+                .red = UInt16(clamp01(paint.color.r * fr) * 0xffff),
+                .green = UInt16(clamp01(paint.color.g * fg) * 0xffff),
+                .blue = UInt16(clamp01(paint.color.b * fb) * 0xffff),
+                .alpha = UInt16(opacity * 0xffff)
+            };
+
+            pixman_image_fill_boxes(PIXMAN_OP_SRC, dst, &color, n, boxes);
+            return;
+        }
+
+        const pixman_color_t color { premultipliedColor(paint.color.r * fr, paint.color.g * fg, paint.color.b * fb, opacity) };
+
+        if (current->framebuffer.m_id == 0)
+        {
+            pixman_image_fill_boxes(PIXMAN_OP_OVER, dst, &color, n, boxes);
+            return;
+        }
+
+        pixman_image_t *solid { pixman_image_create_solid_fill(&color) };
+
+        for (Int32 i = 0; i < n; i++)
+            blendBox(solid, nullptr, 0, 0, boxes[i]);
+
+        pixman_image_unref(solid);
+        return;
+    }
+
+    if (!updateTextureTransform())
+        return;
+
+    pixman_image_set_transform(textureImage, &textureTransform);
+    pixman_image_set_filter(textureImage, textureFilter, nullptr, 0);
+    pixman_image_set_repeat(textureImage, textureRepeat);
+
+    if (paint.customColor)
+    {
+        // The texture only provides the alpha channel
+        const pixman_color_t color { premultipliedColor(paint.color.r * fr, paint.color.g * fg, paint.color.b * fb, opacity) };
+        pixman_image_t *solid { pixman_image_create_solid_fill(&color) };
+
+        for (Int32 i = 0; i < n; i++)
+        {
+            if (blendingEnabled)
+                blendBox(solid, textureImage, boxes[i].x1, boxes[i].y1, boxes[i]);
+            else
+                pixman_image_composite32(PIXMAN_OP_SRC, solid, textureImage, dst,
+                                         boxes[i].x1, boxes[i].y1,
+                                         boxes[i].x1, boxes[i].y1,
+                                         boxes[i].x1, boxes[i].y1,
+                                         boxes[i].x2 - boxes[i].x1, boxes[i].y2 - boxes[i].y1);
+        }
+
+        pixman_image_unref(solid);
+        return;
+    }
+
+    const bool tinted { fr != 1.f || fg != 1.f || fb != 1.f };
+    const bool opaque { PIXMAN_FORMAT_A(pixman_image_get_format(textureImage)) == 0 && opacity >= 1.f };
+
+    // Opaque sources need neither premultiplication nor alpha accumulation
+    if (!tinted && (opaque || !blendingEnabled) && opacity >= 1.f)
+    {
+        const pixman_op_t op { blendingEnabled ? PIXMAN_OP_OVER : PIXMAN_OP_SRC };
+
+        for (Int32 i = 0; i < n; i++)
+            pixman_image_composite32(op, textureImage, nullptr, dst,
+                                     boxes[i].x1, boxes[i].y1,
+                                     0, 0,
+                                     boxes[i].x1, boxes[i].y1,
+                                     boxes[i].x2 - boxes[i].x1, boxes[i].y2 - boxes[i].y1);
+        return;
+    }
+
+    /* Straight source color (rgb * factor, a * factor.a * alpha), the component alpha mask
+     * multiplies each channel by its own factor */
+    pixman_image_t *mask { nullptr };
+
+    if (tinted || opacity < 1.f)
+    {
+        const pixman_color_t factor
+        {
+            .red = UInt16(fr * 0xffff),
+            .green = UInt16(fg * 0xffff),
+            .blue = UInt16(fb * 0xffff),
+            .alpha = UInt16(opacity * 0xffff)
+        };
+
+        mask = pixman_image_create_solid_fill(&factor);
+        pixman_image_set_component_alpha(mask, true);
+    }
+
+    for (Int32 i = 0; i < n; i++)
+    {
+        const Int32 w { boxes[i].x2 - boxes[i].x1 };
+        const Int32 h { boxes[i].y2 - boxes[i].y1 };
+        pixman_image_t *tmp { pixman_image_create_bits(PIXMAN_a8r8g8b8, w, h, nullptr, 0) };
+
+        if (!tmp)
+            continue;
+
+        pixman_image_composite32(PIXMAN_OP_SRC, textureImage, mask, tmp,
+                                 boxes[i].x1, boxes[i].y1,
+                                 0, 0,
+                                 0, 0,
+                                 w, h);
+
+        if (blendingEnabled)
+        {
+            premultiply(tmp);
+            blendBox(tmp, nullptr, 0, 0, boxes[i]);
+        }
+        else
+            pixman_image_composite32(PIXMAN_OP_SRC, tmp, nullptr, dst,
+                                     0, 0,
+                                     0, 0,
+                                     boxes[i].x1, boxes[i].y1,
+                                     w, h);
+
+        pixman_image_unref(tmp);
+    }
+
+    if (mask)
+        pixman_image_unref(mask);
+}
@@ -0,0 +1,147 @@
+#ifndef LSOFTWARERENDERER_H
+#define LSOFTWARERENDERER_H
+
+#include <LFramebuffer.h>
+#include <LPainter.h>
+#include <LTexture.h>
+#include <LRegion.h>
+#include <pixman.h>
+#include <unordered_map>
+#include <memory>
+
+/* Pixman renderer used by LPainter instead of OpenGL ES when LOUVRE_RENDERER=pixman.
+ *
+ * Each framebuffer bound to the painter gets a CPU shadow image with the same size and orientation
+ * as its OpenGL framebuffer. Region fills and texture draws are composited into the shadow with pixman,
+ * and only the pixels touched are uploaded to the OpenGL framebuffer when another one is bound or the
+ * output frame ends, so the damage tracking of LScene still limits the work to the damaged regions.
+ *
+ * Textures created from CPU buffers (wl_shm, LTexture::setDataB()) keep a copy of their pixels. Client
+ * DMA and wl_drm textures are read back from OpenGL once per content change (LTexturePrivate::serial),
+ * native textures and render buffers not drawn by this renderer once per flush.
+ *
+ * It only replaces the composition: the result is still presented through the OpenGL framebuffers of the
+ * graphic backend, which has no CPU presentation path. */
+namespace Louvre
+{
+    class LSoftwareRenderer;
+}
+
+class Louvre::LSoftwareRenderer
+{
+public:
+    static bool enabled();
+
+    // CPU copies of textures, called from LTexture
+    static void textureSetData(LTexture *texture, const LSize &sizeB, UInt32 stride, UInt32 format, const void *pixels);
+    static void textureUpdateRect(LTexture *texture, const LRect &rect, UInt32 stride, const void *pixels);
+    static void textureDestroy(LTexture *texture);
+
+    LSoftwareRenderer(LPainter *painter);
+    ~LSoftwareRenderer();
+
+    // Called from LPainter, the state set with setAlpha(), setColor(), setColorFactor(), etc is read from the painter
+    void bindFramebuffer(LFramebuffer *framebuffer);
+    void bindTextureMode(const LPainter::TextureParams &params);
+    void bindColorMode();
+    void drawBoxes(const LBox *boxes, Int32 n);
+    void drawTexture(const LTexture *texture, const LRect &src, const LRect &dst, Float32 srcScale, Float32 alpha,
+                     bool customColor = false, const LRGBF &color = {0.f, 0.f, 0.f});
+    void drawColor(const LRect &dst, const LRGBF &color, Float32 alpha);
+    void clearScreen();
+
+    LRGBAF clearColor { 0.f, 0.f, 0.f, 0.f };
+
+    // Disabled blending replaces the destination pixels (PIXMAN_OP_SRC), custom blend functions are not emulated
+    bool blendingEnabled { true };
+
+    // Uploads the pixels drawn since the last flush to the bound OpenGL framebuffer
+    void flush();
+
+    // Releases the shadow of an OpenGL framebuffer about to be destroyed
+    void removeTarget(GLuint framebufferId);
+
+private:
+    // Snapshot of a bound framebuffer, its parameters may change before it is flushed (e.g. LOutput fractional oversampling)
+    class TargetFramebuffer final : public LFramebuffer
+    {
+    public:
+        TargetFramebuffer() { m_type = Render; }
+        Float32 scale() const override { return m_scale; }
+        const LSize &sizeB() const override { return m_sizeB; }
+        const LRect &rect() const override { return m_rect; }
+        GLuint id() const override { return m_id; }
+        Int32 buffersCount() const override { return 1; }
+        Int32 currentBufferIndex() const override { return 0; }
+        const LTexture *texture(Int32 index = 0) const override { L_UNUSED(index); return nullptr; }
+        void setFramebufferDamage(const LRegion *damage) override { L_UNUSED(damage); }
+        Transform transform() const override { return m_transform; }
+
+        Float32 m_scale { 0.f };
+        LSize m_sizeB;
+        LRect m_rect;
+        GLuint m_id { 0 };
+        Transform m_transform { Normal };
+    };
+
+    struct Target
+    {
+        Target();
+        ~Target();
+        TargetFramebuffer framebuffer;
+        pixman_image_t *image { nullptr };
+
+        // Copy of the image in the OpenGL context, drawn into the framebuffer when flushed
+        LTexture upload;
+
+        // Drawn since the last flush, in compositor coordinates
+        LRegion damage;
+    };
+
+    struct Paint
+    {
+        bool texture;
+        bool customColor;
+        LRGBF color;
+        Float32 alpha;
+    };
+
+    LPainter *painter;
+    std::unordered_map<GLuint, std::unique_ptr<Target>> targets;
+    Target *current { nullptr };
+
+    // Texture mode
+    bool textureMode { false };
+    LPainter::TextureParams params;
+    pixman_image_t *textureImage { nullptr };
+    pixman_transform_t textureTransform;
+    pixman_filter_t textureFilter;
+    pixman_repeat_t textureRepeat;
+    bool textureDirty { false };
+
+    struct Readback
+    {
+        // LTexturePrivate::serial when read back, textures are unique by pointer and serial
+        UInt32 serial;
+
+        // Kept across flushes, only for textures whose content changes also change their serial
+        bool persistent;
+
+        // nullptr if failed, so it is not retried for each box
+        pixman_image_t *image;
+    };
+
+    std::unordered_map<const LTexture*, Readback> readbacks;
+    void releaseReadbacks(bool all);
+
+    pixman_image_t *sourceImage(const LTexture *texture);
+    pixman_image_t *readback(const LTexture *texture);
+    bool updateTextureTransform();
+    bool toPixels(const LBox &box, pixman_box32_t &pixels) const;
+    void composite(const pixman_box32_t *boxes, Int32 n, const Paint &paint);
+
+    // PIXMAN_OP_OVER of a premultiplied source, accumulating alpha on render buffers like LSceneView
+    void blendBox(pixman_image_t *src, pixman_image_t *mask, Int32 srcX, Int32 srcY, const pixman_box32_t &box);
+};
+
+#endif // LSOFTWARERENDERER_H
@@ -9,6 +9,8 @@
 #include <private/LTexturePrivate.h>
 #include <private/LOutputPrivate.h>
 #include <private/LKeyboardPrivate.h>
+#include <private/LTracePrivate.h>
+#include <private/LUDMABufImporter.h>
 #include <LOutputMode.h>
 #include <LClient.h>
 #include <LTime.h>
@@ -140,6 +142,8 @@ void LSurface::LSurfacePrivate::applyPendingChildren()
 
 bool LSurface::LSurfacePrivate::bufferToTexture()
 {
+    LTRACE_SCOPE("bufferToTexture");
+
     // Only for wl_drm case
     GLint format;
 
@@ -166,8 +170,37 @@ bool LSurface::LSurfacePrivate::bufferToTexture()
         changesToNotify.add(BufferScaleChanged);
     }
 
+    // SHM imported with udmabuf
+    if (LTexture *udmabufTexture = LUDMABufImporter::enabled() ? LUDMABufImporter::texture(current.buffer) : nullptr)
+    {
+        widthB = udmabufTexture->sizeB().w();
+        heightB = udmabufTexture->sizeB().h();
+
+        if (!updateDimensions(widthB, heightB))
+            return false;
+
+        updateDamage();
+
+        if (texture && texture != textureBackup && texture != udmabufTexture && texture->imp()->pendingDelete)
+            delete texture;
+
+        texture = udmabufTexture;
+
+        /* The texture samples the client memory directly, so its content changes on every commit
+         * (the shm path bumps it through setDataB() and updateRect()) */
+        texture->imp()->serial = LTime::nextSerial();
+
+        // The client must not write into it while it's being sampled
+        holdBuffer(current.buffer);
+        pendingDamageB.clear();
+        pendingDamage.clear();
+        damageId = LTime::nextSerial();
+        stateFlags.add(Damaged | BufferReleased);
+        return true;
+    }
+
     // SHM
-    if (wl_shm_buffer_get(current.buffer))
+    else if (wl_shm_buffer_get(current.buffer))
     {
         if (texture && texture != textureBackup && texture->imp()->pendingDelete)
             delete texture;
@@ -304,6 +337,7 @@ bool LSurface::LSurfacePrivate::bufferToTexture()
         else
         {
             wl_shm_buffer_end_access(shm_buffer);
+            holdBuffer(nullptr);
             return true;
         }
 
@@ -347,22 +381,53 @@ bool LSurface::LSurfacePrivate::bufferToTexture()
             delete texture;
 
         texture = dmaBuffer->texture();
+
+        // The client draws into the same planes, each commit is new content
+        texture->imp()->serial = LTime::nextSerial();
     }
     else
     {
-        LLog::error("[LSurfacePrivate::bufferToTexture] Unknown buffer type. Killing client.");
+        LLOG_ERROR("[LSurfacePrivate::bufferToTexture] Unknown buffer type. Killing client.");
         wl_client_destroy(surfaceResource->client()->client());
         return false;
     }
 
     pendingDamageB.clear();
     pendingDamage.clear();
+    holdBuffer(nullptr);
     wl_buffer_send_release(current.buffer);
     damageId = LTime::nextSerial();
     stateFlags.add(Damaged | BufferReleased);
     return true;
 }
 
+static void onHeldBufferDestroy(wl_listener *listener, void *)
+{
+    LSurface::LSurfacePrivate *imp { wl_container_of(listener, imp, heldBufferDestroyListener) };
+    wl_list_remove(&listener->link);
+    imp->heldBuffer = nullptr;
+}
+
+void LSurface::LSurfacePrivate::holdBuffer(wl_resource *buffer)
+{
+    if (heldBuffer == buffer)
+        return;
+
+    if (heldBuffer)
+    {
+        wl_list_remove(&heldBufferDestroyListener.link);
+        wl_buffer_send_release(heldBuffer);
+    }
+
+    heldBuffer = buffer;
+
+    if (heldBuffer)
+    {
+        heldBufferDestroyListener.notify = &onHeldBufferDestroy;
+        wl_resource_add_destroy_listener(heldBuffer, &heldBufferDestroyListener);
+    }
+}
+
 void LSurface::LSurfacePrivate::sendPresentationFeedback(LOutput *output)
 {
     if (wpPresentationFeedbackResources.empty())
@@ -86,6 +86,10 @@ LPRIVATE_CLASS(LSurface)
     LSurfaceView *lastPointerEventView      { nullptr };
 
     LTexture *textureBackup;
+
+    // SHM buffer sampled in place (see LUDMABufImporter), released when replaced
+    wl_resource *heldBuffer                 { nullptr };
+    wl_listener heldBufferDestroyListener;
     LSurface *parent                        { nullptr };
     LSurface *pendingParent                 { nullptr };
     std::vector<LSurfaceView*> views;
@@ -111,6 +115,7 @@ LPRIVATE_CLASS(LSurface)
     void applyPendingRole();
     void applyPendingChildren();
     bool bufferToTexture();
+    void holdBuffer(wl_resource *buffer);
     void notifyPosUpdateToChildren(LSurface *surface);
     void sendPreferredScale();
     bool isInChildrenOrPendingChildren(LSurface *child);
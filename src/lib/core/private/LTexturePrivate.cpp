@@ -2,6 +2,8 @@
 #include <private/LCompositorPrivate.h>
 #include <private/LCursorPrivate.h>
 #include <private/LOutputPrivate.h>
+#include <private/LSoftwareRenderer.h>
+#include <LTime.h>
 
 void LTexture::LTexturePrivate::deleteTexture()
 {
@@ -13,7 +15,8 @@ void LTexture::LTexturePrivate::deleteTexture()
             cursor()->useDefault();
     }
 
-    serial++;
+    serial = LTime::nextSerial();
+    LSoftwareRenderer::textureDestroy(texture);
 
     if (texture->sourceType() == Framebuffer)
         return;
@@ -4,6 +4,7 @@
 #include <GL/gl.h>
 #include <LTexture.h>
 #include <LSize.h>
+#include <pixman.h>
 
 using namespace Louvre;
 
@@ -16,7 +17,8 @@ LPRIVATE_CLASS(LTexture)
     UInt32 format                                       = 0;
     void *graphicBackendData                            = nullptr;
 
-    // Increases each time the texture is modified
+    /* Unique across all textures and updated each time the texture is modified, so a (texture, serial) pair
+     * never matches a texture later allocated at the same address */
     UInt32 serial                                       = 0;
     bool pendingDelete = false;
 
@@ -28,6 +30,12 @@ LPRIVATE_CLASS(LTexture)
     GLenum nativeTarget = 0;
     LOutput *nativeOutput = nullptr;
 
+    // CPU copy drawn by the pixman renderer (LOUVRE_RENDERER=pixman)
+    pixman_image_t *softwareImage = nullptr;
+
+    // False for the upload textures of the pixman renderer, which are also excluded from LOutput::FrameStats::textureUploads
+    bool softwareCopy = true;
+
     // Utility functions    
     inline bool setDataB(GLuint textureId, GLenum target, UInt32 format, const LSize &size, LOutput *output)
     {
@@ -1,3 +1,185 @@
 #include <private/LTimerPrivate.h>
+#include <private/LCompositorPrivate.h>
+#include <bit>
+#include <time.h>
 
+static inline void pushFront(LTimer::LTimerPrivate **list, LTimer::LTimerPrivate *timer)
+{
+    timer->list = list;
+    timer->prev = nullptr;
+    timer->next = *list;
 
+    if (*list)
+        (*list)->prev = timer;
+
+    *list = timer;
+}
+
+void LTimer::LTimerPrivate::Wheel::insert(LTimerPrivate *timer, UInt64 expires)
+{
+    if (timer->list)
+        remove(timer);
+
+    if (expires < current)
+        expires = current;
+
+    const UInt64 maxDelta { (1ULL << (LTIMER_WHEEL_SLOTS_BITS * LTIMER_WHEEL_LEVELS)) - 1 };
+
+    if (expires - current > maxDelta)
+        expires = current + maxDelta;
+
+    const UInt64 delta { expires - current };
+    UInt8 level { 0 };
+
+    while (level < LTIMER_WHEEL_LEVELS - 1 && delta >= (1ULL << (LTIMER_WHEEL_SLOTS_BITS * (level + 1))))
+        level++;
+
+    timer->expires = expires;
+    timer->level = level;
+    timer->slot = (expires >> (LTIMER_WHEEL_SLOTS_BITS * level)) & (LTIMER_WHEEL_SLOTS - 1);
+    pushFront(&slots[level][timer->slot], timer);
+    bitmaps[level] |= 1ULL << timer->slot;
+    count++;
+}
+
+void LTimer::LTimerPrivate::Wheel::remove(LTimerPrivate *timer)
+{
+    if (!timer->list)
+        return;
+
+    if (timer->prev)
+        timer->prev->next = timer->next;
+    else
+        *timer->list = timer->next;
+
+    if (timer->next)
+        timer->next->prev = timer->prev;
+
+    if (timer->list != &expired)
+    {
+        if (!*timer->list)
+            bitmaps[timer->level] &= ~(1ULL << timer->slot);
+
+        count--;
+    }
+
+    timer->list = nullptr;
+    timer->prev = nullptr;
+    timer->next = nullptr;
+}
+
+UInt64 LTimer::LTimerPrivate::Wheel::nextTick() const
+{
+    UInt64 next { UINT64_MAX };
+
+    for (UInt32 l = 0; l < LTIMER_WHEEL_LEVELS; l++)
+    {
+        if (!bitmaps[l])
+            continue;
+
+        // Rotate so that bit 0 is the slot following the current one
+        const UInt64 block { current >> (LTIMER_WHEEL_SLOTS_BITS * l) };
+        const UInt64 rotated { std::rotr(bitmaps[l], (Int32)((block + 1) & (LTIMER_WHEEL_SLOTS - 1))) };
+        const UInt64 tick { (block + std::countr_zero(rotated) + 1) << (LTIMER_WHEEL_SLOTS_BITS * l) };
+
+        if (tick < next)
+            next = tick;
+    }
+
+    return next;
+}
+
+void LTimer::LTimerPrivate::Wheel::advance(UInt64 now)
+{
+    UInt64 next;
+
+    while ((next = nextTick()) <= now)
+    {
+        current = next;
+
+        // Cascade higher levels first, their timers may land on the current level 0 slot
+        for (Int32 l = LTIMER_WHEEL_LEVELS - 1; l >= 1; l--)
+        {
+            if ((current & ((1ULL << (LTIMER_WHEEL_SLOTS_BITS * l)) - 1)) != 0)
+                continue;
+
+            const UInt8 slot = (current >> (LTIMER_WHEEL_SLOTS_BITS * l)) & (LTIMER_WHEEL_SLOTS - 1);
+            LTimerPrivate *timer { slots[l][slot] };
+            slots[l][slot] = nullptr;
+            bitmaps[l] &= ~(1ULL << slot);
+
+            while (timer)
+            {
+                LTimerPrivate *nextTimer { timer->next };
+                timer->list = nullptr;
+                count--;
+                insert(timer, timer->expires);
+                timer = nextTimer;
+            }
+        }
+
+        const UInt8 slot = current & (LTIMER_WHEEL_SLOTS - 1);
+        LTimerPrivate *timer { slots[0][slot] };
+        slots[0][slot] = nullptr;
+        bitmaps[0] &= ~(1ULL << slot);
+
+        while (timer)
+        {
+            LTimerPrivate *nextTimer { timer->next };
+            pushFront(&expired, timer);
+            count--;
+            timer = nextTimer;
+        }
+    }
+
+    // Nothing pending up to now
+    current = now;
+}
+
+LTimer::LTimerPrivate *LTimer::LTimerPrivate::Wheel::popExpired()
+{
+    LTimerPrivate *timer { expired };
+
+    if (timer)
+        remove(timer);
+
+    return timer;
+}
+
+void LTimer::LTimerPrivate::Wheel::arm(UInt64 now)
+{
+    if (!source)
+        return;
+
+    const UInt64 next { nextTick() };
+
+    if (next == UINT64_MAX || (armed != 0 && armed <= next))
+        return;
+
+    armed = next;
+    wl_event_source_timer_update(source, next > now ? next - now : 1);
+}
+
+void LTimer::LTimerPrivate::Wheel::dispatch()
+{
+    armed = 0;
+    advance(now());
+
+    while (LTimerPrivate *timer = popExpired())
+        timer->timer->stop();
+
+    arm(now());
+}
+
+UInt64 LTimer::LTimerPrivate::Wheel::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UInt64)ts.tv_sec * 1000 + (UInt64)ts.tv_nsec / 1000000;
+}
+
+Int32 LTimer::LTimerPrivate::Wheel::waylandTimeoutCallback(void *data)
+{
+    ((Wheel*)data)->dispatch();
+    return 0;
+}
@@ -3,6 +3,10 @@
 
 #include <LTimer.h>
 
+#define LTIMER_WHEEL_LEVELS 6
+#define LTIMER_WHEEL_SLOTS_BITS 6
+#define LTIMER_WHEEL_SLOTS (1 << LTIMER_WHEEL_SLOTS_BITS)
+
 using namespace Louvre;
 
 LPRIVATE_CLASS(LTimer)
@@ -12,14 +16,47 @@ bool running = false;
 bool destroyOnTimeout = false;
 bool pendingDestroy = false;
 LTimer::Callback onTimeoutCallback;
-wl_event_source *waylandEventSource = nullptr;
+LTimer *timer = nullptr;
+
+// Timer wheel links
+LTimerPrivate *prev = nullptr;
+LTimerPrivate *next = nullptr;
+LTimerPrivate **list = nullptr;
+UInt64 expires = 0;
+UInt8 level = 0;
+UInt8 slot = 0;
 
-inline static Int32 waylandTimeoutCallback(void *data)
+/* Hierarchical timer wheel with millisecond ticks, all timers share a single
+ * wl_event_loop timer source (one timerfd). Level L slots span 64^L ms.
+ * Start and cancel are O(1), expired timers are collected in batches. */
+struct Wheel
 {
-    LTimer *timer = (LTimer*)data;
-    timer->stop();
-    return 0;
-}
+    LTimerPrivate *slots[LTIMER_WHEEL_LEVELS][LTIMER_WHEEL_SLOTS] {};
+    UInt64 bitmaps[LTIMER_WHEEL_LEVELS] {};
+    LTimerPrivate *expired = nullptr;
+    UInt64 current = 0;
+    UInt64 armed = 0;
+    UInt32 count = 0;
+    wl_event_source *source = nullptr;
+
+    void insert(LTimerPrivate *timer, UInt64 expires);
+    void remove(LTimerPrivate *timer);
+
+    // Earliest tick at which a timer expires or a slot must be cascaded, UINT64_MAX if empty
+    UInt64 nextTick() const;
+
+    // Moves timers that expire at or before now to the expired list
+    void advance(UInt64 now);
+    LTimerPrivate *popExpired();
+
+    // Rearms the timer source only if the next tick is earlier than the armed one
+    void arm(UInt64 now);
+    void dispatch();
+
+    static UInt64 now();
+    static Int32 waylandTimeoutCallback(void *data);
+};
+
 };
 
 #endif // LTIMERPRIVATE_H
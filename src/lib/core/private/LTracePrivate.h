@@ -0,0 +1,92 @@
+#ifndef LTRACEPRIVATE_H
+#define LTRACEPRIVATE_H
+
+#include <LTrace.h>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <sys/types.h>
+
+#ifndef LOUVRE_TRACING
+#define LOUVRE_TRACING 0
+#endif
+
+// Number of spans kept per thread
+#define LTRACE_RING_SIZE 16384
+
+#if LOUVRE_TRACING == 1
+#define LTRACE_CONCAT_(a, b) a##b
+#define LTRACE_CONCAT(a, b) LTRACE_CONCAT_(a, b)
+#define LTRACE_SCOPE(name) Louvre::LTrace::LTracePrivate::Scope LTRACE_CONCAT(lTraceScope, __LINE__) { name }
+#define LTRACE_THREAD_NAME(name) Louvre::LTrace::LTracePrivate::setThreadName(name)
+#else
+#define LTRACE_SCOPE(name)
+#define LTRACE_THREAD_NAME(name)
+#endif
+
+using namespace Louvre;
+
+class Louvre::LTrace::LTracePrivate
+{
+public:
+    struct Span
+    {
+        // Must be a string literal
+        const char *name;
+        Int64 begin;
+        Int64 end;
+    };
+
+    /* Only written by its thread, spans are published by incrementing head.
+     * Rings are never destroyed so that spans of finished threads can still be dumped. */
+    struct Ring
+    {
+        Span spans[LTRACE_RING_SIZE];
+        std::atomic<UInt64> head { 0 };
+
+        // Index of the first span included in dumps, set by clear() (ringsMutex)
+        UInt64 tail { 0 };
+        pid_t tid;
+        std::string threadName;
+    };
+
+    static std::mutex ringsMutex;
+    static std::vector<std::unique_ptr<Ring>> rings;
+    static thread_local Ring *threadRing;
+
+    // Creates and registers the ring of the calling thread
+    static Ring *createThreadRing();
+    static void setThreadName(const char *name);
+
+    inline static Int64 now()
+    {
+        timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return (Int64)time.tv_sec * 1000000000 + (Int64)time.tv_nsec;
+    }
+
+    inline static void addSpan(const char *name, Int64 begin, Int64 end)
+    {
+        Ring *ring { threadRing ? threadRing : createThreadRing() };
+        const UInt64 head { ring->head.load(std::memory_order_relaxed) };
+        ring->spans[head % LTRACE_RING_SIZE] = { name, begin, end };
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    class Scope
+    {
+    public:
+        inline Scope(const char *name) : m_name(name), m_begin(now()) {}
+        inline ~Scope() { addSpan(m_name, m_begin, now()); }
+        Scope(const Scope&) = delete;
+        Scope &operator=(const Scope&) = delete;
+    private:
+        const char *m_name;
+        Int64 m_begin;
+    };
+};
+
+#endif // LTRACEPRIVATE_H
@@ -0,0 +1,307 @@
+#include <private/LUDMABufImporter.h>
+#include <private/LTexturePrivate.h>
+#include <LCompositor.h>
+#include <LSurface.h>
+#include <LLog.h>
+#include <linux/udmabuf.h>
+#include <drm_fourcc.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Louvre;
+
+using Pool = LUDMABufImporter::Pool;
+using Buffer = LUDMABufImporter::Buffer;
+
+struct LUDMABufImporter::Pool
+{
+    wl_listener destroyListener;
+    Int32 fd;
+    UInt32 refs;
+};
+
+struct LUDMABufImporter::Buffer
+{
+    wl_listener destroyListener;
+    Pool *pool;
+    Int32 offset, width, height, stride;
+    UInt32 format;
+    Int32 dmaFd { -1 };
+    LTexture *texture { nullptr };
+
+    // Import already attempted and failed
+    bool failed { false };
+};
+
+/* A pool or buffer whose create request was just logged. Requests are dispatched one
+ * at a time, so its resource is created right after, before any other request is logged */
+static struct
+{
+    enum { None, PendingPool, PendingBuffer } type { None };
+    wl_client *client;
+    UInt32 id;
+    Int32 fd { -1 };
+    Pool *pool;
+    Int32 offset, width, height, stride;
+    UInt32 format;
+} pending;
+
+static Int32 udmabufFd { -1 };
+static wl_protocol_logger *logger { nullptr };
+
+static void clearPending()
+{
+    if (pending.type == pending.PendingPool)
+        close(pending.fd);
+
+    pending.type = pending.None;
+}
+
+static void unrefPool(Pool *pool)
+{
+    if (--pool->refs > 0)
+        return;
+
+    close(pool->fd);
+    delete pool;
+}
+
+static void onPoolDestroy(wl_listener *listener, void *)
+{
+    Pool *pool { wl_container_of(listener, pool, destroyListener) };
+    unrefPool(pool);
+}
+
+static void onBufferDestroy(wl_listener *listener, void *)
+{
+    Buffer *buffer { wl_container_of(listener, buffer, destroyListener) };
+
+    if (buffer->texture)
+    {
+        for (LSurface *s : LCompositor::compositor()->surfaces())
+            if (s->texture() == buffer->texture)
+            {
+                buffer->texture->imp()->pendingDelete = true;
+                goto skipDeleteTexture;
+            }
+
+        delete buffer->texture;
+    }
+
+    skipDeleteTexture:
+
+    if (buffer->dmaFd >= 0)
+        close(buffer->dmaFd);
+
+    unrefPool(buffer->pool);
+    delete buffer;
+}
+
+static void onRequest(void *, wl_protocol_logger_type type, const wl_protocol_logger_message *message)
+{
+    if (type != WL_PROTOCOL_LOGGER_REQUEST)
+        return;
+
+    // wl_shm::create_pool(id, fd, size)
+    if (message->message == &wl_shm_interface.methods[0])
+    {
+        clearPending();
+
+        // udmabuf requires memfds that can not shrink
+        const Int32 seals { fcntl(message->arguments[1].h, F_GET_SEALS) };
+
+        if (seals == -1 || !(seals & F_SEAL_SHRINK) || (seals & F_SEAL_WRITE))
+            return;
+
+        pending.fd = fcntl(message->arguments[1].h, F_DUPFD_CLOEXEC, 0);
+
+        if (pending.fd == -1)
+            return;
+
+        pending.type = pending.PendingPool;
+        pending.client = wl_resource_get_client(message->resource);
+        pending.id = message->arguments[0].n;
+    }
+
+    // wl_shm_pool::create_buffer(id, offset, width, height, stride, format)
+    else if (message->message == &wl_shm_pool_interface.methods[0])
+    {
+        clearPending();
+        wl_listener *poolListener { wl_resource_get_destroy_listener(message->resource, &onPoolDestroy) };
+
+        // Not a sealed memfd
+        if (!poolListener)
+            return;
+
+        Pool *pool { wl_container_of(poolListener, pool, destroyListener) };
+        pending.type = pending.PendingBuffer;
+        pending.client = wl_resource_get_client(message->resource);
+        pending.id = message->arguments[0].n;
+        pending.pool = pool;
+        pending.offset = message->arguments[1].i;
+        pending.width = message->arguments[2].i;
+        pending.height = message->arguments[3].i;
+        pending.stride = message->arguments[4].i;
+        pending.format = message->arguments[5].u;
+    }
+}
+
+static void onResourceCreated(wl_listener *, void *data)
+{
+    wl_resource *resource { (wl_resource*)data };
+
+    if (pending.type == pending.None || pending.client != wl_resource_get_client(resource) || pending.id != wl_resource_get_id(resource))
+        return;
+
+    if (pending.type == pending.PendingPool)
+    {
+        Pool *pool { new Pool() };
+        pool->fd = pending.fd;
+        pool->refs = 1;
+        pool->destroyListener.notify = &onPoolDestroy;
+        wl_resource_add_destroy_listener(resource, &pool->destroyListener);
+    }
+    else
+    {
+        Buffer *buffer { new Buffer() };
+        buffer->pool = pending.pool;
+        buffer->pool->refs++;
+        buffer->offset = pending.offset;
+        buffer->width = pending.width;
+        buffer->height = pending.height;
+        buffer->stride = pending.stride;
+        buffer->format = LTexture::waylandFormatToDRM(pending.format);
+        buffer->destroyListener.notify = &onBufferDestroy;
+        wl_resource_add_destroy_listener(resource, &buffer->destroyListener);
+    }
+
+    pending.type = pending.None;
+}
+
+struct ClientListeners
+{
+    wl_listener resourceCreatedListener;
+    wl_listener destroyListener;
+};
+
+static void onClientDestroy(wl_listener *listener, void *)
+{
+    ClientListeners *listeners { wl_container_of(listener, listeners, destroyListener) };
+    wl_list_remove(&listeners->resourceCreatedListener.link);
+    delete listeners;
+}
+
+void LUDMABufImporter::init(wl_display *display)
+{
+    unit();
+
+    if (getenvString("LOUVRE_SHM_UDMABUF") != "1")
+        return;
+
+    udmabufFd = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+
+    if (udmabufFd == -1)
+    {
+        LLOG_WARNING("[LUDMABufImporter::init] Failed to open /dev/udmabuf. SHM buffers will be copied.");
+        return;
+    }
+
+    logger = wl_display_add_protocol_logger(display, &onRequest, nullptr);
+    LLOG_DEBUG("[LUDMABufImporter::init] SHM buffers backed by sealed memfds will be imported with udmabuf.");
+}
+
+void LUDMABufImporter::unit()
+{
+    clearPending();
+
+    if (logger)
+    {
+        wl_protocol_logger_destroy(logger);
+        logger = nullptr;
+    }
+
+    if (udmabufFd != -1)
+    {
+        close(udmabufFd);
+        udmabufFd = -1;
+    }
+}
+
+bool LUDMABufImporter::enabled()
+{
+    return logger != nullptr;
+}
+
+void LUDMABufImporter::addClient(wl_client *client)
+{
+    ClientListeners *listeners { new ClientListeners() };
+    listeners->resourceCreatedListener.notify = &onResourceCreated;
+    listeners->destroyListener.notify = &onClientDestroy;
+    wl_client_add_resource_created_listener(client, &listeners->resourceCreatedListener);
+    wl_client_add_destroy_listener(client, &listeners->destroyListener);
+}
+
+LTexture *LUDMABufImporter::texture(wl_resource *resource)
+{
+    wl_listener *listener { wl_resource_get_destroy_listener(resource, &onBufferDestroy) };
+
+    if (!listener)
+        return nullptr;
+
+    Buffer *buffer { wl_container_of(listener, buffer, destroyListener) };
+
+    if (buffer->texture || buffer->failed)
+        return buffer->texture;
+
+    buffer->failed = true;
+
+    if (LTexture::formatPlanes(buffer->format) != 1 || buffer->width <= 0 || buffer->height <= 0 || buffer->stride <= 0)
+        return nullptr;
+
+    // udmabuf ranges must be page aligned
+    const UInt64 pageSize { (UInt64)sysconf(_SC_PAGESIZE) };
+    const UInt64 start { buffer->offset & ~(pageSize - 1) };
+    const UInt64 end { (buffer->offset + (UInt64)buffer->stride * buffer->height + pageSize - 1) & ~(pageSize - 1) };
+    struct stat st;
+
+    if (fstat(buffer->pool->fd, &st) == -1 || end > (UInt64)st.st_size)
+        return nullptr;
+
+    udmabuf_create create {};
+    create.memfd = buffer->pool->fd;
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.offset = start;
+    create.size = end - start;
+
+    const Int32 dmaFd { ioctl(udmabufFd, UDMABUF_CREATE, &create) };
+
+    if (dmaFd == -1)
+        return nullptr;
+
+    LDMAPlanes planes;
+    planes.width = buffer->width;
+    planes.height = buffer->height;
+    planes.format = buffer->format;
+    planes.num_fds = 1;
+    planes.fds[0] = dmaFd;
+    planes.strides[0] = buffer->stride;
+    planes.offsets[0] = buffer->offset - start;
+    planes.modifiers[0] = DRM_FORMAT_MOD_LINEAR;
+
+    LTexture *texture { new LTexture() };
+
+    // E.g. strides not supported by the GPU
+    if (!texture->setDataB(&planes))
+    {
+        delete texture;
+        close(dmaFd);
+        return nullptr;
+    }
+
+    buffer->dmaFd = dmaFd;
+    buffer->texture = texture;
+    buffer->failed = false;
+    return texture;
+}
@@ -0,0 +1,37 @@
+#ifndef LUDMABUFIMPORTER_H
+#define LUDMABUFIMPORTER_H
+
+#include <LNamespaces.h>
+
+/* Imports wl_shm buffers backed by sealed memfds as DMA textures through /dev/udmabuf,
+ * so their pixels are sampled in place instead of being copied on each commit.
+ *
+ * The wl_shm global is implemented by libwayland, which does not expose the pool file
+ * descriptors, so they are duplicated from the create_pool requests with a protocol logger.
+ *
+ * Enabled with LOUVRE_SHM_UDMABUF=1, buffers that can not be imported fall back to the
+ * regular upload path. */
+namespace Louvre
+{
+    class LUDMABufImporter;
+}
+
+class Louvre::LUDMABufImporter
+{
+public:
+    LUDMABufImporter() = delete;
+    struct Pool;
+    struct Buffer;
+
+    static void init(wl_display *display);
+    static void unit();
+    static bool enabled();
+
+    // Must be called for each connected client
+    static void addClient(wl_client *client);
+
+    // Returns nullptr if the buffer can not be sampled in place
+    static LTexture *texture(wl_resource *buffer);
+};
+
+#endif // LUDMABUFIMPORTER_H
@@ -2,32 +2,27 @@
 #include <private/LScenePrivate.h>
 #include <private/LSceneViewPrivate.h>
 
-void LView::LViewPrivate::removeThread(LView *view, std::thread::id thread)
+void LView::LViewPrivate::removeThread(LView *view, UInt32 slot)
 {
-    auto it = threadsMap.find(thread);
-
-    if (it != threadsMap.end())
+    if (slot < threadsData.size())
     {
-        if (it->second.o)
-            view->leftOutput(it->second.o);
-        threadsMap.erase(it);
+        if (threadsData[slot].o)
+            view->leftOutput(threadsData[slot].o);
+
+        threadsData[slot] = ViewThreadData();
     }
 
     if (view->type() != Scene)
         return;
 
     LSceneView *sceneView = (LSceneView*)view;
-
-    auto sit = sceneView->imp()->threadsMap.find(thread);
-
-    if (sit != sceneView->imp()->threadsMap.end())
-        sceneView->imp()->threadsMap.erase(sit);
+    sceneView->imp()->removeThreadData(slot);
 }
 
 void LView::LViewPrivate::markAsChangedOrder(bool includeChildren)
 {
-    for (auto &pair : threadsMap)
-        pair.second.changedOrder = true;
+    for (ViewThreadData &data : threadsData)
+        data.changedOrder = true;
 
     if (includeChildren)
         for (LView *child : children)
@@ -38,13 +33,13 @@ void LView::LViewPrivate::damageScene(LSceneView *s)
 {
     if (s)
     {
-        for (auto &pair : threadsMap)
+        for (ViewThreadData &data : threadsData)
         {
-            if (!pair.second.prevMapped)
+            if (!data.prevMapped)
                 continue;
 
-            if (pair.second.o)
-                s->addDamage(pair.second.o, pair.second.prevClipping);
+            if (data.o)
+                s->addDamage(data.o, data.prevClipping);
         }
 
         for (LView *child : children)
@@ -6,8 +6,7 @@
 #include <LRect.h>
 #include <LPainter.h>
 #include <GL/gl.h>
-#include <thread>
-#include <map>
+#include <vector>
 
 using namespace Louvre;
 
@@ -55,26 +54,7 @@ LPRIVATE_CLASS(LView)
         bool prevColorFactorEnabled { false };
     };
 
-    // This is used to prevent invoking heavy methods
-    struct ViewCache
-    {
-        ViewThreadData *voD;
-        LRect rect;
-        LRect localRect;
-        LRegion damage;
-        LRegion translucent;
-        LRegion opaque;
-        LRegion opaqueOverlay;
-        Float32 opacity;
-        LSizeF scalingVector;
-        bool mapped { false };
-        bool occluded { false };
-        bool scalingEnabled;
-        bool isFullyTrans;
-    };
-
     UInt32 state { Visible | ParentOffset | ParentOpacity | BlockPointer | AutoBlendFunc };
-    ViewCache cache;
 
     UInt32 type;
     LView *parent { nullptr };
@@ -93,11 +73,23 @@ LPRIVATE_CLASS(LView)
     LSize tmpSize;
     LPointF tmpPointF;
 
-    std::map<std::thread::id,ViewThreadData>threadsMap;
+    // Indexed by the thread slot of each output (see LCompositorPrivate::threadsData)
+    std::vector<ViewThreadData>threadsData;
     LScene *scene { nullptr };
     std::list<LView*>::iterator parentLink;
 
-    void removeThread(Louvre::LView *view, std::thread::id thread);
+    // Incremented each time a children list changes, scene views rebuild their flattened tree when it differs
+    inline static UInt64 treeSerial { 1 };
+
+    inline ViewThreadData &threadData(UInt32 slot)
+    {
+        if (slot >= threadsData.size())
+            threadsData.resize(slot + 1);
+
+        return threadsData[slot];
+    }
+
+    void removeThread(Louvre::LView *view, UInt32 slot);
     void markAsChangedOrder(bool includeChildren = true);
     void damageScene(LSceneView *s);
 
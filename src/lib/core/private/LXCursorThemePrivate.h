@@ -0,0 +1,85 @@
+#ifndef LXCURSORTHEMEPRIVATE_H
+#define LXCURSORTHEMEPRIVATE_H
+
+#include <LXCursorTheme.h>
+#include <LXCursor.h>
+#include <condition_variable>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <map>
+#include <set>
+
+using namespace Louvre;
+
+LPRIVATE_CLASS(LXCursorTheme)
+    LXCursorTheme *theme;
+    std::string name;
+    Int32 size;
+    LXCursorTheme::Callback onLoaded;
+
+    // Names passed to preload() or cursor(), loaded in all sizesB
+    std::set<std::string> names;
+
+    // Buffer sizes required by the scales of the current outputs
+    std::set<Int32> sizesB;
+
+    // Loaded cursors, indexed by name and buffer size
+    std::unordered_map<std::string, std::map<Int32, LXCursorTheme::Cursor>> cursors;
+
+    // Cursors already scheduled (pending, loaded or missing in the theme)
+    std::set<std::pair<std::string, Int32>> scheduled;
+
+    /* Unique images, indexed by a hash of their size, hotspot and pixels. The pixels are kept
+     * to tell images with the same hash apart */
+    struct UniqueImage
+    {
+        std::unique_ptr<LXCursor> image;
+        UInt32 width, height;
+        LPoint hotspot;
+        std::vector<UInt32> pixels;
+    };
+
+    std::unordered_multimap<UInt64, UniqueImage> images;
+
+    /* Images parsed by the worker thread, pending upload */
+    struct ParsedImage
+    {
+        UInt64 hash;
+        UInt32 width, height, delay;
+        LPoint hotspot;
+        std::vector<UInt32> pixels;
+    };
+
+    struct Job
+    {
+        std::string name;
+        Int32 sizeB;
+        std::vector<ParsedImage> images;
+    };
+
+    // Main thread only, number of jobs not yet uploaded
+    UInt32 pendingJobs { 0 };
+
+    // Shared with the worker thread
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable jobsCond, resultsCond;
+    std::deque<Job> jobs;
+    std::vector<Job> results;
+    std::atomic<bool> hasResults { false };
+    bool running { true };
+
+    void workerLoop();
+    void schedule(const std::string &cursor, Int32 sizeB);
+
+    // Called from the main loop and public methods, uploads parsed images and tracks output scales
+    void update();
+    bool uploadResults();
+    void updateSizes();
+};
+
+#endif // LXCURSORTHEMEPRIVATE_H
@@ -0,0 +1,45 @@
+#include <protocols/ScreenCopy/private/GScreenCopyManagerPrivate.h>
+#include <protocols/ScreenCopy/private/RScreenCopyFramePrivate.h>
+#include <private/LClientPrivate.h>
+#include <private/LOutputPrivate.h>
+#include <LCompositor.h>
+
+using namespace Louvre::Protocols::ScreenCopy;
+
+GScreenCopyManager::GScreenCopyManager
+    (
+        LClient *client,
+        const wl_interface *interface,
+        Int32 version,
+        UInt32 id,
+        const void *implementation,
+        wl_resource_destroy_func_t destroy
+        )
+    :LResource
+    (
+        client,
+        interface,
+        version,
+        id,
+        implementation,
+        destroy
+        ),
+    LPRIVATE_INIT_UNIQUE(GScreenCopyManager)
+{
+    client->imp()->screenCopyManagerGlobals.push_back(this);
+}
+
+GScreenCopyManager::~GScreenCopyManager()
+{
+    LVectorRemoveOneUnordered(client()->imp()->screenCopyManagerGlobals, this);
+
+    // Stop tracking damage for this manager
+    for (LOutput *o : compositor()->outputs())
+    {
+        o->imp()->removeScreenCopyDamage(this);
+
+        for (RScreenCopyFrame *frame : o->imp()->screenCopyFrames)
+            if (frame->imp()->gScreenCopyManager == this)
+                frame->imp()->gScreenCopyManager = nullptr;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef GSCREENCOPYMANAGER_H
+#define GSCREENCOPYMANAGER_H
+
+#include <LResource.h>
+
+class Louvre::Protocols::ScreenCopy::GScreenCopyManager : public LResource
+{
+public:
+    GScreenCopyManager(LClient *client,
+                const wl_interface *interface,
+                Int32 version,
+                UInt32 id,
+                const void *implementation,
+                wl_resource_destroy_func_t destroy);
+    ~GScreenCopyManager();
+
+    LPRIVATE_IMP_UNIQUE(GScreenCopyManager)
+};
+
+#endif // GSCREENCOPYMANAGER_H
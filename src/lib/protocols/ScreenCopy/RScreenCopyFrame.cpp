@@ -0,0 +1,223 @@
+#include <protocols/ScreenCopy/private/RScreenCopyFramePrivate.h>
+#include <protocols/ScreenCopy/GScreenCopyManager.h>
+#include <protocols/ScreenCopy/wlr-screencopy-unstable-v1.h>
+#include <private/LCompositorPrivate.h>
+#include <private/LOutputPrivate.h>
+#include <private/LPainterPrivate.h>
+#include <LOutputMode.h>
+#include <drm_fourcc.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace Louvre;
+
+static struct zwlr_screencopy_frame_v1_interface screen_copy_frame_implementation =
+{
+    .copy = &RScreenCopyFrame::RScreenCopyFramePrivate::copy,
+    .destroy = &RScreenCopyFrame::RScreenCopyFramePrivate::destroy,
+#if LOUVRE_SCREEN_COPY_MANAGER_VERSION >= 2
+    .copy_with_damage = &RScreenCopyFrame::RScreenCopyFramePrivate::copy_with_damage
+#else
+    .copy_with_damage = NULL
+#endif
+};
+
+RScreenCopyFrame::RScreenCopyFrame
+    (
+        GScreenCopyManager *gScreenCopyManager,
+        LOutput *output,
+        bool overlayCursor,
+        const LRect &region,
+        UInt32 id
+    )
+    :LResource
+    (
+        gScreenCopyManager->client(),
+        &zwlr_screencopy_frame_v1_interface,
+        gScreenCopyManager->version(),
+        id,
+        &screen_copy_frame_implementation,
+        &RScreenCopyFrame::RScreenCopyFramePrivate::resource_destroy
+    ),
+    LPRIVATE_INIT_UNIQUE(RScreenCopyFrame)
+{
+    imp()->gScreenCopyManager = gScreenCopyManager;
+    imp()->overlayCursor = overlayCursor;
+    imp()->bufferDestroyListener.frame = this;
+    imp()->bufferDestroyListener.listener.notify = &RScreenCopyFrame::RScreenCopyFramePrivate::buffer_destroy;
+    wl_list_init(&imp()->bufferDestroyListener.listener.link);
+
+    if (!output || output->state() != LOutput::Initialized)
+    {
+        failed();
+        return;
+    }
+
+    LRect rect { region };
+
+    if (rect.w() < 0)
+    {
+        rect.setX(rect.x() + rect.w());
+        rect.setW(-rect.w());
+    }
+
+    if (rect.h() < 0)
+    {
+        rect.setY(rect.y() + rect.h());
+        rect.setH(-rect.h());
+    }
+
+    LRegion regionTmp { rect };
+    regionTmp.clip(LRect(0, output->size()));
+
+    if (regionTmp.empty())
+    {
+        failed();
+        return;
+    }
+
+    const LBox &extents { regionTmp.extents() };
+    rect = LRect(extents.x1, extents.y1, extents.x2 - extents.x1, extents.y2 - extents.y1);
+
+    if (!output->screenCopyRequest(client(), rect))
+    {
+        failed();
+        return;
+    }
+
+    const LSize &modeSizeB { output->currentMode()->sizeB() };
+
+    // Whole output, avoid rounding errors with fractional scales
+    if (rect == LRect(0, output->size()))
+        imp()->regionB = LRect(0, modeSizeB);
+    else
+    {
+        // Same conversion applied to the output damage in LOutputPrivate::backendPaintGL()
+        regionTmp.transform(output->size(), output->transform());
+        const LBox &box { regionTmp.extents() };
+        const Float32 scale { output->fractionalScale() };
+        const Int32 x1 { std::max(0, Int32(floorf(Float32(box.x1) * scale))) };
+        const Int32 y1 { std::max(0, Int32(floorf(Float32(box.y1) * scale))) };
+        const Int32 x2 { std::min(modeSizeB.w(), Int32(ceilf(Float32(box.x2) * scale))) };
+        const Int32 y2 { std::min(modeSizeB.h(), Int32(ceilf(Float32(box.y2) * scale))) };
+        imp()->regionB = LRect(x1, y1, x2 - x1, y2 - y1);
+    }
+
+    if (imp()->regionB.w() <= 0 || imp()->regionB.h() <= 0)
+    {
+        failed();
+        return;
+    }
+
+    imp()->output = output;
+    output->imp()->screenCopyFrames.push_back(this);
+
+    // Starts tracking damage for this manager (full damage the first time)
+    output->imp()->screenCopyDamageOf(gScreenCopyManager);
+
+    // Read the framebuffer directly in the client buffer format to avoid swizzling on the CPU
+    imp()->shmFormat = compositor()->imp()->painter->imp()->openGLExtensions.EXT_read_format_bgra ?
+                           WL_SHM_FORMAT_XRGB8888 : WL_SHM_FORMAT_XBGR8888;
+
+    buffer(imp()->shmFormat, imp()->regionB.size(), imp()->regionB.w() * 4);
+
+    // DMA buffers are written by the GPU with glCopyTexSubImage2D(), no CPU readback
+    if (compositor()->imp()->graphicBackend->backendGetRendererGPUs() == 1)
+    {
+        imp()->dmaFormat = DRM_FORMAT_XRGB8888;
+        linuxDMABuf(imp()->dmaFormat, imp()->regionB.size());
+    }
+
+    bufferDone();
+}
+
+RScreenCopyFrame::~RScreenCopyFrame()
+{
+    imp()->release();
+}
+
+GScreenCopyManager *RScreenCopyFrame::screenCopyManagerGlobal() const
+{
+    return imp()->gScreenCopyManager;
+}
+
+LOutput *RScreenCopyFrame::output() const
+{
+    return imp()->output;
+}
+
+const LRect &RScreenCopyFrame::regionB() const
+{
+    return imp()->regionB;
+}
+
+bool RScreenCopyFrame::overlayCursor() const
+{
+    return imp()->overlayCursor;
+}
+
+bool RScreenCopyFrame::buffer(UInt32 shmFormat, const LSize &size, UInt32 stride)
+{
+    zwlr_screencopy_frame_v1_send_buffer(resource(), shmFormat, size.w(), size.h(), stride);
+    return true;
+}
+
+bool RScreenCopyFrame::flags(UInt32 flags)
+{
+    zwlr_screencopy_frame_v1_send_flags(resource(), flags);
+    return true;
+}
+
+bool RScreenCopyFrame::ready(const timespec &time)
+{
+    zwlr_screencopy_frame_v1_send_ready(resource(),
+                                        time.tv_sec >> 32,
+                                        time.tv_sec & 0xffffffff,
+                                        time.tv_nsec);
+    return true;
+}
+
+bool RScreenCopyFrame::failed()
+{
+    zwlr_screencopy_frame_v1_send_failed(resource());
+    return true;
+}
+
+bool RScreenCopyFrame::damage(const LRect &rect)
+{
+#if LOUVRE_SCREEN_COPY_MANAGER_VERSION >= 2
+    if (version() >= 2)
+    {
+        zwlr_screencopy_frame_v1_send_damage(resource(), rect.x(), rect.y(), rect.w(), rect.h());
+        return true;
+    }
+#endif
+    L_UNUSED(rect);
+    return false;
+}
+
+bool RScreenCopyFrame::linuxDMABuf(UInt32 format, const LSize &size)
+{
+#if LOUVRE_SCREEN_COPY_MANAGER_VERSION >= 3
+    if (version() >= 3)
+    {
+        zwlr_screencopy_frame_v1_send_linux_dmabuf(resource(), format, size.w(), size.h());
+        return true;
+    }
+#endif
+    L_UNUSED(format);
+    L_UNUSED(size);
+    return false;
+}
+
+bool RScreenCopyFrame::bufferDone()
+{
+#if LOUVRE_SCREEN_COPY_MANAGER_VERSION >= 3
+    if (version() >= 3)
+    {
+        zwlr_screencopy_frame_v1_send_buffer_done(resource());
+        return true;
+    }
+#endif
+    return false;
+}
@@ -0,0 +1,41 @@
+#ifndef RSCREENCOPYFRAME_H
+#define RSCREENCOPYFRAME_H
+
+#include <LResource.h>
+
+class Louvre::Protocols::ScreenCopy::RScreenCopyFrame : public LResource
+{
+public:
+    RScreenCopyFrame(GScreenCopyManager *gScreenCopyManager,
+                     LOutput *output,
+                     bool overlayCursor,
+                     const LRect &region,
+                     UInt32 id);
+    ~RScreenCopyFrame();
+
+    GScreenCopyManager *screenCopyManagerGlobal() const;
+
+    // nullptr if the output is removed before the frame is copied
+    LOutput *output() const;
+
+    // Captured region in output buffer coordinates
+    const LRect &regionB() const;
+    bool overlayCursor() const;
+
+    // Since 1
+    bool buffer(UInt32 shmFormat, const LSize &size, UInt32 stride);
+    bool flags(UInt32 flags);
+    bool ready(const timespec &time);
+    bool failed();
+
+    // Since 2
+    bool damage(const LRect &rect);
+
+    // Since 3
+    bool linuxDMABuf(UInt32 format, const LSize &size);
+    bool bufferDone();
+
+    LPRIVATE_IMP_UNIQUE(RScreenCopyFrame)
+};
+
+#endif // RSCREENCOPYFRAME_H
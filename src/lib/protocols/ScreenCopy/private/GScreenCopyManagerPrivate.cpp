@@ -0,0 +1,65 @@
+#include <protocols/ScreenCopy/private/GScreenCopyManagerPrivate.h>
+#include <protocols/ScreenCopy/RScreenCopyFrame.h>
+#include <protocols/Wayland/GOutput.h>
+#include <LCompositor.h>
+#include <LOutput.h>
+
+struct zwlr_screencopy_manager_v1_interface screen_copy_manager_implementation
+{
+    .capture_output = &GScreenCopyManager::GScreenCopyManagerPrivate::capture_output,
+    .capture_output_region = &GScreenCopyManager::GScreenCopyManagerPrivate::capture_output_region,
+    .destroy = &GScreenCopyManager::GScreenCopyManagerPrivate::destroy
+};
+
+void GScreenCopyManager::GScreenCopyManagerPrivate::bind(wl_client *client, void *data, UInt32 version, UInt32 id)
+{
+    L_UNUSED(data);
+
+    LClient *lClient = compositor()->getClientFromNativeResource(client);
+    new GScreenCopyManager(lClient,
+                    &zwlr_screencopy_manager_v1_interface,
+                    version,
+                    id,
+                    &screen_copy_manager_implementation,
+                    &GScreenCopyManager::GScreenCopyManagerPrivate::resource_destroy);
+}
+
+void GScreenCopyManager::GScreenCopyManagerPrivate::resource_destroy(wl_resource *resource)
+{
+    delete (GScreenCopyManager*)wl_resource_get_user_data(resource);
+}
+
+void GScreenCopyManager::GScreenCopyManagerPrivate::destroy(wl_client *client, wl_resource *resource)
+{
+    L_UNUSED(client)
+    wl_resource_destroy(resource);
+}
+
+void GScreenCopyManager::GScreenCopyManagerPrivate::capture_output(wl_client *client, wl_resource *resource, UInt32 id, Int32 overlay_cursor, wl_resource *output)
+{
+    L_UNUSED(client);
+
+    GScreenCopyManager *gScreenCopyManager { (GScreenCopyManager*)wl_resource_get_user_data(resource) };
+    Wayland::GOutput *gOutput { (Wayland::GOutput*)wl_resource_get_user_data(output) };
+    LOutput *lOutput { gOutput->output() };
+
+    new RScreenCopyFrame(gScreenCopyManager,
+                         lOutput,
+                         overlay_cursor != 0,
+                         lOutput ? LRect(0, lOutput->size()) : LRect(),
+                         id);
+}
+
+void GScreenCopyManager::GScreenCopyManagerPrivate::capture_output_region(wl_client *client, wl_resource *resource, UInt32 id, Int32 overlay_cursor, wl_resource *output, Int32 x, Int32 y, Int32 width, Int32 height)
+{
+    L_UNUSED(client);
+
+    GScreenCopyManager *gScreenCopyManager { (GScreenCopyManager*)wl_resource_get_user_data(resource) };
+    Wayland::GOutput *gOutput { (Wayland::GOutput*)wl_resource_get_user_data(output) };
+
+    new RScreenCopyFrame(gScreenCopyManager,
+                         gOutput->output(),
+                         overlay_cursor != 0,
+                         LRect(x, y, width, height),
+                         id);
+}
@@ -0,0 +1,17 @@
+#ifndef GSCREENCOPYMANAGERPRIVATE_H
+#define GSCREENCOPYMANAGERPRIVATE_H
+
+#include <protocols/ScreenCopy/GScreenCopyManager.h>
+#include <protocols/ScreenCopy/wlr-screencopy-unstable-v1.h>
+
+using namespace Louvre::Protocols::ScreenCopy;
+
+LPRIVATE_CLASS(GScreenCopyManager)
+static void bind(wl_client *client, void *data, UInt32 version, UInt32 id);
+static void resource_destroy(wl_resource *resource);
+static void destroy(wl_client *client, wl_resource *resource);
+static void capture_output(wl_client *client, wl_resource *resource, UInt32 id, Int32 overlay_cursor, wl_resource *output);
+static void capture_output_region(wl_client *client, wl_resource *resource, UInt32 id, Int32 overlay_cursor, wl_resource *output, Int32 x, Int32 y, Int32 width, Int32 height);
+};
+
+#endif // GSCREENCOPYMANAGERPRIVATE_H
@@ -0,0 +1,138 @@
+#include <protocols/ScreenCopy/private/RScreenCopyFramePrivate.h>
+#include <protocols/ScreenCopy/wlr-screencopy-unstable-v1.h>
+#include <protocols/LinuxDMABuf/private/LDMABufferPrivate.h>
+#include <private/LOutputPrivate.h>
+
+void RScreenCopyFrame::RScreenCopyFramePrivate::resource_destroy(wl_resource *resource)
+{
+    delete (RScreenCopyFrame*)wl_resource_get_user_data(resource);
+}
+
+void RScreenCopyFrame::RScreenCopyFramePrivate::destroy(wl_client *client, wl_resource *resource)
+{
+    L_UNUSED(client);
+    wl_resource_destroy(resource);
+}
+
+void RScreenCopyFrame::RScreenCopyFramePrivate::copy(wl_client *client, wl_resource *resource, wl_resource *buffer)
+{
+    L_UNUSED(client);
+    handleCopy((RScreenCopyFrame*)wl_resource_get_user_data(resource), buffer, false);
+}
+
+#if LOUVRE_SCREEN_COPY_MANAGER_VERSION >= 2
+void RScreenCopyFrame::RScreenCopyFramePrivate::copy_with_damage(wl_client *client, wl_resource *resource, wl_resource *buffer)
+{
+    L_UNUSED(client);
+    handleCopy((RScreenCopyFrame*)wl_resource_get_user_data(resource), buffer, true);
+}
+#endif
+
+void RScreenCopyFrame::RScreenCopyFramePrivate::handleCopy(RScreenCopyFrame *rScreenCopyFrame, wl_resource *buffer, bool withDamage)
+{
+    if (rScreenCopyFrame->imp()->used)
+    {
+        wl_resource_post_error(rScreenCopyFrame->resource(),
+                               ZWLR_SCREENCOPY_FRAME_V1_ERROR_ALREADY_USED,
+                               "Frame already used.");
+        return;
+    }
+
+    rScreenCopyFrame->imp()->used = true;
+
+    // Output removed or capture denied, failed() was already sent
+    if (!rScreenCopyFrame->output())
+        return;
+
+    const LSize &sizeB { rScreenCopyFrame->regionB().size() };
+
+    if (wl_shm_buffer *shmBuffer = wl_shm_buffer_get(buffer))
+    {
+        const Int32 stride { wl_shm_buffer_get_stride(shmBuffer) };
+
+        if (wl_shm_buffer_get_format(shmBuffer) != rScreenCopyFrame->imp()->shmFormat ||
+            wl_shm_buffer_get_width(shmBuffer) != sizeB.w() ||
+            wl_shm_buffer_get_height(shmBuffer) != sizeB.h() ||
+            stride < sizeB.w() * 4 ||
+            stride % 4 != 0)
+            goto invalidBuffer;
+    }
+    else if (isDMABuffer(buffer))
+    {
+        LDMABuffer *dmaBuffer { (LDMABuffer*)wl_resource_get_user_data(buffer) };
+
+        if (rScreenCopyFrame->imp()->dmaFormat == 0 ||
+            dmaBuffer->planes()->format != rScreenCopyFrame->imp()->dmaFormat ||
+            Int32(dmaBuffer->planes()->width) != sizeB.w() ||
+            Int32(dmaBuffer->planes()->height) != sizeB.h())
+            goto invalidBuffer;
+
+        if (!dmaBuffer->texture())
+        {
+            dmaBuffer->imp()->texture = new LTexture();
+
+            if (!dmaBuffer->texture()->setDataB(dmaBuffer->planes()))
+            {
+                delete dmaBuffer->imp()->texture;
+                dmaBuffer->imp()->texture = nullptr;
+                rScreenCopyFrame->imp()->release();
+                rScreenCopyFrame->failed();
+                return;
+            }
+        }
+    }
+    else
+        goto invalidBuffer;
+
+    rScreenCopyFrame->imp()->buffer = buffer;
+    rScreenCopyFrame->imp()->withDamage = withDamage;
+    wl_resource_add_destroy_listener(buffer, &rScreenCopyFrame->imp()->bufferDestroyListener.listener);
+
+    // Frames waiting for damage are copied on the next repaint that damages the region
+    if (!withDamage)
+        rScreenCopyFrame->output()->repaint();
+
+    return;
+
+    invalidBuffer:
+    wl_resource_post_error(rScreenCopyFrame->resource(),
+                           ZWLR_SCREENCOPY_FRAME_V1_ERROR_INVALID_BUFFER,
+                           "Invalid buffer attributes.");
+}
+
+void RScreenCopyFrame::RScreenCopyFramePrivate::buffer_destroy(wl_listener *listener, void *data)
+{
+    L_UNUSED(data);
+    BufferDestroyListener *bufferDestroyListener;
+    bufferDestroyListener = wl_container_of(listener, bufferDestroyListener, listener);
+    RScreenCopyFrame *rScreenCopyFrame { bufferDestroyListener->frame };
+    rScreenCopyFrame->imp()->release();
+    rScreenCopyFrame->failed();
+}
+
+void RScreenCopyFrame::RScreenCopyFramePrivate::release()
+{
+    if (pendingCopy)
+    {
+        pendingCopy->frame = nullptr;
+        pendingCopy.reset();
+    }
+
+    if (buffer)
+    {
+        wl_list_remove(&bufferDestroyListener.listener.link);
+        wl_list_init(&bufferDestroyListener.listener.link);
+        buffer = nullptr;
+    }
+
+    detachFromOutput();
+}
+
+void RScreenCopyFrame::RScreenCopyFramePrivate::detachFromOutput()
+{
+    if (output)
+    {
+        LVectorRemoveOneUnordered(output->imp()->screenCopyFrames, bufferDestroyListener.frame);
+        output = nullptr;
+    }
+}
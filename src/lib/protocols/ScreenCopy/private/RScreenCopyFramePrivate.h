@@ -0,0 +1,56 @@
+#ifndef RSCREENCOPYFRAMEPRIVATE_H
+#define RSCREENCOPYFRAMEPRIVATE_H
+
+#include <protocols/ScreenCopy/RScreenCopyFrame.h>
+#include <LRect.h>
+#include <memory>
+
+using namespace Louvre::Protocols::ScreenCopy;
+
+LPRIVATE_CLASS(RScreenCopyFrame)
+static void resource_destroy(wl_resource *resource);
+static void destroy(wl_client *client, wl_resource *resource);
+static void copy(wl_client *client, wl_resource *resource, wl_resource *buffer);
+#if LOUVRE_SCREEN_COPY_MANAGER_VERSION >= 2
+static void copy_with_damage(wl_client *client, wl_resource *resource, wl_resource *buffer);
+#endif
+static void handleCopy(RScreenCopyFrame *rScreenCopyFrame, wl_resource *buffer, bool withDamage);
+static void buffer_destroy(wl_listener *listener, void *data);
+
+// Removes the frame from the output queue and the buffer destroy listener
+void release();
+
+// Removes the frame from the output queue only
+void detachFromOutput();
+
+GScreenCopyManager *gScreenCopyManager = nullptr;
+LOutput *output = nullptr;
+LRect regionB;
+bool overlayCursor = false;
+
+// Formats advertised with the buffer and linux_dmabuf events
+UInt32 shmFormat = 0;
+UInt32 dmaFormat = 0;
+
+// Set by copy or copy_with_damage, a frame can only be copied once
+bool used = false;
+bool withDamage = false;
+wl_resource *buffer = nullptr;
+
+/* SHM copy whose readback is still in flight, shared with the readback callback since the frame
+ * or its buffer can be destroyed before it finishes (frame is set to nullptr in that case) */
+struct PendingCopy
+{
+    RScreenCopyFrame *frame;
+    timespec time;
+};
+std::shared_ptr<PendingCopy> pendingCopy;
+
+struct BufferDestroyListener
+{
+    wl_listener listener;
+    RScreenCopyFrame *frame;
+} bufferDestroyListener;
+};
+
+#endif // RSCREENCOPYFRAMEPRIVATE_H
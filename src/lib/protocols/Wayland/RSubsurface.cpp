@@ -5,9 +5,12 @@
 
 #include <private/LSubsurfaceRolePrivate.h>
 #include <private/LSurfacePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
 #include <LCompositor.h>
 #include <LLog.h>
 
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
+
 struct wl_subsurface_interface subsurface_implementation =
 {
     .destroy = &RSubsurface::RSubsurfacePrivate::destroy,
@@ -46,10 +49,18 @@ RSubsurface::RSubsurface
     surface->imp()->setPendingParent(parent);
     surface->imp()->setPendingRole(imp()->lSubsurfaceRole);
     surface->imp()->applyPendingRole();
+
+    if (LSR::active())
+        LSR::record(LSR::SubsurfaceCreate, resource(), {
+            (Int32)wl_resource_get_id(surface->surfaceResource()->resource()),
+            (Int32)wl_resource_get_id(parent->surfaceResource()->resource()) });
 }
 
 RSubsurface::~RSubsurface()
 {
+    if (LSR::active())
+        LSR::record(LSR::SubsurfaceDestroy, resource());
+
     // Notify
     compositor()->destroySubsurfaceRoleRequest(imp()->lSubsurfaceRole);
     delete imp()->lSubsurfaceRole;
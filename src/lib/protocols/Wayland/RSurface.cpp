@@ -14,10 +14,12 @@
 #include <private/LPointerPrivate.h>
 #include <private/LKeyboardPrivate.h>
 #include <private/LSubsurfaceRolePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
 #include <LDNDIconRole.h>
 #include <LCursorRole.h>
 
 using namespace Protocols::Wayland;
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
 
 struct wl_surface_interface surface_implementation =
 {
@@ -72,12 +74,18 @@ RSurface::RSurface
     compositor()->imp()->surfaces.push_back(surface());
     surface()->imp()->compositorLink = std::prev(compositor()->imp()->surfaces.end());
     compositor()->imp()->surfacesListChanged = true;
+
+    if (LSR::active())
+        LSR::record(LSR::SurfaceCreate, resource());
 }
 
 RSurface::~RSurface()
 {
     LSurface *lSurface = this->surface();
 
+    if (LSR::active())
+        LSR::record(LSR::SurfaceDestroy, resource());
+
     lSurface->imp()->setKeyboardGrabToParent();
 
     // Notify from client
@@ -23,7 +23,7 @@ void GOutput::GOutputPrivate::bind(wl_client *client, void *output, UInt32 versi
     {
         if (g->output() == lOutput)
         {
-            LLog::warning("[GOutputPrivate::bind] Client already bound to output %s. Ignoring it...", lOutput->name());
+            LLOG_WARNING("[GOutputPrivate::bind] Client already bound to output %s. Ignoring it...", lOutput->name());
             return;
         }
     }
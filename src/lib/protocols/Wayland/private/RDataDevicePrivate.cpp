@@ -56,7 +56,7 @@ void RDataDevice::RDataDevicePrivate::start_drag(wl_client *client,
         if (rDataSource)
             rDataSource->cancelled();
 
-        LLog::debug("[RDataDevicePrivate::start_drag] Invalid start drag request. Ignoring it.");
+        LLOG_DEBUG("[RDataDevicePrivate::start_drag] Invalid start drag request. Ignoring it.");
         return;
     }
 
@@ -1,10 +1,13 @@
 #include <protocols/Wayland/private/RSubsurfacePrivate.h>
 #include <protocols/Wayland/private/RSurfacePrivate.h>
 #include <private/LSubsurfaceRolePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
 #include <LCompositor.h>
 #include <LSurface.h>
 #include <LClient.h>
 
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
+
 void RSubsurface::RSubsurfacePrivate::resource_destroy(wl_resource *resource)
 {
     RSubsurface *rSubsurface = (RSubsurface*)wl_resource_get_user_data(resource);
@@ -21,6 +24,10 @@ void RSubsurface::RSubsurfacePrivate::set_position(wl_client *client, wl_resourc
 {
     L_UNUSED(client);
     RSubsurface *rSubsurface = (RSubsurface*)wl_resource_get_user_data(resource);
+
+    if (LSR::active())
+        LSR::record(LSR::SubsurfacePosition, resource, { x, y });
+
     rSubsurface->subsurfaceRole()->imp()->pendingLocalPos = LPoint(x,y);
     rSubsurface->subsurfaceRole()->imp()->hasPendingLocalPos = true;
 }
@@ -49,6 +56,9 @@ void RSubsurface::RSubsurfacePrivate::place_above(wl_client *client, wl_resource
         if (rSubsurface->subsurfaceRole()->imp()->pendingPlaceAbove)
             wl_list_remove(&rSubsurface->subsurfaceRole()->imp()->pendingPlaceAboveDestroyListener.link);
 
+        if (LSR::active())
+            LSR::record(LSR::SubsurfacePlaceAbove, resource, { (Int32)wl_resource_get_id(sibiling) });
+
         rSubsurface->subsurfaceRole()->imp()->pendingPlaceAbove = rSibiling->surface();
         rSubsurface->subsurfaceRole()->imp()->pendingPlaceAboveDestroyListener.notify = &onPendingPlaceAboveDestroy;
         wl_resource_add_destroy_listener(rSibiling->resource(),
@@ -86,6 +96,9 @@ void RSubsurface::RSubsurfacePrivate::place_below(wl_client *client, wl_resource
         if (rSubsurface->subsurfaceRole()->imp()->pendingPlaceBelow)
             wl_list_remove(&rSubsurface->subsurfaceRole()->imp()->pendingPlaceBelowDestroyListener.link);
 
+        if (LSR::active())
+            LSR::record(LSR::SubsurfacePlaceBelow, resource, { (Int32)wl_resource_get_id(sibiling) });
+
         rSubsurface->subsurfaceRole()->imp()
             ->pendingPlaceBelow = rSibiling->surface();
 
@@ -126,6 +139,9 @@ void RSubsurface::RSubsurfacePrivate::set_sync(wl_client *client, wl_resource *r
     L_UNUSED(client);
     RSubsurface *rSubsurface = (RSubsurface*)wl_resource_get_user_data(resource);
 
+    if (LSR::active())
+        LSR::record(LSR::SubsurfaceSync, resource);
+
     if (!rSubsurface->subsurfaceRole()->isSynced())
     {
         rSubsurface->subsurfaceRole()->imp()->isSynced = true;
@@ -139,6 +155,9 @@ void RSubsurface::RSubsurfacePrivate::set_desync(wl_client *client, wl_resource
     L_UNUSED(client);
     RSubsurface *rSubsurface = (RSubsurface*)wl_resource_get_user_data(resource);
 
+    if (LSR::active())
+        LSR::record(LSR::SubsurfaceDesync, resource);
+
     if (rSubsurface->subsurfaceRole()->isSynced() && !hasSyncParent(rSubsurface->subsurfaceRole()->surface()))
     {
         rSubsurface->subsurfaceRole()->imp()->isSynced = false;
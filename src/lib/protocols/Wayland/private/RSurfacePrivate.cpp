@@ -3,6 +3,8 @@
 #include <protocols/Wayland/RCallback.h>
 #include <protocols/TearingControl/RTearingControl.h>
 #include <private/LSurfacePrivate.h>
+#include <private/LTracePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
 #include <LBaseSurfaceRole.h>
 #include <LCompositor.h>
 #include <LTime.h>
@@ -10,6 +12,7 @@
 #include <pixman.h>
 
 using Changes = LSurface::LSurfacePrivate::ChangesToNotify;
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
 
 void RSurface::RSurfacePrivate::resource_destroy(wl_resource *resource)
 {
@@ -29,6 +32,9 @@ void RSurface::RSurfacePrivate::attach(wl_client *client, wl_resource *resource,
     RSurface *rSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *lSurface = rSurface->surface();
 
+    if (LSR::active())
+        LSR::recordAttach(resource, buffer, x, y);
+
     lSurface->imp()->stateFlags.add(LSurface::LSurfacePrivate::BufferAttached);
 
     if (lSurface->role())
@@ -51,6 +57,10 @@ void RSurface::RSurfacePrivate::frame(wl_client *client, wl_resource *resource,
 {
     RSurface *rSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *lSurface = rSurface->surface();
+
+    if (LSR::active())
+        LSR::record(LSR::SurfaceFrame, resource);
+
     new Wayland::RCallback(client, callback, &lSurface->imp()->frameCallbacks);
 }
 
@@ -63,12 +73,18 @@ void RSurface::RSurfacePrivate::commit(wl_client *, wl_resource *resource)
 {
     RSurface *lRSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *surface = lRSurface->surface();
+
+    if (LSR::active())
+        LSR::recordCommit(surface);
+
     apply_commit(surface);
 }
 
 // The origin params indicates who requested the commit for this surface (itself or its parent surface)
 void RSurface::RSurfacePrivate::apply_commit(LSurface *surface, CommitOrigin origin)
 {
+    LTRACE_SCOPE("apply_commit");
+
     // Check if the surface role wants to apply the commit
     if (surface->role() && !surface->role()->acceptCommitRequest(origin))
          return;
@@ -120,7 +136,7 @@ void RSurface::RSurfacePrivate::apply_commit(LSurface *surface, CommitOrigin ori
             // Returns false on wl_client destroy
             if (!imp->bufferToTexture())
             {
-                LLog::error("[RSurfacePrivate::apply_commit] Failed to convert buffer to OpenGL texture.");
+                LLOG_ERROR("[RSurfacePrivate::apply_commit] Failed to convert buffer to OpenGL texture.");
                 return;
             }
         }
@@ -247,6 +263,9 @@ void RSurface::RSurfacePrivate::damage(wl_client *client, wl_resource *resource,
     if (height <= 0)
         return;
 
+    if (LSR::active())
+        LSR::record(LSR::SurfaceDamage, resource, { x, y, width, height });
+
     lSurface->imp()->pendingDamage.push_back(LRect(x, y, width, height));
     lSurface->imp()->changesToNotify.add(Changes::DamageRegionChanged);
 }
@@ -258,6 +277,9 @@ void RSurface::RSurfacePrivate::set_opaque_region(wl_client *client, wl_resource
     RSurface *rSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *lSurface = rSurface->surface();
 
+    if (LSR::active())
+        LSR::recordRegion(LSR::SurfaceOpaqueRegion, resource, region);
+
     if (region)
     {
         RRegion *rRegion = (RRegion*)wl_resource_get_user_data(region);
@@ -276,6 +298,9 @@ void RSurface::RSurfacePrivate::set_input_region(wl_client *client, wl_resource
     RSurface *rSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *lSurface = rSurface->surface();
 
+    if (LSR::active())
+        LSR::recordRegion(LSR::SurfaceInputRegion, resource, region);
+
     if (region == NULL)
     {
         lSurface->imp()->pendingInputRegion.clear();
@@ -305,6 +330,9 @@ void RSurface::RSurfacePrivate::set_buffer_transform(wl_client *client, wl_resou
         return;
     }
 
+    if (LSR::active())
+        LSR::record(LSR::SurfaceBufferTransform, resource, { transform });
+
     lSurface->imp()->pending.transform = (LFramebuffer::Transform)transform;
 }
 #endif
@@ -322,6 +350,10 @@ void RSurface::RSurfacePrivate::set_buffer_scale(wl_client *client, wl_resource
 
     RSurface *rSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *lSurface = rSurface->surface();
+
+    if (LSR::active())
+        LSR::record(LSR::SurfaceBufferScale, resource, { scale });
+
     lSurface->imp()->pending.bufferScale = scale;
 }
 #endif
@@ -345,6 +377,10 @@ void RSurface::RSurfacePrivate::damage_buffer(wl_client *client, wl_resource *re
 
     RSurface *rSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *lSurface = rSurface->surface();
+
+    if (LSR::active())
+        LSR::record(LSR::SurfaceDamageBuffer, resource, { x, y, width, height });
+
     lSurface->imp()->pendingDamageB.push_back(LRect(x, y, width, height));
     lSurface->imp()->changesToNotify.add(Changes::DamageRegionChanged);
 }
@@ -356,6 +392,10 @@ void RSurface::RSurfacePrivate::offset(wl_client *client, wl_resource *resource,
     L_UNUSED(client);
     RSurface *rSurface = (RSurface*)wl_resource_get_user_data(resource);
     LSurface *lSurface = rSurface->surface();
+
+    if (LSR::active())
+        LSR::record(LSR::SurfaceOffset, resource, { x, y });
+
     handleOffset(lSurface, x, y);
 }
 #endif
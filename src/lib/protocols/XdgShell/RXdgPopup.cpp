@@ -5,8 +5,11 @@
 #include <private/LPointerPrivate.h>
 #include <private/LPopupRolePrivate.h>
 #include <private/LSurfacePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
 #include <LCompositor.h>
 
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
+
 static struct xdg_popup_interface xdg_popup_implementation =
 {
     .destroy = &RXdgPopup::RXdgPopupPrivate::destroy,
@@ -48,10 +51,25 @@ RXdgPopup::RXdgPopup
 
     rXdgSurface->surface()->imp()->setParent(rXdgParentSurface->surface());
     rXdgSurface->surface()->imp()->setPendingRole(imp()->lPopupRole);
+
+    if (LSR::active())
+    {
+        const LPositioner &pos { rXdgPositioner->imp()->lPositioner };
+        LSR::record(LSR::XdgPopupCreate, resource(), {
+            (Int32)wl_resource_get_id(rXdgSurface->resource()),
+            (Int32)wl_resource_get_id(rXdgParentSurface->resource()),
+            pos.size().w(), pos.size().h(),
+            pos.anchorRect().x(), pos.anchorRect().y(), pos.anchorRect().w(), pos.anchorRect().h(),
+            (Int32)pos.anchor(), (Int32)pos.gravity(), (Int32)pos.constraintAdjustment(),
+            pos.offset().x(), pos.offset().y() });
+    }
 }
 
 RXdgPopup::~RXdgPopup()
 {
+    if (LSR::active())
+        LSR::record(LSR::XdgPopupDestroy, resource());
+
     compositor()->destroyPopupRoleRequest(imp()->lPopupRole);
 
     if (xdgSurfaceResource())
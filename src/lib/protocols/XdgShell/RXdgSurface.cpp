@@ -4,8 +4,12 @@
 #include <protocols/XdgShell/private/RXdgToplevelPrivate.h>
 #include <protocols/XdgShell/GXdgWmBase.h>
 #include <protocols/XdgShell/xdg-shell.h>
+#include <protocols/Wayland/RSurface.h>
+#include <private/LSessionRecorderPrivate.h>
+#include <LSurface.h>
 
 using namespace Louvre::Protocols::XdgShell;
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
 
 static struct xdg_surface_interface xdg_surface_implementation =
 {
@@ -36,10 +40,16 @@ RXdgSurface::RXdgSurface
     imp()->gXdgWmBase = gXdgWmBase;
     imp()->lSurface = lSurface;
     xdgWmBaseGlobal()->imp()->xdgSurfaces.push_back(this);
+
+    if (LSR::active())
+        LSR::record(LSR::XdgSurfaceCreate, resource(), { (Int32)wl_resource_get_id(lSurface->surfaceResource()->resource()) });
 }
 
 RXdgSurface::~RXdgSurface()
 {
+    if (LSR::active())
+        LSR::record(LSR::XdgSurfaceDestroy, resource());
+
     if (xdgWmBaseGlobal())
         LVectorRemoveOneUnordered(xdgWmBaseGlobal()->imp()->xdgSurfaces, this);
 
@@ -3,8 +3,11 @@
 #include <protocols/XdgShell/xdg-shell.h>
 #include <private/LToplevelRolePrivate.h>
 #include <private/LSurfacePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
 #include <LCompositor.h>
 
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
+
 static struct xdg_toplevel_interface xdg_toplevel_implementation =
 {
     .destroy = &RXdgToplevel::RXdgToplevelPrivate::destroy,
@@ -47,10 +50,16 @@ RXdgToplevel::RXdgToplevel
     toplevelRoleParams.surface = rXdgSurface->surface();
     imp()->lToplevelRole = compositor()->createToplevelRoleRequest(&toplevelRoleParams);
     rXdgSurface->surface()->imp()->setPendingRole(imp()->lToplevelRole);
+
+    if (LSR::active())
+        LSR::record(LSR::XdgToplevelCreate, resource(), { (Int32)wl_resource_get_id(rXdgSurface->resource()) });
 }
 
 RXdgToplevel::~RXdgToplevel()
 {
+    if (LSR::active())
+        LSR::record(LSR::XdgToplevelDestroy, resource());
+
     // Notify
     compositor()->destroyToplevelRoleRequest(imp()->lToplevelRole);
 
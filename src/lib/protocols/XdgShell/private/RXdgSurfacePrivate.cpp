@@ -6,8 +6,11 @@
 #include <private/LSurfacePrivate.h>
 #include <private/LToplevelRolePrivate.h>
 #include <private/LPopupRolePrivate.h>
+#include <private/LSessionRecorderPrivate.h>
 #include <LPositioner.h>
 
+using LSR = LSessionRecorder::LSessionRecorderPrivate;
+
 void RXdgSurface::RXdgSurfacePrivate::resource_destroy(wl_resource *resource)
 {
     RXdgSurface *rXdgSurface = (RXdgSurface*)wl_resource_get_user_data(resource);
@@ -111,6 +114,9 @@ void RXdgSurface::RXdgSurfacePrivate::set_window_geometry(wl_client *client, wl_
         return;
     }
 
+    if (LSR::active())
+        LSR::record(LSR::XdgSurfaceGeometry, resource, { x, y, width, height });
+
     rXdgSurface->imp()->pendingWindowGeometry = LRect(x, y, width, height);
     rXdgSurface->imp()->windowGeometrySet = true;
     rXdgSurface->imp()->hasPendingWindowGeometry = true;